@@ -0,0 +1,149 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <TiledArray/version.h>
+#include <tiledarray.h>
+#include <iostream>
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if (argc < 3) {
+      std::cout << "Usage: " << argv[0]
+                << " matrix_size block_size [repetitions] [max_layers]\n";
+      return 0;
+    }
+    const long matrix_size = atol(argv[1]);
+    const long block_size = atol(argv[2]);
+    if (matrix_size <= 0) {
+      std::cerr << "Error: matrix size must be greater than zero.\n";
+      return 1;
+    }
+    if (block_size <= 0) {
+      std::cerr << "Error: block size must be greater than zero.\n";
+      return 1;
+    }
+    if ((matrix_size % block_size) != 0ul) {
+      std::cerr
+          << "Error: matrix size must be evenly divisible by block size.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 4 ? atol(argv[3]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+    const long num_blocks = matrix_size / block_size;
+    const long max_layers =
+        std::min<long>((argc >= 5 ? atol(argv[4]) : world.size()),
+                       std::min<long>(world.size(), num_blocks));
+    if (max_layers <= 0) {
+      std::cerr << "Error: number of layers must be greater than zero.\n";
+      return 1;
+    }
+
+    if (world.rank() == 0)
+      std::cout << "TiledArray: replicated (2.5D) SUMMA dense matrix multiply "
+                   "test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of nodes     = " << world.size()
+                << "\nMatrix size         = " << matrix_size << "x"
+                << matrix_size << "\nBlock size          = " << block_size
+                << "x" << block_size << "\nMax. layers         = "
+                << max_layers << "\n";
+
+    // Construct TiledRange
+    std::vector<unsigned int> blocking;
+    blocking.reserve(num_blocks + 1);
+    for (long i = 0l; i <= matrix_size; i += block_size) blocking.push_back(i);
+
+    std::vector<TiledArray::TiledRange1> blocking2(
+        2, TiledArray::TiledRange1(blocking.begin(), blocking.end()));
+
+    TiledArray::TiledRange trange(blocking2.begin(), blocking2.end());
+
+    const double gflop = 2.0 * double(matrix_size) * double(matrix_size) *
+                         double(matrix_size) / 1.0e9;
+
+    {  // array lifetime scope
+      // Construct and initialize arrays
+      TiledArray::TArrayD a(world, trange);
+      TiledArray::TArrayD b(world, trange);
+      TiledArray::TArrayD c(world, trange);
+      a.fill(1.0);
+      b.fill(1.0);
+
+      // Scan the number of replicated layers of the process grid
+      for (long layers = 1l; layers <= max_layers; layers *= 2l) {
+        world.gop.fence();
+
+        double total_time = 0.0;
+        for (int i = 0; i < repeat; ++i) {
+          const double start = madness::wall_time();
+          c("m,n") = (a("m,k") * b("k,n")).set_summa_replication(layers);
+          world.gop.fence();
+          total_time += madness::wall_time() - start;
+        }
+
+        // Check the result
+        const double expected = double(matrix_size) * double(matrix_size) *
+                                double(matrix_size);
+        const double sum = c("m,n").sum().get();
+        if (std::abs(sum - expected) > 1.0e-8 * expected) {
+          if (world.rank() == 0)
+            std::cerr << "Error: result mismatch for layers = " << layers
+                      << "\n";
+          rc = 1;
+        }
+
+        if (world.rank() == 0)
+          std::cout << "Layers = " << layers
+                    << "   Average wall time = " << total_time / double(repeat)
+                    << " sec   Average GFLOPS = "
+                    << gflop * double(repeat) / total_time << "\n";
+      }
+
+    }  // array lifetime scope
+
+    TiledArray::finalize();
+
+  } catch (TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
@@ -0,0 +1,133 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <TiledArray/version.h>
+#include <tiledarray.h>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if (argc < 4) {
+      std::cout << "Usage: " << argv[0]
+                << " outer_size outer_block_size inner_size [repetitions]\n"
+                   "Evaluates out(i,k;m,n) = lhs(i,j;m,n) * rhs(j,k;m,n) "
+                   "with einsum.\n";
+      return 0;
+    }
+    const long outer_size = atol(argv[1]);
+    const long block_size = atol(argv[2]);
+    const long inner_size = atol(argv[3]);
+    if (outer_size <= 0 || block_size <= 0 || inner_size <= 0) {
+      std::cerr << "Error: sizes must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 5 ? atol(argv[4]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    const std::size_t num_blocks = (outer_size + block_size - 1) / block_size;
+
+    if (world.rank() == 0)
+      std::cout << "TiledArray: tensor-of-tensors einsum test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of nodes     = " << world.size()
+                << "\nOuter size          = " << outer_size << "x"
+                << outer_size << "\nOuter block size    = " << block_size
+                << "x" << block_size << "\nInner size          = "
+                << inner_size << "x" << inner_size
+                << "\nNumber of blocks    = " << num_blocks * num_blocks
+                << "\n";
+
+    // Construct the outer tiled range
+    std::vector<unsigned int> blocking;
+    blocking.reserve(num_blocks + 1);
+    for (long i = 0l; i < outer_size; i += block_size) blocking.push_back(i);
+    blocking.push_back(outer_size);
+    const TiledArray::TiledRange1 tr1(blocking.begin(), blocking.end());
+    const TiledArray::TiledRange trange({tr1, tr1});
+
+    typedef TiledArray::Tensor<double> inner_type;
+    typedef TiledArray::DistArray<TiledArray::Tensor<inner_type>,
+                                  TiledArray::DensePolicy>
+        array_type;
+    auto make_tile = [inner_size](const TiledArray::Range& range) {
+      TiledArray::Tensor<inner_type> tile(range);
+      for (std::size_t i = 0ul; i < tile.size(); ++i)
+        tile[i] = inner_type(TiledArray::Range{inner_size, inner_size},
+                             double(i % 7) + 1.0);
+      return tile;
+    };
+    array_type lhs(world, trange), rhs(world, trange), out;
+    lhs.init_tiles(make_tile);
+    rhs.init_tiles(make_tile);
+    world.gop.fence();
+
+    // Each element of the result is a sum of outer_size inner Hadamard
+    // products
+    const double gflop = 2.0 * double(outer_size * outer_size * outer_size) *
+                         double(inner_size * inner_size) / 1.0e9;
+
+    double total_time = 0.0;
+    for (long i = 0l; i < repeat; ++i) {
+      const double start = madness::wall_time();
+      TiledArray::expressions::einsum(out("i,k;m,n"), lhs("i,j;m,n"),
+                                      rhs("j,k;m,n"));
+      world.gop.fence();
+      const double time = madness::wall_time() - start;
+      total_time += time;
+      if (world.rank() == 0)
+        std::cout << "Iteration " << i + 1 << "   time=" << time
+                  << "   GFLOPS=" << gflop / time << "\n";
+    }
+
+    if (world.rank() == 0)
+      std::cout << "Average einsum time = " << total_time / double(repeat)
+                << " sec\nAverage GFLOPS      = "
+                << double(repeat) * gflop / total_time << "\n";
+
+    TiledArray::finalize();
+
+  } catch (TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
@@ -0,0 +1,145 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <TiledArray/version.h>
+#include <tiledarray.h>
+#include <iostream>
+#include <random>
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if (argc < 3) {
+      std::cout << "Usage: " << argv[0]
+                << " num_blocks sparsity [repetitions]\n";
+      return 0;
+    }
+    const long num_blocks = atol(argv[1]);
+    const long sparsity = atol(argv[2]);
+    if (num_blocks <= 0) {
+      std::cerr << "Error: number of blocks must be greater than zero.\n";
+      return 1;
+    }
+    if (sparsity <= 0 || sparsity > 100) {
+      std::cerr << "Error: sparsity must be in the range (0, 100].\n";
+      return 1;
+    }
+    const long repeat = (argc >= 4 ? atol(argv[3]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    if (world.rank() == 0)
+      std::cout << "TiledArray: SparseShape::gemm test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of blocks   = " << num_blocks << "x"
+                << num_blocks << "\nNonzero blocks     = " << sparsity
+                << "%\n";
+
+    // Construct TiledRange
+    const long block_size = 8l;
+    std::vector<unsigned int> blocking;
+    blocking.reserve(num_blocks + 1);
+    for (long i = 0l; i <= num_blocks; ++i) blocking.push_back(i * block_size);
+
+    std::vector<TiledArray::TiledRange1> blocking2(
+        2, TiledArray::TiledRange1(blocking.begin(), blocking.end()));
+
+    TiledArray::TiledRange trange(blocking2.begin(), blocking2.end());
+
+    // Construct the shapes with randomly distributed nonzero tiles
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    auto make_shape = [&]() {
+      TiledArray::Tensor<float> norms(trange.tiles_range(), 0.0f);
+      for (auto& norm : norms)
+        if (distribution(generator) < float(sparsity) / 100.0f)
+          norm = distribution(generator) + 0.5f;
+      return TiledArray::SparseShape<float>(norms, trange);
+    };
+    const TiledArray::SparseShape<float> left = make_shape();
+    const TiledArray::SparseShape<float> right = make_shape();
+
+    const TiledArray::math::GemmHelper gemm_helper(
+        TiledArray::math::blas::NoTranspose,
+        TiledArray::math::blas::NoTranspose, 2u, 2u, 2u);
+
+    // Compare the dense (cutoff = 0) and screened (cutoff = 1) products
+    const float default_cutoff =
+        TiledArray::SparseShape<float>::gemm_density_cutoff();
+    TiledArray::SparseShape<float> results[2];
+    const char* names[2] = {"dense   ", "screened"};
+    for (int method = 0; method < 2; ++method) {
+      TiledArray::SparseShape<float>::gemm_density_cutoff(float(method));
+
+      double total_time = 0.0;
+      for (int i = 0; i < repeat; ++i) {
+        const double start = madness::wall_time();
+        results[method] = left.gemm(right, 1.0, gemm_helper);
+        total_time += madness::wall_time() - start;
+      }
+
+      if (world.rank() == 0)
+        std::cout << names[method]
+                  << "   Average wall time = " << total_time / double(repeat)
+                  << " sec   Result sparsity = " << results[method].sparsity()
+                  << "\n";
+    }
+    TiledArray::SparseShape<float>::gemm_density_cutoff(default_cutoff);
+
+    // Check the result
+    const auto& dense_norms = results[0].data();
+    const auto& screened_norms = results[1].data();
+    for (std::size_t i = 0ul; i < dense_norms.size(); ++i) {
+      if (std::abs(dense_norms[i] - screened_norms[i]) >
+          1.0e-4f * std::abs(dense_norms[i])) {
+        if (world.rank() == 0)
+          std::cerr << "Error: result mismatch for tile " << i << "\n";
+        rc = 1;
+        break;
+      }
+    }
+
+    TiledArray::finalize();
+
+  } catch (TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
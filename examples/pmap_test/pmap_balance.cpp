@@ -0,0 +1,155 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/blocked_pmap.h"
+#include "TiledArray/pmap/cyclic_pmap.h"
+#include "TiledArray/pmap/hash_pmap.h"
+#include "TiledArray/pmap/round_robin_pmap.h"
+#include "TiledArray/pmap/weighted_pmap.h"
+#include "tiledarray.h"
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Make a tiled range with tile extents in [1, 2 * block_size)
+TiledArray::TiledRange1 make_trange1(std::size_t tiles, std::size_t block_size,
+                                     std::mt19937& generator) {
+  std::uniform_int_distribution<std::size_t> extent(1ul,
+                                                    2ul * block_size - 1ul);
+  std::vector<std::size_t> boundaries(1, 0ul);
+  for (std::size_t i = 0ul; i < tiles; ++i)
+    boundaries.push_back(boundaries.back() + extent(generator));
+  return TiledArray::TiledRange1(boundaries.begin(), boundaries.end());
+}
+
+void report(TiledArray::World& world, const std::string& name,
+            const TiledArray::Pmap& pmap, const std::vector<double>& volumes,
+            const std::vector<double>& flops, const double time) {
+  if (world.rank() != 0) return;
+  std::cout << std::left << std::setw(22) << name << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10)
+            << TiledArray::detail::imbalance(
+                   TiledArray::detail::pmap_loads(pmap, volumes))
+            << std::setw(10)
+            << TiledArray::detail::imbalance(
+                   TiledArray::detail::pmap_loads(pmap, flops))
+            << std::setw(12) << std::setprecision(6) << time << "\n";
+  std::cout.unsetf(std::ios_base::floatfield);
+}
+
+int main(int argc, char** argv) {
+  TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+  if (argc < 3) {
+    std::cout << "Usage: pmap_balance tiles block_size [sparsity = 0.5]\n"
+                 "Reports the load imbalance (max/mean) of process maps for a "
+                 "tiles x tiles matrix\nwith nonuniform tile extents and "
+                 "random zero tiles.\n";
+    TiledArray::finalize();
+    return 0;
+  }
+  const std::size_t tiles = std::stoul(argv[1]);
+  const std::size_t block_size = std::stoul(argv[2]);
+  const double sparsity = (argc >= 4 ? std::stod(argv[3]) : 0.5);
+
+  // The same seed on every rank gives the same tiling and shape
+  std::mt19937 generator(42);
+  const TiledArray::TiledRange1 tr1 =
+      make_trange1(tiles, block_size, generator);
+  const TiledArray::TiledRange trange({tr1, tr1});
+
+  TiledArray::Tensor<float> norms(trange.tiles_range(), 1.0f);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  for (std::size_t i = 0ul; i < norms.size(); ++i)
+    if (uniform(generator) < sparsity) norms[i] = 0.0f;
+  const TiledArray::SparseShape<float> shape(norms, trange);
+
+  // Costs: the volume of each tile, and the flops of multiplying it by a
+  // square tile
+  const std::vector<double> volumes = TiledArray::tile_costs(trange, shape);
+  const std::vector<double> flops = TiledArray::tile_costs(
+      trange, shape, [](const TiledArray::Range& range) {
+        const double n = double(range.volume());
+        return n * std::sqrt(n);
+      });
+
+  // Factor the processes into a grid for the cyclic map
+  std::size_t proc_rows = std::sqrt(double(world.size()));
+  while (world.size() % proc_rows) --proc_rows;
+  const std::size_t proc_cols = world.size() / proc_rows;
+
+  if (world.rank() == 0)
+    std::cout << "TiledArray: process map balance test...\n"
+              << "Number of processes = " << world.size() << "\n"
+              << "Matrix tiles        = " << tiles << "x" << tiles << "\n"
+              << "Average tile extent = " << block_size << "\n"
+              << "Zero tiles          = " << shape.sparsity() * 100.0 << "%\n"
+              << "\n"
+              << std::left << std::setw(22) << "Process map" << std::right
+              << std::setw(10) << "volume" << std::setw(10) << "flops"
+              << std::setw(12) << "time (s)"
+              << "\n";
+
+  const std::size_t size = trange.tiles_range().volume();
+  double start = madness::wall_time();
+  TiledArray::detail::BlockedPmap blocked(world, size);
+  report(world, "Blocked", blocked, volumes, flops,
+         madness::wall_time() - start);
+
+  start = madness::wall_time();
+  TiledArray::detail::CyclicPmap cyclic(world, tiles, tiles, proc_rows,
+                                        proc_cols);
+  report(world, "Cyclic", cyclic, volumes, flops, madness::wall_time() - start);
+
+  start = madness::wall_time();
+  TiledArray::detail::HashPmap hash(world, size);
+  report(world, "Hash", hash, volumes, flops, madness::wall_time() - start);
+
+  start = madness::wall_time();
+  TiledArray::detail::RoundRobinPmap round_robin(world, size);
+  report(world, "RoundRobin", round_robin, volumes, flops,
+         madness::wall_time() - start);
+
+  typedef TiledArray::detail::WeightedPmap::Partition Partition;
+  start = madness::wall_time();
+  TiledArray::detail::WeightedPmap greedy(world, flops, Partition::greedy);
+  report(world, "Weighted (greedy)", greedy, volumes, flops,
+         madness::wall_time() - start);
+
+  start = madness::wall_time();
+  TiledArray::detail::WeightedPmap contiguous(world, flops,
+                                              Partition::contiguous);
+  report(world, "Weighted (contiguous)", contiguous, volumes, flops,
+         madness::wall_time() - start);
+
+  // The weighted map plugs into the array constructors
+  TiledArray::TSpArrayD array(
+      world, trange, shape,
+      TiledArray::make_weighted_pmap(world, trange, shape));
+  array.fill(1.0);
+  world.gop.fence();
+
+  TiledArray::finalize();
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <tiledarray.h>
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if (argc < 3) {
+      std::cout << "Usage: " << argv[0]
+                << " matrix_size block_size [repetitions] [allgather|node]\n";
+      return 0;
+    }
+    const long matrix_size = atol(argv[1]);
+    const long block_size = atol(argv[2]);
+    if (matrix_size <= 0) {
+      std::cerr << "Error: matrix size must be greater than zero.\n";
+      return 1;
+    }
+    if (block_size <= 0) {
+      std::cerr << "Error: block size must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 4 ? atol(argv[3]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+    const bool by_node = (argc >= 5 && !strcmp(argv[4], "node"));
+    const auto algorithm =
+        (by_node ? TiledArray::ReplicationAlgorithm::node
+                 : TiledArray::ReplicationAlgorithm::allgather);
+
+    const double gbyte =
+        double(matrix_size * matrix_size * sizeof(double)) / 1.0e9;
+    if (world.rank() == 0)
+      std::cout << "TiledArray: replication test..."
+                << "\nNumber of nodes     = " << world.size()
+                << "\nMatrix size         = " << matrix_size << "x"
+                << matrix_size << "\nBlock size          = " << block_size
+                << "x" << block_size << "\nMemory per matrix   = " << gbyte
+                << " GB\nAlgorithm           = "
+                << (by_node ? "node" : "allgather") << "\n";
+
+    // Construct TiledRange
+    std::vector<long> blocking;
+    for (long i = 0l; i < matrix_size; i += block_size) blocking.push_back(i);
+    blocking.push_back(matrix_size);
+    const std::vector<TiledArray::TiledRange1> blocking2(
+        2, TiledArray::TiledRange1(blocking.begin(), blocking.end()));
+    const TiledArray::TiledRange trange(blocking2.begin(), blocking2.end());
+
+    double total_time = 0.0;
+    for (long i = 0l; i < repeat; ++i) {
+      TiledArray::TArrayD a(world, trange);
+      a.fill(1.0);
+      world.gop.fence();
+
+      const double start = madness::wall_time();
+      a.make_replicated(algorithm);
+      world.gop.fence();
+      const double time = madness::wall_time() - start;
+      total_time += time;
+
+      // Each process receives the tiles it does not own
+      if (world.rank() == 0)
+        std::cout << "Iteration " << i + 1 << "   time=" << time
+                  << "   GB/s/process="
+                  << gbyte * double(world.size() - 1) / double(world.size()) /
+                         time
+                  << "\n";
+    }
+
+    if (world.rank() == 0)
+      std::cout << "Average wall time   = " << total_time / double(repeat)
+                << " sec\n";
+
+    TiledArray::finalize();
+
+  } catch (TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
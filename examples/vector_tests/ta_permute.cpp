@@ -0,0 +1,123 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <TiledArray/version.h>
+#include <tiledarray.h>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+template <typename T>
+void permute_test(TiledArray::World& world, const std::string& type_name,
+                  long extent, long repeat);
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if (argc < 2) {
+      std::cout << "Usage: ta_permute tile_extent [repetitions]\n"
+                   "Permutes rank-4 tiles with tile_extent^4 elements.\n";
+      return 0;
+    }
+    const long extent = atol(argv[1]);
+    if (extent <= 0) {
+      std::cerr << "Error: tile extent must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 3 ? atol(argv[2]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    if (world.rank() == 0)
+      std::cout << "TiledArray: tile permutation test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nTile size           = " << extent << "x" << extent
+                << "x" << extent << "x" << extent
+                << "\nRepetitions         = " << repeat << "\n";
+
+    permute_test<float>(world, "float", extent, repeat);
+    permute_test<double>(world, "double", extent, repeat);
+    permute_test<std::complex<double>>(world, "complex<double>", extent,
+                                       repeat);
+
+    TiledArray::finalize();
+
+  } catch (TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
+
+template <typename T>
+void permute_test(TiledArray::World& world, const std::string& type_name,
+                  long extent, long repeat) {
+  if (world.rank() != 0) return;
+
+  // Permutations that appear in typical rank-4 contractions
+  using TiledArray::Permutation;
+  const std::vector<Permutation> perms = {
+      Permutation{0, 1, 3, 2}, Permutation{0, 2, 1, 3},
+      Permutation{1, 0, 3, 2}, Permutation{3, 2, 1, 0},
+      Permutation{2, 3, 0, 1}, Permutation{0, 3, 2, 1}};
+
+  TiledArray::Tensor<T> tile(TiledArray::Range(extent, extent, extent, extent));
+  for (std::size_t i = 0ul; i < tile.size(); ++i) tile[i] = T(i % 1024);
+
+  // Each permutation reads and writes every element once
+  const double gbytes = 2.0 * double(tile.size() * sizeof(T)) / 1.0e9;
+
+  std::cout << "\n" << type_name << ":\n";
+  for (const auto& perm : perms) {
+    // Warm up
+    TiledArray::Tensor<T> result = tile.permute(perm);
+
+    const double start = madness::wall_time();
+    for (long i = 0l; i < repeat; ++i) result = tile.permute(perm);
+    const double stop = madness::wall_time();
+
+    const double time = (stop - start) / double(repeat);
+    std::cout << "  " << perm << ": " << std::fixed << std::setprecision(6)
+              << time << " s, " << std::setprecision(2) << gbytes / time
+              << " GB/s\n";
+    std::cout.unsetf(std::ios_base::floatfield);
+  }
+}
@@ -0,0 +1,149 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <TiledArray/reduce_task.h>
+#include <TiledArray/version.h>
+#include <tiledarray.h>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Sum of tiles
+struct TileSum {
+  typedef TiledArray::Tensor<double> result_type;
+  typedef TiledArray::Tensor<double> argument_type;
+
+  result_type operator()() const { return result_type(); }
+
+  const result_type& operator()(const result_type& result) const {
+    return result;
+  }
+
+  void operator()(result_type& result, const argument_type& arg) const {
+    if (arg.empty()) return;
+    if (result.empty())
+      result = arg.clone();
+    else
+      result.add_to(arg);
+  }
+};
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if (argc < 3) {
+      std::cout << "Usage: ta_reduce_task arguments tile_size [repetitions]\n"
+                   "Reduces arguments tiles with tile_size elements that "
+                   "become ready concurrently\ninto one tile, with each "
+                   "accumulator count.\n";
+      return 0;
+    }
+    const long arguments = atol(argv[1]);
+    const long tile_size = atol(argv[2]);
+    if (arguments <= 0 || tile_size <= 0) {
+      std::cerr << "Error: sizes must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 4 ? atol(argv[3]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    if (world.rank() == 0)
+      std::cout << "TiledArray: reduce task contention test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of threads   = " << madness::ThreadPool::size() + 1
+                << "\nArguments           = " << arguments
+                << "\nTile size           = " << tile_size
+                << "\nRepetitions         = " << repeat << "\n\n"
+                << std::setw(14) << "accumulators" << std::setw(14)
+                << "time (s)" << std::setw(14) << "GB/s"
+                << "\n";
+
+    const TiledArray::Tensor<double> tile(TiledArray::Range(tile_size), 1.0);
+    const double gbytes = double(arguments) * double(tile_size) *
+                          sizeof(double) / 1.0e9;
+    const std::size_t default_accumulators =
+        TiledArray::reduce_task_accumulators();
+
+    for (std::size_t accumulators = 1ul; accumulators <= 64ul;
+         accumulators *= 2ul) {
+      TiledArray::set_reduce_task_accumulators(accumulators);
+
+      double total_time = 0.0;
+      for (long r = 0l; r < repeat; ++r) {
+        // All arguments become ready at about the same time, like the GEMM
+        // results of a SUMMA iteration that contribute to one result tile
+        std::vector<madness::Future<TiledArray::Tensor<double>>> args(
+            arguments);
+        TiledArray::detail::ReduceTask<TileSum> task(world);
+        for (auto& arg : args) task.add(arg);
+
+        const double start = madness::wall_time();
+        auto result = task.submit();
+        for (auto& arg : args)
+          world.taskq.add(
+              [](madness::Future<TiledArray::Tensor<double>>* f,
+                 const TiledArray::Tensor<double>& t) { f->set(t); },
+              &arg, tile);
+        const double sum = result.get()[0];
+        total_time += madness::wall_time() - start;
+        world.gop.fence();
+
+        if (sum != double(arguments)) {
+          std::cerr << "Error: incorrect sum.\n";
+          return 1;
+        }
+      }
+
+      if (world.rank() == 0)
+        std::cout << std::setw(14) << accumulators << std::setw(14)
+                  << total_time / double(repeat) << std::setw(14)
+                  << double(repeat) * gbytes / total_time << "\n";
+    }
+
+    TiledArray::set_reduce_task_accumulators(default_accumulators);
+
+    TiledArray::finalize();
+
+  } catch (TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch (...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
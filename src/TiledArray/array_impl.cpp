@@ -28,31 +28,31 @@
 namespace TiledArray {
 namespace detail {
 
-template class ArrayImpl<Tensor<double, Eigen::aligned_allocator<double> >,
+template class ArrayImpl<Tensor<double, tensor_allocator<double> >,
                          DensePolicy>;
-template class ArrayImpl<Tensor<float, Eigen::aligned_allocator<float> >,
+template class ArrayImpl<Tensor<float, tensor_allocator<float> >,
                          DensePolicy>;
-template class ArrayImpl<Tensor<int, Eigen::aligned_allocator<int> >,
+template class ArrayImpl<Tensor<int, tensor_allocator<int> >,
                          DensePolicy>;
-template class ArrayImpl<Tensor<long, Eigen::aligned_allocator<long> >,
+template class ArrayImpl<Tensor<long, tensor_allocator<long> >,
                          DensePolicy>;
 //    template class ArrayImpl<Tensor<std::complex<double>,
-//    Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>; template
+//    tensor_allocator<std::complex<double> > >, DensePolicy>; template
 //    class ArrayImpl<Tensor<std::complex<float>,
-//    Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>
+//    tensor_allocator<std::complex<float> > >, DensePolicy>
 
-template class ArrayImpl<Tensor<double, Eigen::aligned_allocator<double> >,
+template class ArrayImpl<Tensor<double, tensor_allocator<double> >,
                          SparsePolicy>;
-template class ArrayImpl<Tensor<float, Eigen::aligned_allocator<float> >,
+template class ArrayImpl<Tensor<float, tensor_allocator<float> >,
                          SparsePolicy>;
-template class ArrayImpl<Tensor<int, Eigen::aligned_allocator<int> >,
+template class ArrayImpl<Tensor<int, tensor_allocator<int> >,
                          SparsePolicy>;
-template class ArrayImpl<Tensor<long, Eigen::aligned_allocator<long> >,
+template class ArrayImpl<Tensor<long, tensor_allocator<long> >,
                          SparsePolicy>;
 //    template class ArrayImpl<Tensor<std::complex<double>,
-//    Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>; template
+//    tensor_allocator<std::complex<double> > >, SparsePolicy>; template
 //    class ArrayImpl<Tensor<std::complex<float>,
-//    Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
+//    tensor_allocator<std::complex<float> > >, SparsePolicy>;
 
 }  // namespace detail
 }  // namespace TiledArray
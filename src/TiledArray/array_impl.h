@@ -27,7 +27,9 @@
 #define TILEDARRAY_ARRAY_IMPL_H__INCLUDED
 
 #include <TiledArray/distributed_storage.h>
+#include <TiledArray/symm/tile_symmetry.h>
 #include <TiledArray/tensor_impl.h>
+#include <TiledArray/tile_interface/scale.h>
 #include <TiledArray/transform_iterator.h>
 #include <TiledArray/type_traits.h>
 
@@ -263,7 +265,7 @@ class ArrayIterator {
         array_->pmap()->end();
     do {
       ++it_;
-    } while ((it_ != end) && array_->is_zero(*it_));
+    } while ((it_ != end) && !array_->is_stored(*it_));
   }
 
  public:
@@ -439,6 +441,27 @@ class ArrayImpl : public TensorImpl<Policy> {
 
  private:
   storage_type data_;  ///< Tile container
+  /// The permutational symmetry of the tiles; only the unique tiles are
+  /// stored
+  std::shared_ptr<const symmetry::TileSymmetry> symmetry_;
+
+  /// Reconstruct a tile from the unique tile of its orbit
+
+  /// \param ord The ordinal index of a tile that is not unique
+  /// \return A \c future to tile \c ord
+  future get_symmetric(const ordinal_type ord) const {
+    const auto& tiles_range = TensorImpl_::trange().tiles_range();
+    const auto canonical = symmetry_->canonical(tiles_range.idx(ord));
+    const auto perm = symmetry::TileSymmetry::tile_permutation(
+        canonical.second, tiles_range.rank());
+    const numeric_type factor(
+        static_cast<int>(symmetry_->phase(canonical.second)));
+    return TensorImpl_::world().taskq.add(
+        [perm, factor](const value_type& tile) -> value_type {
+          return scale(tile, factor, perm);
+        },
+        data_.get(tiles_range.ordinal(canonical.first)));
+  }
 
  public:
   /// Constructor
@@ -469,7 +492,9 @@ class ArrayImpl : public TensorImpl<Policy> {
                                         detail::is_integral_range_v<Index>>>
   future get(const Index& i) const {
     TA_ASSERT(!TensorImpl_::is_zero(i));
-    return data_.get(TensorImpl_::trange().tiles_range().ordinal(i));
+    const auto ord = TensorImpl_::trange().tiles_range().ordinal(i);
+    if (symmetry_ && !is_stored(ord)) return get_symmetric(ord);
+    return data_.get(ord);
   }
 
   /// Tile future accessor
@@ -494,8 +519,9 @@ class ArrayImpl : public TensorImpl<Policy> {
             typename = std::enable_if_t<std::is_integral_v<Index> ||
                                         detail::is_integral_range_v<Index>>>
   const future& get_local(const Index& i) const {
-    TA_ASSERT(!TensorImpl_::is_zero(i) && TensorImpl_::is_local(i));
-    return data_.get_local(TensorImpl_::trange().tiles_range().ordinal(i));
+    const auto ord = TensorImpl_::trange().tiles_range().ordinal(i);
+    TA_ASSERT(is_stored(ord) && TensorImpl_::is_local(ord));
+    return data_.get_local(ord);
   }
 
   /// Local tile future accessor
@@ -520,8 +546,9 @@ class ArrayImpl : public TensorImpl<Policy> {
             typename = std::enable_if_t<std::is_integral_v<Index> ||
                                         detail::is_integral_range_v<Index>>>
   future& get_local(const Index& i) {
-    TA_ASSERT(!TensorImpl_::is_zero(i) && TensorImpl_::is_local(i));
-    return data_.get_local(TensorImpl_::trange().tiles_range().ordinal(i));
+    const auto ord = TensorImpl_::trange().tiles_range().ordinal(i);
+    TA_ASSERT(is_stored(ord) && TensorImpl_::is_local(ord));
+    return data_.get_local(ord);
   }
 
   /// Local tile future accessor
@@ -549,8 +576,8 @@ class ArrayImpl : public TensorImpl<Policy> {
             typename = std::enable_if_t<std::is_integral_v<Index> ||
                                         detail::is_integral_range_v<Index>>>
   void set(const Index& i, Value&& value) {
-    TA_ASSERT(!TensorImpl_::is_zero(i));
     const auto ord = TensorImpl_::trange().tiles_range().ordinal(i);
+    TA_ASSERT(is_stored(ord));
     data_.set(ord, std::forward<Value>(value));
     if (set_notifier_accessor()) {
       set_notifier_accessor()(*this, ord);
@@ -569,8 +596,8 @@ class ArrayImpl : public TensorImpl<Policy> {
   template <typename Index, typename Value,
             typename = std::enable_if_t<std::is_integral_v<Index>>>
   void set(const std::initializer_list<Index>& i, Value&& value) {
-    TA_ASSERT(!TensorImpl_::is_zero(i));
     const auto ord = TensorImpl_::trange().tiles_range().ordinal(i);
+    TA_ASSERT(is_stored(ord));
     data_.set(ord, std::forward<Value>(value));
     if (set_notifier_accessor()) {
       set_notifier_accessor()(*this, ord);
@@ -587,7 +614,7 @@ class ArrayImpl : public TensorImpl<Policy> {
     // Find the first non-zero iterator
     const typename pmap_interface::const_iterator end =
         TensorImpl_::pmap()->end();
-    while ((it != end) && TensorImpl_::is_zero(*it)) ++it;
+    while ((it != end) && !is_stored(*it)) ++it;
 
     // Construct and return the iterator
     return iterator(this, it);
@@ -603,7 +630,7 @@ class ArrayImpl : public TensorImpl<Policy> {
     // Find the fist non-zero iterator
     const typename pmap_interface::const_iterator end =
         TensorImpl_::pmap()->end();
-    while ((it != end) && TensorImpl_::is_zero(*it)) ++it;
+    while ((it != end) && !is_stored(*it)) ++it;
 
     // Construct and return the iterator
     return const_iterator(this, it);
@@ -621,6 +648,34 @@ class ArrayImpl : public TensorImpl<Policy> {
     return const_iterator(this, TensorImpl_::pmap()->end());
   }
 
+  /// Symmetry accessor
+
+  /// \return The permutational symmetry of the tiles, or a null pointer if
+  /// the tiles have no symmetry
+  const std::shared_ptr<const symmetry::TileSymmetry>& symmetry() const {
+    return symmetry_;
+  }
+
+  /// Set the permutational symmetry of the tiles
+
+  /// Must be set before any tile is set.
+  /// \param symm The symmetry of the tiles
+  void symmetry(std::shared_ptr<const symmetry::TileSymmetry> symm) {
+    TA_ASSERT(!symm || symm->is_compatible(TensorImpl_::trange()));
+    symmetry_ = std::move(symm);
+  }
+
+  /// Check that a tile is stored
+
+  /// \param ord The ordinal index of a tile
+  /// \return \c true if tile \c ord is nonzero and, if the tiles are
+  /// symmetric, unique
+  bool is_stored(const ordinal_type ord) const {
+    if (TensorImpl_::is_zero(ord)) return false;
+    return !symmetry_ ||
+           symmetry_->is_unique(TensorImpl_::trange().tiles_range().idx(ord));
+  }
+
   /// Unique object id accessor
 
   /// \return A const reference to this object unique id
@@ -637,32 +692,32 @@ class ArrayImpl : public TensorImpl<Policy> {
 #ifndef TILEDARRAY_HEADER_ONLY
 
 extern template class ArrayImpl<
-    Tensor<double, Eigen::aligned_allocator<double>>, DensePolicy>;
-extern template class ArrayImpl<Tensor<float, Eigen::aligned_allocator<float>>,
+    Tensor<double, tensor_allocator<double>>, DensePolicy>;
+extern template class ArrayImpl<Tensor<float, tensor_allocator<float>>,
                                 DensePolicy>;
-extern template class ArrayImpl<Tensor<int, Eigen::aligned_allocator<int>>,
+extern template class ArrayImpl<Tensor<int, tensor_allocator<int>>,
                                 DensePolicy>;
-extern template class ArrayImpl<Tensor<long, Eigen::aligned_allocator<long>>,
+extern template class ArrayImpl<Tensor<long, tensor_allocator<long>>,
                                 DensePolicy>;
 //    extern template
 //    class ArrayImpl<Tensor<std::complex<double>,
-//    Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>; extern
+//    tensor_allocator<std::complex<double> > >, DensePolicy>; extern
 //    template class ArrayImpl<Tensor<std::complex<float>,
-//    Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>;
+//    tensor_allocator<std::complex<float> > >, DensePolicy>;
 
 extern template class ArrayImpl<
-    Tensor<double, Eigen::aligned_allocator<double>>, SparsePolicy>;
-extern template class ArrayImpl<Tensor<float, Eigen::aligned_allocator<float>>,
+    Tensor<double, tensor_allocator<double>>, SparsePolicy>;
+extern template class ArrayImpl<Tensor<float, tensor_allocator<float>>,
                                 SparsePolicy>;
-extern template class ArrayImpl<Tensor<int, Eigen::aligned_allocator<int>>,
+extern template class ArrayImpl<Tensor<int, tensor_allocator<int>>,
                                 SparsePolicy>;
-extern template class ArrayImpl<Tensor<long, Eigen::aligned_allocator<long>>,
+extern template class ArrayImpl<Tensor<long, tensor_allocator<long>>,
                                 SparsePolicy>;
 //    extern template
 //    class ArrayImpl<Tensor<std::complex<double>,
-//    Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>; extern
+//    tensor_allocator<std::complex<double> > >, SparsePolicy>; extern
 //    template class ArrayImpl<Tensor<std::complex<float>,
-//    Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
+//    tensor_allocator<std::complex<float> > >, SparsePolicy>;
 
 #endif  // TILEDARRAY_HEADER_ONLY
 
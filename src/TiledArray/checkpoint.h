@@ -0,0 +1,322 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  checkpoint.h
+ *
+ */
+
+#ifndef TILEDARRAY_CHECKPOINT_H__INCLUDED
+#define TILEDARRAY_CHECKPOINT_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/error.h>
+#include <TiledArray/external/madness.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+namespace detail {
+
+/// Shared checkpoint file
+
+/// A thin wrapper around an MPI-IO file handle that is opened by all ranks
+/// of a \c World and closed when the object is destroyed. Reads and writes
+/// are split into chunks that fit the \c int counts of MPI.
+class CheckpointFile {
+ private:
+  MPI_File file_;  ///< The MPI-IO file handle
+
+  /// The largest number of bytes moved by one MPI-IO call
+  static constexpr std::uint64_t max_chunk = 1ul << 30;
+
+ public:
+  /// Open a checkpoint file
+
+  /// This is a collective operation.
+  /// \param world The world of the ranks that open the file
+  /// \param filename The name of the file
+  /// \param write If \c true , the file is created (or overwritten) for
+  /// writing, otherwise it is opened for reading
+  /// \throw TiledArray::Exception When the file cannot be opened
+  CheckpointFile(World& world, const std::string& filename, const bool write) {
+    const int amode =
+        (write ? MPI_MODE_CREATE | MPI_MODE_WRONLY : MPI_MODE_RDONLY);
+    if (MPI_File_open(world.mpi.comm().Get_mpi_comm(), filename.c_str(),
+                      amode, MPI_INFO_NULL, &file_) != MPI_SUCCESS)
+      TA_EXCEPTION("unable to open the checkpoint file");
+  }
+
+  ~CheckpointFile() { MPI_File_close(&file_); }
+
+  CheckpointFile(const CheckpointFile&) = delete;
+  CheckpointFile& operator=(const CheckpointFile&) = delete;
+
+  /// Set the size of the file
+
+  /// This is a collective operation.
+  /// \param size The size of the file in bytes
+  /// \throw TiledArray::Exception When the file cannot be resized
+  void resize(const std::uint64_t size) {
+    if (MPI_File_set_size(file_, MPI_Offset(size)) != MPI_SUCCESS)
+      TA_EXCEPTION("unable to resize the checkpoint file");
+  }
+
+  /// Write data at an offset
+
+  /// \param offset The offset of the data in the file
+  /// \param data The data
+  /// \param size The number of bytes to be written
+  /// \throw TiledArray::Exception When the data cannot be written
+  void write(std::uint64_t offset, const void* data, std::uint64_t size) {
+    const char* ptr = static_cast<const char*>(data);
+    while (size) {
+      const int n = int(std::min(size, max_chunk));
+      if (MPI_File_write_at(file_, MPI_Offset(offset), ptr, n, MPI_BYTE,
+                            MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        TA_EXCEPTION("unable to write to the checkpoint file");
+      offset += n;
+      ptr += n;
+      size -= n;
+    }
+  }
+
+  /// Read data at an offset
+
+  /// \param offset The offset of the data in the file
+  /// \param[out] data The buffer that will hold the data
+  /// \param size The number of bytes to be read
+  /// \param collective If \c true , all ranks read the same range with
+  /// collective MPI-IO calls
+  /// \throw TiledArray::Exception When the data cannot be read
+  void read(std::uint64_t offset, void* data, std::uint64_t size,
+            const bool collective = false) {
+    char* ptr = static_cast<char*>(data);
+    while (size) {
+      const int n = int(std::min(size, max_chunk));
+      const int result =
+          (collective ? MPI_File_read_at_all(file_, MPI_Offset(offset), ptr, n,
+                                             MPI_BYTE, MPI_STATUS_IGNORE)
+                      : MPI_File_read_at(file_, MPI_Offset(offset), ptr, n,
+                                         MPI_BYTE, MPI_STATUS_IGNORE));
+      if (result != MPI_SUCCESS)
+        TA_EXCEPTION("unable to read from the checkpoint file");
+      offset += n;
+      ptr += n;
+      size -= n;
+    }
+  }
+};  // class CheckpointFile
+
+/// Fixed-size header of a checkpoint file
+struct CheckpointHeader {
+  char magic[8];                ///< Identifies a checkpoint file
+  std::uint64_t version;        ///< The format version
+  std::uint64_t type_hash;      ///< Hash of the array type
+  std::uint64_t metadata_size;  ///< Size of the serialized trange and shape
+  std::uint64_t volume;         ///< Number of tiles in the index
+  std::uint64_t nproc;          ///< Number of ranks that wrote the file
+
+  static constexpr char checkpoint_magic[8] = {'T', 'A', 'C', 'K',
+                                               'P', 'T', '\0', '\0'};
+  static constexpr std::uint64_t checkpoint_version = 1ul;
+};  // struct CheckpointHeader
+
+/// Serialize an object into a buffer
+
+/// \tparam T The object type
+/// \param object The object to be serialized
+/// \return A buffer that holds the serialized object
+template <typename T>
+std::vector<unsigned char> checkpoint_serialize(const T& object) {
+  madness::archive::BufferOutputArchive count;
+  count& object;
+  std::vector<unsigned char> buffer(count.size());
+  madness::archive::BufferOutputArchive ar(buffer.data(), buffer.size());
+  ar& object;
+  return buffer;
+}
+
+}  // namespace detail
+
+/// Write an array to a checkpoint file
+
+/// Every rank writes its local tiles directly into one shared file with
+/// MPI-IO, so the bandwidth of the file system is not limited by a few
+/// writer ranks. The file holds
+/// -# a \c detail::CheckpointHeader ,
+/// -# the serialized tiled range and shape of \c array ,
+/// -# a tile index with the offset and size of each tile (zero tiles have
+///    size 0), and
+/// -# the serialized tiles; the tiles of each rank are stored contiguously.
+///
+/// The file uses the byte order of the writing machine.
+/// \note This is a collective operation that fences before and after
+/// writing.
+/// \tparam Tile The tile type of \c array
+/// \tparam Policy The policy type of \c array
+/// \param array The array to be written
+/// \param filename The name of the checkpoint file
+/// \throw TiledArray::Exception When the file cannot be written
+template <typename Tile, typename Policy>
+void write_checkpoint(const DistArray<Tile, Policy>& array,
+                      const std::string& filename) {
+  World& world = array.world();
+  world.gop.fence();
+
+  const auto volume = array.trange().tiles_range().volume();
+  const auto& pmap = *array.pmap();
+
+  // Size of each tile
+  std::vector<std::uint64_t> sizes(volume, 0ul);
+  for (auto it = array.begin(); it != array.end(); ++it) {
+    madness::archive::BufferOutputArchive count;
+    count & it->get();
+    sizes[it.ordinal()] = count.size();
+  }
+  world.gop.sum(sizes.data(), sizes.size());
+
+  // Place the tiles of each rank contiguously after the index
+  const std::vector<unsigned char> metadata =
+      detail::checkpoint_serialize(std::make_pair(array.trange(), array.shape()));
+  const std::uint64_t data_offset = sizeof(detail::CheckpointHeader) +
+                                    metadata.size() +
+                                    2ul * volume * sizeof(std::uint64_t);
+  std::vector<std::uint64_t> rank_offsets(world.size() + 1ul, 0ul);
+  for (std::size_t ord = 0ul; ord < volume; ++ord)
+    rank_offsets[pmap.owner(ord) + 1ul] += sizes[ord];
+  rank_offsets[0] = data_offset;
+  std::partial_sum(rank_offsets.begin(), rank_offsets.end(),
+                   rank_offsets.begin());
+  std::vector<std::uint64_t> index(2ul * volume, 0ul);
+  for (std::size_t ord = 0ul; ord < volume; ++ord) {
+    if (sizes[ord]) {
+      std::uint64_t& offset = rank_offsets[pmap.owner(ord)];
+      index[2ul * ord] = offset;
+      index[2ul * ord + 1ul] = sizes[ord];
+      offset += sizes[ord];
+    }
+  }
+
+  {
+    detail::CheckpointFile file(world, filename, true);
+    file.resize(rank_offsets.back());
+
+    if (world.rank() == 0) {
+      detail::CheckpointHeader header;
+      std::copy_n(detail::CheckpointHeader::checkpoint_magic, 8, header.magic);
+      header.version = detail::CheckpointHeader::checkpoint_version;
+      header.type_hash = typeid(array).hash_code();
+      header.metadata_size = metadata.size();
+      header.volume = volume;
+      header.nproc = world.size();
+      file.write(0ul, &header, sizeof(header));
+      file.write(sizeof(header), metadata.data(), metadata.size());
+      file.write(sizeof(header) + metadata.size(), index.data(),
+                 index.size() * sizeof(std::uint64_t));
+    }
+
+    for (auto it = array.begin(); it != array.end(); ++it) {
+      const std::size_t ord = it.ordinal();
+      const std::vector<unsigned char> buffer =
+          detail::checkpoint_serialize(it->get());
+      TA_ASSERT(buffer.size() == index[2ul * ord + 1ul]);
+      file.write(index[2ul * ord], buffer.data(), buffer.size());
+    }
+  }  // close the file
+
+  world.gop.fence();
+}
+
+/// Read an array from a checkpoint file
+
+/// Every rank reads the header and tile index of a file that was written
+/// by \c write_checkpoint() and then reads its local tiles directly from
+/// the file. The array may be distributed differently than the array that
+/// was written, e.g. when the number of ranks has changed.
+/// \note This is a collective operation.
+/// \tparam Array The array type, which must match the type of the array
+/// that was written
+/// \param world The world of the array
+/// \param filename The name of the checkpoint file
+/// \param pmap The process map of the array (default: the default process
+/// map of \c Array )
+/// \return The array
+/// \throw TiledArray::Exception When the file cannot be read, or it does
+/// not hold an array of type \c Array
+template <typename Array>
+Array read_checkpoint(
+    World& world, const std::string& filename,
+    const std::shared_ptr<typename Array::pmap_interface>& pmap = {}) {
+  typedef typename Array::value_type value_type;
+
+  detail::CheckpointFile file(world, filename, false);
+
+  detail::CheckpointHeader header;
+  file.read(0ul, &header, sizeof(header), true);
+  if (std::memcmp(header.magic, detail::CheckpointHeader::checkpoint_magic,
+                  8) != 0 ||
+      header.version != detail::CheckpointHeader::checkpoint_version)
+    TA_EXCEPTION("read_checkpoint: invalid checkpoint file");
+  if (header.type_hash != typeid(Array).hash_code())
+    TA_EXCEPTION("read_checkpoint: source DistArray type != Array type");
+
+  // Read the tiled range, shape, and tile index
+  std::vector<unsigned char> metadata(header.metadata_size);
+  file.read(sizeof(header), metadata.data(), metadata.size(), true);
+  std::pair<typename Array::trange_type, typename Array::shape_type> meta;
+  {
+    madness::archive::BufferInputArchive ar(metadata.data(), metadata.size());
+    ar& meta;
+  }
+  if (meta.first.tiles_range().volume() != header.volume)
+    TA_EXCEPTION("read_checkpoint: invalid checkpoint file");
+  std::vector<std::uint64_t> index(2ul * header.volume);
+  file.read(sizeof(header) + metadata.size(), index.data(),
+            index.size() * sizeof(std::uint64_t), true);
+
+  Array array(world, meta.first, meta.second, pmap);
+
+  // Read the local tiles
+  std::vector<unsigned char> buffer;
+  for (const auto ord : *array.pmap()) {
+    if (array.is_zero(ord)) continue;
+    const std::uint64_t size = index[2ul * ord + 1ul];
+    if (size == 0ul)
+      TA_EXCEPTION("read_checkpoint: a non-zero tile is missing");
+    buffer.resize(size);
+    file.read(index[2ul * ord], buffer.data(), size);
+
+    value_type tile;
+    madness::archive::BufferInputArchive ar(buffer.data(), size);
+    ar& tile;
+    array.set(ord, std::move(tile));
+  }
+
+  return array;
+}
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_CHECKPOINT_H__INCLUDED
@@ -0,0 +1,300 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  chunked_bcast.h
+ *
+ */
+
+#ifndef TILEDARRAY_CHUNKED_BCAST_H__INCLUDED
+#define TILEDARRAY_CHUNKED_BCAST_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/external/madness.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace TiledArray {
+namespace detail {
+
+/// Chunked broadcast message key
+
+/// The first member is the key of the broadcast, the second member is the
+/// message index: 0 for the header, which holds the size of the serialized
+/// object in bytes, and \c i for the \c i-th chunk of the object. A key type
+/// that differs from that used by \c madness::WorldGopInterface::bcast()
+/// ensures that chunk messages do not collide with ordinary broadcasts.
+typedef std::pair<madness::DistributedID, std::size_t> chunked_bcast_key;
+
+/// Chunk of a serialized object
+typedef std::vector<unsigned char> chunked_bcast_chunk;
+
+/// Send the chunks of a serialized object to the children of this process
+
+/// This task waits for the object, serializes it, and sends the header and
+/// chunks to the children of the broadcast root.
+/// \tparam T The type of the object to be broadcast
+template <typename T>
+class ChunkedBcastSend : public madness::TaskInterface {
+ private:
+  World& world_;                      ///< The world of the broadcast
+  const madness::DistributedID key_;  ///< The broadcast key
+  Future<T> value_;                   ///< The object to be broadcast
+  const ProcessID child0_;            ///< The first child process
+  const ProcessID child1_;            ///< The second child process
+  const std::size_t chunk_size_;      ///< The number of bytes per chunk
+
+  /// Send a message to the children of this process
+
+  /// \tparam Msg The message type
+  /// \param index The message index
+  /// \param msg The message
+  template <typename Msg>
+  void send(const std::size_t index, const Msg& msg) const {
+    const chunked_bcast_key key(key_, index);
+    if (child0_ != -1) world_.gop.send(child0_, key, msg);
+    if (child1_ != -1) world_.gop.send(child1_, key, msg);
+  }
+
+ public:
+  /// Constructor
+
+  /// \param world The world of the broadcast
+  /// \param key The broadcast key
+  /// \param value The object to be broadcast
+  /// \param child0 The first child process
+  /// \param child1 The second child process
+  /// \param chunk_size The number of bytes per chunk
+  ChunkedBcastSend(World& world, const madness::DistributedID& key,
+                   const Future<T>& value, const ProcessID child0,
+                   const ProcessID child1, const std::size_t chunk_size)
+      : madness::TaskInterface(madness::TaskAttributes::hipri()),
+        world_(world),
+        key_(key),
+        value_(value),
+        child0_(child0),
+        child1_(child1),
+        chunk_size_(chunk_size) {
+    if (!value_.probe()) {
+      madness::DependencyInterface::inc();
+      value_.register_callback(this);
+    }
+  }
+
+  virtual ~ChunkedBcastSend() {}
+
+  /// Task run function
+  virtual void run(const madness::TaskThreadEnv&) {
+    // Serialize the object
+    madness::archive::BufferOutputArchive count;
+    count& value_.get();
+    const std::size_t nbytes = count.size();
+    chunked_bcast_chunk buffer(nbytes);
+    madness::archive::BufferOutputArchive ar(buffer.data(), nbytes);
+    ar& value_.get();
+
+    // Send the header followed by the chunks
+    send(0ul, nbytes);
+    std::size_t index = 1ul;
+    for (std::size_t first = 0ul; first < nbytes; first += chunk_size_) {
+      const std::size_t last = std::min(first + chunk_size_, nbytes);
+      send(index++, chunked_bcast_chunk(buffer.begin() + first,
+                                        buffer.begin() + last));
+    }
+  }
+
+};  // class ChunkedBcastSend
+
+/// Deserialize an object once all of its chunks have arrived
+
+/// \tparam T The type of the object to be broadcast
+template <typename T>
+class ChunkedBcastAssemble : public madness::TaskInterface {
+ private:
+  Future<T> value_;  ///< The result object
+  std::vector<Future<chunked_bcast_chunk>> chunks_;  ///< The object chunks
+  const std::size_t nbytes_;  ///< The size of the serialized object
+
+ public:
+  /// Constructor
+
+  /// \param value The future that will be set to the broadcast object
+  /// \param chunks The chunks of the serialized object
+  /// \param nbytes The size of the serialized object in bytes
+  ChunkedBcastAssemble(const Future<T>& value,
+                       std::vector<Future<chunked_bcast_chunk>>&& chunks,
+                       const std::size_t nbytes)
+      : madness::TaskInterface(madness::TaskAttributes::hipri()),
+        value_(value),
+        chunks_(std::move(chunks)),
+        nbytes_(nbytes) {
+    for (auto& chunk : chunks_) {
+      if (!chunk.probe()) {
+        madness::DependencyInterface::inc();
+        chunk.register_callback(this);
+      }
+    }
+  }
+
+  virtual ~ChunkedBcastAssemble() {}
+
+  /// Task run function
+  virtual void run(const madness::TaskThreadEnv&) {
+    // Concatenate the chunks
+    chunked_bcast_chunk buffer;
+    buffer.reserve(nbytes_);
+    for (auto& chunk : chunks_) {
+      const chunked_bcast_chunk& data = chunk.get();
+      buffer.insert(buffer.end(), data.begin(), data.end());
+      chunk = Future<chunked_bcast_chunk>();
+    }
+    TA_ASSERT(buffer.size() == nbytes_);
+
+    // Deserialize the object
+    T result;
+    madness::archive::BufferInputArchive ar(buffer.data(), nbytes_);
+    ar& result;
+    value_.set(std::move(result));
+  }
+
+};  // class ChunkedBcastAssemble
+
+/// Receive and forward the chunks of a broadcast object
+
+/// This task waits for the header message, which holds the size of the
+/// serialized object, and then posts the receives for all chunks. Each chunk
+/// is forwarded to the children of this process as soon as it arrives, so
+/// transfers of consecutive chunks overlap along the broadcast tree.
+/// \tparam T The type of the object to be broadcast
+template <typename T>
+class ChunkedBcastRecv : public madness::TaskInterface {
+ private:
+  World& world_;                      ///< The world of the broadcast
+  const madness::DistributedID key_;  ///< The broadcast key
+  Future<T> value_;                   ///< The result object
+  const ProcessID parent_;            ///< The parent process
+  const ProcessID child0_;            ///< The first child process
+  const ProcessID child1_;            ///< The second child process
+  const std::size_t chunk_size_;      ///< The number of bytes per chunk
+  Future<std::size_t> nbytes_;  ///< The size of the serialized object
+
+  /// Receive a message and forward it to the children of this process
+
+  /// \tparam Msg The message type
+  /// \param index The message index
+  /// \return A future to the message
+  template <typename Msg>
+  Future<Msg> recv(const std::size_t index) const {
+    const chunked_bcast_key key(key_, index);
+    Future<Msg> msg = world_.gop.template recv<Msg>(parent_, key);
+    if (child0_ != -1) world_.gop.send(child0_, key, msg);
+    if (child1_ != -1) world_.gop.send(child1_, key, msg);
+    return msg;
+  }
+
+ public:
+  /// Constructor
+
+  /// \param world The world of the broadcast
+  /// \param key The broadcast key
+  /// \param value The future that will be set to the broadcast object
+  /// \param parent The parent process
+  /// \param child0 The first child process
+  /// \param child1 The second child process
+  /// \param chunk_size The number of bytes per chunk
+  ChunkedBcastRecv(World& world, const madness::DistributedID& key,
+                   const Future<T>& value, const ProcessID parent,
+                   const ProcessID child0, const ProcessID child1,
+                   const std::size_t chunk_size)
+      : madness::TaskInterface(madness::TaskAttributes::hipri()),
+        world_(world),
+        key_(key),
+        value_(value),
+        parent_(parent),
+        child0_(child0),
+        child1_(child1),
+        chunk_size_(chunk_size),
+        nbytes_(recv<std::size_t>(0ul)) {
+    if (!nbytes_.probe()) {
+      madness::DependencyInterface::inc();
+      nbytes_.register_callback(this);
+    }
+  }
+
+  virtual ~ChunkedBcastRecv() {}
+
+  /// Task run function
+  virtual void run(const madness::TaskThreadEnv&) {
+    const std::size_t nbytes = nbytes_.get();
+    const std::size_t nchunks = (nbytes + chunk_size_ - 1ul) / chunk_size_;
+
+    std::vector<Future<chunked_bcast_chunk>> chunks;
+    chunks.reserve(nchunks);
+    for (std::size_t index = 1ul; index <= nchunks; ++index)
+      chunks.push_back(recv<chunked_bcast_chunk>(index));
+
+    world_.taskq.add(
+        new ChunkedBcastAssemble<T>(value_, std::move(chunks), nbytes));
+  }
+
+};  // class ChunkedBcastRecv
+
+/// Pipelined (chunked) broadcast
+
+/// This function has the same semantics as
+/// \c madness::WorldGopInterface::bcast() , but the object is serialized and
+/// streamed through the binary broadcast tree in chunks of \c chunk_size
+/// bytes. Each process forwards a chunk to its children as soon as it has
+/// been received, so the hops of the tree overlap and the broadcast time of
+/// large objects approaches the bandwidth bound rather than
+/// <tt>(tree depth) * (object size) / bandwidth</tt> .
+/// \tparam T The type of the object to be broadcast; it must be serializable
+/// with MADNESS archives
+/// \param world The world of the broadcast
+/// \param key The broadcast key; it must be unique among all chunked
+/// broadcasts in \c world that are in flight
+/// \param[in,out] value On the root process the object to be broadcast,
+/// otherwise an unset future that will be set to the broadcast object
+/// \param group_root The group rank of the broadcast root process
+/// \param group The broadcast group
+/// \param chunk_size The number of bytes per chunk
+template <typename T>
+void chunked_bcast(World& world, const madness::DistributedID& key,
+                   Future<T>& value, const ProcessID group_root,
+                   const madness::Group& group, const std::size_t chunk_size) {
+  TA_ASSERT(chunk_size > 0ul);
+  TA_ASSERT(group.size() > 0);
+  TA_ASSERT(group_root < group.size());
+
+  ProcessID parent = -1, child0 = -1, child1 = -1;
+  group.make_tree(group_root, parent, child0, child1);
+
+  if (group.rank() == group_root) {
+    if ((child0 != -1) || (child1 != -1))
+      world.taskq.add(new ChunkedBcastSend<T>(world, key, value, child0,
+                                              child1, chunk_size));
+  } else {
+    TA_ASSERT(!value.probe());
+    world.taskq.add(new ChunkedBcastRecv<T>(world, key, value, parent, child0,
+                                            child1, chunk_size));
+  }
+}
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_CHUNKED_BCAST_H__INCLUDED
@@ -0,0 +1,1094 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  compressed_sparse_shape.h
+ *
+ */
+
+#ifndef TILEDARRAY_COMPRESSED_SPARSE_SHAPE_H__INCLUDED
+#define TILEDARRAY_COMPRESSED_SPARSE_SHAPE_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <TiledArray/sparse_shape.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace TiledArray {
+
+/// Compressed sparse shape
+
+/// This shape holds the same (scaled, i.e. per-element) tile norms as
+/// \c SparseShape<T> , but only the nonzero norms are stored, as a list of
+/// tile ordinals sorted in ascending order and the corresponding norms.
+/// Thus its memory footprint is proportional to the number of nonzero tiles
+/// rather than to the volume of the tile range, which makes it suitable for
+/// the metadata of very sparse high-rank arrays. Queries cost
+/// \f$ O(\log n_{\rm nz}) \f$ operations. The zero threshold is
+/// \c SparseShape<T>::threshold() .
+///
+/// It implements the shape interface used by \c DistArray and the expression
+/// engines, so it can be used as the shape of an array via
+/// \c CompressedSparsePolicy . Unlike \c SparseShape it does not implement
+/// the addition of a constant, which would make every tile nonzero.
+///
+/// A shape may further be partitioned with \c local() ; a partitioned shape
+/// holds only the nonzero norms of the tiles that are owned by this process,
+/// and can only be queried for those tiles. Partitioned shapes only support
+/// queries; they cannot be used as the shape of an array.
+/// \tparam T The sparse element value type
+template <typename T>
+class CompressedSparseShape {
+ public:
+  typedef CompressedSparseShape<T> CompressedSparseShape_;  ///< This type
+  typedef SparseShape<T> sparse_shape_type;  ///< Uncompressed shape type
+  typedef T value_type;                      ///< The norm value type
+  typedef typename sparse_shape_type::size_type size_type;  ///< Size type
+  typedef Range::ordinal_type ordinal_type;  ///< Tile ordinal type
+
+ private:
+  typedef detail::ValArray<value_type> vector_type;
+
+  Range range_;  ///< The tiles range
+  std::shared_ptr<vector_type>
+      size_vectors_;  ///< Tile size information; size_vectors_.get()[d][i]
+                      ///< reports the size of i-th tile in dimension d
+  std::vector<ordinal_type> ordinals_;  ///< Sorted ordinals of nonzero tiles
+  std::vector<value_type> norms_;       ///< Scaled norms of nonzero tiles
+  size_type nnz_ = 0ul;  ///< Number of nonzero tiles in the entire shape
+  std::shared_ptr<const Pmap>
+      pmap_;  ///< The process map of a partitioned shape (null if the shape
+              ///< is not partitioned)
+
+  CompressedSparseShape(const Range& range,
+                        const std::shared_ptr<vector_type>& size_vectors,
+                        std::vector<ordinal_type>&& ordinals,
+                        std::vector<value_type>&& norms)
+      : range_(range),
+        size_vectors_(size_vectors),
+        ordinals_(std::move(ordinals)),
+        norms_(std::move(norms)),
+        nnz_(ordinals_.size()) {}
+
+  /// Sort the nonzero tiles by ordinal
+
+  /// \param ordinals The ordinals of the nonzero tiles
+  /// \param norms The norms of the nonzero tiles
+  static void sort(std::vector<ordinal_type>& ordinals,
+                   std::vector<value_type>& norms) {
+    if (std::is_sorted(ordinals.begin(), ordinals.end())) return;
+    std::vector<size_type> order(ordinals.size());
+    std::iota(order.begin(), order.end(), size_type(0));
+    std::sort(order.begin(), order.end(), [&ordinals](auto i, auto j) {
+      return ordinals[i] < ordinals[j];
+    });
+    std::vector<ordinal_type> sorted_ordinals(ordinals.size());
+    std::vector<value_type> sorted_norms(norms.size());
+    for (size_type i = 0ul; i < order.size(); ++i) {
+      sorted_ordinals[i] = ordinals[order[i]];
+      sorted_norms[i] = norms[order[i]];
+    }
+    ordinals = std::move(sorted_ordinals);
+    norms = std::move(sorted_norms);
+  }
+
+  /// Find the position of a tile in the list of nonzero tiles
+
+  /// \param ord The ordinal of the tile
+  /// \return The position of \c ord in \c ordinals_ , or
+  /// <tt>ordinals_.size()</tt> if the tile is zero
+  size_type find(const ordinal_type ord) const {
+    TA_ASSERT(!pmap_ || pmap_->is_local(ord));
+    const auto it = std::lower_bound(ordinals_.begin(), ordinals_.end(), ord);
+    if (it != ordinals_.end() && *it == ord) return it - ordinals_.begin();
+    return ordinals_.size();
+  }
+
+  /// Volume of a tile
+
+  /// \param ord The ordinal of the tile
+  /// \return The number of elements in tile \c ord
+  value_type tile_volume(const ordinal_type ord) const {
+    const auto index = range_.idx(ord);
+    const unsigned int rank = range_.rank();
+    value_type volume = 1;
+    for (unsigned int d = 0u; d < rank; ++d)
+      volume *= size_vectors_.get()[d][index[d] - range_.lobound(d)];
+    return volume;
+  }
+
+  /// Combine the nonzero norms of two shapes
+
+  /// \tparam Union If \c true the result holds the tiles that are nonzero in
+  /// either shape, otherwise the tiles that are nonzero in both
+  /// \tparam Op The norm operation type
+  /// \param other The right-hand argument
+  /// \param op The operation that computes the norm of a result tile from its
+  /// ordinal and the norms of the argument tiles (zero for a zero tile)
+  /// \return The combined shape, screened with the zero threshold
+  template <bool Union, typename Op>
+  CompressedSparseShape_ combine(const CompressedSparseShape_& other,
+                                 const Op& op) const {
+    TA_ASSERT(!empty());
+    TA_ASSERT(!other.empty());
+    TA_ASSERT(range_ == other.range_);
+    TA_ASSERT(!pmap_ && !other.pmap_);
+
+    const value_type threshold = sparse_shape_type::threshold();
+    std::vector<ordinal_type> ordinals;
+    std::vector<value_type> norms;
+    auto push = [&](const ordinal_type ord, const value_type left,
+                    const value_type right) {
+      const value_type norm = op(ord, left, right);
+      if (norm >= threshold) {
+        ordinals.push_back(ord);
+        norms.push_back(norm);
+      }
+    };
+
+    const size_type n_left = ordinals_.size();
+    const size_type n_right = other.ordinals_.size();
+    size_type i = 0ul, j = 0ul;
+    while (i < n_left && j < n_right) {
+      if (ordinals_[i] < other.ordinals_[j]) {
+        if constexpr (Union) push(ordinals_[i], norms_[i], value_type(0));
+        ++i;
+      } else if (other.ordinals_[j] < ordinals_[i]) {
+        if constexpr (Union)
+          push(other.ordinals_[j], value_type(0), other.norms_[j]);
+        ++j;
+      } else {
+        push(ordinals_[i], norms_[i], other.norms_[j]);
+        ++i;
+        ++j;
+      }
+    }
+    if constexpr (Union) {
+      for (; i < n_left; ++i) push(ordinals_[i], norms_[i], value_type(0));
+      for (; j < n_right; ++j)
+        push(other.ordinals_[j], value_type(0), other.norms_[j]);
+    }
+
+    return CompressedSparseShape_(range_, size_vectors_, std::move(ordinals),
+                                  std::move(norms));
+  }
+
+ public:
+  /// Default constructor
+
+  /// Construct a shape with no data.
+  CompressedSparseShape() = default;
+
+  /// "Dense" constructor
+
+  /// This constructor sets the tile norms to the same value.
+  /// \param tile_norm The value of the (per-element) norm for every tile
+  /// \param trange The tiled range of the tensor
+  /// \note this ctor *does not* scale tile norms
+  /// \note if \c tile_norm is less than the threshold then all tiles are zero
+  CompressedSparseShape(const value_type& tile_norm, const TiledRange& trange)
+      : range_(trange.tiles_range()),
+        size_vectors_(sparse_shape_type::initialize_size_vectors(trange)) {
+    if (tile_norm >= sparse_shape_type::threshold()) {
+      ordinals_.resize(range_.volume());
+      std::iota(ordinals_.begin(), ordinals_.end(), ordinal_type(0));
+      norms_.assign(range_.volume(), tile_norm);
+    }
+    nnz_ = ordinals_.size();
+  }
+
+  /// "Dense" constructor
+
+  /// This constructor scales the tile norms, i.e. multiplies each tile norm
+  /// by the inverse of its volume, and compresses them.
+  /// \param tile_norms The Frobenius norm of tiles by default
+  /// \param trange The tiled range of the tensor
+  /// \param do_not_scale if true, assume that the tile norms in \c tile_norms
+  /// are already scaled
+  CompressedSparseShape(const Tensor<value_type>& tile_norms,
+                        const TiledRange& trange, bool do_not_scale = false)
+      : CompressedSparseShape(
+            sparse_shape_type(tile_norms, trange, do_not_scale)) {}
+
+  /// Collective "dense" constructor
+
+  /// The tile norms are max-reduced across all processes, scaled, and
+  /// compressed.
+  /// \param world The world where the shape will live
+  /// \param tile_norms The Frobenius norm of tiles by default; expected to
+  /// contain nonzeros for this rank's subset of tiles, or be replicated.
+  /// \param trange The tiled range of the tensor
+  /// \param do_not_scale if true, assume that the tile norms in \c tile_norms
+  /// are already scaled
+  CompressedSparseShape(World& world, const Tensor<value_type>& tile_norms,
+                        const TiledRange& trange, bool do_not_scale = false)
+      : CompressedSparseShape(
+            sparse_shape_type(world, tile_norms, trange, do_not_scale)) {}
+
+  /// Compressing constructor
+
+  /// \param shape The shape to be compressed
+  explicit CompressedSparseShape(const sparse_shape_type& shape)
+      : range_(shape.data().range()), size_vectors_(shape.size_vectors_) {
+    TA_ASSERT(!shape.empty());
+    const value_type* const data = shape.data().data();
+    const ordinal_type volume = range_.volume();
+    for (ordinal_type ord = 0ul; ord < volume; ++ord) {
+      if (data[ord] != value_type(0)) {
+        ordinals_.push_back(ord);
+        norms_.push_back(data[ord]);
+      }
+    }
+    nnz_ = ordinals_.size();
+  }
+
+  /// "Sparse" constructor
+
+  /// This constructor never constructs the dense norm tensor, hence it
+  /// should be used for the shapes of very sparse arrays.
+  /// \tparam SparseNormSequence the sequence of \c
+  /// std::pair<index,value_type> objects, where \c index is a
+  /// directly-addressable sequence of indices; every index must appear at
+  /// most once.
+  /// \param tile_norms The Frobenius norm of tiles
+  /// \param trange The tiled range of the tensor
+  /// \param do_not_scale if true, assume that the tile norms in \c tile_norms
+  /// are already scaled
+  template <typename SparseNormSequence,
+            typename = std::enable_if_t<
+                TiledArray::detail::has_member_function_begin_anyreturn<
+                    std::decay_t<SparseNormSequence>>::value &&
+                TiledArray::detail::has_member_function_end_anyreturn<
+                    std::decay_t<SparseNormSequence>>::value>>
+  CompressedSparseShape(const SparseNormSequence& tile_norms,
+                        const TiledRange& trange, bool do_not_scale = false)
+      : range_(trange.tiles_range()),
+        size_vectors_(sparse_shape_type::initialize_size_vectors(trange)) {
+    const auto dim = range_.rank();
+    const value_type threshold = sparse_shape_type::threshold();
+    for (const auto& pair_idx_norm : tile_norms) {
+      value_type norm_per_element = pair_idx_norm.second;
+      if (!do_not_scale) {
+        uint64_t tile_volume = 1;
+        for (size_t d = 0; d != dim; ++d)
+          tile_volume *= size_vectors_.get()[d].at(pair_idx_norm.first[d]);
+        norm_per_element /= tile_volume;
+      }
+      if (norm_per_element >= threshold) {
+        ordinals_.push_back(range_.ordinal(pair_idx_norm.first));
+        norms_.push_back(norm_per_element);
+      }
+    }
+    sort(ordinals_, norms_);
+    TA_ASSERT(std::adjacent_find(ordinals_.begin(), ordinals_.end()) ==
+              ordinals_.end());
+    nnz_ = ordinals_.size();
+  }
+
+  /// Collective "sparse" constructor
+
+  /// The nonzero norms of every process are gathered, and the largest norm
+  /// of each tile is kept; the dense norm tensor is never constructed.
+  /// \tparam SparseNormSequence the sequence of \c
+  /// std::pair<index,value_type> objects, where \c index is a
+  /// directly-addressable sequence of indices; every index must appear at
+  /// most once on each process.
+  /// \param world The world where the shape will live
+  /// \param tile_norms The Frobenius norm of tiles; expected to contain
+  /// nonzeros for this rank's subset of tiles, or be replicated.
+  /// \param trange The tiled range of the tensor
+  /// \param do_not_scale if true, assume that the tile norms in \c tile_norms
+  /// are already scaled
+  template <typename SparseNormSequence,
+            typename = std::enable_if_t<
+                TiledArray::detail::has_member_function_begin_anyreturn<
+                    std::decay_t<SparseNormSequence>>::value &&
+                TiledArray::detail::has_member_function_end_anyreturn<
+                    std::decay_t<SparseNormSequence>>::value>>
+  CompressedSparseShape(World& world, const SparseNormSequence& tile_norms,
+                        const TiledRange& trange, bool do_not_scale = false)
+      : CompressedSparseShape(tile_norms, trange, do_not_scale) {
+    // Gather the nonzero tiles of all processes
+    std::vector<size_type> counts(world.size(), 0ul);
+    counts[world.rank()] = ordinals_.size();
+    world.gop.sum(counts.data(), counts.size());
+    const size_type offset = std::accumulate(
+        counts.begin(), counts.begin() + world.rank(), size_type(0));
+    const size_type total =
+        std::accumulate(counts.begin(), counts.end(), size_type(0));
+    std::vector<ordinal_type> ordinals(total, ordinal_type(0));
+    std::vector<value_type> norms(total, value_type(0));
+    std::copy(ordinals_.begin(), ordinals_.end(), ordinals.begin() + offset);
+    std::copy(norms_.begin(), norms_.end(), norms.begin() + offset);
+    if (total > 0ul) {
+      world.gop.sum(ordinals.data(), total);
+      world.gop.sum(norms.data(), total);
+    }
+    sort(ordinals, norms);
+
+    // Keep the largest norm of each tile
+    ordinals_.clear();
+    norms_.clear();
+    for (size_type i = 0ul; i < total; ++i) {
+      if (!ordinals_.empty() && ordinals_.back() == ordinals[i]) {
+        norms_.back() = std::max(norms_.back(), norms[i]);
+      } else {
+        ordinals_.push_back(ordinals[i]);
+        norms_.push_back(norms[i]);
+      }
+    }
+    nnz_ = ordinals_.size();
+  }
+
+  /// Decompress this shape
+
+  /// \return A \c SparseShape<T> that holds the norms of this shape
+  /// \throw TiledArray::Exception When this shape is partitioned
+  sparse_shape_type to_sparse_shape() const {
+    TA_ASSERT(!empty());
+    TA_ASSERT(!pmap_);
+    Tensor<value_type> tile_norms(range_, value_type(0));
+    for (size_type i = 0ul; i < ordinals_.size(); ++i)
+      tile_norms.data()[ordinals_[i]] = norms_[i];
+    return sparse_shape_type(tile_norms, size_vectors_,
+                             range_.volume() - ordinals_.size());
+  }
+
+  /// Partition this shape
+
+  /// \param pmap The process map of the tiles
+  /// \return A shape that holds only the nonzero tiles of this shape that
+  /// are owned by this process
+  /// \throw TiledArray::Exception When \c pmap does not map the tiles of this
+  /// shape
+  CompressedSparseShape_ local(const std::shared_ptr<const Pmap>& pmap) const {
+    TA_ASSERT(!empty());
+    TA_ASSERT(pmap);
+    TA_ASSERT(pmap->size() == range_.volume());
+    CompressedSparseShape_ result;
+    result.range_ = range_;
+    result.size_vectors_ = size_vectors_;
+    for (size_type i = 0ul; i < ordinals_.size(); ++i) {
+      if (pmap->is_local(ordinals_[i])) {
+        result.ordinals_.push_back(ordinals_[i]);
+        result.norms_.push_back(norms_[i]);
+      }
+    }
+    result.nnz_ = nnz_;
+    result.pmap_ = pmap;
+    return result;
+  }
+
+  /// Partitioning check
+
+  /// \return \c true when this shape holds only the tiles owned by this
+  /// process
+  bool is_partitioned() const { return bool(pmap_); }
+
+  /// Validate shape range
+
+  /// \return \c true when range matches the range of this shape
+  bool validate(const Range& range) const {
+    if (empty()) return false;
+    return (range == range_);
+  }
+
+  /// Check that a tile is zero
+
+  /// \tparam Index The type of the index
+  /// \param index The index or ordinal of the tile
+  /// \return \c true if the tile is zero
+  /// \throw TiledArray::Exception When this shape is partitioned and the
+  /// tile is not owned by this process
+  template <typename Index>
+  bool is_zero(const Index& index) const {
+    TA_ASSERT(!empty());
+    return find(range_.ordinal(index)) == ordinals_.size();
+  }
+
+  /// Check density
+
+  /// \return false
+  static constexpr bool is_dense() { return false; }
+
+  /// Threshold accessor
+
+  /// The threshold is shared with \c SparseShape<T> .
+  /// \return The current threshold
+  static value_type threshold() { return sparse_shape_type::threshold(); }
+
+  /// Set threshold to \c thresh
+
+  /// \param thresh The new threshold
+  static void threshold(const value_type thresh) {
+    sparse_shape_type::threshold(thresh);
+  }
+
+  /// Sparsity of the shape
+
+  /// \return The fraction of tiles that are zero.
+  float sparsity() const {
+    TA_ASSERT(!empty());
+    return float(range_.volume() - nnz_) / float(range_.volume());
+  }
+
+  /// Number of nonzero tiles
+
+  /// \return The number of nonzero tiles held by this object
+  size_type nnz() const { return ordinals_.size(); }
+
+  /// Nonzero tile ordinals accessor
+
+  /// \return The ordinals of the nonzero tiles held by this object, in
+  /// ascending order
+  const std::vector<ordinal_type>& ordinals() const { return ordinals_; }
+
+  /// Nonzero tile norms accessor
+
+  /// \return The (scaled) norms of the tiles in \c ordinals()
+  const std::vector<value_type>& norms() const { return norms_; }
+
+  /// Tile norm accessor
+
+  /// \tparam Index The index type
+  /// \param index The index or ordinal of the tile norm to retrieve
+  /// \return The (scaled) norm of the tile at \c index
+  /// \throw TiledArray::Exception When this shape is partitioned and the
+  /// tile is not owned by this process
+  template <typename Index>
+  value_type operator[](const Index& index) const {
+    TA_ASSERT(!empty());
+    const size_type i = find(range_.ordinal(index));
+    return (i == ordinals_.size() ? value_type(0) : norms_[i]);
+  }
+
+  /// Tiles range accessor
+
+  /// \return A const reference to the range of tile indices of this shape
+  const Range& range() const { return range_; }
+
+  /// Initialization check
+
+  /// \return \c true when this shape has been initialized.
+  bool empty() const { return range_.volume() == 0ul; }
+
+  /// Compute union of two shapes
+
+  /// \param mask_shape The input shape, hard zeros are used to mask the
+  /// output.
+  /// \return A shape that is masked by the mask.
+  CompressedSparseShape_ mask(const CompressedSparseShape_& mask_shape) const {
+    TA_ASSERT(!empty());
+    TA_ASSERT(!mask_shape.empty());
+    TA_ASSERT(range_ == mask_shape.range_);
+    TA_ASSERT(!pmap_ && !mask_shape.pmap_);
+
+    std::vector<ordinal_type> ordinals;
+    std::vector<value_type> norms;
+    auto mask_it = mask_shape.ordinals_.begin();
+    const auto mask_end = mask_shape.ordinals_.end();
+    for (size_type i = 0ul; i < ordinals_.size(); ++i) {
+      mask_it = std::lower_bound(mask_it, mask_end, ordinals_[i]);
+      if (mask_it == mask_end) break;
+      if (*mask_it == ordinals_[i]) {
+        ordinals.push_back(ordinals_[i]);
+        norms.push_back(norms_[i]);
+      }
+    }
+
+    return CompressedSparseShape_(range_, size_vectors_, std::move(ordinals),
+                                  std::move(norms));
+  }
+
+  /// Creates a copy of this with a sub-block updated with another shape
+
+  /// \tparam Index1 An integral range type
+  /// \tparam Index2 An integral range type
+  /// \param lower_bound The lower bound of the sub-block to be updated
+  /// \param upper_bound The upper bound of the sub-block to be updated
+  /// \param other The shape that will be used to update the sub-block
+  /// \return A new shape where the sub-block defined by \p lower_bound and
+  /// \p upper_bound holds the norms of \c other
+  template <typename Index1, typename Index2,
+            typename = std::enable_if_t<detail::is_integral_range_v<Index1> &&
+                                        detail::is_integral_range_v<Index2>>>
+  CompressedSparseShape_ update_block(
+      const Index1& lower_bound, const Index2& upper_bound,
+      const CompressedSparseShape_& other) const {
+    TA_ASSERT(!empty());
+    TA_ASSERT(!other.empty());
+    TA_ASSERT(!pmap_ && !other.pmap_);
+    const unsigned int rank = range_.rank();
+    const std::vector<ordinal_type> lower(std::begin(lower_bound),
+                                          std::end(lower_bound));
+    const std::vector<ordinal_type> upper(std::begin(upper_bound),
+                                          std::end(upper_bound));
+    TA_ASSERT(lower.size() == rank && upper.size() == rank);
+    TA_ASSERT(other.range_.rank() == rank);
+
+    // Keep the nonzero tiles outside of the block
+    std::vector<ordinal_type> ordinals;
+    std::vector<value_type> norms;
+    for (size_type i = 0ul; i < ordinals_.size(); ++i) {
+      const auto index = range_.idx(ordinals_[i]);
+      bool in_block = true;
+      for (unsigned int d = 0u; d < rank && in_block; ++d) {
+        const ordinal_type index_d = index[d];
+        in_block = (index_d >= lower[d]) && (index_d < upper[d]);
+      }
+      if (!in_block) {
+        ordinals.push_back(ordinals_[i]);
+        norms.push_back(norms_[i]);
+      }
+    }
+
+    // Insert the nonzero tiles of the block
+    std::vector<ordinal_type> index(rank);
+    for (size_type j = 0ul; j < other.ordinals_.size(); ++j) {
+      const auto block_index = other.range_.idx(other.ordinals_[j]);
+      for (unsigned int d = 0u; d < rank; ++d)
+        index[d] = lower[d] + (block_index[d] - other.range_.lobound(d));
+      ordinals.push_back(range_.ordinal(index));
+      norms.push_back(other.norms_[j]);
+    }
+    sort(ordinals, norms);
+
+    return CompressedSparseShape_(range_, size_vectors_, std::move(ordinals),
+                                  std::move(norms));
+  }
+
+  /// Bitwise comparison
+
+  /// \param other A shape
+  /// \return \c true if this shape and \c other hold identical norms
+  bool operator==(const CompressedSparseShape_& other) const {
+    if (!(range_ == other.range_) || nnz_ != other.nnz_ ||
+        ordinals_ != other.ordinals_ || norms_ != other.norms_)
+      return false;
+    const unsigned int rank = range_.rank();
+    for (unsigned int d = 0u; d < rank; ++d)
+      if (!(size_vectors_.get()[d] == other.size_vectors_.get()[d]))
+        return false;
+    return true;
+  }
+
+  /// Create a copy of a sub-block of the shape
+
+  /// \tparam Index1 An integral range type
+  /// \tparam Index2 An integral range type
+  /// \param lower_bound The lower bound of the sub-block
+  /// \param upper_bound The upper bound of the sub-block
+  template <typename Index1, typename Index2,
+            typename = std::enable_if_t<detail::is_integral_range_v<Index1> &&
+                                        detail::is_integral_range_v<Index2>>>
+  CompressedSparseShape_ block(const Index1& lower_bound,
+                               const Index2& upper_bound) const {
+    TA_ASSERT(!empty());
+    TA_ASSERT(!pmap_);
+    const unsigned int rank = range_.rank();
+
+    // Construct the block range and size vectors
+    std::vector<ordinal_type> lower(rank), extent(rank);
+    std::shared_ptr<vector_type> size_vectors(
+        new vector_type[rank], std::default_delete<vector_type[]>());
+    {
+      unsigned int d = 0u;
+      auto lower_it = std::begin(lower_bound);
+      auto upper_it = std::begin(upper_bound);
+      for (; d < rank; ++d, ++lower_it, ++upper_it) {
+        const ordinal_type lower_d = *lower_it, upper_d = *upper_it;
+        TA_ASSERT(lower_d >= ordinal_type(range_.lobound(d)));
+        TA_ASSERT(lower_d < upper_d);
+        TA_ASSERT(upper_d <= ordinal_type(range_.upbound(d)));
+        lower[d] = lower_d;
+        extent[d] = upper_d - lower_d;
+        size_vectors.get()[d] = vector_type(
+            extent[d],
+            size_vectors_.get()[d].data() + (lower_d - range_.lobound(d)));
+      }
+    }
+    const Range block_range(extent);
+
+    // Copy the nonzero tiles of the block
+    std::vector<ordinal_type> ordinals;
+    std::vector<value_type> norms;
+    std::vector<ordinal_type> block_index(rank);
+    for (size_type i = 0ul; i < ordinals_.size(); ++i) {
+      const auto index = range_.idx(ordinals_[i]);
+      bool in_block = true;
+      for (unsigned int d = 0u; d < rank && in_block; ++d) {
+        const ordinal_type index_d = index[d];
+        in_block = (index_d >= lower[d]) && (index_d - lower[d] < extent[d]);
+        block_index[d] = index_d - lower[d];
+      }
+      if (in_block) {
+        ordinals.push_back(block_range.ordinal(block_index));
+        norms.push_back(norms_[i]);
+      }
+    }
+
+    return CompressedSparseShape_(block_range, size_vectors,
+                                  std::move(ordinals), std::move(norms));
+  }
+
+  /// Create a copy of a sub-block of the shape
+
+  /// \tparam Index1 An integral type
+  /// \tparam Index2 An integral type
+  /// \param lower_bound The lower bound of the sub-block
+  /// \param upper_bound The upper bound of the sub-block
+  template <typename Index1, typename Index2,
+            typename = std::enable_if_t<std::is_integral_v<Index1> &&
+                                        std::is_integral_v<Index2>>>
+  CompressedSparseShape_ block(
+      const std::initializer_list<Index1>& lower_bound,
+      const std::initializer_list<Index2>& upper_bound) const {
+    return this
+        ->block<std::initializer_list<Index1>, std::initializer_list<Index2>>(
+            lower_bound, upper_bound);
+  }
+
+  /// Create a permuted shape of this shape
+
+  /// \param perm The permutation to be applied
+  /// \return A new, permuted shape
+  CompressedSparseShape_ perm(const Permutation& perm) const {
+    TA_ASSERT(!empty());
+    TA_ASSERT(!pmap_);
+    const unsigned int rank = range_.rank();
+    TA_ASSERT(perm.size() == rank);
+
+    std::shared_ptr<vector_type> size_vectors(
+        new vector_type[rank], std::default_delete<vector_type[]>());
+    for (unsigned int d = 0u; d < rank; ++d)
+      size_vectors.get()[perm[d]] = size_vectors_.get()[d];
+    const Range result_range = perm * range_;
+
+    std::vector<ordinal_type> ordinals(ordinals_.size());
+    std::vector<value_type> norms(norms_);
+    std::vector<Range::index1_type> result_index(rank);
+    for (size_type i = 0ul; i < ordinals_.size(); ++i) {
+      const auto index = range_.idx(ordinals_[i]);
+      for (unsigned int d = 0u; d < rank; ++d) result_index[perm[d]] = index[d];
+      ordinals[i] = result_range.ordinal(result_index);
+    }
+    sort(ordinals, norms);
+
+    return CompressedSparseShape_(result_range, size_vectors,
+                                  std::move(ordinals), std::move(norms));
+  }
+
+  /// Create a scaled sub-block of the shape
+
+  /// \tparam Index1 An integral range type
+  /// \tparam Index2 An integral range type
+  /// \tparam Scalar A numeric type
+  /// \param lower_bound The lower bound of the sub-block
+  /// \param upper_bound The upper bound of the sub-block
+  /// \param factor The scaling factor
+  template <typename Index1, typename Index2, typename Scalar,
+            typename = std::enable_if_t<detail::is_integral_range_v<Index1> &&
+                                        detail::is_integral_range_v<Index2> &&
+                                        detail::is_numeric_v<Scalar>>>
+  CompressedSparseShape_ block(const Index1& lower_bound,
+                               const Index2& upper_bound,
+                               const Scalar factor) const {
+    return block(lower_bound, upper_bound).scale(factor);
+  }
+
+  /// Create a permuted sub-block of the shape
+
+  /// \tparam Index1 An integral range type
+  /// \tparam Index2 An integral range type
+  /// \param lower_bound The lower bound of the sub-block
+  /// \param upper_bound The upper bound of the sub-block
+  /// \param perm The permutation to be applied to the sub-block
+  template <typename Index1, typename Index2,
+            typename = std::enable_if_t<detail::is_integral_range_v<Index1> &&
+                                        detail::is_integral_range_v<Index2>>>
+  CompressedSparseShape_ block(const Index1& lower_bound,
+                               const Index2& upper_bound,
+                               const Permutation& perm) const {
+    return block(lower_bound, upper_bound).perm(perm);
+  }
+
+  /// Create a scaled and permuted sub-block of the shape
+
+  /// \tparam Index1 An integral range type
+  /// \tparam Index2 An integral range type
+  /// \tparam Scalar A numeric type
+  /// \param lower_bound The lower bound of the sub-block
+  /// \param upper_bound The upper bound of the sub-block
+  /// \param factor The scaling factor
+  /// \param perm The permutation to be applied to the sub-block
+  template <typename Index1, typename Index2, typename Scalar,
+            typename = std::enable_if_t<detail::is_integral_range_v<Index1> &&
+                                        detail::is_integral_range_v<Index2> &&
+                                        detail::is_numeric_v<Scalar>>>
+  CompressedSparseShape_ block(const Index1& lower_bound,
+                               const Index2& upper_bound, const Scalar factor,
+                               const Permutation& perm) const {
+    return block(lower_bound, upper_bound).scale(factor, perm);
+  }
+
+  /// Scale shape
+
+  /// \tparam Scalar A numeric type
+  /// \param factor The scaling factor
+  /// \return A new shape with the norms of this shape scaled by
+  /// <tt>abs(factor)</tt>
+  template <typename Scalar,
+            typename = std::enable_if_t<detail::is_numeric_v<Scalar>>>
+  CompressedSparseShape_ scale(const Scalar factor) const {
+    TA_ASSERT(!empty());
+    TA_ASSERT(!pmap_);
+    const value_type threshold = sparse_shape_type::threshold();
+    const value_type abs_factor = sparse_shape_type::to_abs_factor(factor);
+    std::vector<ordinal_type> ordinals;
+    std::vector<value_type> norms;
+    ordinals.reserve(ordinals_.size());
+    norms.reserve(norms_.size());
+    for (size_type i = 0ul; i < ordinals_.size(); ++i) {
+      const value_type norm = norms_[i] * abs_factor;
+      if (norm >= threshold) {
+        ordinals.push_back(ordinals_[i]);
+        norms.push_back(norm);
+      }
+    }
+
+    return CompressedSparseShape_(range_, size_vectors_, std::move(ordinals),
+                                  std::move(norms));
+  }
+
+  /// Scale and permute shape
+
+  /// \tparam Factor The scaling factor type
+  /// \param factor The scaling factor
+  /// \param perm The permutation to be applied to the result
+  /// \return A new, scaled and permuted shape
+  template <typename Factor>
+  CompressedSparseShape_ scale(const Factor factor,
+                               const Permutation& perm) const {
+    return scale(factor).perm(perm);
+  }
+
+  /// Add shapes
+
+  /// \param other The shape to be added to this shape
+  /// \return A shape whose norms are the sums of the norms of the arguments
+  CompressedSparseShape_ add(const CompressedSparseShape_& other) const {
+    return combine<true>(other,
+                         [](const ordinal_type, const value_type left,
+                            const value_type right) { return left + right; });
+  }
+
+  /// Add and permute shapes
+
+  /// \param other The shape to be added to this shape
+  /// \param perm The permutation to be applied to the result
+  /// \return A permuted sum of shapes
+  CompressedSparseShape_ add(const CompressedSparseShape_& other,
+                             const Permutation& perm) const {
+    return add(other).perm(perm);
+  }
+
+  /// Add and scale shapes
+
+  /// \tparam Factor The scaling factor type
+  /// \param other The shape to be added to this shape
+  /// \param factor The scaling factor
+  /// \return A scaled sum of shapes
+  template <typename Factor>
+  CompressedSparseShape_ add(const CompressedSparseShape_& other,
+                             const Factor factor) const {
+    const value_type abs_factor = sparse_shape_type::to_abs_factor(factor);
+    return combine<true>(other, [abs_factor](const ordinal_type,
+                                             const value_type left,
+                                             const value_type right) {
+      return (left + right) * abs_factor;
+    });
+  }
+
+  /// Add, scale, and permute shapes
+
+  /// \tparam Factor The scaling factor type
+  /// \param other The shape to be added to this shape
+  /// \param factor The scaling factor
+  /// \param perm The permutation to be applied to the result
+  /// \return A scaled and permuted sum of shapes
+  template <typename Factor>
+  CompressedSparseShape_ add(const CompressedSparseShape_& other,
+                             const Factor factor,
+                             const Permutation& perm) const {
+    return add(other, factor).perm(perm);
+  }
+
+  CompressedSparseShape_ subt(const CompressedSparseShape_& other) const {
+    return add(other);
+  }
+
+  CompressedSparseShape_ subt(const CompressedSparseShape_& other,
+                              const Permutation& perm) const {
+    return add(other, perm);
+  }
+
+  template <typename Factor>
+  CompressedSparseShape_ subt(const CompressedSparseShape_& other,
+                              const Factor factor) const {
+    return add(other, factor);
+  }
+
+  template <typename Factor>
+  CompressedSparseShape_ subt(const CompressedSparseShape_& other,
+                              const Factor factor,
+                              const Permutation& perm) const {
+    return add(other, factor, perm);
+  }
+
+  /// Multiply shapes
+
+  /// The (scaled) norm of a product tile is bounded by the product of the
+  /// argument norms times the tile volume; only the tiles that are nonzero
+  /// in both arguments are visited.
+  /// \tparam Factor The scaling factor type
+  /// \param other The right-hand argument
+  /// \param factor The scaling factor
+  /// \return The shape of the scaled (Hadamard) product
+  template <typename Factor>
+  CompressedSparseShape_ mult(const CompressedSparseShape_& other,
+                              const Factor factor) const {
+    const value_type abs_factor = sparse_shape_type::to_abs_factor(factor);
+    return combine<false>(other, [this, abs_factor](const ordinal_type ord,
+                                                    const value_type left,
+                                                    const value_type right) {
+      return left * right * abs_factor * tile_volume(ord);
+    });
+  }
+
+  CompressedSparseShape_ mult(const CompressedSparseShape_& other) const {
+    return mult(other, value_type(1));
+  }
+
+  CompressedSparseShape_ mult(const CompressedSparseShape_& other,
+                              const Permutation& perm) const {
+    return mult(other).perm(perm);
+  }
+
+  template <typename Factor>
+  CompressedSparseShape_ mult(const CompressedSparseShape_& other,
+                              const Factor factor,
+                              const Permutation& perm) const {
+    return mult(other, factor).perm(perm);
+  }
+
+  /// Contract two shapes
+
+  /// The product is computed row by row of the fused left-hand matrix, with
+  /// a dense accumulator of one result row; only the products of nonzero
+  /// norms are computed, and neither argument nor the result is ever
+  /// decompressed.
+  /// \tparam Factor The scaling factor type
+  /// \param other The right-hand argument
+  /// \param factor The scaling factor
+  /// \param gemm_helper The contraction helper
+  /// \return The shape of the contraction result
+  /// \note expression abs(Factor) must be well defined (by default, std::abs
+  /// will be used)
+  template <typename Factor>
+  CompressedSparseShape_ gemm(const CompressedSparseShape_& other,
+                              const Factor factor,
+                              const math::GemmHelper& gemm_helper) const {
+    TA_ASSERT(!empty());
+    TA_ASSERT(!other.empty());
+    TA_ASSERT(!pmap_ && !other.pmap_);
+
+    const value_type abs_factor = sparse_shape_type::to_abs_factor(factor);
+    const value_type threshold = sparse_shape_type::threshold();
+    using integer = TiledArray::math::blas::integer;
+    integer M = 0, N = 0, K = 0;
+    gemm_helper.compute_matrix_sizes(M, N, K, range_, other.range_);
+
+    // Construct the result size vectors
+    std::shared_ptr<vector_type> size_vectors(
+        new vector_type[gemm_helper.result_rank()],
+        std::default_delete<vector_type[]>());
+    unsigned int x = 0ul;
+    for (unsigned int i = gemm_helper.left_outer_begin();
+         i < gemm_helper.left_outer_end(); ++i, ++x)
+      size_vectors.get()[x] = size_vectors_.get()[i];
+    for (unsigned int i = gemm_helper.right_outer_begin();
+         i < gemm_helper.right_outer_end(); ++i, ++x)
+      size_vectors.get()[x] = other.size_vectors_.get()[i];
+
+    const Range result_range =
+        gemm_helper.make_result_range<Range>(range_, other.range_);
+
+    // Compute the squared inner size vector (each argument is scaled by it)
+    const unsigned int k_rank =
+        gemm_helper.left_inner_end() - gemm_helper.left_inner_begin();
+    vector_type k_sizes2(K, value_type(1));
+    if (k_rank > 0u) {
+      const vector_type k_sizes = sparse_shape_type::recursive_outer_product(
+          size_vectors_.get() + gemm_helper.left_inner_begin(), k_rank,
+          [](const vector_type& size_vector) -> const vector_type& {
+            return size_vector;
+          });
+      for (integer k = 0; k < K; ++k) k_sizes2[k] = k_sizes[k] * k_sizes[k];
+    }
+
+    // Compute the row offsets of the right-hand argument
+    const ordinal_type k_size = K, n_size = N;
+    std::vector<size_type> right_row_ptr(k_size + 1, 0ul);
+    for (const ordinal_type ord : other.ordinals_)
+      ++right_row_ptr[ord / n_size + 1];
+    std::partial_sum(right_row_ptr.begin(), right_row_ptr.end(),
+                     right_row_ptr.begin());
+
+    // Compute the result rows
+    std::vector<ordinal_type> ordinals;
+    std::vector<value_type> norms;
+    std::vector<value_type> row(n_size, value_type(0));
+    std::vector<ordinal_type> row_cols;
+    std::vector<bool> row_mask(n_size, false);
+    for (size_type first = 0ul; first < ordinals_.size();) {
+      const ordinal_type m = ordinals_[first] / k_size;
+      size_type last = first;
+      for (; last < ordinals_.size() && ordinals_[last] / k_size == m;
+           ++last) {
+        const ordinal_type k = ordinals_[last] % k_size;
+        const value_type a = norms_[last] * k_sizes2[k] * abs_factor;
+        for (size_type j = right_row_ptr[k]; j < right_row_ptr[k + 1]; ++j) {
+          const ordinal_type n = other.ordinals_[j] % n_size;
+          if (!row_mask[n]) {
+            row_mask[n] = true;
+            row_cols.push_back(n);
+          }
+          row[n] += a * other.norms_[j];
+        }
+      }
+
+      // Screen and store the result row
+      std::sort(row_cols.begin(), row_cols.end());
+      for (const ordinal_type n : row_cols) {
+        if (row[n] >= threshold) {
+          ordinals.push_back(m * n_size + n);
+          norms.push_back(row[n]);
+        }
+        row[n] = value_type(0);
+        row_mask[n] = false;
+      }
+      row_cols.clear();
+      first = last;
+    }
+
+    return CompressedSparseShape_(result_range, size_vectors,
+                                  std::move(ordinals), std::move(norms));
+  }
+
+  /// Contract and permute two shapes
+
+  /// \tparam Factor The scaling factor type
+  /// \param other The right-hand argument
+  /// \param factor The scaling factor
+  /// \param gemm_helper The contraction helper
+  /// \param perm The permutation to be applied to the result
+  /// \return The shape of the permuted contraction result
+  /// \note expression abs(Factor) must be well defined (by default, std::abs
+  /// will be used)
+  template <typename Factor>
+  CompressedSparseShape_ gemm(const CompressedSparseShape_& other,
+                              const Factor factor,
+                              const math::GemmHelper& gemm_helper,
+                              const Permutation& perm) const {
+    return gemm(other, factor, gemm_helper).perm(perm);
+  }
+
+  template <typename Archive,
+            typename std::enable_if<madness::archive::is_input_archive<
+                Archive>::value>::type* = nullptr>
+  void serialize(const Archive& ar) {
+    ar& range_;
+    const unsigned int dim = range_.rank();
+    size_vectors_ = std::shared_ptr<vector_type>(
+        new vector_type[dim], std::default_delete<vector_type[]>());
+    for (unsigned d = 0; d != dim; ++d) ar& size_vectors_.get()[d];
+    ar& ordinals_& norms_& nnz_;
+    pmap_.reset();
+  }
+
+  template <typename Archive,
+            typename std::enable_if<madness::archive::is_output_archive<
+                Archive>::value>::type* = nullptr>
+  void serialize(const Archive& ar) const {
+    TA_ASSERT(!pmap_);
+    ar& range_;
+    const unsigned int dim = range_.rank();
+    for (unsigned d = 0; d != dim; ++d) ar& size_vectors_.get()[d];
+    ar& ordinals_& norms_& nnz_;
+  }
+
+};  // class CompressedSparseShape
+
+/// Add the shape to an output stream
+
+/// \tparam T the numeric type supporting the type of \c shape
+/// \param os The output stream
+/// \param shape the CompressedSparseShape<T> object
+/// \return A reference to the output stream
+template <typename T>
+inline std::ostream& operator<<(std::ostream& os,
+                                const CompressedSparseShape<T>& shape) {
+  os << "CompressedSparseShape<" << typeid(T).name() << ">: " << shape.nnz()
+     << " nonzero tiles" << std::endl;
+  for (std::size_t i = 0ul; i < shape.nnz(); ++i)
+    os << "  " << shape.ordinals()[i] << ": " << shape.norms()[i] << std::endl;
+  return os;
+}
+
+/// collective bitwise-compare-reduce for CompressedSparseShape objects
+
+/// @param world the World object
+/// @param[in] shape the CompressedSparseShape object
+/// @return true if \c shape is bitwise identical across \c world
+/// @note must be invoked on every rank of World
+template <typename T>
+bool is_replicated(World& world, const CompressedSparseShape<T>& shape) {
+  TA_ASSERT(!shape.is_partitioned());
+
+  // The number of nonzero tiles must match before the tiles can be compared
+  const std::size_t nnz = shape.nnz();
+  std::size_t bounds[2] = {nnz, std::numeric_limits<std::size_t>::max() - nnz};
+  world.gop.max(bounds, 2);
+  if (bounds[0] != std::numeric_limits<std::size_t>::max() - bounds[1])
+    return false;
+
+  auto ordinals = shape.ordinals();
+  auto norms = shape.norms();
+  if (nnz > 0ul) {
+    world.gop.max(ordinals.data(), nnz);
+    world.gop.max(norms.data(), nnz);
+  }
+  return ordinals == shape.ordinals() && norms == shape.norms();
+}
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_COMPRESSED_SPARSE_SHAPE_H__INCLUDED
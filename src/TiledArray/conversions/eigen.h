@@ -542,6 +542,191 @@ array_to_eigen(const DistArray<Tile, Policy>& array) {
   return matrix;
 }
 
+// clang-format off
+/// Gather an Array object into an Eigen matrix object on one rank
+
+/// This function will copy the content of \c array into a matrix that exists
+/// only on rank \p root ; unlike array_to_eigen() , \c array does not need to
+/// be replicated, and each tile is sent once, directly from its owner to
+/// \p root . The other ranks do not hold a copy of the matrix, so the memory
+/// and communication costs are O(N) in the number of matrix elements instead
+/// of O(N P) for P ranks. This is a collective function, but only \p root
+/// blocks until all elements of \c array have been copied.
+/// Usage:
+/// \code
+/// TiledArray::TArrayD array(world, trange);
+/// // Set tiles of array ...
+///
+/// Eigen::MatrixXd m = gather_array_to_eigen(array);
+/// if (world.rank() == 0) {
+///   // use m ...
+/// }
+/// \endcode
+/// \tparam Tile The array tile type
+/// \tparam EigenStorageOrder The storage order of the resulting Eigen::Matrix
+///      object; the default is Eigen::ColMajor, i.e. the column-major storage
+/// \param array The array to be converted
+/// \param root The rank that will hold the result
+/// \param max_pending_tiles If not zero, \p root requests at most this many
+/// tiles at a time, which bounds the memory used by the tiles that have been
+/// received but not yet copied into the matrix (streaming mode); if zero,
+/// all tiles are requested at once
+/// \return an Eigen matrix with the data of \c array on \p root , and an
+/// empty matrix on the other ranks
+/// \throw TiledArray::Exception When the number
+/// of dimensions of \c array is not equal to 1 or 2.
+// clang-format on
+template <typename Tile, typename Policy,
+          unsigned int EigenStorageOrder = Eigen::ColMajor>
+Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic, Eigen::Dynamic,
+              EigenStorageOrder>
+gather_array_to_eigen(const DistArray<Tile, Policy>& array,
+                      const ProcessID root = 0,
+                      const std::size_t max_pending_tiles = 0ul) {
+  typedef Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic,
+                        Eigen::Dynamic, EigenStorageOrder>
+      EigenMatrix;
+
+  const auto rank = array.trange().tiles_range().rank();
+
+  // Check that the array will fit in a matrix or vector
+  TA_ASSERT((rank == 2u) ||
+            (rank == 1u) &&
+                "TiledArray::gather_array_to_eigen(): The array dimensions "
+                "must be equal to 1 or 2.");
+  TA_ASSERT(root >= 0 && root < array.world().size());
+
+  if (array.world().rank() != root) return EigenMatrix();
+
+  // Construct the Eigen matrix
+  const auto* MADNESS_RESTRICT const array_extent =
+      array.trange().elements_range().extent_data();
+  // if array is sparse must initialize to zero
+  EigenMatrix matrix =
+      EigenMatrix::Zero(array_extent[0], (rank == 2 ? array_extent[1] : 1));
+
+  // Spawn tasks to copy array tiles to the Eigen matrix; the tiles are
+  // fetched from their owners by find()
+  madness::AtomicInt counter;
+  counter = 0;
+  int n = 0;
+  for (std::size_t i = 0; i < array.size(); ++i) {
+    if (!array.is_zero(i)) {
+      if (max_pending_tiles > 0ul) {
+        const int max_n = n - int(max_pending_tiles);
+        array.world().await([&counter, max_n]() { return counter > max_n; });
+      }
+      array.world().taskq.add(
+          &detail::counted_tensor_to_eigen_submatrix<
+              EigenMatrix, typename DistArray<Tile, Policy>::value_type>,
+          array.find(i), &matrix, &counter);
+      ++n;
+    }
+  }
+
+  // Wait until the above tasks are complete. Tasks will be processed by this
+  // thread while waiting.
+  array.world().await([&counter, n]() { return counter == n; });
+
+  return matrix;
+}
+
+// clang-format off
+/// Scatter an Eigen matrix on one rank into an Array object
+
+/// This function will copy the content of \c matrix , which only needs to be
+/// defined on rank \p root , into an \c Array object that is tiled according
+/// to the \c trange object. Unlike eigen_to_array() , the matrix does not
+/// need to be replicated: \p root creates every tile and sends it directly
+/// to its owner. This is a collective function; it will block until
+/// all elements of \c matrix have been copied.
+///
+/// Usage:
+/// \code
+/// Eigen::MatrixXd m;
+/// if (world.rank() == 0) {
+///   m.resize(100, 100);
+///   // Fill m with data ...
+/// }
+///
+/// TiledArray::TArrayD array =
+///     scatter_eigen_to_array<TiledArray::TArrayD>(world, trange, m);
+/// \endcode
+/// \tparam A The array type
+/// \tparam Derived The Eigen matrix derived type
+/// \param world The world where the array will live
+/// \param trange The tiled range of the new array
+/// \param matrix The Eigen matrix to be copied; it is only accessed on
+/// \p root
+/// \param root The rank that holds \p matrix
+/// \param pmap the process map object [default=null]; initialized to the
+/// default if null; it must not be replicated
+/// \param max_pending_tiles If not zero, \p root creates at most this many
+/// tiles at a time, which bounds the memory used by the tiles that have been
+/// created but not yet sent (streaming mode); if zero, all tiles are created
+/// at once
+/// \return An \c Array object that is a copy of \c matrix
+// clang-format on
+template <typename A, typename Derived>
+A scatter_eigen_to_array(
+    World& world, const typename A::trange_type& trange,
+    const Eigen::MatrixBase<Derived>& matrix, const ProcessID root = 0,
+    std::shared_ptr<typename A::pmap_interface> pmap = {},
+    const std::size_t max_pending_tiles = 0ul) {
+  typedef typename A::index1_type size_type;
+  TA_ASSERT(root >= 0 && root < world.size());
+  TA_ASSERT((trange.tiles_range().rank() == 2 ||
+             trange.tiles_range().rank() == 1) &&
+            "TiledArray::scatter_eigen_to_array(): The number of dimensions "
+            "in trange must be equal to 1 or 2.");
+  TA_ASSERT(!pmap || !pmap->is_replicated());
+
+  A array = (pmap ? A(world, trange, pmap) : A(world, trange));
+
+  if (world.rank() == root) {
+    // Check that trange matches the dimensions of other
+    if (trange.tiles_range().rank() == 2) {
+      TA_ASSERT(
+          trange.elements_range().extent(0) == size_type(matrix.rows()) &&
+          "TiledArray::scatter_eigen_to_array(): The number of rows in trange "
+          "is not equal to the number of rows in the Eigen matrix.");
+      TA_ASSERT(
+          trange.elements_range().extent(1) == size_type(matrix.cols()) &&
+          "TiledArray::scatter_eigen_to_array(): The number of columns in "
+          "trange is not equal to the number of columns in the Eigen matrix.");
+    } else {
+      TA_ASSERT(
+          trange.elements_range().extent(0) == size_type(matrix.size()) &&
+          "TiledArray::scatter_eigen_to_array(): The size of trange must be "
+          "equal to the matrix size.");
+    }
+
+    // Spawn tasks to copy Eigen to the array tiles; remote tiles are sent to
+    // their owners by set()
+    madness::AtomicInt counter;
+    counter = 0;
+    std::int64_t n = 0;
+    for (std::size_t i = 0; i < array.size(); ++i) {
+      if (max_pending_tiles > 0ul) {
+        const std::int64_t max_n = n - std::int64_t(max_pending_tiles);
+        world.await([&counter, max_n]() { return counter > max_n; });
+      }
+      world.taskq.add(&detail::counted_eigen_submatrix_to_tensor<A, Derived>,
+                      &matrix, &array, i, &counter);
+      ++n;
+    }
+
+    // Wait until the write tasks are complete
+    world.await([&counter, n]() { return counter == n; });
+  }
+
+  // the other ranks receive their tiles asynchronously; truncating a sparse
+  // array waits for them
+  array.truncate();
+
+  return array;
+}
+
 /// Convert a row-major matrix buffer into an Array object
 
 /// This function will copy the content of \c buffer into an \c Array object
@@ -30,12 +30,6 @@
 #include <TiledArray/type_traits.h>
 #include <TiledArray/util/function.h>
 
-/// Forward declarations
-namespace Eigen {
-template <typename>
-class aligned_allocator;
-}  // namespace Eigen
-
 namespace TiledArray {
 
 /// Forward declarations
@@ -277,9 +271,8 @@ inline std::
   tiles.reserve(arg.pmap()->size());
 
   // Construct a tensor to hold updated tile norms for the result shape.
-  TiledArray::Tensor<typename shape_type::value_type,
-                     Eigen::aligned_allocator<typename shape_type::value_type>>
-      tile_norms(arg.trange().tiles_range(), 0);
+  TiledArray::Tensor<typename shape_type::value_type> tile_norms(
+      arg.trange().tiles_range(), 0);
 
   // Construct the task function used to construct the result tiles.
   madness::AtomicInt counter;
@@ -299,7 +292,6 @@ inline std::
 
   World& world = arg.world();
 
-  const auto& arg_shape_data = arg.shape().data();
   switch (shape_reduction) {
     case ShapeReductionMethod::Intersect:
       // Get local tile index iterator
@@ -312,7 +304,7 @@ inline std::
         tiles.emplace_back(index, std::move(result_tile));
         if (op_returns_void)  // if Op does not evaluate norms, use the (scaled)
                               // norms of the first arg
-          tile_norms[index] = arg_shape_data[index];
+          tile_norms[index] = arg.shape()[index];
       }
       break;
     case ShapeReductionMethod::Union:
@@ -30,12 +30,6 @@
 #include "TiledArray/shape.h"
 #include "TiledArray/type_traits.h"
 
-/// Forward declarations
-namespace Eigen {
-template <typename>
-class aligned_allocator;
-}  // namespace Eigen
-
 namespace TiledArray {
 
 /// Construct dense Array
@@ -146,10 +140,8 @@ inline Array make_array(World& world, const detail::trange_t<Array>& trange,
   tiles.reserve(pmap->size());
 
   // Construct a tensor to hold updated tile norms for the result shape.
-  TiledArray::Tensor<
-      typename detail::shape_t<Array>::value_type,
-      Eigen::aligned_allocator<typename detail::shape_t<Array>::value_type> >
-      tile_norms(trange.tiles_range(), 0);
+  TiledArray::Tensor<typename detail::shape_t<Array>::value_type> tile_norms(
+      trange.tiles_range(), 0);
 
   // Construct the task function used to construct the result tiles.
   madness::AtomicInt counter;
@@ -25,26 +25,145 @@
 #include "TiledArray/util/annotation.h"
 #include "TiledArray/special/diagonal_array.h"
 
-/// \name Retile function
-/// \brief Retiles a tensor with a provided TiledRange
-
-/// Retiles the data of the input tensor by comparing each dimension of its
-/// TiledRange with the corresponding dimension of the input TiledRange. If they
-/// are not equivalent, a suitably tiled identity matrix is used to convert that
-/// dimension to the desired tiling.
-/// \param tensor The tensor whose data is to be retiled
-/// \param new_trange The desired TiledRange of the output tensor
-/// \return A new tensor with appropriately tiled data
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace TiledArray {
+namespace detail {
+
+/// Source tiles that overlap each destination tile of one dimension
+
+/// \param source The tiling of the source dimension
+/// \param target The tiling of the destination dimension; it must span the
+/// same elements as \p source
+/// \return The indices of the source tiles that overlap each tile of
+/// \p target , in increasing order; the outer vector is indexed by the
+/// destination tile index relative to \c target.tiles_range().first
+inline std::vector<std::vector<TiledRange1::index1_type>> retile_overlaps(
+    const TiledRange1& source, const TiledRange1& target) {
+  TA_ASSERT(source.elements_range() == target.elements_range());
+  std::vector<std::vector<TiledRange1::index1_type>> result(
+      target.tile_extent());
+
+  // Sweep the tile boundaries of both dimensions
+  auto s = source.tiles_range().first;
+  for (auto t = target.tiles_range().first; t != target.tiles_range().second;
+       ++t) {
+    auto& overlaps = result[t - target.tiles_range().first];
+    const auto& tile = target.tile(t);
+    while (source.tile(s).second <= tile.first) ++s;
+    for (auto i = s; i != source.tiles_range().second &&
+                     source.tile(i).first < tile.second;
+         ++i)
+      overlaps.push_back(i);
+  }
+  return result;
+}
+
+/// Visit the source tiles that overlap a destination tile
+
+/// \tparam Op The visitor type
+/// \param overlaps The overlapping source tiles of each dimension, as computed
+/// by \c retile_overlaps()
+/// \param tile_index The index of the destination tile
+/// \param target_first The first tile index of each destination dimension
+/// \param op The visitor, called as \c op(source_tile_index) for every source
+/// tile that overlaps \p tile_index
+template <typename Index, typename Op>
+void for_each_retile_overlap(
+    const std::vector<std::vector<std::vector<TiledRange1::index1_type>>>&
+        overlaps,
+    const Index& tile_index,
+    const std::vector<TiledRange1::index1_type>& target_first, Op&& op) {
+  const auto rank = overlaps.size();
+  std::vector<const std::vector<TiledRange1::index1_type>*> lists(rank);
+  for (std::size_t d = 0ul; d < rank; ++d)
+    lists[d] = &overlaps[d][tile_index[d] - target_first[d]];
+
+  // Iterate over the cartesian product of the per-dimension lists
+  std::vector<std::size_t> counter(rank, 0ul);
+  std::vector<TiledRange1::index1_type> source_index(rank);
+  while (true) {
+    for (std::size_t d = 0ul; d < rank; ++d)
+      source_index[d] = (*lists[d])[counter[d]];
+    op(source_index);
+
+    std::size_t d = rank;
+    while (d > 0ul) {
+      --d;
+      if (++counter[d] != lists[d]->size()) break;
+      counter[d] = 0ul;
+      if (d == 0ul) return;
+    }
+    if (rank == 0ul) return;
+  }
+}
 
+/// Remote access to the blocks of the tiles of an array
+
+/// Each process that owns source tiles serves the sub-blocks that other
+/// processes need to assemble their destination tiles. Requests are sent
+/// with \c task() to the owner of the source tile, so every block is moved
+/// with a single point-to-point message.
+/// \tparam Array The array type
+template <typename Array>
+class RetileEngine : public madness::WorldObject<RetileEngine<Array>> {
+ public:
+  typedef typename Array::value_type value_type;  ///< The tile type
+
+ private:
+  Array source_;  ///< The array that is being retiled
+
+  /// Copy a block of a tile
+
+  /// \param tile The tile
+  /// \param block The range of the block
+  /// \return A tile that holds a copy of the block of \p tile
+  static value_type extract(const value_type& tile, const Range& block) {
+    return value_type(tile.block(block.lobound(), block.upbound()));
+  }
+
+ public:
+  /// Constructor
+
+  /// \param source The array that is being retiled
+  explicit RetileEngine(const Array& source)
+      : madness::WorldObject<RetileEngine<Array>>(source.world()),
+        source_(source) {
+    this->process_pending();
+  }
+
+  virtual ~RetileEngine() {}
+
+  /// Block accessor
+
+  /// \param ordinal The ordinal of a local, non-zero tile of the source array
+  /// \param block The range of the requested block of the tile
+  /// \return The block of the tile; the tile itself is returned when
+  /// \p block spans the whole tile
+  madness::Future<value_type> get_block(const std::size_t ordinal,
+                                        const Range& block) {
+    TA_ASSERT(source_.is_local(ordinal));
+    if (source_.trange().make_tile_range(ordinal) == block)
+      return source_.find(ordinal);
+    return this->get_world().taskq.add(&RetileEngine::extract,
+                                       source_.find(ordinal), block);
+  }
+};  // class RetileEngine
+
+/// Retile an array by multiplying it by identity matrices
+
+/// Each dimension that changes is retiled by a contraction with a suitably
+/// tiled identity matrix. This works with any tile type, but every changed
+/// dimension requires a contraction and a complete intermediate array.
+/// \param tensor The array whose data is to be retiled
+/// \param new_trange The desired TiledRange of the output array
+/// \return A new array with appropriately tiled data
 template <typename TileType, typename PolicyType>
-auto retile(const DistArray<TileType, PolicyType>& tensor,
-            const TiledRange& new_trange) {
-  // Make sure ranks match
-  auto rank = new_trange.rank();
-  auto tensor_rank = tensor.trange().rank();
-  assert((rank == tensor_rank) && "TiledRanges are of different ranks");
+auto retile_by_contraction(const DistArray<TileType, PolicyType>& tensor,
+                           const TiledRange& new_trange) {
+  const auto rank = new_trange.rank();
 
   // Makes the annotations for the contraction step
   auto annotations =
@@ -70,8 +189,10 @@ auto retile(const DistArray<TileType, PolicyType>& tensor,
   using tensor_type = DistArray<TileType, PolicyType>;
   auto start = detail::dummy_annotation(rank);
   tensor_type output_tensor;
-  for (auto i = 0; i < rank; ++i) {
-    if (i == 0) { output_tensor(start) = tensor(start); }
+  for (std::size_t i = 0; i < rank; ++i) {
+    if (i == 0) {
+      output_tensor(start) = tensor(start);
+    }
     if (new_trange.dim(i) != tensor.trange().dim(i)) {
       // Make identity for contraction
       TiledRange retiler{tensor.trange().dim(i), new_trange.dim(i)};
@@ -88,7 +209,167 @@ auto retile(const DistArray<TileType, PolicyType>& tensor,
   return output_tensor;
 }
 
-} // namespace TiledArray
+/// Retile an array by moving blocks of its tiles
+
+/// The overlaps of the source and destination tiles are computed from the
+/// tile boundaries of each dimension. Every destination tile is assembled by
+/// its owner from (strided) copies of the blocks of the overlapping source
+/// tiles, which are requested directly from their owners, so the data is
+/// moved once and no intermediate arrays are formed. For sparse arrays the
+/// norm of each destination tile is bounded by the norms of the overlapping
+/// source tiles, so the shape is computed without reading any tile data.
+/// \param tensor The array whose data is to be retiled
+/// \param new_trange The desired TiledRange of the output array
+/// \return A new array with appropriately tiled data
+template <typename TileType, typename PolicyType>
+auto retile_by_redistribution(const DistArray<TileType, PolicyType>& tensor,
+                              const TiledRange& new_trange) {
+  typedef DistArray<TileType, PolicyType> array_type;
+  typedef typename array_type::shape_type shape_type;
+  typedef TiledRange1::index1_type index1_type;
+
+  World& world = tensor.world();
+  const TiledRange& trange = tensor.trange();
+  const auto rank = new_trange.rank();
+
+  std::vector<std::vector<std::vector<index1_type>>> overlaps;
+  std::vector<index1_type> target_first;
+  overlaps.reserve(rank);
+  target_first.reserve(rank);
+  for (std::size_t d = 0ul; d < rank; ++d) {
+    overlaps.emplace_back(retile_overlaps(trange.dim(d), new_trange.dim(d)));
+    target_first.push_back(new_trange.dim(d).tiles_range().first);
+  }
+
+  // The range of the block of source tile source_index that overlaps the
+  // destination tile with range tile_range
+  auto make_block = [&](const std::vector<index1_type>& source_index,
+                        const Range& tile_range) {
+    std::vector<index1_type> lobound(rank), upbound(rank);
+    for (std::size_t d = 0ul; d < rank; ++d) {
+      const auto& source_tile = trange.dim(d).tile(source_index[d]);
+      lobound[d] = std::max<index1_type>(source_tile.first,
+                                         tile_range.lobound()[d]);
+      upbound[d] = std::min<index1_type>(source_tile.second,
+                                         tile_range.upbound()[d]);
+    }
+    return Range(lobound, upbound);
+  };
+
+  // Construct the result array
+  array_type result;
+  if constexpr (is_dense_v<shape_type>) {
+    result = array_type(world, new_trange);
+  } else {
+    // The Frobenius norm of a destination tile is bounded by the norms of the
+    // overlapping source tiles
+    typedef typename shape_type::value_type norm_type;
+    const auto& source_norms = tensor.shape().data();
+    Tensor<norm_type> norms(new_trange.tiles_range(), norm_type(0));
+    for (const auto& tile_index : new_trange.tiles_range()) {
+      norm_type sum = 0;
+      for_each_retile_overlap(
+          overlaps, tile_index, target_first,
+          [&](const std::vector<index1_type>& source_index) {
+            const auto ordinal = trange.tiles_range().ordinal(source_index);
+            if (tensor.is_zero(ordinal)) return;
+            const norm_type norm =
+                source_norms[ordinal] *
+                norm_type(trange.make_tile_range(ordinal).volume());
+            sum += norm * norm;
+          });
+      norms[new_trange.tiles_range().ordinal(tile_index)] = std::sqrt(sum);
+    }
+    result = array_type(world, new_trange, shape_type(norms, new_trange));
+  }
+
+  // Assemble a tile from the blocks of the source tiles; a local source tile
+  // that is reused whole is copied so that the arrays do not share data
+  auto assemble = [](const Range& range, const bool complete,
+                     const bool shared,
+                     const std::vector<madness::Future<TileType>>& blocks) {
+    if (blocks.size() == 1ul && blocks.front().get().range() == range)
+      return (shared ? blocks.front().get().clone() : blocks.front().get());
+    TileType tile =
+        (complete ? TileType(range) : TileType(range, numeric_t<TileType>(0)));
+    for (const auto& block : blocks) {
+      const TileType& b = block.get();
+      tile.block(b.range().lobound(), b.range().upbound()) = b;
+    }
+    return tile;
+  };
+
+  RetileEngine<array_type> engine(tensor);
+  for (const auto ordinal : *result.pmap()) {
+    if (result.is_zero(ordinal)) continue;
+    const auto tile_index = new_trange.tiles_range().idx(ordinal);
+    auto tile_range = new_trange.make_tile_range(ordinal);
+
+    std::vector<madness::Future<TileType>> blocks;
+    bool complete = true, shared = false;
+    for_each_retile_overlap(
+        overlaps, tile_index, target_first,
+        [&](const std::vector<index1_type>& source_index) {
+          const auto source_ordinal =
+              trange.tiles_range().ordinal(source_index);
+          if (tensor.is_zero(source_ordinal)) {
+            complete = false;
+            return;
+          }
+          const auto owner = tensor.owner(source_ordinal);
+          shared = shared || (owner == world.rank());
+          blocks.emplace_back(engine.task(
+              owner, &RetileEngine<array_type>::get_block, source_ordinal,
+              make_block(source_index, tile_range)));
+        });
+
+    result.set(ordinal,
+               world.taskq.add(assemble, std::move(tile_range), complete,
+                               shared, std::move(blocks)));
+  }
+
+  // keep the engine around until everyone is done
+  world.gop.fence();
+
+  return result;
+}
+
+}  // namespace detail
+
+/// \name Retile function
+/// \brief Retiles a tensor with a provided TiledRange
+
+/// Retiles the data of the input tensor by redistributing the blocks of its
+/// tiles that overlap each tile of the input TiledRange. Tiles that are not
+/// (plain) TiledArray::Tensor objects are retiled by contraction with
+/// suitably tiled identity matrices instead.
+/// \param tensor The tensor whose data is to be retiled
+/// \param new_trange The desired TiledRange of the output tensor
+/// \return A new tensor with appropriately tiled data
+/// \note This is a collective function.
+template <typename TileType, typename PolicyType>
+auto retile(const DistArray<TileType, PolicyType>& tensor,
+            const TiledRange& new_trange) {
+  // Make sure ranks and elements match
+  TA_ASSERT(new_trange.rank() == tensor.trange().rank() &&
+            "TiledRanges are of different ranks");
+  TA_ASSERT(new_trange.elements_range() == tensor.trange().elements_range() &&
+            "TiledRanges span different elements");
+
+  if constexpr (detail::is_ta_tensor_v<TileType> &&
+                !detail::is_tensor_of_tensor_v<TileType>) {
+    if (new_trange == tensor.trange()) {
+      DistArray<TileType, PolicyType> output_tensor;
+      const auto start = detail::dummy_annotation(new_trange.rank());
+      output_tensor(start) = tensor(start);
+      return output_tensor;
+    }
+    return detail::retile_by_redistribution(tensor, new_trange);
+  } else {
+    return detail::retile_by_contraction(tensor, new_trange);
+  }
+}
 
+}  // namespace TiledArray
 
 #endif  // TILEDARRAY_RETILE_H
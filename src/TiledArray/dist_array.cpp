@@ -31,30 +31,30 @@
 
 namespace TiledArray {
 
-template class DistArray<Tensor<double, Eigen::aligned_allocator<double> >,
+template class DistArray<Tensor<double, tensor_allocator<double> >,
                          DensePolicy>;
-template class DistArray<Tensor<float, Eigen::aligned_allocator<float> >,
+template class DistArray<Tensor<float, tensor_allocator<float> >,
                          DensePolicy>;
-template class DistArray<Tensor<int, Eigen::aligned_allocator<int> >,
+template class DistArray<Tensor<int, tensor_allocator<int> >,
                          DensePolicy>;
-template class DistArray<Tensor<long, Eigen::aligned_allocator<long> >,
+template class DistArray<Tensor<long, tensor_allocator<long> >,
                          DensePolicy>;
 //  template class DistArray<Tensor<std::complex<double>,
-//  Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>; template
+//  tensor_allocator<std::complex<double> > >, DensePolicy>; template
 //  class DistArray<Tensor<std::complex<float>,
-//  Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>;
+//  tensor_allocator<std::complex<float> > >, DensePolicy>;
 
-template class DistArray<Tensor<double, Eigen::aligned_allocator<double> >,
+template class DistArray<Tensor<double, tensor_allocator<double> >,
                          SparsePolicy>;
-template class DistArray<Tensor<float, Eigen::aligned_allocator<float> >,
+template class DistArray<Tensor<float, tensor_allocator<float> >,
                          SparsePolicy>;
-template class DistArray<Tensor<int, Eigen::aligned_allocator<int> >,
+template class DistArray<Tensor<int, tensor_allocator<int> >,
                          SparsePolicy>;
-template class DistArray<Tensor<long, Eigen::aligned_allocator<long> >,
+template class DistArray<Tensor<long, tensor_allocator<long> >,
                          SparsePolicy>;
 //  template class DistArray<Tensor<std::complex<double>,
-//  Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>; template
+//  tensor_allocator<std::complex<double> > >, SparsePolicy>; template
 //  class DistArray<Tensor<std::complex<float>,
-//  Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
+//  tensor_allocator<std::complex<float> > >, SparsePolicy>;
 
 }  // namespace TiledArray
@@ -52,7 +52,7 @@ class TsrExpr;
 /// used to construct distributed tensor algebraic operations.
 /// \tparam T The element type of for array tiles
 /// \tparam Tile The tile type [ Default = \c Tensor<T> ]
-template <typename Tile = Tensor<double, Eigen::aligned_allocator<double>>,
+template <typename Tile = Tensor<double, tensor_allocator<double>>,
           typename Policy = DensePolicy>
 class DistArray : public madness::archive::ParallelSerializableObject {
  public:
@@ -274,6 +274,23 @@ class DistArray : public madness::archive::ParallelSerializableObject {
                 std::shared_ptr<pmap_interface>())
       : pimpl_(init(world, trange, shape, pmap)) {}
 
+  /// Symmetric array constructor
+
+  /// Constructs an array with the given meta data that stores only the tiles
+  /// that are unique under the permutational symmetry \c symm ; see
+  /// \c make_symmetric() . Only the unique tiles may be assigned.
+  /// \param world The world where the array will live.
+  /// \param trange The tiled range object that will be used to set the array
+  /// tiling. \param shape The array shape that defines zero and non-zero tiles
+  /// \param pmap The tile index -> process map
+  /// \param symm The permutational symmetry of the tiles
+  DistArray(World& world, const trange_type& trange, const shape_type& shape,
+            const std::shared_ptr<pmap_interface>& pmap,
+            std::shared_ptr<const symmetry::TileSymmetry> symm)
+      : pimpl_(init(world, trange, shape, pmap)) {
+    pimpl_->symmetry(std::move(symm));
+  }
+
   /// \name Initializer list constructors
   /// \brief Creates a new tensor containing the elements in the provided
   ///         `std::initializer_list`.
@@ -768,12 +785,19 @@ class DistArray : public madness::archive::ParallelSerializableObject {
 
   /// Fill all local tiles with random values
   ///
-  /// This function will fill all local tiles with random values. The random
-  /// values are generated by calling TiledArray::detail::MakeRandom, which can
-  /// be specialized to determine how the random values for a given type are
-  /// generated. It should be noted that if MakeRandom does not know how to
-  /// generate random values of type T this function will be disabled via SFINAE
-  /// and attempting to use it will lead to a compile-time error.
+  /// This function will fill all local tiles with random values. When \c T is
+  /// the element type and TiledArray::detail::RandomBits can make values of
+  /// type \c T , the values are generated by a counter-based generator
+  /// (Philox) keyed on the seed, the tile ordinal, and the element offset:
+  /// the contiguous tile data is filled in vectorized loops, and the values do
+  /// not depend on the number of processes. The seed is set by
+  /// TiledArray::set_random_seed, and each call generates a new sequence.
+  /// Otherwise the random values are generated by calling
+  /// TiledArray::detail::MakeRandom, which can be specialized to determine how
+  /// the random values for a given type are generated. It should be noted that
+  /// if MakeRandom does not know how to generate random values of type T this
+  /// function will be disabled via SFINAE and attempting to use it will lead
+  /// to a compile-time error.
   ///
   /// \tparam T The type of random value to generate. Defaults to
   ///           element_type.
@@ -790,8 +814,24 @@ class DistArray : public madness::archive::ParallelSerializableObject {
   template <typename T = element_type,
             typename = detail::enable_if_can_make_random_t<T>>
   void fill_random(bool skip_set = false) {
-    init_elements(
-        [](const auto&) { return detail::MakeRandom<T>::generate_value(); });
+    if constexpr (std::is_same_v<T, element_type> &&
+                  detail::is_tensor_helper<value_type>::value &&
+                  detail::RandomBits<T>::words > 0) {
+      init_tiles(
+          [key = detail::next_random_key(),
+           tr = trange()](const range_type& range) -> value_type {
+            value_type tile(range);
+            const auto ord =
+                tr.tiles_range().ordinal(tr.element_to_tile(range.lobound()));
+            detail::random_fill(tile.data(), tile.size(), key, ord);
+            return tile;
+          },
+          skip_set);
+    } else {
+      init_elements(
+          [](const auto&) { return detail::MakeRandom<T>::generate_value(); },
+          skip_set);
+    }
   }
 
   /// Initialize (local) tiles with a user provided functor
@@ -842,7 +882,7 @@ class DistArray : public madness::archive::ParallelSerializableObject {
     const auto end = pimpl_->pmap()->end();
     for (; it != end; ++it) {
       const auto& index = *it;
-      if (!pimpl_->is_zero(index)) {
+      if (pimpl_->is_stored(index)) {
         if (skip_set) {
           auto fut = find(index);
           if (fut.probe()) continue;
@@ -871,6 +911,13 @@ class DistArray : public madness::archive::ParallelSerializableObject {
   /// \code
   /// element_type op(const index&)
   /// \endcode
+  /// or, if \c op cannot be called with an index,
+  /// \code
+  /// element_type op(ordinal_type)
+  /// \endcode
+  /// where the argument is the ordinal of the element in
+  /// \c elements_range() . The ordinal version avoids constructing the index
+  /// of every element: each row of a tile is filled by a contiguous loop.
   /// For example, in the following code, the array elements are initialized
   /// with random numbers from 0 to 1:
   /// \code
@@ -889,18 +936,45 @@ class DistArray : public madness::archive::ParallelSerializableObject {
   template <typename Op>
   void init_elements(Op&& op, bool skip_set = false) {
     auto op_shared_handle = make_op_shared_handle(std::forward<Op>(op));
-    init_tiles(
-        [op = std::move(op_shared_handle)](
-            const TiledArray::Range& range) -> value_type {
-          // Initialize the tile with the given range object
-          Tile tile(range);
-
-          // Initialize tile elements
-          for (auto& idx : range) tile[idx] = op(idx);
-
-          return tile;
-        },
-        skip_set);
+    if constexpr (std::is_invocable_v<Op, const index&>) {
+      init_tiles(
+          [op = std::move(op_shared_handle)](
+              const TiledArray::Range& range) -> value_type {
+            // Initialize the tile with the given range object
+            Tile tile(range);
+
+            // Initialize tile elements
+            for (auto& idx : range) tile[idx] = op(idx);
+
+            return tile;
+          },
+          skip_set);
+    } else {
+      static_assert(std::is_invocable_v<Op, ordinal_type>,
+                    "DistArray::init_elements(op): op must be callable with "
+                    "an element index or an element ordinal");
+      init_tiles(
+          [op = std::move(op_shared_handle),
+           elements = trange().elements_range()](
+              const TiledArray::Range& range) -> value_type {
+            // Initialize the tile with the given range object
+            Tile tile(range);
+
+            // Initialize tile elements, one row at a time
+            const auto rank = range.rank();
+            const ordinal_type row = (rank > 0 ? range.extent(rank - 1) : 1);
+            const ordinal_type volume = range.volume();
+            auto* const data = tile.data();
+            for (ordinal_type first = 0; first < volume; first += row) {
+              const ordinal_type offset = elements.ordinal(range.idx(first));
+              for (ordinal_type i = 0; i < row; ++i)
+                data[first + i] = op(offset + i);
+            }
+
+            return tile;
+          },
+          skip_set);
+    }
   }
 
   /// Tiled range accessor
@@ -1164,9 +1238,13 @@ class DistArray : public madness::archive::ParallelSerializableObject {
   void swap(DistArray_& other) { std::swap(pimpl_, other.pimpl_); }
 
   /// Convert a distributed array into a replicated array
+  /// \param algorithm The replication algorithm; with
+  ///        \c ReplicationAlgorithm::node the tiles are exchanged between
+  ///        nodes by one process per node
   /// \throw TiledArray::Exception if the PIMPL is not initialized. Strong throw
   ///                              guarantee.
-  void make_replicated() {
+  void make_replicated(const ReplicationAlgorithm algorithm =
+                           ReplicationAlgorithm::allgather) {
     if ((!impl_ref().pmap()->is_replicated()) && (world().size() > 1)) {
       // Construct a replicated array
       auto pmap = std::make_shared<detail::ReplicatedPmap>(world(), size());
@@ -1174,8 +1252,8 @@ class DistArray : public madness::archive::ParallelSerializableObject {
 
       // Create the replicator object that will do an all-to-all broadcast of
       // the local tile data.
-      auto replicator =
-          std::make_shared<detail::Replicator<DistArray_>>(*this, result);
+      auto replicator = std::make_shared<detail::Replicator<DistArray_>>(
+          *this, result, algorithm);
 
       // Put the replicator pointer in the deferred cleanup object so it will
       // be deleted at the end of the next fence.
@@ -1186,6 +1264,38 @@ class DistArray : public madness::archive::ParallelSerializableObject {
     }
   }
 
+  /// Permutational symmetry accessor
+
+  /// \return The permutational symmetry of the tiles of this array, or a null
+  /// pointer if this array stores all nonzero tiles
+  /// \throw TiledArray::Exception if the PIMPL is not initialized.
+  const std::shared_ptr<const symmetry::TileSymmetry>& symmetry() const {
+    return impl_ref().symmetry();
+  }
+
+  /// Convert this array into a symmetric array
+
+  /// The symmetric array stores only the unique tiles of this array, i.e. the
+  /// tiles whose index is lexicographically smallest in its orbit under the
+  /// group of \c symm ; \c find() reconstructs the other tiles by permuting
+  /// the unique tiles and applying the phase. The other tiles of this array
+  /// are assumed to obey the symmetry and are discarded. Use
+  /// \c Expr::set_symmetry() to evaluate only the unique tiles of an
+  /// expression. Operations that construct new arrays from a symmetric
+  /// array, e.g. \c clone() or \c foreach(), store all tiles of the result.
+  /// \note This is a collective operation.
+  /// \param symm The symmetry of the tiles
+  /// \throw TiledArray::Exception if the PIMPL is not initialized, or if the
+  ///                              tiled range is not compatible with \c symm
+  void make_symmetric(std::shared_ptr<const symmetry::TileSymmetry> symm) {
+    TA_ASSERT(symm);
+    TA_ASSERT(symm->is_compatible(trange()));
+    DistArray_ result(world(), trange(), shape(), pmap(), std::move(symm));
+    for (const auto index : *pmap())
+      if (result.pimpl_->is_stored(index)) result.set(index, find(index));
+    DistArray_::operator=(result);
+  }
+
   /// Update shape data and remove tiles that are below the zero threshold
   /// \param[in] thresh the threshold below which the tiles are considered
   ///        to be zero (only for sparse arrays will such tiles be discarded)
@@ -1557,32 +1667,32 @@ madness::AtomicInt DistArray<Tile, Policy>::cleanup_counter_;
 #ifndef TILEDARRAY_HEADER_ONLY
 
 extern template class DistArray<
-    Tensor<double, Eigen::aligned_allocator<double>>, DensePolicy>;
-extern template class DistArray<Tensor<float, Eigen::aligned_allocator<float>>,
+    Tensor<double, tensor_allocator<double>>, DensePolicy>;
+extern template class DistArray<Tensor<float, tensor_allocator<float>>,
                                 DensePolicy>;
-extern template class DistArray<Tensor<int, Eigen::aligned_allocator<int>>,
+extern template class DistArray<Tensor<int, tensor_allocator<int>>,
                                 DensePolicy>;
-extern template class DistArray<Tensor<long, Eigen::aligned_allocator<long>>,
+extern template class DistArray<Tensor<long, tensor_allocator<long>>,
                                 DensePolicy>;
 //  extern template
 //  class DistArray<Tensor<std::complex<double>,
-//  Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>; extern
+//  tensor_allocator<std::complex<double> > >, DensePolicy>; extern
 //  template class DistArray<Tensor<std::complex<float>,
-//  Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>
+//  tensor_allocator<std::complex<float> > >, DensePolicy>
 
 extern template class DistArray<
-    Tensor<double, Eigen::aligned_allocator<double>>, SparsePolicy>;
-extern template class DistArray<Tensor<float, Eigen::aligned_allocator<float>>,
+    Tensor<double, tensor_allocator<double>>, SparsePolicy>;
+extern template class DistArray<Tensor<float, tensor_allocator<float>>,
                                 SparsePolicy>;
-extern template class DistArray<Tensor<int, Eigen::aligned_allocator<int>>,
+extern template class DistArray<Tensor<int, tensor_allocator<int>>,
                                 SparsePolicy>;
-extern template class DistArray<Tensor<long, Eigen::aligned_allocator<long>>,
+extern template class DistArray<Tensor<long, tensor_allocator<long>>,
                                 SparsePolicy>;
 //  extern template
 //  class DistArray<Tensor<std::complex<double>,
-//  Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>; extern
+//  tensor_allocator<std::complex<double> > >, SparsePolicy>; extern
 //  template class DistArray<Tensor<std::complex<float>,
-//  Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
+//  tensor_allocator<std::complex<float> > >, SparsePolicy>;
 
 #endif  // TILEDARRAY_HEADER_ONLY
 
@@ -109,8 +109,7 @@ class BinaryEvalImpl : public DistEvalImpl<typename Op::result_type, Policy>,
         left_.owner(source_index);  // Left and right
                                     // should have the same owner
 
-    const madness::DistributedID key(DistEvalImpl_::id(), i);
-    return TensorImpl_::world().gop.template recv<value_type>(source, key);
+    return DistEvalImpl_::recv_tile(source, i);
   }
 
   /// Discard a tile that is not needed
@@ -130,6 +129,7 @@ class BinaryEvalImpl : public DistEvalImpl<typename Op::result_type, Policy>,
   template <typename L, typename R, typename U = value_type>
   std::enable_if_t<!detail::is_cuda_tile_v<U>, void> eval_tile(
       const ordinal_type i, L left, R right) {
+    tracing::TileContext context(i);
     DistEvalImpl_::set_tile(i, op_(left, right));
   }
 
@@ -150,6 +150,7 @@ class BinaryEvalImpl : public DistEvalImpl<typename Op::result_type, Policy>,
   /// \param right The right-hand tile
   template <typename L, typename R>
   void eval_tile(const ordinal_type i, L left, R right) {
+    tracing::TileContext context(i);
     DistEvalImpl_::set_tile(i, op_(left, right));
   }
 #endif
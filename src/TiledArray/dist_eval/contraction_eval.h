@@ -22,11 +22,14 @@
 
 #include <vector>
 
+#include <TiledArray/chunked_bcast.h>
 #include <TiledArray/config.h>
 #include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/dist_eval/summa_depth_controller.h>
 #include <TiledArray/proc_grid.h>
 #include <TiledArray/reduce_task.h>
 #include <TiledArray/shape.h>
+#include <TiledArray/shm_bcast.h>
 #include <TiledArray/type_traits.h>
 
 #include <TiledArray/tensor/type_traits.h>
@@ -51,6 +54,15 @@ namespace detail {
 /// argument and the column phase of the right-hand argument are equal to
 /// the number of rows and columns, respectively, in the \c ProcGrid object
 /// passed to the constructor.
+/// \note If the \c ProcGrid object is replicated (i.e. it has more than one
+/// layer) the replicated (2.5D) SUMMA algorithm is used: each layer of the
+/// process grid evaluates the contributions of a contiguous slice of the
+/// inner dimension (see \c ProcGrid::layer_k_begin() ) and the partial
+/// results are reduced onto the first layer. In this case the arguments must
+/// be distributed with the process maps generated by
+/// \c ProcGrid::make_row_phase_pmap() and
+/// \c ProcGrid::make_col_phase_pmap() , which place column/row \c k of the
+/// left/right argument on the layer that evaluates \c k .
 template <typename Left, typename Right, typename Op, typename Policy>
 class Summa
     : public DistEvalImpl<typename Op::result_type, Policy>,
@@ -76,9 +88,10 @@ class Summa
   typedef Op op_type;  ///< Tile evaluation operator type
 
  private:
-  static ordinal_type max_memory_;  ///< Maximum memory used per node
+  static ordinal_type bcast_cutoff_;  ///< Tiles larger than this (in bytes)
+                                      ///< are broadcast in chunks
   static ordinal_type
-      max_depth_;  ///< Maximum number of concurrent SUMMA iterations
+      bcast_chunk_size_;  ///< Chunk size (in bytes) of chunked broadcasts
 
   // Arguments and operation
   left_type left_;    ///< The left-hand argument
@@ -89,13 +102,28 @@ class Summa
   madness::Group row_group_;  ///< The row process group for this rank
   madness::Group col_group_;  ///< The column process group for this rank
 
+  /// The intra-node transport, or null
+  std::shared_ptr<SharedMemoryTransport> shm_;
+
   // Dimension information
   const ordinal_type k_;      ///< Number of tiles in the inner dimension
   const ProcGrid proc_grid_;  ///< Process grid for this contraction
+  const ordinal_type
+      k_begin_;  ///< The first inner index evaluated by this process's layer
+  const ordinal_type
+      k_end_;  ///< The end of the inner index range evaluated by this
+               ///< process's layer (equals \c k_ for a 2D process grid)
 
   // Contraction results
   ReducePairTask<op_type>* reduce_tasks_;  ///< A pointer to the reduction tasks
 
+  // Pipeline depth control
+  std::unique_ptr<SummaDepthController>
+      depth_controller_;  ///< Run-time depth controller (null if the depth
+                          ///< is fixed)
+  ordinal_type depth_ = 0ul;  ///< The number of step tasks that exist beyond
+                              ///< the currently running step task
+
   // Constants used to iterate over columns and rows of left_ and right_,
   // respectively.
   const ordinal_type
@@ -133,45 +161,23 @@ class Summa
  private:
   // Static variable initialization ----------------------------------------
 
-  /// Initialize max_memory_ limit for SUMMA
-  static ordinal_type init_max_memory() {
-    const char* max_memory = getenv("TA_SUMMA_MAX_MEMORY");
-    if (max_memory) {
-      // Convert the string into bytes
-      std::stringstream ss(max_memory);
-      double memory = 0.0;
-      if (ss >> memory) {
-        if (memory > 0.0) {
-          std::string unit;
-          if (ss >> unit) {  // Failure == assume bytes
-            if (unit == "KB" || unit == "kB") {
-              memory *= 1000.0;
-            } else if (unit == "KiB" || unit == "kiB") {
-              memory *= 1024.0;
-            } else if (unit == "MB") {
-              memory *= 1000000.0;
-            } else if (unit == "MiB") {
-              memory *= 1048576.0;
-            } else if (unit == "GB") {
-              memory *= 1000000000.0;
-            } else if (unit == "GiB") {
-              memory *= 1073741824.0;
-            }
-          }
-        }
-      }
+  /// Initialize the chunked broadcast cutoff for SUMMA
 
-      memory = std::max(memory, 104857600.0);  // Minimum 100 MiB
-      return memory;
-    }
-
-    return 0ul;
+  /// The default cutoff is 8 MiB; a cutoff of 0 disables chunked broadcasts.
+  static ordinal_type init_bcast_cutoff() {
+    const char* bcast_cutoff = getenv("TA_SUMMA_BCAST_CUTOFF");
+    if (bcast_cutoff) return memory_size_to_bytes(bcast_cutoff);
+    return 8388608ul;  // 8 MiB
   }
 
-  static ordinal_type init_max_depth() {
-    const char* max_depth = getenv("TA_SUMMA_MAX_DEPTH");
-    if (max_depth) return std::stoul(max_depth);
-    return 0ul;
+  /// Initialize the chunk size of chunked broadcasts for SUMMA
+
+  /// The default chunk size is 1 MiB; the minimum is 64 KiB.
+  static ordinal_type init_bcast_chunk_size() {
+    const char* bcast_chunk_size = getenv("TA_SUMMA_BCAST_CHUNK_SIZE");
+    if (bcast_chunk_size)
+      return std::max(memory_size_to_bytes(bcast_chunk_size), 65536.0);
+    return 1048576ul;  // 1 MiB
   }
 
   // Process groups --------------------------------------------------------
@@ -567,18 +573,68 @@ class Summa
     get_vector(right_, begin, end, right_stride_local_, row);
   }
 
+  /// Broadcast a tile
+
+  /// When the intra-node transport is enabled and two processes of the group
+  /// run on the same node, \c TiledArray::Tensor tiles are broadcast with
+  /// \c shm_bcast() : they travel in messages only between nodes and are
+  /// copied through shared memory within each node. Otherwise, tiles larger
+  /// than \c bcast_cutoff_ bytes are broadcast in chunks (see
+  /// \c chunked_bcast() ) when the binary broadcast tree has more than one
+  /// level, i.e. the group has more than 3 processes, all other tiles with
+  /// \c madness::WorldGopInterface::bcast() .
+  /// \tparam Arg The argument type
+  /// \param[in] arg The owner of the tile
+  /// \param[in] index The index of the tile in \c arg
+  /// \param[in] key The broadcast key
+  /// \param[in,out] tile The tile to be broadcast (root), or the future that
+  /// will hold the broadcast tile
+  /// \param[in] group_root The root process of the broadcast
+  /// \param[in] group The process group where the tile will be broadcast
+  template <typename Arg>
+  void bcast_tile(const Arg& arg, const ordinal_type index,
+                  const madness::DistributedID& key,
+                  Future<typename Arg::eval_type>& tile,
+                  const ProcessID group_root,
+                  const madness::Group& group) const {
+    // The tile size is estimated from the tile range, so that all processes
+    // in the group select the same broadcast algorithm.
+    const ordinal_type bytes = arg.trange().make_tile_range(index).volume() *
+                               sizeof(numeric_t<typename Arg::eval_type>);
+    if (TensorImpl_::world().rank() == group_root)
+      tracing::instant(tracing::Event::send, bytes, index);
+    else
+      trace_arrival(tracing::Event::broadcast, tile, bytes, index);
+    if constexpr (is_shm_copyable_v<typename Arg::eval_type>) {
+      if (shm_ && shm_bcast_has_peers(*shm_, group)) {
+        shm_bcast(TensorImpl_::world(), shm_, key, tile, group_root, group,
+                  (bcast_cutoff_ && (bytes > bcast_cutoff_))
+                      ? std::size_t(bcast_chunk_size_)
+                      : std::size_t(0));
+        return;
+      }
+    }
+    if (bcast_cutoff_ && (group.size() > 3) && (bytes > bcast_cutoff_))
+      chunked_bcast(TensorImpl_::world(), key, tile, group_root, group,
+                    bcast_chunk_size_);
+    else
+      TensorImpl_::world().gop.bcast(key, tile, group_root, group);
+  }
+
   /// Broadcast tiles from \c arg
 
+  /// \param[in] arg The owner of the tiles to be broadcast
   /// \param[in] start The index of the first tile to be broadcast
   /// \param[in] stride The stride between tile indices to be broadcast
   /// \param[in] group The process group where the tiles will be broadcast
   /// \param[in] group_root The root process of the broadcast
   /// \param[in] key_offset The broadcast key offset value
   /// \param[out] vec The vector that will hold broadcast tiles
-  template <typename Datum>
-  void bcast(const ordinal_type start, const ordinal_type stride,
-             const madness::Group& group, const ProcessID group_root,
-             const ordinal_type key_offset, std::vector<Datum>& vec) const {
+  template <typename Arg, typename Datum>
+  void bcast(const Arg& arg, const ordinal_type start,
+             const ordinal_type stride, const madness::Group& group,
+             const ProcessID group_root, const ordinal_type key_offset,
+             std::vector<Datum>& vec) const {
     TA_ASSERT(vec.size() != 0ul);
     TA_ASSERT(group.size() > 0);
     TA_ASSERT(group_root < group.size());
@@ -601,7 +657,7 @@ class Summa
 
       // Broadcast the tile
       const madness::DistributedID key(DistEvalImpl_::id(), index + key_offset);
-      TensorImpl_::world().gop.bcast(key, it->second, group_root, group);
+      bcast_tile(arg, index, key, it->second, group_root, group);
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
       ss << index << " ";
@@ -623,8 +679,7 @@ class Summa
     ProcessID group_root = k % proc_grid_.proc_cols();
     if (!right_.shape().is_dense() &&
         row_group.size() < static_cast<ProcessID>(proc_grid_.proc_cols())) {
-      const ProcessID world_root =
-          proc_grid_.rank_row() * proc_grid_.proc_cols() + group_root;
+      const ProcessID world_root = proc_grid_.map_col(group_root);
       group_root = row_group.rank(world_root);
     }
     return group_root;
@@ -635,8 +690,7 @@ class Summa
     ProcessID group_root = k % proc_grid_.proc_rows();
     if (!left_.shape().is_dense() &&
         col_group.size() < static_cast<ProcessID>(proc_grid_.proc_rows())) {
-      const ProcessID world_root =
-          group_root * proc_grid_.proc_cols() + proc_grid_.rank_col();
+      const ProcessID world_root = proc_grid_.map_row(group_root);
       group_root = col_group.rank(world_root);
     }
     return group_root;
@@ -652,8 +706,8 @@ class Summa
     if (!row_group.empty()) {
       // Broadcast column k of left_.
       ProcessID group_root = get_row_group_root(k, row_group);
-      bcast(left_start_local_ + k, left_stride_local_, row_group, group_root,
-            0ul, col);
+      bcast(left_, left_start_local_ + k, left_stride_local_, row_group,
+            group_root, 0ul, col);
     }
   }
 
@@ -669,8 +723,8 @@ class Summa
       ProcessID group_root = get_col_group_root(k, col_group);
 
       // Broadcast row k of right_.
-      bcast(k * proc_grid_.cols() + proc_grid_.rank_col(), right_stride_local_,
-            col_group, group_root, left_.size(), row);
+      bcast(right_, k * proc_grid_.cols() + proc_grid_.rank_col(),
+            right_stride_local_, col_group, group_root, left_.size(), row);
     }
   }
 
@@ -706,7 +760,7 @@ class Summa
           // Broadcast the tile
           const madness::DistributedID key(DistEvalImpl_::id(), index);
           auto tile = get_tile(left_, index);
-          TensorImpl_::world().gop.bcast(key, tile, group_root, row_group);
+          bcast_tile(left_, index, key, tile, group_root, row_group);
         } else {
           // Discard the tile
           left_.discard(index);
@@ -750,7 +804,7 @@ class Summa
           const madness::DistributedID key(DistEvalImpl_::id(),
                                            index + left_.size());
           auto tile = get_tile(right_, index);
-          TensorImpl_::world().gop.bcast(key, tile, group_root, col_group);
+          bcast_tile(right_, index, key, tile, group_root, col_group);
         } else {
           // Discard the tile
           right_.discard(index);
@@ -768,12 +822,12 @@ class Summa
   /// non-zero tiles in this processes column.
   /// \param k The first row to search
   /// \return The first row, greater than or equal to \c k with non-zero
-  /// tiles, or \c k_ if none is found.
+  /// tiles, or \c k_end_ if none is found.
   ordinal_type iterate_row(ordinal_type k) const {
     // Iterate over k's until a non-zero tile is found or the end of the
-    // matrix is reached.
+    // matrix (or this layer's slice of it) is reached.
     ordinal_type end = k * proc_grid_.cols();
-    for (; k < k_; ++k) {
+    for (; k < k_end_; ++k) {
       // Search for non-zero tiles in row k of right
       ordinal_type i = end + proc_grid_.rank_col();
       end += proc_grid_.cols();
@@ -791,11 +845,11 @@ class Summa
   /// checks for non-zero tiles in this process's row.
   /// \param k The first column to test for non-zero tiles
   /// \return The first column, greater than or equal to \c k, that contains
-  /// a non-zero tile. If no non-zero tile is not found, return \c k_.
+  /// a non-zero tile. If no non-zero tile is not found, return \c k_end_.
   ordinal_type iterate_col(ordinal_type k) const {
     // Iterate over k's until a non-zero tile is found or the end of the
-    // matrix is reached.
-    for (; k < k_; ++k)
+    // matrix (or this layer's slice of it) is reached.
+    for (; k < k_end_; ++k)
       // Search row k for non-zero tiles
       for (ordinal_type i = left_start_local_ + k; i < left_end_;
            i += left_stride_local_)
@@ -865,10 +919,13 @@ class Summa
 
   /// Initialize reduce tasks and construct broadcast groups
   ordinal_type initialize(const DenseShape&) {
-    // Construct static broadcast groups for dense arguments
-    const madness::DistributedID col_did(DistEvalImpl_::id(), 0ul);
+    // Construct static broadcast groups for dense arguments (each layer of
+    // the process grid has its own groups)
+    const madness::DistributedID col_did(DistEvalImpl_::id(),
+                                         proc_grid_.layer());
     col_group_ = proc_grid_.make_col_group(col_did);
-    const madness::DistributedID row_did(DistEvalImpl_::id(), k_);
+    const madness::DistributedID row_did(DistEvalImpl_::id(),
+                                         k_ + proc_grid_.layer());
     row_group_ = proc_grid_.make_row_group(row_did);
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
@@ -891,14 +948,23 @@ class Summa
 
     // Iterate over all local tiles
     const ordinal_type n = proc_grid_.local_size();
+    const ordinal_type local_cols = proc_grid_.local_cols();
     for (ordinal_type t = 0ul; t < n; ++t) {
       // Initialize the reduction task
       ReducePairTask<op_type>* MADNESS_RESTRICT const reduce_task =
           reduce_tasks_ + t;
       new (reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
+
+      // The index of the result tile, in block-cyclic order
+      const ordinal_type index =
+          (proc_grid_.rank_row() + (t / local_cols) * proc_grid_.proc_rows()) *
+              proc_grid_.cols() +
+          proc_grid_.rank_col() + (t % local_cols) * proc_grid_.proc_cols();
+      reduce_task->trace_ordinal(DistEvalImpl_::perm_index_to_target(index));
     }
 
-    return proc_grid_.local_size();
+    // Only the first layer sets result tiles
+    return (proc_grid_.layer() == 0u ? proc_grid_.local_size() : 0ul);
   }
 
   /// Initialize reduce tasks
@@ -934,12 +1000,15 @@ class Summa
         // Initialize the reduction task
 
         // Skip zero tiles
-        if (!shape.is_zero(DistEvalImpl_::perm_index_to_target(index))) {
+        const ordinal_type perm_index =
+            DistEvalImpl_::perm_index_to_target(index);
+        if (!shape.is_zero(perm_index)) {
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
           ss << index << " ";
 #endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
 
           new (reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
+          reduce_task->trace_ordinal(perm_index);
           ++tile_count;
         } else {
           // Construct an empty task to represent zero tiles.
@@ -953,7 +1022,8 @@ class Summa
     printf(ss.str().c_str());
 #endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
 
-    return tile_count;
+    // Only the first layer sets result tiles
+    return (proc_grid_.layer() == 0u ? tile_count : 0ul);
   }
 
   ordinal_type initialize() {
@@ -972,6 +1042,83 @@ class Summa
 
   // Finalize functions ----------------------------------------------------
 
+  /// Reduce the partial results of two process grid layers
+
+  /// \param left The partial result tile of one layer
+  /// \param right The partial result tile of another layer
+  /// \return The sum of \c left and \c right
+  value_type reduce_layers(const value_type& left,
+                           const value_type& right) const {
+    using TiledArray::empty;
+    if (empty(right)) return left;
+    if (empty(left)) return right;
+
+    tracing::Scope scope(tracing::Event::reduce, 0, 0);
+    value_type result = left;
+    op_(result, right);
+    return result;
+  }
+
+  /// The key of the partial result of a layer
+
+  /// The keys follow the broadcast keys of \c left_ and \c right_ tiles,
+  /// which are in <tt>[0, left_.size() + right_.size())</tt>, so that
+  /// partial results are never matched with broadcast tiles.
+  /// \param layer The layer that computed the partial result (> 0)
+  /// \param index The (unpermuted) index of the result tile
+  /// \param size The number of result tiles
+  /// \return The key of the partial result
+  ordinal_type layer_key(const ordinal_type layer, const ordinal_type index,
+                         const ordinal_type size) const {
+    TA_ASSERT(layer > 0ul);
+    return left_.size() + right_.size() + (layer - 1ul) * size + index;
+  }
+
+  /// Set a result tile
+
+  /// For a 2D process grid the result of \c reduce_task is the result tile.
+  /// For a replicated process grid \c reduce_task only holds the
+  /// contributions of this layer's inner index slice; the partial results
+  /// of all layers are reduced onto the first layer, which sets the tile.
+  /// \param index The (unpermuted) index of the result tile
+  /// \param perm_index The permuted index of the result tile
+  /// \param reduce_task The reduction task for the result tile
+  void set_result_tile(const ordinal_type index, const ordinal_type perm_index,
+                       ReducePairTask<op_type>& reduce_task) {
+    if (proc_grid_.layers() == 1u) {
+      DistEvalImpl_::set_tile(perm_index, reduce_task.submit());
+      return;
+    }
+
+    // A layer may not contribute to a result tile of a sparse contraction
+    Future<value_type> partial =
+        (reduce_task.count() > 0 ? reduce_task.submit()
+                                 : Future<value_type>(value_type()));
+
+    World& world = TensorImpl_::world();
+    const ordinal_type size = TensorImpl_::size();
+    const ProcessID layer_size = proc_grid_.proc_size();
+    if (proc_grid_.layer() != 0u) {
+      // Send the partial result to the matching process of the first layer
+      const madness::DistributedID key(
+          DistEvalImpl_::id(), layer_key(proc_grid_.layer(), index, size));
+      world.gop.send(world.rank() - proc_grid_.layer_offset(), key, partial);
+    } else {
+      // Accumulate the partial results of the other layers
+      for (ordinal_type layer = 1ul; layer < proc_grid_.layers(); ++layer) {
+        const madness::DistributedID key(DistEvalImpl_::id(),
+                                         layer_key(layer, index, size));
+        partial = world.taskq.add(
+            shared_from_this(), &Summa_::reduce_layers, partial,
+            world.gop.template recv<value_type>(
+                layer * layer_size + world.rank(), key),
+            madness::TaskAttributes::hipri());
+      }
+
+      DistEvalImpl_::set_tile(perm_index, partial);
+    }
+  }
+
   /// Set the result tiles, destroy reduce tasks, and destroy broadcast groups
   void finalize(const DenseShape&) {
     // Initialize iteration variables
@@ -990,8 +1137,8 @@ class Summa
       for (ordinal_type index = row_start; index < row_end;
            index += row_stride, ++reduce_task) {
         // Set the result tile
-        DistEvalImpl_::set_tile(DistEvalImpl_::perm_index_to_target(index),
-                                reduce_task->submit());
+        set_result_tile(index, DistEvalImpl_::perm_index_to_target(index),
+                        *reduce_task);
 
         // Destroy the reduce task
         reduce_task->~ReducePairTask<op_type>();
@@ -1037,7 +1184,7 @@ class Summa
 #endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
 
           // Set the result tile
-          DistEvalImpl_::set_tile(perm_index, reduce_task->submit());
+          set_result_tile(index, perm_index, *reduce_task);
         }
 
         // Destroy the reduce task
@@ -1084,6 +1231,83 @@ class Summa
 
   };  // class FinalizeTask
 
+  /// Task that measures the timings of a SUMMA iteration
+
+  /// The tile contractions of an iteration release a dependency of this task
+  /// instead of that of the step task that is controlled by the iteration.
+  /// This task records the time at which all tiles of the iteration have
+  /// been received, and, when it runs, the time at which all contractions
+  /// have been completed. It reports both to the depth controller, and then
+  /// releases its dependency of the controlled step task.
+  class StepMonitor : public madness::TaskInterface {
+   private:
+    /// Callback that records the arrival of the tiles of the iteration
+    class DataCallback : public madness::CallbackInterface {
+     private:
+      StepMonitor* const monitor_;  ///< The monitor of the iteration
+      madness::AtomicInt count_;    ///< The number of pending tiles + 1
+
+     public:
+      DataCallback(StepMonitor* const monitor) : monitor_(monitor) {
+        count_ = 1;
+      }
+
+      virtual ~DataCallback() {}
+
+      /// Register this callback with a tile future
+      template <typename T>
+      void register_future(Future<T> tile) {
+        count_++;
+        tile.register_callback(this);
+      }
+
+      virtual void notify() {
+        if (count_.dec_and_test()) {
+          monitor_->data_time_ = madness::wall_time();
+          monitor_->notify();
+        }
+      }
+    };  // class DataCallback
+
+    std::shared_ptr<Summa_> owner_;       ///< The parent object for this task
+    madness::TaskInterface* const task_;  ///< The controlled step task
+    const double start_time_;             ///< The start time of the iteration
+    double data_time_;  ///< The time at which all tiles were received
+    DataCallback data_callback_;  ///< Records the arrival of the tiles
+
+   public:
+    /// Constructor
+
+    /// \param owner The parent object for this task
+    /// \param col The column of left-hand argument tiles of the iteration
+    /// \param row The row of right-hand argument tiles of the iteration
+    /// \param task The step task that depends on the contractions of the
+    /// iteration
+    StepMonitor(const std::shared_ptr<Summa_>& owner,
+                const std::vector<col_datum>& col,
+                const std::vector<row_datum>& row,
+                madness::TaskInterface* const task)
+        : madness::TaskInterface(1, madness::TaskAttributes::hipri()),
+          owner_(owner),
+          task_(task),
+          start_time_(madness::wall_time()),
+          data_time_(start_time_),
+          data_callback_(this) {
+      for (const auto& datum : col) data_callback_.register_future(datum.second);
+      for (const auto& datum : row) data_callback_.register_future(datum.second);
+      data_callback_.notify();
+    }
+
+    virtual ~StepMonitor() {}
+
+    virtual void run(const madness::TaskThreadEnv&) {
+      owner_->depth_controller_->record(data_time_ - start_time_,
+                                        madness::wall_time() - data_time_);
+      task_->notify();
+    }
+
+  };  // class StepMonitor
+
   // Contraction functions -------------------------------------------------
 
   /// Schedule local contraction tasks for \c col and \c row tile pairs
@@ -1315,7 +1539,9 @@ class Summa
     void make_next_step_tasks(Derived* task, ordinal_type depth) {
       TA_ASSERT(depth > 0);
       // Set the depth to be no greater than the maximum number steps
-      if (depth > owner_->k_) depth = owner_->k_;
+      const ordinal_type nsteps = owner_->k_end_ - owner_->k_begin_;
+      if (depth > nsteps) depth = nsteps;
+      owner_->depth_ = depth;
 
       // Spawn n=depth step tasks
       for (; depth > 0ul; --depth) {
@@ -1336,12 +1562,24 @@ class Summa
       printf("step:  start rank=%i k=%lu\n", owner_->world().rank(), k);
 #endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
 
-      if (k < owner_->k_) {
-        // Initialize next tail task and submit next task
+      if (k < owner_->k_end_) {
+        // Get the number of tail tasks to append: 1 keeps the depth of the
+        // pipeline constant, 0 shrinks and 2 grows it by one step.
+        const unsigned int num_tail_tasks =
+            (owner_->depth_controller_
+                 ? owner_->depth_controller_->next(owner_->depth_)
+                 : 1u);
+        TA_ASSERT(num_tail_tasks > 0u || owner_->depth_ > 1ul);
+        owner_->depth_ = owner_->depth_ + num_tail_tasks - 1ul;
+
+        // Initialize the next tail tasks and submit next task
         TA_ASSERT(next_step_task_);
-        next_step_task_->tail_step_task_ = new Derived(
-            static_cast<Derived*>(tail_step_task_),
-            1);  // <- ndep=1, will control its scheduling by this task
+        StepTask* tail_step_task = tail_step_task_;
+        for (unsigned int i = 0u; i < num_tail_tasks; ++i)
+          tail_step_task = new Derived(
+              static_cast<Derived*>(tail_step_task),
+              1);  // <- ndep=1, will control its scheduling by this task
+        next_step_task_->tail_step_task_ = tail_step_task;
         // submit next step task ... even if it's same as tail_step_task_ it is
         // safe to submit because its ndep > 0 (see
         // StepTask::make_next_step_tasks)
@@ -1356,14 +1594,29 @@ class Summa
                          madness::TaskAttributes::hipri());
 
         // Submit tasks for the contraction of col and row tiles.
-        owner_->contract(k, col_, row_, tail_step_task_);
+        if (owner_->depth_controller_) {
+          // Measure the timings of this step
+          tail_step_task_->inc();
+          StepMonitor* const monitor =
+              new StepMonitor(owner_, col_, row_, tail_step_task_);
+          owner_->contract(k, col_, row_, monitor);
+          world_.taskq.add(monitor);
+        } else {
+          owner_->contract(k, col_, row_, tail_step_task_);
+        }
 
-        // Notify task dependencies
+        // Notify task dependencies of the old tail task and of the new tail
+        // tasks that are followed by another task
         TA_ASSERT(tail_step_task_);
-        if (trace_tasks)
-          tail_step_task_->notify_debug("StepTask nth ctor");
-        else
-          tail_step_task_->notify();
+        tail_step_task = tail_step_task_;
+        for (unsigned int i = 0u; i < num_tail_tasks; ++i) {
+          StepTask* const next_tail_step_task = tail_step_task->next_step_task_;
+          if (trace_tasks)
+            tail_step_task->notify_debug("StepTask nth ctor");
+          else
+            tail_step_task->notify();
+          tail_step_task = next_tail_step_task;
+        }
         finalize_task_->notify();
 
       } else if (finalize_task_) {
@@ -1402,7 +1655,8 @@ class Summa
    public:
     DenseStepTask(const std::shared_ptr<Summa_>& owner,
                   const ordinal_type depth)
-        : StepTask(owner, owner->k_ + 1ul), k_(0) {
+        : StepTask(owner, owner->k_end_ - owner->k_begin_ + 1ul),
+          k_(owner->k_begin_) {
       StepTask::make_next_step_tasks(this, depth);
       StepTask::spawn_get_row_col_tasks(k_);
     }
@@ -1410,7 +1664,7 @@ class Summa
     DenseStepTask(DenseStepTask* const parent, const int ndep)
         : StepTask(parent, ndep), k_(parent->k_ + 1ul) {
       // Spawn tasks to get k-th row and column tiles
-      if (k_ < owner_->k_) StepTask::spawn_get_row_col_tasks(k_);
+      if (k_ < owner_->k_end_) StepTask::spawn_get_row_col_tasks(k_);
     }
 
     virtual ~DenseStepTask() {}
@@ -1438,7 +1692,7 @@ class Summa
       k = owner_->iterate_sparse(k + offset);
       k_.set(k);
 
-      if (k < owner_->k_) {
+      if (k < owner_->k_end_) {
         // NOTE: The order of task submissions is dependent on the order in
         // which we want the tasks to complete.
 
@@ -1473,13 +1727,13 @@ class Summa
         madness::DependencyInterface::inc_debug("SparseStepTask ctor");
       else
         madness::DependencyInterface::inc();
-      world_.taskq.add(this, &SparseStepTask::iterate_task, 0ul, 0ul,
-                       madness::TaskAttributes::hipri());
+      world_.taskq.add(this, &SparseStepTask::iterate_task, owner->k_begin_,
+                       0ul, madness::TaskAttributes::hipri());
     }
 
     SparseStepTask(SparseStepTask* const parent, const int ndep)
         : StepTask(parent, ndep) {
-      if (parent->k_.probe() && (parent->k_.get() >= owner_->k_)) {
+      if (parent->k_.probe() && (parent->k_.get() >= owner_->k_end_)) {
         // Avoid running extra tasks if not needed.
         k_.set(parent->k_.get());
         TA_ASSERT(ndep ==
@@ -1531,8 +1785,11 @@ class Summa
         op_(op),
         row_group_(),
         col_group_(),
+        shm_(SharedMemoryTransport::instance(world)),
         k_(k),
         proc_grid_(proc_grid),
+        k_begin_(proc_grid.layer_k_begin(k)),
+        k_end_(proc_grid.layer_k_end(k)),
         reduce_tasks_(NULL),
         left_start_local_(proc_grid_.rank_row() * k),
         left_end_(left.size()),
@@ -1564,8 +1821,7 @@ class Summa
     // Compute the process that owns tile
     const ProcessID source = proc_row * proc_grid_.proc_cols() + proc_col;
 
-    const madness::DistributedID key(DistEvalImpl_::id(), i);
-    return TensorImpl_::world().gop.template recv<value_type>(source, key);
+    return DistEvalImpl_::recv_tile(source, i);
   }
 
   /// Discard a tile that is not needed
@@ -1576,6 +1832,29 @@ class Summa
   virtual void discard_tile(ordinal_type i) const { get_tile(i); }
 
  private:
+  /// Estimate the memory used by the tiles of one iteration
+
+  /// \param left_sparsity The fraction of zero tiles in the left-hand matrix
+  /// \param right_sparsity The fraction of zero tiles in the right-hand matrix
+  /// \return The average memory, in bytes, used by the tiles of one
+  /// iteration on this process
+  std::size_t step_memory(const float left_sparsity,
+                          const float right_sparsity) const {
+    // Compute the average memory requirement per iteration of this process
+    const std::size_t local_memory_per_iter_left =
+        (left_.trange().elements_range().volume() /
+         left_.trange().tiles_range().volume()) *
+        sizeof(typename numeric_type<typename left_type::eval_type>::type) *
+        proc_grid_.local_rows() * (1.0f - left_sparsity);
+    const std::size_t local_memory_per_iter_right =
+        (right_.trange().elements_range().volume() /
+         right_.trange().tiles_range().volume()) *
+        sizeof(typename numeric_type<typename right_type::eval_type>::type) *
+        proc_grid_.local_cols() * (1.0f - right_sparsity);
+
+    return local_memory_per_iter_left + local_memory_per_iter_right;
+  }
+
   /// Adjust iteration depth based on memory constraints
 
   /// \param depth The unbounded iteration depth
@@ -1587,24 +1866,13 @@ class Summa
   ordinal_type mem_bound_depth(ordinal_type depth, const float left_sparsity,
                                const float right_sparsity) {
     // Check if a memory bound has been set
-    const ordinal_type available_memory = max_memory_;
+    const ordinal_type available_memory = summa_depth_config().max_memory;
     if (available_memory) {
-      // Compute the average memory requirement per iteration of this process
-      const std::size_t local_memory_per_iter_left =
-          (left_.trange().elements_range().volume() /
-           left_.trange().tiles_range().volume()) *
-          sizeof(typename numeric_type<typename left_type::eval_type>::type) *
-          proc_grid_.local_rows() * (1.0f - left_sparsity);
-      const std::size_t local_memory_per_iter_right =
-          (right_.trange().elements_range().volume() /
-           right_.trange().tiles_range().volume()) *
-          sizeof(typename numeric_type<typename right_type::eval_type>::type) *
-          proc_grid_.local_cols() * (1.0f - right_sparsity);
-
       // Compute the maximum number of iterations based on available memory
       const ordinal_type mem_bound_depth =
-          ((local_memory_per_iter_left + local_memory_per_iter_right) /
-           available_memory);
+          available_memory /
+          std::max<std::size_t>(step_memory(left_sparsity, right_sparsity),
+                                1ul);
 
       // Check if the memory bounded depth is less than the optimal depth
       if (depth > mem_bound_depth) {
@@ -1666,15 +1934,22 @@ class Summa
       // Construct the first SUMMA iteration task
       if (TensorImpl_::shape().is_dense()) {
         // We cannot have more iterations than there are blocks in the k
-        // dimension
-        if (depth > k_) depth = k_;
+        // dimension (slice)
+        if (depth > k_end_ - k_begin_) depth = k_end_ - k_begin_;
 
         // Modify the number of concurrent iterations based on the available
         // memory.
         depth = mem_bound_depth(depth, 0.0f, 0.0f);
 
         // Enforce user defined depth bound
-        if (max_depth_) depth = std::min(depth, max_depth_);
+        const SummaDepthConfig& config = summa_depth_config();
+        if (config.max_depth)
+          depth = std::min<ordinal_type>(depth, config.max_depth);
+
+        // Construct the run-time depth controller
+        if (config.adaptive)
+          depth_controller_ = std::make_unique<SummaDepthController>(
+              config, step_memory(0.0f, 0.0f));
 
         TensorImpl_::world().taskq.add(
             new DenseStepTask(shared_from_this(), depth));
@@ -1695,15 +1970,22 @@ class Summa
             float(depth) * (1.0f - 1.35638f * std::log2(frac_non_zero)) + 0.5f;
 
         // We cannot have more iterations than there are blocks in the k
-        // dimension
-        if (depth > k_) depth = k_;
+        // dimension (slice)
+        if (depth > k_end_ - k_begin_) depth = k_end_ - k_begin_;
 
         // Modify the number of concurrent iterations based on the available
         // memory and sparsity of the argument tensors.
         depth = mem_bound_depth(depth, left_sparsity, right_sparsity);
 
         // Enforce user defined depth bound
-        if (max_depth_) depth = std::min(depth, max_depth_);
+        const SummaDepthConfig& config = summa_depth_config();
+        if (config.max_depth)
+          depth = std::min<ordinal_type>(depth, config.max_depth);
+
+        // Construct the run-time depth controller
+        if (config.adaptive)
+          depth_controller_ = std::make_unique<SummaDepthController>(
+              config, step_memory(left_sparsity, right_sparsity));
 
         TensorImpl_::world().taskq.add(
             new SparseStepTask(shared_from_this(), depth));
@@ -1732,13 +2014,13 @@ class Summa
 
 template <typename Left, typename Right, typename Op, typename Policy>
 typename Summa<Left, Right, Op, Policy>::ordinal_type
-    Summa<Left, Right, Op, Policy>::max_depth_ =
-        Summa<Left, Right, Op, Policy>::init_max_depth();
+    Summa<Left, Right, Op, Policy>::bcast_cutoff_ =
+        Summa<Left, Right, Op, Policy>::init_bcast_cutoff();
 
 template <typename Left, typename Right, typename Op, typename Policy>
 typename Summa<Left, Right, Op, Policy>::ordinal_type
-    Summa<Left, Right, Op, Policy>::max_memory_ =
-        Summa<Left, Right, Op, Policy>::init_max_memory();
+    Summa<Left, Right, Op, Policy>::bcast_chunk_size_ =
+        Summa<Left, Right, Op, Policy>::init_bcast_chunk_size();
 }  // namespace detail
 }  // namespace TiledArray
 
@@ -25,6 +25,7 @@
 #include <TiledArray/permutation.h>
 #include <TiledArray/tensor_impl.h>
 #include <TiledArray/type_traits.h>
+#include <TiledArray/util/tracing.h>
 #ifdef TILEDARRAY_HAS_CUDA
 #include <TiledArray/cuda/cuda_task_fn.h>
 #include <TiledArray/external/cuda.h>
@@ -33,6 +34,40 @@
 namespace TiledArray {
 namespace detail {
 
+/// Record the wait for a tile, from now until its future is set
+
+/// Does nothing if tracing is disabled.
+/// \tparam T The tile type
+/// \param event The traced event, \c tracing::Event::broadcast or
+/// \c tracing::Event::receive
+/// \param f The future of the tile
+/// \param bytes The size of the tile in bytes
+/// \param ordinal The tile ordinal
+template <typename T>
+void trace_arrival(const tracing::Event event, Future<T>& f,
+                   const std::uint64_t bytes, const std::uint64_t ordinal) {
+  if (!tracing::enabled()) return;
+
+  class Arrival : public madness::CallbackInterface {
+    tracing::Event event_;
+    time_point start_;
+    std::uint64_t bytes_;
+    std::uint64_t ordinal_;
+
+   public:
+    Arrival(const tracing::Event event, const std::uint64_t bytes,
+            const std::uint64_t ordinal)
+        : event_(event), start_(now()), bytes_(bytes), ordinal_(ordinal) {}
+
+    virtual void notify() {
+      tracing::record(event_, start_, now(), ordinal_, bytes_, 0);
+      delete this;
+    }
+  };  // class Arrival
+
+  f.register_callback(new Arrival(event, bytes, ordinal));
+}
+
 /// Distributed evaluator implementation object
 
 /// This class is used as the base class for other distributed evaluation
@@ -154,7 +189,10 @@ class DistEvalImpl : public TensorImpl<Policy>,
   void set_tile(ordinal_type i, const value_type& value) {
     // Store value
     madness::DistributedID id(id_, i);
-    TensorImpl_::world().gop.send(TensorImpl_::owner(i), id, value);
+    const ProcessID owner = TensorImpl_::owner(i);
+    if (tracing::enabled() && (owner != TensorImpl_::world().rank()))
+      tracing::instant(tracing::Event::send, tile_bytes(i), i);
+    TensorImpl_::world().gop.send(owner, id, value);
 
     // Record the assignment of a tile
     DistEvalImpl_::notify();
@@ -178,6 +216,29 @@ class DistEvalImpl : public TensorImpl<Policy>,
   /// Tile set notification
   virtual void notify() { set_counter_++; }
 
+  /// \param i The index of a tile
+  /// \return The estimated size of tile \c i in bytes, for tracing
+  std::uint64_t tile_bytes(const ordinal_type i) const {
+    return TensorImpl_::trange().make_tile_range(i).volume() *
+           sizeof(numeric_t<value_type>);
+  }
+
+  /// Receive a tile that is set with \c set_tile()
+
+  /// The wait for tiles sent by other processes is traced.
+  /// \param source The process that sets the tile
+  /// \param i The index of the tile
+  /// \return The future of tile \c i
+  Future<value_type> recv_tile(const ProcessID source,
+                               const ordinal_type i) const {
+    const madness::DistributedID key(id_, i);
+    Future<value_type> result =
+        TensorImpl_::world().gop.template recv<value_type>(source, key);
+    if (source != TensorImpl_::world().rank())
+      trace_arrival(tracing::Event::receive, result, tile_bytes(i), i);
+    return result;
+  }
+
   /// Wait for all tiles to be assigned
   void wait() const {
     const int task_count = task_count_;
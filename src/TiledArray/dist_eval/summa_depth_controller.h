@@ -0,0 +1,204 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  summa_depth_controller.h
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_DEPTH_CONTROLLER_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_DEPTH_CONTROLLER_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/util/env.h>
+#include <TiledArray/util/memory_size.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+namespace TiledArray {
+
+/// SUMMA pipeline depth parameters
+
+/// The depth of the SUMMA pipeline is the number of inner-dimension
+/// iterations whose tiles are gathered and broadcast concurrently. The
+/// initial depth is computed from the process grid, sparsity of the
+/// arguments, and \c max_memory . If \c adaptive is \c true the depth is
+/// adjusted while the contraction is evaluated: every \c window iterations
+/// the fraction of time that iterations spent waiting for broadcast tiles,
+/// relative to the time spent contracting them, is compared with
+/// \c grow_ratio and \c shrink_ratio ; the depth is increased when
+/// communication dominates and decreased when it does not, or when the
+/// estimated memory held by the in-flight iterations exceeds \c max_memory .
+///
+/// The default values are read from the environment:
+/// \c TA_SUMMA_MAX_DEPTH , \c TA_SUMMA_MAX_MEMORY (e.g. "2 GiB"),
+/// \c TA_SUMMA_ADAPTIVE_DEPTH (0 or 1), \c TA_SUMMA_MIN_DEPTH ,
+/// \c TA_SUMMA_DEPTH_WINDOW , \c TA_SUMMA_DEPTH_GROW_RATIO , and
+/// \c TA_SUMMA_DEPTH_SHRINK_RATIO .
+struct SummaDepthConfig {
+  std::size_t max_depth = 0ul;   ///< Maximum depth (0 = unbounded)
+  std::size_t max_memory = 0ul;  ///< Memory available to the pipeline of each
+                                 ///< process in bytes (0 = unbounded)
+  bool adaptive = false;         ///< Adjust the depth at run time
+  std::size_t min_depth = 1ul;   ///< Minimum depth of an adaptive pipeline
+  std::size_t window = 4ul;  ///< Number of iterations between adjustments
+  double grow_ratio = 0.25;  ///< Grow the depth when the broadcast wait
+                             ///< fraction is above this value
+  double shrink_ratio = 0.05;  ///< Shrink the depth when the broadcast wait
+                               ///< fraction is below this value
+
+  /// Construct a configuration from the environment
+
+  /// \return The configuration defined by the \c TA_SUMMA_* environment
+  /// variables, with defaults for unset variables
+  static SummaDepthConfig from_env() {
+    SummaDepthConfig config;
+    config.max_depth =
+        detail::getenv_number("TA_SUMMA_MAX_DEPTH", config.max_depth);
+    if (const char* str = std::getenv("TA_SUMMA_MAX_MEMORY")) {
+      // Minimum 100 MiB
+      config.max_memory =
+          std::max(detail::memory_size_to_bytes(str), 104857600.0);
+    }
+    config.adaptive = (detail::getenv_number("TA_SUMMA_ADAPTIVE_DEPTH",
+                                             int(config.adaptive)) != 0);
+    config.min_depth = std::max(
+        detail::getenv_number("TA_SUMMA_MIN_DEPTH", config.min_depth), 1ul);
+    config.window = std::max(
+        detail::getenv_number("TA_SUMMA_DEPTH_WINDOW", config.window), 1ul);
+    config.grow_ratio =
+        detail::getenv_number("TA_SUMMA_DEPTH_GROW_RATIO", config.grow_ratio);
+    config.shrink_ratio = detail::getenv_number("TA_SUMMA_DEPTH_SHRINK_RATIO",
+                                                config.shrink_ratio);
+    return config;
+  }
+};  // struct SummaDepthConfig
+
+namespace detail {
+
+/// Global SUMMA depth configuration accessor
+inline SummaDepthConfig& summa_depth_config_accessor() {
+  static SummaDepthConfig config = SummaDepthConfig::from_env();
+  return config;
+}
+
+}  // namespace detail
+
+/// SUMMA depth configuration accessor
+
+/// \return The configuration used by contractions
+inline const SummaDepthConfig& summa_depth_config() {
+  return detail::summa_depth_config_accessor();
+}
+
+/// Set the SUMMA depth configuration
+
+/// The new configuration is used by contractions that are evaluated after
+/// this call; it must not be called while a contraction is being evaluated.
+/// \param config The new configuration
+/// \throw TiledArray::Exception When <tt>config.min_depth == 0</tt> or
+/// <tt>config.window == 0</tt>
+inline void set_summa_depth_config(const SummaDepthConfig& config) {
+  TA_ASSERT(config.min_depth > 0ul);
+  TA_ASSERT(config.window > 0ul);
+  detail::summa_depth_config_accessor() = config;
+}
+
+namespace detail {
+
+/// Run-time controller of the SUMMA pipeline depth
+
+/// The SUMMA iterations report the time they waited for broadcast tiles and
+/// the time it took to contract the tiles with \c record() , which may be
+/// called concurrently. Each time an iteration starts it asks \c next() how
+/// many iterations to append to the pipeline: 0 (shrink), 1 (keep), or 2
+/// (grow).
+class SummaDepthController {
+ private:
+  const SummaDepthConfig config_;  ///< Control parameters
+  const std::size_t step_memory_;  ///< Estimated memory per iteration
+  std::mutex mutex_;               ///< Protects the measurements
+  double wait_time_ = 0.0;  ///< Sum of broadcast wait times in the window
+  double contract_time_ = 0.0;  ///< Sum of contraction times in the window
+  std::size_t count_ = 0ul;     ///< Number of measurements in the window
+
+ public:
+  /// Constructor
+
+  /// \param config The control parameters
+  /// \param step_memory The estimated memory used by the tiles of one
+  /// iteration on this process in bytes
+  SummaDepthController(const SummaDepthConfig& config,
+                       const std::size_t step_memory)
+      : config_(config), step_memory_(step_memory) {}
+
+  SummaDepthController(const SummaDepthController&) = delete;
+  SummaDepthController& operator=(const SummaDepthController&) = delete;
+
+  /// Record the timings of an iteration
+
+  /// \param wait_time The time from the start of the iteration until all of
+  /// its tiles were received
+  /// \param contract_time The time from the receipt of the tiles until all
+  /// of their contractions were completed
+  void record(const double wait_time, const double contract_time) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wait_time_ += wait_time;
+    contract_time_ += contract_time;
+    ++count_;
+  }
+
+  /// Compute the number of iterations to append to the pipeline
+
+  /// \param depth The number of iterations in the pipeline
+  /// \return The number of iterations that the starting iteration should
+  /// append to the pipeline: 0, 1, or 2
+  unsigned int next(const std::size_t depth) {
+    const bool can_shrink = (depth > std::max(config_.min_depth, 1ul));
+    const bool can_grow =
+        ((config_.max_depth == 0ul) || (depth < config_.max_depth)) &&
+        ((config_.max_memory == 0ul) ||
+         ((depth + 1ul) * step_memory_ <= config_.max_memory));
+
+    // Memory constraints are enforced immediately
+    if (can_shrink && config_.max_memory &&
+        (depth * step_memory_ > config_.max_memory))
+      return 0u;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count_ < config_.window) return 1u;
+
+    const double total_time = wait_time_ + contract_time_;
+    const double wait_fraction =
+        (total_time > 0.0 ? wait_time_ / total_time : 0.0);
+    wait_time_ = 0.0;
+    contract_time_ = 0.0;
+    count_ = 0ul;
+
+    if (can_grow && (wait_fraction > config_.grow_ratio)) return 2u;
+    if (can_shrink && (wait_fraction < config_.shrink_ratio)) return 0u;
+    return 1u;
+  }
+
+};  // class SummaDepthController
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_DIST_EVAL_SUMMA_DEPTH_CONTROLLER_H__INCLUDED
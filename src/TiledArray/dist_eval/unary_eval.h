@@ -89,8 +89,7 @@ class UnaryEvalImpl
     TA_ASSERT(TensorImpl_::is_local(i));
     TA_ASSERT(!TensorImpl_::is_zero(i));
     const auto source = arg_.owner(DistEvalImpl_::perm_index_to_source(i));
-    const madness::DistributedID key(DistEvalImpl_::id(), i);
-    return TensorImpl_::world().gop.template recv<value_type>(source, key);
+    return DistEvalImpl_::recv_tile(source, i);
   }
 
   /// Discard a tile that is not needed
@@ -128,12 +127,14 @@ class UnaryEvalImpl
   template <typename U = value_type>
   std::enable_if_t<!detail::is_cuda_tile_v<U>, void> eval_tile(
       const ordinal_type i, tile_argument_type tile) {
+    tracing::TileContext context(i);
     DistEvalImpl_::set_tile(i, op_(tile));
   }
 #else
   /// \param i The tile index
   /// \param tile The tile to be evaluated
   void eval_tile(const ordinal_type i, tile_argument_type tile) {
+    tracing::TileContext context(i);
     DistEvalImpl_::set_tile(i, op_(tile));
   }
 #endif
@@ -21,6 +21,14 @@
 #define TILEDARRAY_DISTRIBUTED_STORAGE_H__INCLUDED
 
 #include <TiledArray/pmap/pmap.h>
+#include <TiledArray/shared_memory.h>
+#include <TiledArray/tensor/type_traits.h>
+#include <TiledArray/tile_spill.h>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace TiledArray {
 namespace detail {
@@ -40,6 +48,23 @@ namespace detail {
 /// can easily be achieved by only constructing world objects in the main
 /// thread. DO NOT construct world objects within tasks where the order of
 /// execution is nondeterministic.
+/// \note When tile spilling is enabled (see \c SpillConfig ), local elements
+/// that have been set count against the memory budget of this process. The
+/// least recently used elements may then be serialized to a node-local file
+/// and released; they are read back transparently by \c get_local() and
+/// \c get() . Since elements are immutable, an element is written to disk
+/// at most once. \c get() returns a copy of the future of an element, which
+/// remains valid when the element is spilled. \c get_local() returns a
+/// reference into the container, so an element accessed with it is pinned:
+/// it is not spilled again until this object is destroyed.
+/// \note When the intra-node transport is enabled (see
+/// \c SharedMemoryConfig ), \c TiledArray::Tensor elements requested with
+/// \c get() by another process of the same node are copied into the
+/// shared-memory segment of the owner and copied out by the requester,
+/// without serialization; the reply message only carries the location of
+/// the copy. Each copy is made for one request and its block is reclaimed
+/// once the requester has read it; when the segment is full, elements are
+/// sent as usual.
 template <typename T>
 class DistributedStorage : public madness::WorldObject<DistributedStorage<T> > {
  public:
@@ -67,26 +92,294 @@ class DistributedStorage : public madness::WorldObject<DistributedStorage<T> > {
   mutable container_type data_;     ///< The local data container
   madness::AtomicInt num_live_ds_;  ///< Number of live DelayedSet objects
 
+  /// Elements that can be copied through shared memory
+  static constexpr bool is_shm_copyable = is_shm_copyable_v<value_type>;
+
+  /// The intra-node transport, or null
+  std::shared_ptr<SharedMemoryTransport> shm_;
+
+  /// Spills the local elements of this container to disk
+  class Spiller : public TileSpillManager::Client,
+                  public std::enable_shared_from_this<Spiller> {
+   private:
+    std::mutex mutex_;  ///< Protects storage_ and pinned_
+    DistributedStorage_* storage_;  ///< The owning container
+    const std::string directory_;   ///< The directory of the spill file
+    std::unique_ptr<SpillFile> file_;  ///< The spill file
+    std::mutex extents_mutex_;         ///< Protects file_ and extents_
+    std::unordered_map<key_type, std::pair<std::size_t, std::size_t>>
+        extents_;  ///< Offset and size of the spilled elements in file_
+    std::unordered_set<key_type> pinned_;  ///< Elements that are not spilled
+
+   public:
+    Spiller(DistributedStorage_& storage, const std::string& directory)
+        : storage_(&storage), directory_(directory) {}
+
+    /// Detach from the owning container, which is about to be destroyed
+    void detach() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      storage_ = nullptr;
+    }
+
+    /// Never spill an element
+
+    /// The future of a pinned element is never reassigned, so references to
+    /// it remain valid. An element that is being spilled when this is called
+    /// is spilled before this returns, and must be restored by the caller.
+    /// \param key The element key
+    void pin(const key_type key) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pinned_.insert(key);
+    }
+
+    /// Register a local element that has been set with the spill manager
+
+    /// \param key The element key
+    /// \param f The future of element \c key
+    void track(const key_type key, const future& f) {
+      TA_ASSERT(f.probe());
+      TileSpillManager::instance().insert(this->shared_from_this(), key,
+                                          bytes(f.get()));
+    }
+
+    /// The size of an element
+
+    /// The size of a \c TiledArray::Tensor of numeric elements is computed
+    /// from its range; other elements are serialized to count their bytes.
+    /// \param value An element
+    /// \return The size of \c value in bytes
+    static std::size_t bytes(const value_type& value) {
+      if constexpr (is_ta_tensor_v<value_type>) {
+        if constexpr (is_numeric_v<typename value_type::value_type>) {
+          // The data, and the lower bound, upper bound, extent, and stride of
+          // each dimension of the range
+          using index1_type = typename value_type::range_type::index1_type;
+          return value.size() * sizeof(typename value_type::value_type) +
+                 4ul * value.range().rank() * sizeof(index1_type);
+        }
+      }
+      madness::archive::BufferOutputArchive count;
+      count& value;
+      return count.size();
+    }
+
+    /// Register a local element with the spill manager when it is set
+
+    /// \param key The element key
+    /// \param f The future of element \c key
+    void track_when_set(const key_type key, const future& f) {
+      if (f.probe())
+        track(key, f);
+      else
+        const_cast<future&>(f).register_callback(
+            new DelayedTrack(this->shared_from_this(), key, f));
+    }
+
+    /// Move an element to disk and release it
+
+    /// \param key The element key
+    virtual void spill(const std::size_t key) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!storage_ || pinned_.count(key)) return;
+
+      accessor acc;
+      if (!storage_->data_.find(acc, key)) return;
+      future& f = acc->second;
+      if (!f.probe()) return;
+
+      std::lock_guard<std::mutex> extents_lock(extents_mutex_);
+      if (extents_.find(key) == extents_.end()) {
+        // Serialize the element
+        madness::archive::BufferOutputArchive count;
+        count& f.get();
+        const std::size_t size = count.size();
+        std::vector<unsigned char> buffer(size);
+        madness::archive::BufferOutputArchive ar(buffer.data(), size);
+        ar& f.get();
+
+        if (!file_) file_ = std::make_unique<SpillFile>(directory_);
+        extents_.emplace(key, std::make_pair(file_->write(buffer.data(), size),
+                                             size));
+      }
+
+      // Release the element
+      f = future();
+    }
+
+    /// Read a spilled element back into memory
+
+    /// \param key The element key
+    /// \param[out] f The unset future of element \c key
+    /// \return The size of the element in bytes (see \c bytes() ), or 0
+    /// if \c key has not been spilled
+    std::size_t restore(const key_type key, future& f) {
+      std::vector<unsigned char> buffer;
+      {
+        std::lock_guard<std::mutex> extents_lock(extents_mutex_);
+        auto it = extents_.find(key);
+        if (it == extents_.end()) return 0ul;
+        buffer.resize(it->second.second);
+        file_->read(it->second.first, buffer.data(), buffer.size());
+      }
+
+      value_type value;
+      madness::archive::BufferInputArchive ar(buffer.data(), buffer.size());
+      ar& value;
+      const std::size_t size = std::max(bytes(value), std::size_t(1));
+      f.set(std::move(value));
+      return size;
+    }
+
+  };  // class Spiller
+
+  std::shared_ptr<Spiller> spiller_;  ///< Spills elements to disk, or null
+
+  /// Registers a local element with the spill manager once it has been set
+  struct DelayedTrack : public madness::CallbackInterface {
+   private:
+    std::weak_ptr<Spiller> spiller_;  ///< The spiller of the owning object
+    size_type index_;                 ///< The element key
+    future future_;                   ///< The future of the element
+
+   public:
+    DelayedTrack(const std::shared_ptr<Spiller>& spiller, size_type i,
+                 const future& f)
+        : spiller_(spiller), index_(i), future_(f) {}
+
+    virtual ~DelayedTrack() {}
+
+    virtual void notify() {
+      if (std::shared_ptr<Spiller> spiller = spiller_.lock())
+        spiller->track(index_, future_);
+      delete this;
+    }
+  };  // struct DelayedTrack
+
+  /// Find or insert a local element, reading it back from disk if necessary
+
+  /// The future is returned by value, since the future in the container is
+  /// replaced when the element is spilled by another thread.
+  /// \param i The element key
+  /// \return The future of element \c i
+  future restore_local(const size_type i) const {
+    TA_ASSERT(spiller_);
+    accessor acc;
+    [[maybe_unused]] const bool inserted = data_.insert(acc, i);
+    const std::size_t restored =
+        (acc->second.probe() ? 0ul : spiller_->restore(i, acc->second));
+    future result = acc->second;
+    acc.release();
+
+    // Update the spill manager after the element lock has been released
+    if (restored)
+      TileSpillManager::instance().insert(spiller_, i, restored);
+    else if (result.probe())
+      TileSpillManager::instance().touch(spiller_.get(), i);
+    return result;
+  }
+
+  /// Find or insert a local element
+
+  /// \param i The element key
+  /// \return The future of element \c i
+  future find_local(const size_type i) const {
+    TA_ASSERT(pmap_->is_local(i));
+    if (spiller_) return restore_local(i);
+    const_accessor acc;
+    [[maybe_unused]] const bool inserted = data_.insert(acc, i);
+    return acc->second;
+  }
+
+  /// Find or insert a local element that will not be spilled
+
+  /// \param i The element key
+  /// \return A reference to the future of element \c i
+  future& pin_local(const size_type i) const {
+    TA_ASSERT(spiller_);
+    spiller_->pin(i);
+    restore_local(i);
+    accessor acc;
+    [[maybe_unused]] const bool inserted = data_.insert(acc, i);
+    return acc->second;
+  }
+
   // not allowed
   DistributedStorage(const DistributedStorage_&);
   DistributedStorage_& operator=(const DistributedStorage_&);
 
   void set_handler(const size_type i, const value_type& value) {
-    future& f = get_local(i);
+    future f = find_local(i);
 
     // Check that the future has not been set already.
     TA_ASSERT(!f.probe() && "Tile has already been assigned.");
 
     f.set(value);
+    if (spiller_) spiller_->track(i, f);
   }
 
   void get_handler(const size_type i,
                    const typename future::remote_refT& ref) const {
-    const future& f = get_local(i);
+    const future f = find_local(i);
     future remote_f(ref);
     remote_f.set(f);
   }
 
+  /// Request handler of an element that is copied through shared memory
+
+  /// \param i The element key
+  /// \param requester The process that requested the element
+  /// \param ref The future of the requester
+  void get_shm_handler(const size_type i, const ProcessID requester,
+                       const typename future::remote_refT& ref) const {
+    WorldObject_::task(get_world().rank(), &DistributedStorage_::shm_put,
+                       find_local(i), requester, ref,
+                       madness::TaskAttributes::hipri());
+  }
+
+  /// Copy a local element into shared memory and notify the requester
+
+  /// The element is published in a block with a single reader, so the block
+  /// is reclaimed once the requester has copied it. If the segment is full,
+  /// the element is sent instead.
+  /// \param value The element
+  /// \param requester The process that requested the element
+  /// \param ref The future of the requester
+  void shm_put(const value_type& value, const ProcessID requester,
+               const typename future::remote_refT& ref) const {
+    const std::size_t bytes =
+        value.size() * sizeof(typename value_type::value_type);
+    const std::size_t offset =
+        (value.empty() ? SharedMemoryArena::npos : shm_->publish(bytes, 1l));
+    if (offset != SharedMemoryArena::npos)
+      std::memcpy(shm_->data(offset), value.data(), bytes);
+
+    if (offset == SharedMemoryArena::npos) {
+      future remote_f(ref);
+      remote_f.set(value);
+    } else {
+      WorldObject_::task(requester, &DistributedStorage_::shm_get,
+                         get_world().rank(), offset, value.range(), ref,
+                         madness::TaskAttributes::hipri());
+    }
+  }
+
+  /// Copy an element out of the shared memory of its owner
+
+  /// \param owner The owner of the element
+  /// \param offset The offset of the element in the segment of \c owner
+  /// \param range The range of the element
+  /// \param ref The future of the element
+  void shm_get(const ProcessID owner, const std::size_t offset,
+               const typename value_type::range_type& range,
+               const typename future::remote_refT& ref) const {
+    value_type value(range);
+    std::memcpy(value.data(), shm_->data(owner, offset),
+                value.size() * sizeof(typename value_type::value_type));
+    shm_->release(owner, offset);
+    future f(ref);
+    f.set(std::move(value));
+  }
+
   void set_remote(const size_type i, const value_type& value) {
     WorldObject_::task(owner(i), &DistributedStorage_::set_handler, i, value,
                        madness::TaskAttributes::hipri());
@@ -136,6 +429,10 @@ class DistributedStorage : public madness::WorldObject<DistributedStorage<T> > {
     TA_ASSERT(pmap_->rank() == pmap_interface::size_type(world.rank()));
     TA_ASSERT(pmap_->procs() == pmap_interface::size_type(world.size()));
     num_live_ds_ = 0;
+    if (spill_config().memory_budget)
+      spiller_ = std::make_shared<Spiller>(*this, spill_config().directory);
+    if constexpr (is_shm_copyable)
+      shm_ = SharedMemoryTransport::instance(world);
     WorldObject_::process_pending();
   }
 
@@ -147,6 +444,10 @@ class DistributedStorage : public madness::WorldObject<DistributedStorage<T> > {
           "this object.");
       abort();
     }
+    if (spiller_) {
+      TileSpillManager::instance().erase(spiller_.get());
+      spiller_->detach();
+    }
   }
 
   using WorldObject_::get_world;
@@ -202,11 +503,21 @@ class DistributedStorage : public madness::WorldObject<DistributedStorage<T> > {
   future get(size_type i) const {
     TA_ASSERT(i < max_size_);
     if (is_local(i)) {
-      return get_local(i);
+      return find_local(i);
     } else {
       // Send a request to the owner of i for the element.
       future result;
-      WorldObject_::task(owner(i), &DistributedStorage_::get_handler, i,
+      const ProcessID source = owner(i);
+      if constexpr (is_shm_copyable) {
+        if (shm_ && shm_->is_peer(source)) {
+          WorldObject_::task(source, &DistributedStorage_::get_shm_handler, i,
+                             get_world().rank(),
+                             result.remote_ref(get_world()),
+                             madness::TaskAttributes::hipri());
+          return result;
+        }
+      }
+      WorldObject_::task(source, &DistributedStorage_::get_handler, i,
                          result.remote_ref(get_world()),
                          madness::TaskAttributes::hipri());
 
@@ -224,6 +535,7 @@ class DistributedStorage : public madness::WorldObject<DistributedStorage<T> > {
     TA_ASSERT(pmap_->is_local(i));
 
     // Return the local element.
+    if (spiller_) return pin_local(i);
     const_accessor acc;
     [[maybe_unused]] const bool inserted = data_.insert(acc, i);
     return acc->second;
@@ -239,6 +551,7 @@ class DistributedStorage : public madness::WorldObject<DistributedStorage<T> > {
     TA_ASSERT(pmap_->is_local(i));
 
     // Return the local element.
+    if (spiller_) return pin_local(i);
     accessor acc;
     [[maybe_unused]] const bool inserted = data_.insert(acc, i);
     return acc->second;
@@ -282,7 +595,10 @@ class DistributedStorage : public madness::WorldObject<DistributedStorage<T> > {
         TA_ASSERT(!existing_f.probe() && "Tile has already been assigned.");
         // Set the future
         existing_f.set(f);
+      } else {
+        acc.release();
       }
+      if (spiller_) spiller_->track_when_set(i, f);
     } else {
       if (f.probe()) {
         set_remote(i, f);
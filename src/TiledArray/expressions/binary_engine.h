@@ -182,6 +182,19 @@ class BinaryEngine : public ExprEngine<Derived> {
   BinaryEngine(const BinaryExpr<D>& expr)
       : ExprEngine_(expr), left_(expr.left()), right_(expr.right()) {}
 
+  /// Rebind the leaves of this engine to the arrays of an expression
+
+  /// \param expr An expression of the same type as the one this engine was
+  /// constructed from
+  /// \param reuse The criterion for reusing the structure of this engine
+  /// \return \c true if the structure of this engine is valid for \p expr
+  template <typename D>
+  bool rebind(const BinaryExpr<D>& expr, const PlanReuse reuse) {
+    const bool left = left_.rebind(expr.left(), reuse);
+    const bool right = right_.rebind(expr.right(), reuse);
+    return left && right;
+  }
+
   /// Set the index list for this expression
 
   /// This function will set the index list for this expression and its
@@ -299,6 +312,16 @@ class BinaryEngine : public ExprEngine<Derived> {
     return dist_eval_type(pimpl);
   }
 
+  /// Accumulate the predicted cost of this expression
+
+  /// \param cost The cost of this expression and its arguments is added to
+  /// \c cost
+  void add_cost(ExprCost& cost) const {
+    left_.add_cost(cost);
+    right_.add_cost(cost);
+    ExprEngine_::add_cost(cost);
+  }
+
   /// Expression print
 
   /// \param os The output stream
@@ -26,6 +26,7 @@
 #ifndef TILEDARRAY_EXPRESSIONS_BLK_TSR_ENGINE_H__INCLUDED
 #define TILEDARRAY_EXPRESSIONS_BLK_TSR_ENGINE_H__INCLUDED
 
+#include <TiledArray/block_range.h>
 #include <TiledArray/expressions/leaf_engine.h>
 #include <TiledArray/tile_op/shift.h>
 
@@ -183,6 +184,19 @@ class BlkTsrEngineBase : public LeafEngine<Derived> {
         lower_bound_(expr.lower_bound()),
         upper_bound_(expr.upper_bound()) {}
 
+  /// Rebind this engine to the array of an expression
+
+  /// \param expr An expression of the same type as the one this engine was
+  /// constructed from
+  /// \param reuse The criterion for reusing the structure of this engine
+  /// \return \c true if the structure of this engine is valid for \p expr
+  template <typename D>
+  bool rebind(const Expr<D>& expr, const PlanReuse reuse) {
+    const bool valid = LeafEngine_::rebind(expr, reuse);
+    return valid && (lower_bound_ == expr.derived().lower_bound()) &&
+           (upper_bound_ == expr.derived().upper_bound());
+  }
+
   /// Non-permuting tiled range factory function
 
   /// \return The result tiled range
@@ -279,6 +293,20 @@ class BlkTsrEngineBase : public LeafEngine<Derived> {
     return dist_eval_type(pimpl);
   }
 
+  /// Accumulate the predicted cost of this expression
+
+  /// Each nonzero tile of the block is fetched from the owner of the array
+  /// tile by the owner of the tile of this expression, and copied.
+  /// \param cost The cost of this expression is added to \c cost
+  void add_cost(ExprCost& cost) const {
+    const BlockRange block_range(array_.trange().tiles_range(), lower_bound_,
+                                 upper_bound_);
+    LeafEngine_::add_cost(
+        cost,
+        [&block_range](const auto index) { return block_range.ordinal(index); },
+        true);
+  }
+
   /// Expression identification tag
 
   /// \return An expression tag used to identify this expression
@@ -503,6 +531,17 @@ class ScalBlkTsrEngine
   ScalBlkTsrEngine(const ScalBlkTsrExpr<A, S>& expr)
       : BlkTsrEngineBase_(expr), factor_(expr.factor()) {}
 
+  /// Rebind this engine to the array of an expression
+
+  /// \param expr An expression of the same type as the one this engine was
+  /// constructed from
+  /// \param reuse The criterion for reusing the structure of this engine
+  /// \return \c true if the structure of this engine is valid for \p expr
+  template <typename A, typename S>
+  bool rebind(const ScalBlkTsrExpr<A, S>& expr, const PlanReuse reuse) {
+    return BlkTsrEngineBase_::rebind(expr, reuse) && (factor_ == expr.factor());
+  }
+
   /// Non-permuting shape factory function
 
   /// \return The result shape
@@ -518,6 +557,11 @@ class ScalBlkTsrEngine
     return array_.shape().block(lower_bound_, upper_bound_, factor_, perm);
   }
 
+  /// Floating-point operations per element of the tile operation
+
+  /// \return The number of operations per result element (scale)
+  static constexpr unsigned int flops_per_element() { return 1u; }
+
   /// Non-permuting tile operation factory function
 
   /// \return The tile operation
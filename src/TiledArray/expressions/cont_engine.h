@@ -33,6 +33,7 @@
 #include <TiledArray/tensor/utility.h>
 #include <TiledArray/tile_op/contract_reduce.h>
 #include <TiledArray/tile_op/mult.h>
+#include <TiledArray/util/env.h>
 
 namespace TiledArray {
 namespace expressions {
@@ -130,6 +131,19 @@ class ContEngine : public BinaryEngine<Derived> {
     return i;
   }
 
+  /// Default number of replicated process grid layers for SUMMA
+
+  /// The default is read from the \c TA_SUMMA_REPLICATION environment
+  /// variable; if it is not set the 2D SUMMA algorithm (1 layer) is used.
+  /// \return The default number of process grid layers
+  static size_type summa_replication() {
+    static const size_type layers = std::max<size_type>(
+        TiledArray::detail::getenv_number<size_type>("TA_SUMMA_REPLICATION",
+                                                     1ul),
+        1ul);
+    return layers;
+  }
+
   TensorProduct product_type_ = TensorProduct::Invalid;
   TensorProduct inner_product_type_ = TensorProduct::Invalid;
 
@@ -293,6 +307,8 @@ class ContEngine : public BinaryEngine<Derived> {
     if (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->shape) {
       shape_ = shape_.mask(*ExprEngine_::override_ptr_->shape);
     }
+    if (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->symmetry)
+      shape_ = ExprEngine_::override_ptr_->symmetry->mask(shape_, trange_);
   }
 
   /// Initialize result tensor distribution
@@ -330,8 +346,18 @@ class ContEngine : public BinaryEngine<Derived> {
       n *= right_element_size[i];
     }
 
+    // Select the number of replicated process grid layers (2.5D SUMMA); each
+    // layer must have at least one process and one inner tile index.
+    size_type layers = summa_replication();
+    if (ExprEngine_::override_ptr_ &&
+        ExprEngine_::override_ptr_->summa_replication > 0u)
+      layers = ExprEngine_::override_ptr_->summa_replication;
+    layers = std::min<size_type>(
+        layers,
+        std::min<size_type>(K_, static_cast<size_type>(world->size())));
+
     // Construct the process grid.
-    proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n);
+    proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n, layers);
 
     // Initialize children
     left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
@@ -432,6 +458,181 @@ class ContEngine : public BinaryEngine<Derived> {
     return dist_eval_type(pimpl);
   }
 
+  /// Accumulate the predicted cost of this expression
+
+  /// The contraction is modeled on \c TiledArray::detail::Summa : each
+  /// nonzero tile of the left-hand (right-hand) argument is broadcast from
+  /// its owner to the processes of its process grid row (column) that hold
+  /// result tiles that depend on it, the tile products that are not
+  /// screened by the shapes are evaluated by the process that holds the
+  /// result tile, and the partial results of the layers of a replicated
+  /// process grid are reduced onto the first layer before each result tile
+  /// is sent to its owner.
+  /// \param cost The cost of this expression and its arguments is added to
+  /// \c cost
+  void add_cost(ExprCost& cost) const {
+    left_.add_cost(cost);
+    right_.add_cost(cost);
+
+    const std::size_t M = proc_grid_.rows();
+    const std::size_t N = proc_grid_.cols();
+    const std::size_t K = K_;
+    const std::size_t proc_rows = proc_grid_.proc_rows();
+    const std::size_t proc_cols = proc_grid_.proc_cols();
+    const std::size_t proc_size = proc_grid_.proc_size();
+    const std::size_t layers = proc_grid_.layers();
+    const std::size_t element_size = ExprEngine_::element_size();
+    const auto& left_shape = left_.shape();
+    const auto& right_shape = right_.shape();
+
+    // Fused tile extents of the rows, the inner dimension, and the columns
+    const auto& gemm_helper = op_.gemm_helper();
+    const unsigned int inner_rank = gemm_helper.num_contract_ranks();
+    const unsigned int left_outer_rank = gemm_helper.left_rank() - inner_rank;
+    const auto m =
+        detail::fused_tile_extents(left_.trange(), 0u, left_outer_rank);
+    const auto k = detail::fused_tile_extents(left_.trange(), left_outer_rank,
+                                              gemm_helper.left_rank());
+    const auto n = detail::fused_tile_extents(right_.trange(), inner_rank,
+                                              gemm_helper.right_rank());
+
+    // The layer that evaluates each inner index
+    std::vector<std::size_t> k_layer(K);
+    for (std::size_t l = 0ul; l < layers; ++l)
+      for (std::size_t x = proc_grid_.layer_k_begin(K, l);
+           x < proc_grid_.layer_k_begin(K, l + 1u); ++x)
+        k_layer[x] = l;
+
+    // Map the (unpermuted) result tiles to the tiles of this expression
+    const Permutation perm = outer(perm_);
+    const PermIndex source_to_target =
+        (perm ? PermIndex(-perm * trange_.tiles_range(), perm) : PermIndex());
+    auto is_zero = [&](const std::size_t ij) {
+      return shape_.is_zero(source_to_target ? source_to_target(ij) : ij);
+    };
+
+    // Tile products that are screened by the norms of the arguments
+    auto is_screened = [&](const std::size_t ik, const std::size_t kj) {
+#ifndef TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
+      if constexpr (!shape_type::is_dense())
+        return (left_shape[ik] * right_shape[kj]) <
+               (shape_.threshold() / K);
+#endif  // TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
+      return false;
+    };
+
+    // Tile products and the reduction of the result tiles
+    std::vector<bool> contributes(layers);
+    for (std::size_t i = 0ul; i < M; ++i) {
+      for (std::size_t j = 0ul; j < N; ++j) {
+        const std::size_t ij = i * N + j;
+        if (is_zero(ij)) continue;
+        const ProcessID grid_proc =
+            (i % proc_rows) * proc_cols + (j % proc_cols);
+        const std::size_t mn = m[i] * n[j];
+
+        std::fill(contributes.begin(), contributes.end(), false);
+        for (std::size_t x = 0ul; x < K; ++x) {
+          const std::size_t ik = i * K + x;
+          const std::size_t kj = x * N + j;
+          if (left_shape.is_zero(ik) || right_shape.is_zero(kj) ||
+              is_screened(ik, kj))
+            continue;
+          ProcessCost& proc = cost[k_layer[x] * proc_size + grid_proc];
+          proc.flops += 2.0 * mn * k[x];
+          ++proc.tasks;
+          contributes[k_layer[x]] = true;
+        }
+
+        // The first layer reduces the partial results of the other layers
+        const std::size_t bytes = mn * element_size;
+        cost[grid_proc].memory += bytes;
+        ++cost[grid_proc].tasks;
+        for (std::size_t l = 1ul; l < layers; ++l) {
+          if (!contributes[l]) continue;
+          const ProcessID proc = l * proc_size + grid_proc;
+          cost[proc].memory += bytes;
+          cost.send(proc, grid_proc, bytes);
+          ++cost[grid_proc].tasks;
+        }
+        cost.send(grid_proc,
+                  pmap_->owner(source_to_target ? source_to_target(ij) : ij),
+                  bytes);
+      }
+    }
+
+    // Broadcast of the arguments; the groups are constructed as in
+    // Summa::make_row_group() and Summa::make_col_group()
+    std::vector<bool> group(std::max(proc_rows, proc_cols));
+    for (std::size_t x = 0ul; x < K; ++x) {
+      const ProcessID layer_offset = k_layer[x] * proc_size;
+
+      // Left-hand tiles x of each process row
+      for (std::size_t r = 0ul; r < proc_rows; ++r) {
+        std::fill(group.begin(), group.end(), false);
+        bool nonzero = false;
+        for (std::size_t i = r; i < M; i += proc_rows) {
+          if (left_shape.is_zero(i * K + x)) continue;
+          nonzero = true;
+          for (std::size_t j = 0ul; j < N; ++j)
+            if (!group[j % proc_cols] && !is_zero(i * N + j))
+              group[j % proc_cols] = true;
+        }
+        if (!nonzero) continue;
+        for (std::size_t c = 0ul; c < proc_cols; ++c) {
+          if (!group[c]) continue;
+          bool needed = false;
+          for (std::size_t j = c; j < N && !needed; j += proc_cols)
+            needed = !right_shape.is_zero(x * N + j);
+          group[c] = needed;
+        }
+        group[x % proc_cols] = true;
+
+        for (std::size_t i = r; i < M; i += proc_rows) {
+          const std::size_t ik = i * K + x;
+          if (left_shape.is_zero(ik)) continue;
+          const ProcessID root = left_.pmap()->owner(ik);
+          for (std::size_t c = 0ul; c < proc_cols; ++c)
+            if (group[c])
+              cost.send(root, layer_offset + r * proc_cols + c,
+                        m[i] * k[x] * element_size);
+        }
+      }
+
+      // Right-hand tiles x of each process column
+      for (std::size_t c = 0ul; c < proc_cols; ++c) {
+        std::fill(group.begin(), group.end(), false);
+        bool nonzero = false;
+        for (std::size_t j = c; j < N; j += proc_cols) {
+          if (right_shape.is_zero(x * N + j)) continue;
+          nonzero = true;
+          for (std::size_t i = 0ul; i < M; ++i)
+            if (!group[i % proc_rows] && !is_zero(i * N + j))
+              group[i % proc_rows] = true;
+        }
+        if (!nonzero) continue;
+        for (std::size_t r = 0ul; r < proc_rows; ++r) {
+          if (!group[r]) continue;
+          bool needed = false;
+          for (std::size_t i = r; i < M && !needed; i += proc_rows)
+            needed = !left_shape.is_zero(i * K + x);
+          group[r] = needed;
+        }
+        group[x % proc_rows] = true;
+
+        for (std::size_t j = c; j < N; j += proc_cols) {
+          const std::size_t kj = x * N + j;
+          if (right_shape.is_zero(kj)) continue;
+          const ProcessID root = right_.pmap()->owner(kj);
+          for (std::size_t r = 0ul; r < proc_rows; ++r)
+            if (group[r])
+              cost.send(root, layer_offset + r * proc_cols + c,
+                        k[x] * n[j] * element_size);
+        }
+      }
+    }
+  }
+
   /// Expression identification tag
 
   /// \return An expression tag used to identify this expression
@@ -23,8 +23,15 @@
 #include "TiledArray/conversions/make_array.h"
 #include "TiledArray/expressions/index_list.h"
 #include "TiledArray/expressions/tsr_expr.h"
+#include "TiledArray/math/blas.h"
+#include "TiledArray/reduce_task.h"
 #include "TiledArray/tensor/tensor.h"
 
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace TiledArray::expressions {
 
 /// Assembles the range for the target annotation
@@ -164,6 +171,263 @@ inline auto make_bound_annotation(const IndexList& free_vars,
 
 namespace kernels {
 
+/// Precomputed form of make_index
+
+/// \c make_index looks up the position of every annotation each time it is
+/// called. This class does the lookups once, so that mapping the free and
+/// bound coordinate indices of a loop to the index of a tensor only gathers
+/// their elements.
+class IndexMap {
+ private:
+  /// Whether each mode of the tensor is free, and its position in the free
+  /// or bound index
+  container::svector<std::pair<bool, std::size_t>> modes_;
+
+ public:
+  /// Constructor
+
+  /// \param free_vars The free variables of the contraction
+  /// \param bound_vars The bound variables of the contraction
+  /// \param tensor_vars The annotation of the tensor
+  template <typename IndexList_>
+  IndexMap(const IndexList_& free_vars, const IndexList_& bound_vars,
+           const IndexList_& tensor_vars) {
+    modes_.reserve(tensor_vars.size());
+    for (std::size_t i = 0; i < tensor_vars.size(); ++i) {
+      const auto& x = tensor_vars[i];
+      const bool is_free = free_vars.count(x);
+      const auto modes =
+          is_free ? free_vars.positions(x) : bound_vars.positions(x);
+      TA_ASSERT(modes.size() == 1);  // Annotation should only appear once
+      modes_.emplace_back(is_free, modes[0]);
+    }
+  }
+
+  /// Map the loop indices to the index of the tensor
+
+  /// \param free_idx A coordinate index of the free variables
+  /// \param bound_idx A coordinate index of the bound variables
+  /// \return The coordinate index of the tensor element
+  template <typename FreeIndex, typename BoundIndex>
+  auto operator()(const FreeIndex& free_idx,
+                  const BoundIndex& bound_idx) const {
+    std::decay_t<FreeIndex> rv(modes_.size());
+    for (std::size_t i = 0; i < modes_.size(); ++i)
+      rv[i] = modes_[i].first ? free_idx[modes_[i].second]
+                              : bound_idx[modes_[i].second];
+    return rv;
+  }
+};  // class IndexMap
+
+/// Batched GEMM form of a contraction of two plain tensors
+
+/// A contraction in which every annotation labels at most one mode of each
+/// tensor, and every bound annotation appears in both arguments, is
+/// evaluated as
+/// \f[
+///   C_{hmn} = \sum_k A_{hmk} B_{hkn}
+/// \f]
+/// where \c h groups the annotations shared by the result and both
+/// arguments (Hadamard), \c m and \c n group the remaining annotations of the
+/// result, and \c k groups the bound annotations. "Batched" only refers to
+/// the \c h loop: each \c h slice is a separate GEMM call, there is no
+/// batched BLAS call.
+/// Arguments whose modes are not already in the \c hmk ( \c hkn ) or \c hkm
+/// ( \c hnk ) order are permuted first, and the result is permuted to the
+/// order of the result annotation if necessary. The plan only depends on
+/// the annotations, so a tensor-of-tensors kernel builds it once and applies
+/// it to every pair of inner tensors, whose extents may differ.
+class GemmPlan {
+ private:
+  typedef container::svector<std::size_t> positions_type;
+
+  bool valid_ = false;        ///< The contraction maps to GEMM
+  Permutation lhs_perm_;      ///< Permutes lhs to hmk order (empty if none)
+  Permutation rhs_perm_;      ///< Permutes rhs to hkn order (empty if none)
+  Permutation result_perm_;   ///< Permutes hmn to the result (empty if none)
+  math::blas::Op lhs_op_ = math::blas::NoTranspose;  ///< lhs GEMM operation
+  math::blas::Op rhs_op_ = math::blas::NoTranspose;  ///< rhs GEMM operation
+  positions_type lhs_h_;      ///< Modes of lhs in the h group
+  positions_type lhs_m_;      ///< Modes of lhs in the m group
+  positions_type lhs_k_;      ///< Modes of lhs in the k group
+  positions_type rhs_n_;      ///< Modes of rhs in the n group
+
+  /// Modes of \c vars labeled by \c group
+  static positions_type positions(const IndexList& vars,
+                                  const std::vector<std::string>& group) {
+    positions_type rv;
+    rv.reserve(group.size());
+    for (const auto& x : group) rv.push_back(vars.positions(x)[0]);
+    return rv;
+  }
+
+  /// Concatenate annotation groups
+  static IndexList concat(const std::vector<std::string>& first,
+                          const std::vector<std::string>& second,
+                          const std::vector<std::string>& third) {
+    std::vector<std::string> rv(first);
+    rv.insert(rv.end(), second.begin(), second.end());
+    rv.insert(rv.end(), third.begin(), third.end());
+    return IndexList(rv.begin(), rv.end());
+  }
+
+  /// Product of the extents of \c modes
+  template <typename Range_>
+  static std::size_t volume(const Range_& range, const positions_type& modes) {
+    std::size_t rv = 1;
+    for (const auto mode : modes) rv *= range.extent_data()[mode];
+    return rv;
+  }
+
+ public:
+  /// Constructor
+
+  /// \param out_vars The annotation of the result
+  /// \param lhs_vars The annotation of the left-hand argument
+  /// \param rhs_vars The annotation of the right-hand argument
+  GemmPlan(const IndexList& out_vars, const IndexList& lhs_vars,
+           const IndexList& rhs_vars) {
+    auto unique = [](const IndexList& vars) {
+      for (const auto& x : vars)
+        if (vars.count(x) != 1) return false;
+      return true;
+    };
+    if (!unique(out_vars) || !unique(lhs_vars) || !unique(rhs_vars)) return;
+
+    // Group the annotations; h, m, and n follow the order of the result and
+    // k follows the order of lhs
+    std::vector<std::string> h, m, n, k;
+    for (const auto& x : out_vars) {
+      const bool in_lhs = lhs_vars.count(x), in_rhs = rhs_vars.count(x);
+      if (in_lhs && in_rhs)
+        h.push_back(x);
+      else if (in_lhs)
+        m.push_back(x);
+      else if (in_rhs)
+        n.push_back(x);
+      else
+        return;
+    }
+    for (const auto& x : lhs_vars) {
+      if (out_vars.count(x)) continue;
+      if (!rhs_vars.count(x)) return;  // Summed over lhs only
+      k.push_back(x);
+    }
+    for (const auto& x : rhs_vars)
+      if (!out_vars.count(x) && !lhs_vars.count(x)) return;
+
+    // Use the transposed layouts of the arguments when they match, otherwise
+    // permute them
+    if (lhs_vars == concat(h, k, m) && !(m.empty() || k.empty())) {
+      lhs_op_ = math::blas::Transpose;
+    } else {
+      const auto hmk = concat(h, m, k);
+      if (lhs_vars != hmk) lhs_perm_ = hmk.permutation(lhs_vars);
+    }
+    if (rhs_vars == concat(h, n, k) && !(n.empty() || k.empty())) {
+      rhs_op_ = math::blas::Transpose;
+    } else {
+      const auto hkn = concat(h, k, n);
+      if (rhs_vars != hkn) rhs_perm_ = hkn.permutation(rhs_vars);
+    }
+    const auto hmn = concat(h, m, n);
+    if (out_vars != hmn) result_perm_ = out_vars.permutation(hmn);
+
+    lhs_h_ = positions(lhs_vars, h);
+    lhs_m_ = positions(lhs_vars, m);
+    lhs_k_ = positions(lhs_vars, k);
+    rhs_n_ = positions(rhs_vars, n);
+    valid_ = true;
+  }
+
+  /// \return \c true if the contraction maps to GEMM, otherwise \c false
+  explicit operator bool() const { return valid_; }
+
+  /// Evaluate the contraction
+
+  /// \tparam LHSType The left-hand tensor type
+  /// \tparam RHSType The right-hand tensor type
+  /// \param lhs The left-hand argument
+  /// \param rhs The right-hand argument
+  /// \return The contraction of \c lhs and \c rhs
+  template <typename LHSType, typename RHSType>
+  std::decay_t<LHSType> operator()(const LHSType& lhs,
+                                   const RHSType& rhs) const {
+    std::decay_t<LHSType> rv;
+    accumulate(rv, lhs, rhs);
+    return rv;
+  }
+
+  /// Add the contraction to a tensor
+
+  /// \tparam ResultType The result tensor type
+  /// \tparam LHSType The left-hand tensor type
+  /// \tparam RHSType The right-hand tensor type
+  /// \param[in,out] result The tensor that the contraction is added to; if
+  /// it is empty it is assigned the contraction
+  /// \param lhs The left-hand argument
+  /// \param rhs The right-hand argument
+  template <typename ResultType, typename LHSType, typename RHSType>
+  void accumulate(ResultType& result, const LHSType& lhs,
+                  const RHSType& rhs) const {
+    using numeric_type = typename ResultType::numeric_type;
+    using range_type = typename ResultType::range_type;
+    using integer = math::blas::integer;
+    TA_ASSERT(valid_);
+
+    const std::size_t h = volume(lhs.range(), lhs_h_);
+    const std::size_t m = volume(lhs.range(), lhs_m_);
+    const std::size_t k = volume(lhs.range(), lhs_k_);
+    const std::size_t n = volume(rhs.range(), rhs_n_);
+    TA_ASSERT(h * k * n == rhs.range().volume());
+
+    // The range of the result in hmn order
+    std::vector<std::pair<typename range_type::index1_type,
+                          typename range_type::index1_type>>
+        dims;
+    dims.reserve(lhs_h_.size() + lhs_m_.size() + rhs_n_.size());
+    for (const auto mode : lhs_h_) dims.emplace_back(lhs.range().dim(mode));
+    for (const auto mode : lhs_m_) dims.emplace_back(lhs.range().dim(mode));
+    for (const auto mode : rhs_n_) dims.emplace_back(rhs.range().dim(mode));
+
+    const bool in_place = !result.empty() && !result_perm_;
+    ResultType hmn =
+        (in_place ? result : ResultType(range_type(dims), numeric_type(0)));
+    TA_ASSERT(hmn.range().volume() == h * m * n);
+    if (h * m * n * k == 0ul) return;
+
+    const auto left = (lhs_perm_ ? lhs.permute(lhs_perm_) : lhs);
+    const auto right = (rhs_perm_ ? rhs.permute(rhs_perm_) : rhs);
+    const auto* a = left.data();
+    const auto* b = right.data();
+    auto* c = hmn.data();
+
+    if (m == 1ul && n == 1ul) {
+      // Batched dot products; the transposes do not change the layout
+      for (std::size_t x = 0ul; x < h; ++x, a += k, b += k) {
+        numeric_type sum = 0;
+        for (std::size_t y = 0ul; y < k; ++y) sum += a[y] * b[y];
+        c[x] += sum;
+      }
+    } else {
+      const integer lda = (lhs_op_ == math::blas::NoTranspose ? k : m);
+      const integer ldb = (rhs_op_ == math::blas::NoTranspose ? n : k);
+      const numeric_type beta = (in_place ? 1 : 0);
+      for (std::size_t x = 0ul; x < h; ++x)
+        math::blas::gemm(lhs_op_, rhs_op_, m, n, k, numeric_type(1),
+                         a + x * m * k, lda, b + x * k * n, ldb, beta,
+                         c + x * m * n, n);
+    }
+
+    if (in_place) return;
+    if (result_perm_) hmn = hmn.permute(result_perm_);
+    if (result.empty())
+      result = std::move(hmn);
+    else
+      result += hmn;
+  }
+};  // class GemmPlan
+
 // Contract two tensors to a scalar
 template <typename IndexList_, typename LHSType, typename RHSType>
 auto s_t_t_contract_(const IndexList_& free_vars, const IndexList_& lhs_vars,
@@ -229,17 +493,22 @@ auto t_s_t_contract_(const IndexList_& free_vars, const IndexList_& lhs_vars,
 template <typename IndexList_, typename LHSType, typename RHSType>
 auto t_t_t_contract_(const IndexList_& free_vars, const IndexList_& lhs_vars,
                      const IndexList_& rhs_vars, LHSType&& lhs, RHSType&& rhs) {
+  using lhs_numeric_type = typename std::decay_t<LHSType>::numeric_type;
+  using rhs_numeric_type = typename std::decay_t<RHSType>::numeric_type;
+
+  // Use GEMM when the annotations allow it
+  if constexpr (detail::is_numeric_v<lhs_numeric_type> &&
+                std::is_same_v<lhs_numeric_type, rhs_numeric_type>) {
+    const GemmPlan plan(outer(free_vars), outer(lhs_vars), outer(rhs_vars));
+    if (plan) return plan(lhs, rhs);
+  }
+
   // Get the indices being contracted over
   const auto bound_vars = make_bound_annotation(free_vars, lhs_vars, rhs_vars);
 
-  // Lambdas to bind the annotations, making it easier to get coordinate indices
-  auto lhs_idx = [=](const auto& free_idx, const auto& bound_idx) {
-    return make_index(free_vars, bound_vars, lhs_vars, free_idx, bound_idx);
-  };
-
-  auto rhs_idx = [=](const auto& free_idx, const auto& bound_idx) {
-    return make_index(free_vars, bound_vars, rhs_vars, free_idx, bound_idx);
-  };
+  // Bind the annotations, making it easier to get coordinate indices
+  const IndexMap lhs_idx(free_vars, bound_vars, lhs_vars);
+  const IndexMap rhs_idx(free_vars, bound_vars, rhs_vars);
 
   auto orange = range_from_annotation(free_vars, lhs_vars, rhs_vars, lhs, rhs);
   std::decay_t<LHSType> rv(orange, 0.0);
@@ -465,14 +734,9 @@ auto tot_tot_tot_contract_(const IndexList_& out_vars,
   const auto bound_vars =
       make_bound_annotation(out_ovars, lhs_ovars, rhs_ovars);
 
-  // lambdas to bind annotations, making it easier to get coordinate indices
-  auto lhs_idx = [=](const auto& free_idx, const auto& bound_idx) {
-    return make_index(out_ovars, bound_vars, lhs_ovars, free_idx, bound_idx);
-  };
-
-  auto rhs_idx = [=](const auto& free_idx, const auto& bound_idx) {
-    return make_index(out_ovars, bound_vars, rhs_ovars, free_idx, bound_idx);
-  };
+  // Bind the annotations, making it easier to get coordinate indices
+  const IndexMap lhs_idx(out_ovars, bound_vars, lhs_ovars);
+  const IndexMap rhs_idx(out_ovars, bound_vars, rhs_ovars);
 
   auto orange =
       range_from_annotation(out_ovars, lhs_ovars, rhs_ovars, lhs, rhs);
@@ -480,6 +744,34 @@ auto tot_tot_tot_contract_(const IndexList_& out_vars,
   typename tot_type::value_type default_tile;
   tot_type rv(orange, default_tile);
 
+  // The inner contraction is the same for every pair of inner tensors, so
+  // map it to GEMM once and accumulate each product in place; this is still
+  // one GEMM (per h slice) for every pair of inner tensors
+  using lhs_numeric_type = typename std::decay_t<LHSType>::numeric_type;
+  using rhs_numeric_type = typename std::decay_t<RHSType>::numeric_type;
+  if constexpr (detail::is_numeric_v<lhs_numeric_type> &&
+                std::is_same_v<lhs_numeric_type, rhs_numeric_type>) {
+    const GemmPlan plan(out_ivars, lhs_ivars, rhs_ivars);
+    if (plan) {
+      if (bound_vars.size() == 0) {  // Hadamard on the outside
+        std::decay_t<decltype(*lhs.range().begin())> empty;
+        for (const auto& free_idx : orange)
+          plan.accumulate(rv(free_idx), lhs(lhs_idx(free_idx, empty)),
+                          rhs(rhs_idx(free_idx, empty)));
+      } else {
+        auto bound_range =
+            range_from_annotation(bound_vars, lhs_ovars, rhs_ovars, lhs, rhs);
+        for (const auto& free_idx : orange) {
+          auto& inner_out = rv(free_idx);
+          for (const auto& bound_idx : bound_range)
+            plan.accumulate(inner_out, lhs(lhs_idx(free_idx, bound_idx)),
+                            rhs(rhs_idx(free_idx, bound_idx)));
+        }
+      }
+      return rv;
+    }
+  }
+
   // If bound_vars is empty we're doing Hadamard on the outside
   if (bound_vars.size() == 0) {  // Hadamard on the outside
     std::decay_t<decltype(*lhs.range().begin())> empty;
@@ -557,16 +849,92 @@ struct KernelSelector<true, false, true> {
 
 }  // namespace kernels
 
+/// Pairwise reduction of the tile products of an einsum
+
+/// Used with \c detail::ReducePairTask to accumulate the contributions to
+/// one result tile as the argument tiles arrive.
+/// \tparam OutTile The result tile type
+/// \tparam LTile The left-hand argument tile type
+/// \tparam RTile The right-hand argument tile type
+/// \tparam Selector The tile kernel type
+template <typename OutTile, typename LTile, typename RTile, typename Selector>
+class EinsumReduceOp {
+ public:
+  typedef OutTile result_type;          ///< The result tile type
+  typedef LTile first_argument_type;    ///< The left-hand tile type
+  typedef RTile second_argument_type;   ///< The right-hand tile type
+
+ private:
+  std::shared_ptr<const BipartiteIndexList> ovars_;  ///< Result annotation
+  std::shared_ptr<const BipartiteIndexList> lvars_;  ///< Left annotation
+  std::shared_ptr<const BipartiteIndexList> rvars_;  ///< Right annotation
+
+ public:
+  EinsumReduceOp() = default;
+
+  /// Constructor
+
+  /// \param ovars The annotation of the result
+  /// \param lvars The annotation of the left-hand argument
+  /// \param rvars The annotation of the right-hand argument
+  EinsumReduceOp(const std::shared_ptr<const BipartiteIndexList>& ovars,
+                 const std::shared_ptr<const BipartiteIndexList>& lvars,
+                 const std::shared_ptr<const BipartiteIndexList>& rvars)
+      : ovars_(ovars), lvars_(lvars), rvars_(rvars) {}
+
+  /// Create an empty result tile
+  result_type operator()() const { return result_type(); }
+
+  /// Post-process the result tile (no operation)
+  const result_type& operator()(const result_type& result) const {
+    return result;
+  }
+
+  /// Reduce two result tiles
+  void operator()(result_type& result, const result_type& arg) const {
+    if (arg.empty()) return;
+    if (result.empty())
+      result = arg;
+    else
+      result += arg;
+  }
+
+  /// Accumulate the product of an argument tile pair
+  void operator()(result_type& result, const first_argument_type& left,
+                  const second_argument_type& right) const {
+    if (result.empty())
+      result = Selector()(*ovars_, *lvars_, *rvars_, left, right);
+    else
+      result += Selector()(*ovars_, *lvars_, *rvars_, left, right);
+  }
+};  // class EinsumReduceOp
+
+/// Evaluate a tensor contraction in Einstein notation
+
+/// The contributions to each local result tile are reduced by a task as the
+/// argument tiles arrive, so that remote argument tiles are fetched
+/// concurrently and no worker thread blocks on them. Each remote argument
+/// tile is requested at most once per process. For sparse results this
+/// function waits for the local result tiles, since their norms define the
+/// result shape; dense results are returned immediately, like the results of
+/// other expressions.
+/// \param out The result expression
+/// \param lhs The left-hand argument expression
+/// \param rhs The right-hand argument expression
 template <typename ResultType, typename LHSType, typename RHSType>
 void einsum(TsrExpr<ResultType, true> out, const TsrExpr<LHSType, true>& lhs,
             const TsrExpr<RHSType, true>& rhs) {
-  const BipartiteIndexList ovars(out.annotation());
-  const BipartiteIndexList lvars(lhs.annotation());
-  const BipartiteIndexList rvars(rhs.annotation());
+  const auto ovars =
+      std::make_shared<const BipartiteIndexList>(out.annotation());
+  const auto lvars =
+      std::make_shared<const BipartiteIndexList>(lhs.annotation());
+  const auto rvars =
+      std::make_shared<const BipartiteIndexList>(rhs.annotation());
 
   using out_tile_type = typename ResultType::value_type;
   using lhs_tile_type = typename LHSType::value_type;
   using rhs_tile_type = typename RHSType::value_type;
+  using ordinal_type = typename ResultType::ordinal_type;
 
   constexpr bool out_is_tot =
       TiledArray::detail::is_tensor_of_tensor_v<out_tile_type>;
@@ -575,26 +943,46 @@ void einsum(TsrExpr<ResultType, true> out, const TsrExpr<LHSType, true>& lhs,
   constexpr bool rhs_is_tot =
       TiledArray::detail::is_tensor_of_tensor_v<rhs_tile_type>;
 
-  const auto out_ovars = outer(ovars);
-  const auto lhs_ovars = outer(lvars);
-  const auto rhs_ovars = outer(rvars);
+  const auto out_ovars = outer(*ovars);
+  const auto lhs_ovars = outer(*lvars);
+  const auto rhs_ovars = outer(*rvars);
 
   const auto bound_vars =
       make_bound_annotation(out_ovars, lhs_ovars, rhs_ovars);
 
   const auto& ltensor = lhs.array();
   const auto& rtensor = rhs.array();
+  World& world = ltensor.world();
 
   const auto orange =
       trange_from_annotation(out_ovars, lhs_ovars, rhs_ovars, ltensor, rtensor);
   const auto brange = trange_from_annotation(bound_vars, lhs_ovars, rhs_ovars,
                                              ltensor, rtensor);
 
-  kernels::KernelSelector<out_is_tot, lhs_is_tot, rhs_is_tot> selector;
+  using selector_type =
+      kernels::KernelSelector<out_is_tot, lhs_is_tot, rhs_is_tot>;
+  using op_type = EinsumReduceOp<out_tile_type, lhs_tile_type, rhs_tile_type,
+                                 selector_type>;
+  const op_type op(ovars, lvars, rvars);
+
+  // Argument tiles used by this process, so that each one is requested once
+  std::unordered_map<ordinal_type, Future<lhs_tile_type>> ltiles;
+  std::unordered_map<ordinal_type, Future<rhs_tile_type>> rtiles;
+  auto find_tile = [](auto& tiles, const auto& tensor, const auto& idx) {
+    const auto ord = tensor.trange().tiles_range().ordinal(idx);
+    auto it = tiles.find(ord);
+    if (it == tiles.end()) it = tiles.emplace(ord, tensor.find(ord)).first;
+    return it->second;
+  };
 
-  auto l = [=](auto& tile, const Range& r) {
-    const auto oidx =
-        orange.tiles_range().idx(orange.element_to_tile(r.lobound()));
+  // Submit the reduction of each local result tile
+  const auto pmap = TiledArray::detail::policy_t<ResultType>::default_pmap(
+      world, orange.tiles_range().volume());
+  std::vector<std::pair<ordinal_type, Future<out_tile_type>>> tiles;
+  tiles.reserve(pmap->local_size());
+  for (const auto ord : *pmap) {
+    const auto oidx = orange.tiles_range().idx(ord);
+    TiledArray::detail::ReducePairTask<op_type> reduce_task(world, op);
     auto bitr = brange.tiles_range().begin();
     const auto eitr = brange.tiles_range().end();
     do {
@@ -602,22 +990,48 @@ void einsum(TsrExpr<ResultType, true> out, const TsrExpr<LHSType, true>& lhs,
       decltype(oidx) bidx = have_bound ? *bitr : oidx;
       auto lidx = make_index(out_ovars, bound_vars, lhs_ovars, oidx, bidx);
       auto ridx = make_index(out_ovars, bound_vars, rhs_ovars, oidx, bidx);
-      if (!ltensor.shape().is_zero(lidx) && !rtensor.shape().is_zero(ridx)) {
-        const auto& ltile = ltensor.find(lidx).get();
-        const auto& rtile = rtensor.find(ridx).get();
-        if (tile.empty())
-          tile = selector(ovars, lvars, rvars, ltile, rtile);
-        else
-          tile += selector(ovars, lvars, rvars, ltile, rtile);
-      }
+      if (!ltensor.shape().is_zero(lidx) && !rtensor.shape().is_zero(ridx))
+        reduce_task.add(find_tile(ltiles, ltensor, lidx),
+                        find_tile(rtiles, rtensor, ridx));
       if (have_bound) ++bitr;
-    } while (bitr != brange.tiles_range().end());
-    return !tile.empty() ? tile.norm() : 0.0;
-  };
+    } while (bitr != eitr);
+
+    tiles.emplace_back(ord, reduce_task.count()
+                                ? reduce_task.submit()
+                                : Future<out_tile_type>(out_tile_type()));
+  }
 
-  auto rv = make_array<ResultType>(ltensor.world(), orange, l);
-  out.array() = rv;
-  ltensor.world().gop.fence();
+  if constexpr (is_dense_v<ResultType>) {
+    ResultType result(world, orange, pmap);
+    for (auto& tile : tiles) result.set(tile.first, std::move(tile.second));
+    out.array() = result;
+  } else {
+    // The result shape is defined by the norms of the local result tiles
+    using shape_type = typename ResultType::shape_type;
+    Tensor<typename shape_type::value_type> tile_norms(orange.tiles_range(),
+                                                       0);
+    madness::AtomicInt counter;
+    counter = 0;
+    for (auto& tile : tiles) {
+      world.taskq.add(
+          [&tile_norms, &counter](const ordinal_type ord,
+                                  const out_tile_type& t) {
+            if (!t.empty()) tile_norms[ord] = t.norm();
+            ++counter;
+          },
+          tile.first, tile.second);
+    }
+    const int task_count = tiles.size();
+    world.await(
+        [&counter, task_count]() -> bool { return counter == task_count; });
+
+    ResultType result(world, orange, shape_type(world, tile_norms, orange),
+                      pmap);
+    for (auto& tile : tiles)
+      if (!result.is_zero(tile.first))
+        result.set(tile.first, std::move(tile.second));
+    out.array() = result;
+  }
 }
 
 }  // namespace TiledArray::expressions
@@ -27,6 +27,7 @@
 #define TILEDARRAY_EXPRESSIONS_EXPR_H__INCLUDED
 
 #include "../reduce_task.h"
+#include "../symm/tile_symmetry.h"
 #include "../tile_interface/cast.h"
 #include "../tile_interface/scale.h"
 #include "../tile_op/binary_reduction.h"
@@ -60,7 +61,8 @@ struct is_aliased;
 
 template <typename Engine>
 struct EngineParamOverride {
-  EngineParamOverride() : world(nullptr), pmap(), shape(nullptr) {}
+  EngineParamOverride()
+      : world(nullptr), pmap(), shape(nullptr), summa_replication(0u) {}
 
   typedef
       typename EngineTrait<Engine>::policy policy;  ///< The result policy type
@@ -72,6 +74,10 @@ struct EngineParamOverride {
   World* world;
   std::shared_ptr<pmap_interface> pmap;
   const shape_type* shape;
+  unsigned int summa_replication;  ///< Number of process grid layers used by
+                                   ///< a contraction (0 = use the default)
+  std::shared_ptr<const symmetry::TileSymmetry>
+      symmetry;  ///< Permutational symmetry of the result tiles
 };
 
 /// \brief type trait checks if T has array() member
@@ -148,6 +154,35 @@ class Expr {
     }
     return derived();
   }
+  /// \param layers the number of replicated process grid layers used to
+  /// evaluate a contraction expression (2.5D SUMMA); 1 selects the 2D SUMMA
+  /// algorithm, 0 the default (see \c TA_SUMMA_REPLICATION ). Ignored by
+  /// expressions that are not contractions.
+  Expr<Derived>& set_summa_replication(const unsigned int layers) {
+    if (override_ptr_) {
+      override_ptr_->summa_replication = layers;
+    } else {
+      override_ptr_ = std::make_shared<override_type>();
+      override_ptr_->summa_replication = layers;
+    }
+    return derived();
+  }
+  /// \param symm the permutational symmetry of the result tiles; only the
+  /// unique tiles of the result are evaluated (for sparse arrays the other
+  /// tiles are screened, e.g. contractions skip their products), and the
+  /// result array stores only the unique tiles (see
+  /// \c DistArray::make_symmetric ). The symmetry acts on the modes of the
+  /// result in the order of its annotation.
+  Expr<Derived>& set_symmetry(
+      std::shared_ptr<const symmetry::TileSymmetry> symm) {
+    if (override_ptr_) {
+      override_ptr_->symmetry = std::move(symm);
+    } else {
+      override_ptr_ = std::make_shared<override_type>();
+      override_ptr_->symmetry = std::move(symm);
+    }
+    return derived();
+  }
 
  private:
   /// Task function used to evaluate a lazy tile and apply an op
@@ -369,6 +404,63 @@ class Expr {
     return *static_cast<const derived_type*>(this);
   }
 
+  /// The world where this expression is evaluated for \c tsr
+
+  /// 1. result's world is assigned, use it
+  /// 2. if this expression's world was assigned by set_world(), use it
+  /// 3. otherwise revert to the TA default for the MADNESS world
+  /// \tparam A The array type
+  /// \tparam Alias Tile alias flag
+  /// \param tsr The tensor to be assigned
+  /// \return The target world
+  template <typename A, bool Alias>
+  World& target_world(const TsrExpr<A, Alias>& tsr) const {
+    const auto has_set_world = override_ptr_ && override_ptr_->world;
+    return (tsr.array().is_initialized()
+                ? tsr.array().world()
+                : (has_set_world ? *override_ptr_->world
+                                 : TiledArray::get_default_world()));
+  }
+
+  /// Evaluate an initialized engine and assign the result to \c tsr
+
+  /// \tparam A The array type
+  /// \tparam Alias Tile alias flag
+  /// \param engine An engine of this expression, initialized for \c tsr
+  /// \param tsr The tensor to be assigned
+  template <typename A, bool Alias>
+  void eval_engine_to(const engine_type& engine,
+                      TsrExpr<A, Alias>& tsr) const {
+    // Create the distributed evaluator from this expression
+    typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+    dist_eval.eval();
+
+    // Create the result array; a symmetric result stores only the unique
+    // tiles, the shape of the other tiles is copied from the unique tiles.
+    std::shared_ptr<const symmetry::TileSymmetry> symm;
+    if (override_ptr_) symm = override_ptr_->symmetry;
+    A result =
+        (symm ? A(dist_eval.world(), dist_eval.trange(),
+                  symm->symmetrize(dist_eval.shape(), dist_eval.trange()),
+                  dist_eval.pmap(), symm)
+              : A(dist_eval.world(), dist_eval.trange(), dist_eval.shape(),
+                  dist_eval.pmap()));
+
+    // Move the data from dist_eval into the result array. There is no
+    // communication in this step.
+    for (const auto index : *dist_eval.pmap()) {
+      if (dist_eval.is_zero(index)) continue;
+      if (symm && !result.pimpl()->is_stored(index)) continue;
+      auto tile_contents = dist_eval.get(index);
+      set_tile(result, index, tile_contents);
+    }
+
+    // Wait for child expressions of dist_eval
+    dist_eval.wait();
+    // Swap the new array with the result array object.
+    result.swap(tsr.array());
+  }
+
   /// Evaluate this object and assign it to \c tsr
 
   /// This expression is evaluated in parallel in distributed environments,
@@ -383,14 +475,7 @@ class Expr {
                   "Assignment to an array of lazy tiles is not supported.");
 
     // Get the target world
-    // 1. result's world is assigned, use it
-    // 2. if this expression's world was assigned by set_world(), use it
-    // 3. otherwise revert to the TA default for the MADNESS world
-    const auto has_set_world = override_ptr_ && override_ptr_->world;
-    World& world = (tsr.array().is_initialized()
-                        ? tsr.array().world()
-                        : (has_set_world ? *override_ptr_->world
-                                         : TiledArray::get_default_world()));
+    World& world = target_world(tsr);
 
     // Get the output process map.
     // If result's pmap is assigned use it as the initial guess
@@ -406,26 +491,36 @@ class Expr {
     engine_type engine(derived());
     engine.init(world, pmap, target_indices);
 
-    // Create the distributed evaluator from this expression
-    typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
-    dist_eval.eval();
+    eval_engine_to(engine, tsr);
+  }
 
-    // Create the result array
-    A result(dist_eval.world(), dist_eval.trange(), dist_eval.shape(),
-             dist_eval.pmap());
+  /// Predict the cost of assigning this object to \c tsr
 
-    // Move the data from dist_eval into the result array. There is no
-    // communication in this step.
-    for (const auto index : *dist_eval.pmap()) {
-      if (dist_eval.is_zero(index)) continue;
-      auto tile_contents = dist_eval.get(index);
-      set_tile(result, index, tile_contents);
-    }
+  /// This is a dry run of \c eval_to() : the expression engine is
+  /// initialized, which evaluates the tiled ranges, the shapes, and the
+  /// process maps of the expression tree, but no tile is computed, moved
+  /// or allocated, and \c tsr is not modified. No communication is
+  /// involved, and the prediction is the same on every process of the
+  /// target world. To predict the cost on another number of processes,
+  /// run the dry run with that number of processes.
+  /// \tparam A The array type
+  /// \tparam Alias Tile alias flag
+  /// \param tsr The tensor that would be assigned
+  /// \return The predicted cost of each process of the target world
+  template <typename A, bool Alias>
+  ExprCost predict_cost(const TsrExpr<A, Alias>& tsr) const {
+    World& world = target_world(tsr);
 
-    // Wait for child expressions of dist_eval
-    dist_eval.wait();
-    // Swap the new array with the result array object.
-    result.swap(tsr.array());
+    std::shared_ptr<typename TsrExpr<A, Alias>::array_type::pmap_interface>
+        pmap;
+    if (tsr.array().is_initialized()) pmap = tsr.array().pmap();
+
+    engine_type engine(derived());
+    engine.init(world, pmap, BipartiteIndexList(tsr.annotation()));
+
+    ExprCost cost(world.size());
+    engine.add_cost(cost);
+    return cost;
   }
 
   /// Evaluate this object and assign it to \c tsr
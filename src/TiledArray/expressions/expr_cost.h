@@ -0,0 +1,200 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  expr_cost.h
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_COST_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_COST_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/tiled_range.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace TiledArray {
+namespace expressions {
+
+/// Predicted cost of an expression evaluation on one process
+struct ProcessCost {
+  /// Floating-point operations, counted in operations on the numeric type of
+  /// the tiles (i.e. a complex multiply-add counts as 2)
+  double flops = 0.0;
+  std::size_t bytes_sent = 0ul;      ///< Tile data sent to other processes
+  std::size_t bytes_received = 0ul;  ///< Tile data received from others
+  std::size_t tasks = 0ul;           ///< Number of tile tasks
+  /// Tile memory allocated by the evaluation, assuming that no tile is
+  /// released before the evaluation is complete
+  std::size_t memory = 0ul;
+
+  /// Accumulate the cost of another process
+
+  /// \param other The cost to be added to this cost
+  /// \return A reference to this object
+  ProcessCost& operator+=(const ProcessCost& other) {
+    flops += other.flops;
+    bytes_sent += other.bytes_sent;
+    bytes_received += other.bytes_received;
+    tasks += other.tasks;
+    memory += other.memory;
+    return *this;
+  }
+};  // struct ProcessCost
+
+/// Predicted cost of an expression evaluation
+
+/// The cost is obtained from the structure of an initialized expression
+/// engine, i.e. from the tiled ranges, shapes, process maps and process
+/// grids, without computing or moving any tile; see
+/// \c Expr::predict_cost() and \c ExprPlan::predict_cost(). Since the
+/// structure is replicated the prediction is identical on every process.
+/// Tensor-of-tensor tiles are counted as one element per inner tensor.
+class ExprCost {
+ public:
+  typedef std::vector<ProcessCost>::size_type size_type;  ///< Size type
+
+ private:
+  std::vector<ProcessCost> procs_;  ///< The cost of each process
+
+ public:
+  /// Constructor
+
+  /// \param nprocs The number of processes
+  explicit ExprCost(const size_type nprocs) : procs_(nprocs) {}
+
+  /// \return The number of processes
+  size_type size() const { return procs_.size(); }
+
+  /// Process cost accessor
+
+  /// \param rank The rank of a process
+  /// \return A reference to the cost of process \c rank
+  ProcessCost& operator[](const size_type rank) {
+    TA_ASSERT(rank < procs_.size());
+    return procs_[rank];
+  }
+
+  /// Process cost accessor
+
+  /// \param rank The rank of a process
+  /// \return A const reference to the cost of process \c rank
+  const ProcessCost& operator[](const size_type rank) const {
+    TA_ASSERT(rank < procs_.size());
+    return procs_[rank];
+  }
+
+  /// Record a tile transfer
+
+  /// Nothing is recorded if \c source and \c target are the same process.
+  /// The copy of the tile counts toward the memory of \c target .
+  /// \param source The process that sends the tile
+  /// \param target The process that receives the tile
+  /// \param bytes The size of the tile data
+  void send(const size_type source, const size_type target,
+            const std::size_t bytes) {
+    if (source == target) return;
+    TA_ASSERT(source < procs_.size());
+    TA_ASSERT(target < procs_.size());
+    procs_[source].bytes_sent += bytes;
+    procs_[target].bytes_received += bytes;
+    procs_[target].memory += bytes;
+  }
+
+  /// \return The sum of the cost of all processes
+  ProcessCost total() const {
+    ProcessCost result;
+    for (const auto& proc : procs_) result += proc;
+    return result;
+  }
+
+  /// \return The maximum of each cost over all processes
+  ProcessCost max() const {
+    ProcessCost result;
+    for (const auto& proc : procs_) {
+      result.flops = std::max(result.flops, proc.flops);
+      result.bytes_sent = std::max(result.bytes_sent, proc.bytes_sent);
+      result.bytes_received =
+          std::max(result.bytes_received, proc.bytes_received);
+      result.tasks = std::max(result.tasks, proc.tasks);
+      result.memory = std::max(result.memory, proc.memory);
+    }
+    return result;
+  }
+};  // class ExprCost
+
+namespace detail {
+
+/// Fused tile extents of a range of dimensions
+
+/// \param trange A tiled range
+/// \param first The first dimension
+/// \param last One past the last dimension
+/// \return The number of elements of each tile of dimensions
+/// <tt>[first,last)</tt> of \c trange , in row-major order
+inline std::vector<std::size_t> fused_tile_extents(const TiledRange& trange,
+                                                   const unsigned int first,
+                                                   const unsigned int last) {
+  std::vector<std::size_t> result(1ul, 1ul);
+  for (unsigned int d = first; d < last; ++d) {
+    const auto& tr1 = trange.data()[d];
+    std::vector<std::size_t> fused;
+    fused.reserve(result.size() * tr1.tile_extent());
+    for (const auto extent : result)
+      for (const auto& tile : tr1)
+        fused.push_back(extent * (tile.second - tile.first));
+    result.swap(fused);
+  }
+  return result;
+}
+
+}  // namespace detail
+
+/// Print the predicted cost of each process and the total
+
+/// \param os The output stream
+/// \param cost The predicted cost
+/// \return \c os
+inline std::ostream& operator<<(std::ostream& os, const ExprCost& cost) {
+  auto print = [&os](const auto& label, const ProcessCost& proc) {
+    os << std::setw(8) << label << std::setw(14) << proc.flops
+       << std::setw(14) << proc.bytes_sent << std::setw(14)
+       << proc.bytes_received << std::setw(10) << proc.tasks << std::setw(14)
+       << proc.memory << "\n";
+  };
+  os << std::setw(8) << "rank" << std::setw(14) << "flops" << std::setw(14)
+     << "bytes sent" << std::setw(14) << "bytes recv" << std::setw(10)
+     << "tasks" << std::setw(14) << "memory"
+     << "\n";
+  for (ExprCost::size_type rank = 0ul; rank < cost.size(); ++rank)
+    print(rank, cost[rank]);
+  print("max", cost.max());
+  print("total", cost.total());
+  return os;
+}
+
+}  // namespace expressions
+
+using expressions::ExprCost;
+using expressions::ProcessCost;
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_EXPRESSIONS_EXPR_COST_H__INCLUDED
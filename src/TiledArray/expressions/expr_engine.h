@@ -26,8 +26,11 @@
 #ifndef TILEDARRAY_EXPRESSIONS_EXPR_ENGINE_H__INCLUDED
 #define TILEDARRAY_EXPRESSIONS_EXPR_ENGINE_H__INCLUDED
 
+#include <TiledArray/expressions/expr_cost.h>
 #include <TiledArray/expressions/expr_trace.h>
 #include <TiledArray/external/madness.h>
+#include <TiledArray/perm_index.h>
+#include <TiledArray/type_traits.h>
 
 namespace TiledArray {
 namespace expressions {
@@ -40,6 +43,23 @@ class Expr;
 template <typename>
 struct EngineTrait;
 
+/// Criterion for reusing the structure of an initialized engine
+
+/// An \c ExprPlan evaluates the same engine repeatedly; before each
+/// evaluation the engine is rebound to the current arguments, and the
+/// criterion decides whether the structure computed by \c ExprEngine::init
+/// (permutations, tiled ranges, shapes, process grid and maps) is still
+/// valid.
+enum class PlanReuse {
+  /// The tiled ranges, the shapes and the scaling factors of all arguments
+  /// are unchanged
+  same_shape,
+  /// The tiled ranges, the zero tiles of the shapes and the scaling factors
+  /// of all arguments are unchanged; the shape norms computed by the first
+  /// evaluation are kept as estimates
+  same_zero_tiles
+};
+
 /// Expression engine
 template <typename Derived>
 class ExprEngine : private NO_DEFAULTS {
@@ -159,6 +179,9 @@ class ExprEngine : private NO_DEFAULTS {
 
     if (override_ptr_ && override_ptr_->shape)
       shape_ = shape_.mask(*override_ptr_->shape);
+    // Only the unique tiles of a symmetric result are evaluated
+    if (override_ptr_ && override_ptr_->symmetry)
+      shape_ = override_ptr_->symmetry->mask(shape_, trange_);
   }
 
   /// Initialize result tensor distribution
@@ -268,6 +291,51 @@ class ExprEngine : private NO_DEFAULTS {
   /// \return An expression tag used to identify this expression
   const char* make_tag() const { return ""; }
 
+  /// Size of a tile element
+
+  /// \return The size of the numeric type of the result tiles, in bytes
+  static constexpr std::size_t element_size() {
+    return sizeof(TiledArray::detail::numeric_t<value_type>);
+  }
+
+  /// Floating-point operations per element of the tile operation
+
+  /// Derived classes override this function if their tile operation adds,
+  /// multiplies or scales.
+  /// \return The number of operations per result element
+  static constexpr unsigned int flops_per_element() { return 0u; }
+
+  /// Accumulate the predicted cost of this expression
+
+  /// This is the cost of an element-wise tile operation: each nonzero tile
+  /// is computed by the owner of the corresponding argument tiles, which
+  /// have the same (unpermuted) process map as this expression, and then
+  /// sent to the owner of the permuted tile. Derived classes add the cost
+  /// of their arguments, or override this function.
+  /// \param cost The cost of this expression is added to \c cost
+  void add_cost(ExprCost& cost) const {
+    const auto& tiles_range = trange_.tiles_range();
+    const Permutation perm = outer(perm_);
+    const PermIndex target_to_source =
+        (perm ? PermIndex(tiles_range, -perm) : PermIndex());
+    const double flops = derived_type::flops_per_element();
+
+    const auto volume = tiles_range.volume();
+    for (std::decay_t<decltype(volume)> index = 0ul; index < volume; ++index) {
+      if (shape_.is_zero(index)) continue;
+      const auto source_index =
+          (target_to_source ? target_to_source(index) : index);
+      const ProcessID source = pmap_->owner(source_index);
+      const std::size_t size = trange_.make_tile_range(index).volume();
+
+      ProcessCost& proc = cost[source];
+      proc.flops += flops * size;
+      ++proc.tasks;
+      proc.memory += size * element_size();
+      cost.send(source, pmap_->owner(index), size * element_size());
+    }
+  }
+
 };  // class ExprEngine
 
 }  // namespace expressions
@@ -0,0 +1,182 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  expr_plan.h
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
+
+#include <TiledArray/expressions/tsr_expr.h>
+
+#include <memory>
+
+namespace TiledArray {
+namespace expressions {
+
+/// A compiled assignment of an expression to an array
+
+/// Assigning an expression to an array, e.g.
+/// \code
+/// r("i,j,a,b") = t("i,j,c,d") * g("a,b,c,d");
+/// \endcode
+/// initializes a new expression engine every time. This computes the
+/// permutations of the arguments, the tiled range and the shape of every
+/// intermediate (e.g. \c SparseShape::gemm for contractions), and the
+/// process grids and process maps, before any tile is computed. A plan
+/// keeps the initialized engine, so that evaluating the same assignment
+/// again only does the tile operations:
+/// \code
+/// auto plan = make_plan(r("i,j,a,b"), t("i,j,c,d") * g("a,b,c,d"));
+/// for (...) {
+///   // update the data of t and g
+///   plan.eval();  // same as r("i,j,a,b") = t("i,j,c,d") * g("a,b,c,d");
+/// }
+/// \endcode
+/// The plan refers to the arrays of the expression, which must outlive it,
+/// and it uses their current contents when it is evaluated. Before every
+/// evaluation the engine is rebound to the current arrays; if their tiled
+/// ranges or shapes, the scaling factors, or the world of the result have
+/// changed, the plan is recompiled automatically.
+/// \tparam A The result array type
+/// \tparam Alias The tile alias flag of the result
+/// \tparam E The expression type
+template <typename A, bool Alias, typename E>
+class ExprPlan {
+ public:
+  typedef TsrExpr<A, Alias> result_type;           ///< The result type
+  typedef E expr_type;                             ///< The expression type
+  typedef typename E::engine_type engine_type;     ///< The engine type
+
+ private:
+  result_type result_;                    ///< The assigned array
+  expr_type expr_;                        ///< The expression
+  PlanReuse reuse_;                       ///< The reuse criterion
+  std::unique_ptr<engine_type> engine_;   ///< The initialized engine
+  std::size_t compilations_ = 0ul;        ///< The number of compilations
+
+  /// Initialize a new engine
+
+  /// \param world The world where the expression is evaluated
+  void compile(World& world) {
+    static_assert(!is_lazy_tile<typename A::value_type>::value,
+                  "Assignment to an array of lazy tiles is not supported.");
+
+    // As in Expr::eval_to, the process map of the result is the initial
+    // guess
+    std::shared_ptr<typename A::pmap_interface> pmap;
+    if (result_.array().is_initialized()) pmap = result_.array().pmap();
+
+    engine_ = std::make_unique<engine_type>(expr_);
+    engine_->init(world, pmap, BipartiteIndexList(result_.annotation()));
+    ++compilations_;
+  }
+
+  /// Rebind the engine to the current arguments, or recompile it
+  void prepare() {
+    World& world = expr_.target_world(result_);
+    const bool valid = engine_ && (engine_->world() == &world) &&
+                       engine_->rebind(expr_, reuse_);
+    if (!valid) compile(world);
+  }
+
+ public:
+  ExprPlan() = delete;
+  ExprPlan(const ExprPlan&) = delete;
+  ExprPlan(ExprPlan&&) = default;
+  ExprPlan& operator=(const ExprPlan&) = delete;
+  ExprPlan& operator=(ExprPlan&&) = default;
+
+  /// Construct a plan
+
+  /// The plan is compiled by the first evaluation.
+  /// \param result The array to be assigned
+  /// \param expr The expression
+  /// \param reuse The criterion for reusing the plan
+  ExprPlan(const result_type& result, const expr_type& expr,
+           const PlanReuse reuse = PlanReuse::same_shape)
+      : result_(result), expr_(expr), reuse_(reuse) {}
+
+  /// Evaluate the expression and assign it to the result
+
+  /// The plan is recompiled first if it is not valid for the current
+  /// arguments. This is a collective operation: all processes must evaluate
+  /// the plan, and they reach the same decision to recompile it.
+  /// \return The result array
+  A& eval() {
+    prepare();
+    expr_.eval_engine_to(*engine_, result_);
+    return result_.array();
+  }
+
+  /// Predict the cost of evaluating the plan
+
+  /// The plan is recompiled first if it is not valid for the current
+  /// arguments, as in \c eval(), but it is not evaluated; see
+  /// \c Expr::predict_cost() .
+  /// \return The predicted cost of each process
+  ExprCost predict_cost() {
+    prepare();
+    ExprCost cost(engine_->world()->size());
+    engine_->add_cost(cost);
+    return cost;
+  }
+
+  /// Discard the compiled plan; the next evaluation recompiles it
+  void invalidate() { engine_.reset(); }
+
+  /// \return \c true if the plan has been compiled
+  bool compiled() const { return static_cast<bool>(engine_); }
+
+  /// \return The number of times the plan has been compiled
+  std::size_t compilations() const { return compilations_; }
+
+  /// Print the compiled expression
+
+  /// \param os The output stream
+  /// \throw TiledArray::Exception if the plan has not been compiled
+  void print(ExprOStream os) const {
+    TA_ASSERT(engine_);
+    engine_->print(os, BipartiteIndexList(result_.annotation()));
+  }
+};  // class ExprPlan
+
+/// Construct a compiled assignment
+
+/// \tparam A The result array type
+/// \tparam Alias The tile alias flag of the result
+/// \tparam D The expression type
+/// \param result The array to be assigned, e.g. \c r("i,j")
+/// \param expr The expression, e.g. \c t("i,k")*g("k,j")
+/// \param reuse The criterion for reusing the plan
+/// \return The plan
+template <typename A, bool Alias, typename D>
+ExprPlan<A, Alias, D> make_plan(const TsrExpr<A, Alias>& result,
+                                const Expr<D>& expr,
+                                const PlanReuse reuse = PlanReuse::same_shape) {
+  return ExprPlan<A, Alias, D>(result, expr.derived(), reuse);
+}
+
+}  // namespace expressions
+
+using expressions::make_plan;
+using expressions::PlanReuse;
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
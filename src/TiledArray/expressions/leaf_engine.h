@@ -32,6 +32,24 @@
 namespace TiledArray {
 namespace expressions {
 
+/// Compare the zero tiles of two shapes
+
+/// \param a A shape
+/// \param b A shape of the same tiled range as \p a
+/// \return \c true if \p a and \p b have the same zero tiles
+template <typename Shape>
+bool same_zero_tiles(const Shape& a, const Shape& b) {
+  if constexpr (Shape::is_dense()) {
+    return true;
+  } else {
+    const auto volume = a.data().range().volume();
+    if (volume != b.data().range().volume()) return false;
+    for (std::size_t ord = 0ul; ord < volume; ++ord)
+      if (a.is_zero(ord) != b.is_zero(ord)) return false;
+    return true;
+  }
+}
+
 /// Leaf expression engine
 
 /// \tparam Derived The derived class type
@@ -126,6 +144,27 @@ class LeafEngine : public ExprEngine<Derived> {
   /// This function is a noop since the index list is fixed.
   void init_indices() {}
 
+  /// Rebind this engine to the array of an expression
+
+  /// \param expr An expression of the same type as the one this engine was
+  /// constructed from
+  /// \param reuse The criterion for reusing the structure of this engine
+  /// \return \c true if the structure of this engine is valid for the array
+  /// of \p expr
+  template <typename D>
+  bool rebind(const Expr<D>& expr, const PlanReuse reuse) {
+    const array_type& array = expr.derived().array();
+    const bool valid =
+        array.is_initialized() &&
+        (array.id() == array_.id() ||
+         (array.trange() == array_.trange() &&
+          (reuse == PlanReuse::same_shape
+               ? array.shape() == array_.shape()
+               : same_zero_tiles(array.shape(), array_.shape()))));
+    array_ = array;
+    return valid;
+  }
+
   void init_distribution(World* world,
                          const std::shared_ptr<pmap_interface>& pmap) {
     ExprEngine_::init_distribution(world, (pmap ? pmap : array_.pmap()));
@@ -171,6 +210,56 @@ class LeafEngine : public ExprEngine<Derived> {
     return dist_eval_type(pimpl);
   }
 
+  /// Accumulate the predicted cost of this expression
+
+  /// Each nonzero tile is fetched from the owner of the array tile by the
+  /// owner of the tile of this expression, and copied if it is permuted or
+  /// scaled.
+  /// \param cost The cost of this expression is added to \c cost
+  void add_cost(ExprCost& cost) const {
+    add_cost(cost, [](const auto index) { return index; }, false);
+  }
+
+ protected:
+  /// Accumulate the predicted cost of this expression
+
+  /// \tparam ArrayIndex The type of \c array_index
+  /// \param cost The cost of this expression is added to \c cost
+  /// \param array_index A function that maps the unpermuted ordinal index of
+  /// a tile of this expression to the ordinal index of the array tile
+  /// \param copy If \c true the tile operation always copies the tiles
+  template <typename ArrayIndex>
+  void add_cost(ExprCost& cost, const ArrayIndex& array_index,
+                const bool copy) const {
+    const auto& tiles_range = trange_.tiles_range();
+    const Permutation perm = outer(perm_);
+    const PermIndex target_to_source =
+        (perm ? PermIndex(tiles_range, -perm) : PermIndex());
+    const double flops = Derived::flops_per_element();
+    const auto& array_pmap = array_.pmap();
+
+    const auto volume = tiles_range.volume();
+    for (std::decay_t<decltype(volume)> index = 0ul; index < volume; ++index) {
+      if (shape_.is_zero(index)) continue;
+      const ProcessID source = array_pmap->owner(
+          array_index(target_to_source ? target_to_source(index) : index));
+      const ProcessID target = pmap_->owner(index);
+      const std::size_t bytes = trange_.make_tile_range(index).volume() *
+                                ExprEngine_::element_size();
+
+      if (source != target) {
+        cost.send(source, target, bytes);
+      } else if (copy || perm || flops > 0.0) {
+        cost[target].memory += bytes;
+      } else {
+        continue;
+      }
+      ProcessCost& proc = cost[target];
+      proc.flops += flops * (bytes / ExprEngine_::element_size());
+      ++proc.tasks;
+    }
+  }
+
 };  // class LeafEngine
 
 }  // namespace expressions
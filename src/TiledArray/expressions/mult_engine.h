@@ -390,6 +390,22 @@ class MultEngine : public ContEngine<MultEngine<Left, Right, Result>> {
                                              outer(perm));
   }
 
+  /// Floating-point operations per element of the tile operation
+
+  /// \return The number of operations per result element (Hadamard product)
+  static constexpr unsigned int flops_per_element() { return 1u; }
+
+  /// Accumulate the predicted cost of this expression
+
+  /// \param cost The cost of this expression and its arguments is added to
+  /// \c cost
+  void add_cost(ExprCost& cost) const {
+    if (this->product_type() == TensorProduct::Contraction)
+      ContEngine_::add_cost(cost);
+    else
+      BinaryEngine_::add_cost(cost);
+  }
+
   /// Non-permuting tile operation factory function
 
   /// \return The tile operation
@@ -524,6 +540,18 @@ class ScalMultEngine
   template <typename L, typename R, typename S>
   ScalMultEngine(const ScalMultExpr<L, R, S>& expr) : ContEngine_(expr) {}
 
+  /// Rebind the leaves of this engine to the arrays of an expression
+
+  /// \param expr An expression of the same type as the one this engine was
+  /// constructed from
+  /// \param reuse The criterion for reusing the structure of this engine
+  /// \return \c true if the structure of this engine is valid for \p expr
+  template <typename L, typename R, typename S>
+  bool rebind(const ScalMultExpr<L, R, S>& expr, const PlanReuse reuse) {
+    return ContEngine_::rebind(expr, reuse) &&
+           (ContEngine_::factor_ == expr.factor());
+  }
+
   /// Set the index list for this expression
 
   /// This function will set the index list for this expression and its
@@ -654,6 +682,22 @@ class ScalMultEngine
                                              ContEngine_::factor_, perm);
   }
 
+  /// Floating-point operations per element of the tile operation
+
+  /// \return The number of operations per result element (Hadamard product and scale)
+  static constexpr unsigned int flops_per_element() { return 2u; }
+
+  /// Accumulate the predicted cost of this expression
+
+  /// \param cost The cost of this expression and its arguments is added to
+  /// \c cost
+  void add_cost(ExprCost& cost) const {
+    if (this->product_type() == TensorProduct::Contraction)
+      ContEngine_::add_cost(cost);
+    else
+      BinaryEngine_::add_cost(cost);
+  }
+
   /// Non-permuting tile operation factory function
 
   /// \return The tile operation
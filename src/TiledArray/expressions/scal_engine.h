@@ -122,6 +122,17 @@ class ScalEngine : public UnaryEngine<ScalEngine<Arg, Scalar, Result>> {
   ScalEngine(const ScalExpr<A, S>& expr)
       : UnaryEngine_(expr), factor_(expr.factor()) {}
 
+  /// Rebind the leaves of this engine to the arrays of an expression
+
+  /// \param expr An expression of the same type as the one this engine was
+  /// constructed from
+  /// \param reuse The criterion for reusing the structure of this engine
+  /// \return \c true if the structure of this engine is valid for \p expr
+  template <typename A, typename S>
+  bool rebind(const ScalExpr<A, S>& expr, const PlanReuse reuse) {
+    return UnaryEngine_::rebind(expr, reuse) && (factor_ == expr.factor());
+  }
+
   /// Non-permuting shape factory function
 
   /// \return The result shape
@@ -137,6 +148,11 @@ class ScalEngine : public UnaryEngine<ScalEngine<Arg, Scalar, Result>> {
     return UnaryEngine_::arg_.shape().scale(factor_, perm);
   }
 
+  /// Floating-point operations per element of the tile operation
+
+  /// \return The number of operations per result element (scale)
+  static constexpr unsigned int flops_per_element() { return 1u; }
+
   /// Non-permuting tile operation factory function
 
   /// \return The tile operation
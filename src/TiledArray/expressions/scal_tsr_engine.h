@@ -121,6 +121,17 @@ class ScalTsrEngine : public LeafEngine<ScalTsrEngine<Array, Scalar, Result>> {
   ScalTsrEngine(const ScalTsrExpr<A, S>& expr)
       : LeafEngine_(expr), factor_(expr.factor()) {}
 
+  /// Rebind this engine to the array of an expression
+
+  /// \param expr An expression of the same type as the one this engine was
+  /// constructed from
+  /// \param reuse The criterion for reusing the structure of this engine
+  /// \return \c true if the structure of this engine is valid for \p expr
+  template <typename A, typename S>
+  bool rebind(const ScalTsrExpr<A, S>& expr, const PlanReuse reuse) {
+    return LeafEngine_::rebind(expr, reuse) && (factor_ == expr.factor());
+  }
+
   /// Non-permuting shape factory function
 
   /// \return The result shape
@@ -134,6 +145,11 @@ class ScalTsrEngine : public LeafEngine<ScalTsrEngine<Array, Scalar, Result>> {
     return LeafEngine_::array_.shape().scale(factor_, perm);
   }
 
+  /// Floating-point operations per element of the tile operation
+
+  /// \return The number of operations per result element (scale)
+  static constexpr unsigned int flops_per_element() { return 1u; }
+
   /// Non-permuting tile operation factory function
 
   /// \return The tile operation
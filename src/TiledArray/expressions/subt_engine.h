@@ -186,6 +186,11 @@ class SubtEngine : public BinaryEngine<SubtEngine<Left, Right, Result>> {
                                              perm);
   }
 
+  /// Floating-point operations per element of the tile operation
+
+  /// \return The number of operations per result element (subtract)
+  static constexpr unsigned int flops_per_element() { return 1u; }
+
   /// Non-permuting tile operation factory function
 
   /// \return The tile operation
@@ -270,6 +275,17 @@ class ScalSubtEngine
   ScalSubtEngine(const ScalSubtExpr<L, R, S>& expr)
       : BinaryEngine_(expr), factor_(expr.factor()) {}
 
+  /// Rebind the leaves of this engine to the arrays of an expression
+
+  /// \param expr An expression of the same type as the one this engine was
+  /// constructed from
+  /// \param reuse The criterion for reusing the structure of this engine
+  /// \return \c true if the structure of this engine is valid for \p expr
+  template <typename L, typename R, typename S>
+  bool rebind(const ScalSubtExpr<L, R, S>& expr, const PlanReuse reuse) {
+    return BinaryEngine_::rebind(expr, reuse) && (factor_ == expr.factor());
+  }
+
   /// Non-permuting shape factory function
 
   /// \return The result shape
@@ -287,6 +303,11 @@ class ScalSubtEngine
                                              factor_, perm);
   }
 
+  /// Floating-point operations per element of the tile operation
+
+  /// \return The number of operations per result element (subtract and scale)
+  static constexpr unsigned int flops_per_element() { return 2u; }
+
   /// Non-permuting tile operation factory function
 
   /// \return The tile operation
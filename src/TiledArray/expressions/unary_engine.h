@@ -89,6 +89,17 @@ class UnaryEngine : ExprEngine<Derived> {
   template <typename D>
   UnaryEngine(const UnaryExpr<D>& expr) : ExprEngine_(expr), arg_(expr.arg()) {}
 
+  /// Rebind the leaves of this engine to the arrays of an expression
+
+  /// \param expr An expression of the same type as the one this engine was
+  /// constructed from
+  /// \param reuse The criterion for reusing the structure of this engine
+  /// \return \c true if the structure of this engine is valid for \p expr
+  template <typename D>
+  bool rebind(const UnaryExpr<D>& expr, const PlanReuse reuse) {
+    return arg_.rebind(expr.arg(), reuse);
+  }
+
   // Pull base class functions into this class.
   using ExprEngine_::derived;
   using ExprEngine_::indices;
@@ -173,6 +184,15 @@ class UnaryEngine : ExprEngine<Derived> {
     return dist_eval_type(pimpl);
   }
 
+  /// Accumulate the predicted cost of this expression
+
+  /// \param cost The cost of this expression and its arguments is added to
+  /// \c cost
+  void add_cost(ExprCost& cost) const {
+    arg_.add_cost(cost);
+    ExprEngine_::add_cost(cost);
+  }
+
   /// Expression print
 
   /// \param os The output stream
@@ -48,6 +48,8 @@ inline World& initialize(int& argc, char**& argv, const MPI_Comm& comm,
 
 /// Finalizes TiledArray (and MADWorld runtime, if it had not been initialized
 /// when TiledArray::initialize was called).
+/// @note if tracing is enabled, writes the trace events of this rank, see
+///       TiledArray/util/tracing.h
 void finalize();
 
 }  // namespace TiledArray
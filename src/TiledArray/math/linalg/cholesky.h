@@ -28,15 +28,29 @@
 #if TILEDARRAY_HAS_SCALAPACK
 #include <TiledArray/math/linalg/scalapack/cholesky.h>
 #endif
+#include <TiledArray/math/linalg/native/cholesky.h>
 #include <TiledArray/math/linalg/non-distributed/cholesky.h>
 
 namespace TiledArray::math::linalg {
 
+namespace detail {
+
+/// \c true if the tile tasks of \c native can factorize \c Array
+template <typename Array>
+constexpr bool use_native_v =
+    TiledArray::detail::is_ta_tensor_v<typename Array::value_type>;
+
+}  // namespace detail
+
 template <typename Array>
 auto cholesky(const Array& A, TiledRange l_trange = TiledRange()) {
 #if TILEDARRAY_HAS_SCALAPACK
   if (A.world().size() > 1 && A.range().volume() > 10000000)
     return scalapack::cholesky<Array>(A, l_trange);
+#else
+  if constexpr (detail::use_native_v<Array>)
+    if (A.world().size() > 1 && A.range().volume() > 10000000)
+      return native::cholesky(A, l_trange);
 #endif
   return non_distributed::cholesky<Array>(A, l_trange);
 }
@@ -46,6 +60,10 @@ auto cholesky_linv(const Array& A, TiledRange l_trange = TiledRange()) {
 #if TILEDARRAY_HAS_SCALAPACK
   if (A.world().size() > 1 && A.range().volume() > 10000000)
     return scalapack::cholesky_linv<Both>(A, l_trange);
+#else
+  if constexpr (detail::use_native_v<Array>)
+    if (A.world().size() > 1 && A.range().volume() > 10000000)
+      return native::cholesky_linv<Both>(A, l_trange);
 #endif
   return non_distributed::cholesky_linv<Both>(A, l_trange);
 }
@@ -56,6 +74,10 @@ auto cholesky_solve(const Array& A, const Array& B,
 #if TILEDARRAY_HAS_SCALAPACK
   if (A.world().size() > 1 && A.range().volume() > 10000000)
     return scalapack::cholesky_solve<Array>(A, B, x_trange);
+#else
+  if constexpr (detail::use_native_v<Array>)
+    if (A.world().size() > 1 && A.range().volume() > 10000000)
+      return native::cholesky_solve(A, B, x_trange);
 #endif
   return non_distributed::cholesky_solve(A, B, x_trange);
 }
@@ -68,6 +90,10 @@ auto cholesky_lsolve(Op transpose, const Array& A, const Array& B,
   if (A.world().size() > 1 && A.range().volume() > 10000000)
     return scalapack::cholesky_lsolve<Array>(transpose, A, B, l_trange,
                                              x_trange);
+#else
+  if constexpr (detail::use_native_v<Array>)
+    if (A.world().size() > 1 && A.range().volume() > 10000000)
+      return native::cholesky_lsolve(transpose, A, B, l_trange, x_trange);
 #endif
   return non_distributed::cholesky_lsolve(transpose, A, B, l_trange, x_trange);
 }
@@ -28,6 +28,7 @@
 #if TILEDARRAY_HAS_SCALAPACK
 #include <TiledArray/math/linalg/scalapack/heig.h>
 #endif
+#include <TiledArray/math/linalg/native/heig.h>
 #include <TiledArray/math/linalg/non-distributed/heig.h>
 
 namespace TiledArray::math::linalg {
@@ -38,6 +39,13 @@ auto heig(const Array& A, TiledRange evec_trange = TiledRange()) {
   if (A.world().size() > 1 && A.range().volume() > 10000000) {
     return scalapack::heig(A, evec_trange);
   }
+#else
+  if constexpr (TiledArray::detail::is_ta_tensor_v<
+                    typename Array::value_type>) {
+    if (A.world().size() > 1 && A.range().volume() > 10000000) {
+      return native::heig(A, evec_trange);
+    }
+  }
 #endif
   return non_distributed::heig(A, evec_trange);
 }
@@ -0,0 +1,592 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021 Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  cholesky.h
+ *
+ */
+#ifndef TILEDARRAY_MATH_LINALG_NATIVE_CHOL_H__INCLUDED
+#define TILEDARRAY_MATH_LINALG_NATIVE_CHOL_H__INCLUDED
+
+#include <TiledArray/config.h>
+
+#include <TiledArray/conversions/make_array.h>
+#include <TiledArray/conversions/retile.h>
+#include <TiledArray/dist_array.h>
+#include <TiledArray/math/linalg/forward.h>
+#include <TiledArray/math/linalg/native/util.h>
+#include <Eigen/Cholesky>
+
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace TiledArray::math::linalg::native {
+
+namespace detail {
+
+/// Cholesky factorization of a diagonal tile (LAPACK's ?potrf)
+
+/// \param a The lower triangle of a Hermitian positive definite tile
+/// \return \p a overwritten by its lower triangular Cholesky factor
+/// \throw TiledArray::Exception if \p a is not positive definite
+template <typename Tile>
+Tile potrf(Tile a) {
+  using T = typename Tile::numeric_type;
+  auto A = matrix_map(a);
+  ::Eigen::LLT<Matrix<T>> llt(A);
+  if (llt.info() != ::Eigen::Success)
+    TA_EXCEPTION("cholesky: the matrix is not positive definite");
+  A = llt.matrixL().toDenseMatrix();
+  return a;
+}
+
+/// Solve \f$ X L^H = B \f$ for a tile of the panel (LAPACK's ?trsm)
+
+/// \param b The tile \c B
+/// \param l The lower triangular diagonal tile \c L
+/// \return \p b overwritten by \c X
+template <typename Tile>
+Tile trsm_panel(Tile b, const Tile& l) {
+  auto B = matrix_map(b);
+  matrix_map(l)
+      .template triangularView<::Eigen::Lower>()
+      .adjoint()
+      .template solveInPlace<::Eigen::OnTheRight>(B);
+  return b;
+}
+
+/// Update a diagonal tile of the trailing matrix (LAPACK's ?herk)
+
+/// \param c The tile \c C ; only the lower triangle is referenced
+/// \param a The tile \c A
+/// \return \p c overwritten by \f$ C - A A^H \f$
+template <typename Tile>
+Tile herk(Tile c, const Tile& a) {
+  using R = TiledArray::detail::scalar_t<typename Tile::numeric_type>;
+  matrix_map(c).template selfadjointView<::Eigen::Lower>().rankUpdate(
+      matrix_map(a), R(-1));
+  return c;
+}
+
+/// Update an off-diagonal tile of the trailing matrix (BLAS's ?gemm)
+
+/// \param c The tile \c C
+/// \param a The tile \c A
+/// \param b The tile \c B
+/// \return \p c overwritten by \f$ C - A B^H \f$
+template <typename Tile>
+Tile gemm_nc(Tile c, const Tile& a, const Tile& b) {
+  matrix_map(c).noalias() -= matrix_map(a) * matrix_map(b).adjoint();
+  return c;
+}
+
+/// Solve \f$ op(L) X = B \f$ for one tile (LAPACK's ?trsm)
+
+/// \param b The tile \c B
+/// \param l The lower triangular diagonal tile \c L
+/// \param op The operation applied to \c L
+/// \return \p b overwritten by \c X
+template <typename Tile>
+Tile trsm_solve(Tile b, const Tile& l, const Op op) {
+  auto B = matrix_map(b);
+  const auto L = matrix_map(l).template triangularView<::Eigen::Lower>();
+  if (op == Op::NoTrans)
+    L.solveInPlace(B);
+  else if (op == Op::Trans)
+    L.transpose().solveInPlace(B);
+  else
+    L.adjoint().solveInPlace(B);
+  return b;
+}
+
+/// Update a tile of the right-hand side of a triangular solve (BLAS's ?gemm)
+
+/// \param c The tile \c C
+/// \param a The tile \c A
+/// \param b The tile \c B
+/// \param op The operation applied to \c A
+/// \return \p c overwritten by \f$ C - op(A) B \f$
+template <typename Tile>
+Tile gemm_solve(Tile c, const Tile& a, const Tile& b, const Op op) {
+  auto C = matrix_map(c);
+  const auto A = matrix_map(a);
+  const auto B = matrix_map(b);
+  if (op == Op::NoTrans)
+    C.noalias() -= A * B;
+  else if (op == Op::Trans)
+    C.noalias() -= A.transpose() * B;
+  else
+    C.noalias() -= A.adjoint() * B;
+  return c;
+}
+
+/// A matrix whose tiles are factorized by tasks
+
+/// Each rank holds the futures of the current version of its local tiles
+/// and of the final tiles that it has requested from other ranks. The tile
+/// structure, i.e. which tiles may be non-zero, is replicated on every rank
+/// and is updated symbolically as the tasks are submitted, so that no task
+/// is submitted for a tile that is known to be zero.
+/// \tparam Tile The tile type
+template <typename Tile>
+class TileMatrix {
+ public:
+  typedef DistArray<Tile, DensePolicy> array_type;  ///< The result array type
+  typedef Future<Tile> future;                       ///< Tile future type
+
+ private:
+  array_type result_;              ///< The final tiles
+  std::size_t rows_ = 0ul;         ///< The number of tile rows
+  std::size_t cols_ = 0ul;         ///< The number of tile columns
+  std::vector<bool> nonzero_;      ///< Structurally non-zero tiles
+  /// The current version of the local tiles that are not final yet
+  std::unordered_map<std::size_t, future> current_;
+  mutable std::unordered_map<std::size_t, future> cache_;  ///< Fetched tiles
+
+ public:
+  /// Copy the tiles of an array
+
+  /// \param array A rank-2 array
+  /// \param pred Only the tiles whose index satisfies \c pred(i,j) are
+  /// copied; the others are structurally zero
+  template <typename Array, typename Pred>
+  TileMatrix(const Array& array, const Pred& pred)
+      : result_(array.world(), array.trange(), array.pmap()),
+        rows_(array.trange().dim(0).tile_extent()),
+        cols_(array.trange().dim(1).tile_extent()),
+        nonzero_(rows_ * cols_, false) {
+    for (std::size_t i = 0ul; i < rows_; ++i)
+      for (std::size_t j = 0ul; j < cols_; ++j)
+        nonzero_[i * cols_ + j] = pred(i, j) && !array.is_zero({i, j});
+    for (const auto ordinal : *array.pmap())
+      if (nonzero_[ordinal])
+        current_.emplace(ordinal, world().taskq.add(
+                                      [](const Tile& tile) {
+                                        return tile.clone();
+                                      },
+                                      array.find(ordinal)));
+  }
+
+  World& world() const { return result_.world(); }
+  std::size_t rows() const { return rows_; }
+  std::size_t cols() const { return cols_; }
+  const array_type& array() const { return result_; }
+
+  /// \return \c true if tile \c (i,j) may be non-zero
+  bool nonzero(const std::size_t i, const std::size_t j) const {
+    return nonzero_[i * cols_ + j];
+  }
+
+  /// \return \c true if tile \c (i,j) is owned by this rank
+  bool is_local(const std::size_t i, const std::size_t j) const {
+    return result_.is_local(i * cols_ + j);
+  }
+
+  /// Update a local tile
+
+  /// Submits the task \c op(tile,args...) where \c tile is the current
+  /// version of tile \c (i,j) ; the result becomes the current version. A
+  /// structurally zero tile is filled in with zeros first.
+  /// \param i The tile row
+  /// \param j The tile column
+  /// \param op The update
+  /// \param args The futures or values of the other arguments of \p op
+  template <typename Fn, typename... Args>
+  void update(const std::size_t i, const std::size_t j, Fn op,
+              Args&&... args) {
+    const std::size_t ordinal = i * cols_ + j;
+    TA_ASSERT(result_.is_local(ordinal));
+    auto it = current_.find(ordinal);
+    if (it == current_.end()) {
+      TA_ASSERT(!nonzero_[ordinal]);  // final tiles cannot be updated
+      nonzero_[ordinal] = true;
+      it = current_
+               .emplace(ordinal,
+                        future(Tile(result_.trange().make_tile_range(ordinal),
+                                    typename Tile::numeric_type(0))))
+               .first;
+    }
+    it->second =
+        world().taskq.add(op, it->second, std::forward<Args>(args)...);
+  }
+
+  /// Mark a tile as non-zero on the ranks that do not own it
+
+  /// \param i The tile row
+  /// \param j The tile column
+  void fill_in(const std::size_t i, const std::size_t j) {
+    nonzero_[i * cols_ + j] = true;
+  }
+
+  /// Finalize a local tile
+
+  /// Submits the task \c op(tile,args...) where \c tile is the current
+  /// version of tile \c (i,j) , with high priority; the result is the final
+  /// version of the tile, which may then be fetched by any rank.
+  /// \param i The tile row
+  /// \param j The tile column
+  /// \param op The final operation
+  /// \param args The futures or values of the other arguments of \p op
+  template <typename Fn, typename... Args>
+  void finalize(const std::size_t i, const std::size_t j, Fn op,
+                Args&&... args) {
+    const std::size_t ordinal = i * cols_ + j;
+    auto it = current_.find(ordinal);
+    TA_ASSERT(it != current_.end());
+    result_.set(ordinal, world().taskq.add(op, it->second,
+                                           std::forward<Args>(args)...,
+                                           madness::TaskAttributes::hipri()));
+    current_.erase(it);
+  }
+
+  /// Fetch a final tile
+
+  /// Every tile is requested from its owner at most once.
+  /// \param i The tile row
+  /// \param j The tile column
+  /// \return A future to the final version of tile \c (i,j)
+  future fetch(const std::size_t i, const std::size_t j) const {
+    const std::size_t ordinal = i * cols_ + j;
+    TA_ASSERT(nonzero_[ordinal]);
+    auto it = cache_.find(ordinal);
+    if (it == cache_.end())
+      it = cache_.emplace(ordinal, result_.find(ordinal)).first;
+    return it->second;
+  }
+
+  /// Start a new computation from the final tiles
+
+  /// The final tiles become the current versions of the tiles, so that the
+  /// matrix can be updated and finalized again.
+  void reset() {
+    array_type result(world(), result_.trange(), result_.pmap());
+    for (const auto ordinal : *result_.pmap())
+      if (nonzero_[ordinal] && !current_.count(ordinal))
+        // The final tile may still be read by tasks of this rank
+        current_.emplace(ordinal, world().taskq.add(
+                                      [](const Tile& tile) {
+                                        return tile.clone();
+                                      },
+                                      result_.find(ordinal)));
+    result_ = result;
+    cache_.clear();
+  }
+
+  /// Convert the final tiles to an array
+
+  /// Tiles that are structurally zero are zero in the result, and the tiles
+  /// that were never finalized are taken as they are. This is a collective
+  /// operation.
+  /// \tparam Array The result array type
+  /// \return The array
+  template <typename Array>
+  Array to_array() {
+    using numeric_type = typename Tile::numeric_type;
+    for (const auto& tile : current_) result_.set(tile.first, tile.second);
+    current_.clear();
+    cache_.clear();
+    if constexpr (is_dense_v<typename Array::policy_type>) {
+      for (const auto ordinal : *result_.pmap())
+        if (!nonzero_[ordinal])
+          result_.set(ordinal, Tile(result_.trange().make_tile_range(ordinal),
+                                    numeric_type(0)));
+      return Array(result_);
+    } else {
+      using shape_type = typename Array::shape_type;
+      Tensor<typename shape_type::value_type> norms(
+          result_.trange().tiles_range(), 0);
+      for (const auto ordinal : *result_.pmap())
+        if (nonzero_[ordinal])
+          norms[ordinal] = result_.find(ordinal).get().norm();
+      const shape_type shape(world(), norms, result_.trange());
+      Array result(world(), result_.trange(), shape, result_.pmap());
+      for (const auto ordinal : *result_.pmap())
+        if (!result.is_zero(ordinal))
+          result.set(ordinal, result_.find(ordinal));
+      return result;
+    }
+  }
+};
+
+/// Factorize the tiles of a Hermitian positive definite matrix
+
+/// The right-looking tile algorithm submits, for each tile column \c k , a
+/// ?potrf task for the diagonal tile, ?trsm tasks for the panel and ?herk
+/// and ?gemm tasks for the trailing matrix. Every rank submits the tasks of
+/// its own tiles; the factorization of the next panel starts as soon as its
+/// tiles have been updated, overlapping the rest of the trailing update.
+/// Updates that involve structurally zero tiles are skipped.
+/// \param[in,out] A The lower triangle of the matrix; on exit the Cholesky
+/// factor
+template <typename Tile>
+void factorize(TileMatrix<Tile>& A) {
+  const std::size_t n = A.rows();
+  TA_ASSERT(A.cols() == n);
+  for (std::size_t k = 0ul; k < n; ++k) {
+    if (A.is_local(k, k)) A.finalize(k, k, &potrf<Tile>);
+    for (std::size_t i = k + 1ul; i < n; ++i)
+      if (A.nonzero(i, k) && A.is_local(i, k))
+        A.finalize(i, k, &trsm_panel<Tile>, A.fetch(k, k));
+
+    for (std::size_t j = k + 1ul; j < n; ++j) {
+      if (!A.nonzero(j, k)) continue;
+      for (std::size_t i = j; i < n; ++i) {
+        if (!A.nonzero(i, k)) continue;
+        if (!A.is_local(i, j))
+          A.fill_in(i, j);
+        else if (i == j)
+          A.update(i, j, &herk<Tile>, A.fetch(i, k));
+        else
+          A.update(i, j, &gemm_nc<Tile>, A.fetch(i, k), A.fetch(j, k));
+      }
+    }
+  }
+}
+
+/// Solve a triangular system with tasks
+
+/// Solves \f$ op(L) X = B \f$ by tile forward (\p op is \c Op::NoTrans ) or
+/// back substitution. Every rank submits the tasks of its own tiles of
+/// \c B ; updates that involve structurally zero tiles are skipped.
+/// \param L The lower triangular Cholesky factor
+/// \param[in,out] B The right-hand side; on exit the solution
+/// \param op The operation applied to \p L
+template <typename Tile>
+void solve(const TileMatrix<Tile>& L, TileMatrix<Tile>& B, const Op op) {
+  const std::size_t n = L.rows();
+  TA_ASSERT(B.rows() == n);
+  const bool forward = (op == Op::NoTrans);
+  for (std::size_t s = 0ul; s < n; ++s) {
+    const std::size_t k = (forward ? s : n - 1ul - s);
+    for (std::size_t j = 0ul; j < B.cols(); ++j)
+      if (B.nonzero(k, j) && B.is_local(k, j))
+        B.finalize(k, j, &trsm_solve<Tile>, L.fetch(k, k), op);
+
+    // The rows of B that have not been solved yet
+    const std::size_t first = (forward ? k + 1ul : 0ul);
+    const std::size_t last = (forward ? n : k);
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t li = (forward ? i : k);
+      const std::size_t lk = (forward ? k : i);
+      if (!L.nonzero(li, lk)) continue;
+      for (std::size_t j = 0ul; j < B.cols(); ++j) {
+        if (!B.nonzero(k, j)) continue;
+        if (!B.is_local(i, j))
+          B.fill_in(i, j);
+        else
+          B.update(i, j, &gemm_solve<Tile>, L.fetch(li, lk), B.fetch(k, j),
+                   op);
+      }
+    }
+  }
+}
+
+/// Copy a matrix into a TileMatrix with the square tiling of its rows
+
+/// \param A A square rank-2 array
+/// \param pred Only the tiles whose index satisfies \c pred(i,j) are copied
+template <typename Array, typename Pred>
+auto make_square_tile_matrix(const Array& A, const Pred& pred) {
+  TA_ASSERT(A.trange().rank() == 2);
+  TA_ASSERT(A.trange().dim(0).extent() == A.trange().dim(1).extent());
+  const TiledRange trange{A.trange().dim(0), A.trange().dim(0)};
+  return TileMatrix<typename Array::value_type>(
+      (A.trange() == trange ? A : retile(A, trange)), pred);
+}
+
+/// Copy a right-hand side into a TileMatrix whose rows are tiled like \p A
+
+/// \param B A rank-2 array
+/// \param A The matrix
+template <typename Tile, typename Array>
+auto make_rhs_tile_matrix(const Array& B, const TileMatrix<Tile>& A) {
+  TA_ASSERT(B.trange().rank() == 2);
+  const TiledRange trange{A.array().trange().dim(0), B.trange().dim(1)};
+  return TileMatrix<Tile>((B.trange() == trange ? B : retile(B, trange)),
+                          [](std::size_t, std::size_t) { return true; });
+}
+
+/// The predicate of the lower triangle of tiles
+inline bool lower_tiles(const std::size_t i, const std::size_t j) {
+  return i >= j;
+}
+
+/// Change the tiling of a result, if needed
+
+/// \param array The result
+/// \param trange The requested tiled range; empty keeps the tiling of
+/// \p array
+template <typename Array>
+Array with_trange(const Array& array, const TiledRange& trange) {
+  if (trange.rank() == 0 || trange == array.trange()) return array;
+  return retile(array, trange);
+}
+
+}  // namespace detail
+
+/**
+ *  @brief Compute the Cholesky factorization of a HPD rank-2 tensor with
+ *  tile tasks
+ *
+ *  A(i,j) = L(i,k) * conj(L(j,k))
+ *
+ *  The factorization works directly on the tiles of @p A , with the
+ *  process map of @p A , by a graph of ?potrf, ?trsm, ?herk and ?gemm tile
+ *  tasks; no block-cyclic or replicated copy of the matrix is made. The
+ *  zero tiles of a sparse @p A (and of its fill-in) are skipped.
+ *
+ *  Example Usage:
+ *
+ *  auto L = cholesky(A, ...)
+ *
+ *  @tparam Array a DistArray of TiledArray::Tensor tiles
+ *
+ *  @param[in] A           Input array to be factorized. Must be rank-2 and
+ *                         square; only its lower triangle is referenced
+ *  @param[in] l_trange    TiledRange for resulting Cholesky factor. If left
+ *                         empty, will default to array.trange()
+ *
+ *  @returns The lower triangular Cholesky factor L in TA format
+ *  @note this is a collective operation with respect to the world of @p A
+ */
+template <typename Array>
+auto cholesky(const Array& A, TiledRange l_trange = TiledRange()) {
+  auto L = detail::make_square_tile_matrix(A, detail::lower_tiles);
+  detail::factorize(L);
+  if (l_trange.rank() == 0) l_trange = A.trange();
+  return detail::with_trange(L.template to_array<Array>(),
+                             l_trange);
+}
+
+/**
+ *  @brief Compute the inverse of the Cholesky factor of an HPD rank-2 tensor
+ *  with tile tasks. Optionally return the Cholesky factor itself
+ *
+ *  A(i,j) = L(i,k) * conj(L(j,k)) -> compute Linv
+ *
+ *  The inverse is computed by a tile forward substitution on the identity;
+ *  only the lower triangle of tiles is ever formed.
+ *
+ *  @tparam Both  Whether or not to return the cholesky factor
+ *  @tparam Array a DistArray of TiledArray::Tensor tiles
+ *
+ *  @param[in] A           Input array to be factorized. Must be rank-2
+ *  @param[in] l_trange    TiledRange for resulting inverse Cholesky factor.
+ *                         If left empty, will default to array.trange()
+ *
+ *  @returns The inverse lower triangular Cholesky factor in TA format
+ *  @note this is a collective operation with respect to the world of @p A
+ */
+template <bool Both = false, typename Array>
+auto cholesky_linv(const Array& A, TiledRange l_trange = TiledRange()) {
+  using numeric_type = typename Array::numeric_type;
+  auto L = detail::make_square_tile_matrix(A, detail::lower_tiles);
+  detail::factorize(L);
+
+  // Solve L X = I
+  const auto& trange = L.array().trange();
+  auto identity = make_array<Array>(
+      A.world(), trange,
+      [](typename Array::value_type& tile, const Range& range) {
+        tile = typename Array::value_type(range, numeric_type(0));
+        const auto lo = range.lobound_data();
+        const auto up = range.upbound_data();
+        for (auto i = std::max(lo[0], lo[1]); i < std::min(up[0], up[1]); ++i)
+          tile(i, i) = numeric_type(1);
+        return tile.norm();
+      });
+  auto X = detail::TileMatrix<typename Array::value_type>(
+      identity, [](std::size_t i, std::size_t j) { return i == j; });
+  detail::solve(L, X, Op::NoTrans);
+
+  if (l_trange.rank() == 0) l_trange = A.trange();
+  auto L_inv = detail::with_trange(
+      X.template to_array<Array>(), l_trange);
+  if constexpr (Both)
+    return std::make_tuple(
+        detail::with_trange(L.template to_array<Array>(),
+                            l_trange),
+        L_inv);
+  else
+    return L_inv;
+}
+
+/**
+ *  @brief Solve A(i,k) X(k,j) = B(i,j) for an HPD rank-2 tensor A with tile
+ *  tasks
+ *
+ *  @tparam Array a DistArray of TiledArray::Tensor tiles
+ *
+ *  @param[in] A           The matrix. Must be rank-2 and square
+ *  @param[in] B           The right-hand sides. Must be rank-2
+ *  @param[in] x_trange    TiledRange for the solution. If left empty, will
+ *                         default to B.trange()
+ *
+ *  @returns The solution X in TA format
+ *  @note this is a collective operation with respect to the world of @p A
+ */
+template <typename Array>
+auto cholesky_solve(const Array& A, const Array& B,
+                    TiledRange x_trange = TiledRange()) {
+  auto L = detail::make_square_tile_matrix(A, detail::lower_tiles);
+  detail::factorize(L);
+  auto X = detail::make_rhs_tile_matrix(B, L);
+  detail::solve(L, X, Op::NoTrans);
+  X.reset();
+  detail::solve(L, X, Op::ConjTrans);
+  if (x_trange.rank() == 0) x_trange = B.trange();
+  return detail::with_trange(X.template to_array<Array>(), x_trange);
+}
+
+/**
+ *  @brief Compute the Cholesky factor L of an HPD rank-2 tensor A and solve
+ *  op(L)(i,k) X(k,j) = B(i,j) with tile tasks
+ *
+ *  @tparam Array a DistArray of TiledArray::Tensor tiles
+ *
+ *  @param[in] transpose   The operation applied to L
+ *  @param[in] A           The matrix. Must be rank-2 and square
+ *  @param[in] B           The right-hand sides. Must be rank-2
+ *  @param[in] l_trange    TiledRange for the Cholesky factor. If left empty,
+ *                         will default to A.trange()
+ *  @param[in] x_trange    TiledRange for the solution. If left empty, will
+ *                         default to B.trange()
+ *
+ *  @returns A tuple of the Cholesky factor L and the solution X in TA format
+ *  @note this is a collective operation with respect to the world of @p A
+ */
+template <typename Array>
+auto cholesky_lsolve(Op transpose, const Array& A, const Array& B,
+                     TiledRange l_trange = TiledRange(),
+                     TiledRange x_trange = TiledRange()) {
+  auto L = detail::make_square_tile_matrix(A, detail::lower_tiles);
+  detail::factorize(L);
+  auto X = detail::make_rhs_tile_matrix(B, L);
+  detail::solve(L, X, transpose);
+  if (l_trange.rank() == 0) l_trange = A.trange();
+  if (x_trange.rank() == 0) x_trange = B.trange();
+  return std::make_tuple(
+      detail::with_trange(L.template to_array<Array>(),
+                          l_trange),
+      detail::with_trange(X.template to_array<Array>(),
+                          x_trange));
+}
+
+}  // namespace TiledArray::math::linalg::native
+
+#endif  // TILEDARRAY_MATH_LINALG_NATIVE_CHOL_H__INCLUDED
@@ -0,0 +1,690 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021 Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  heig.h
+ *
+ */
+#ifndef TILEDARRAY_MATH_LINALG_NATIVE_HEIG_H__INCLUDED
+#define TILEDARRAY_MATH_LINALG_NATIVE_HEIG_H__INCLUDED
+
+#include <TiledArray/config.h>
+
+#include <TiledArray/conversions/dense_to_sparse.h>
+#include <TiledArray/conversions/retile.h>
+#include <TiledArray/external/eigen.h>
+#include <TiledArray/math/linalg/native/util.h>
+#include <TiledArray/math/linalg/util.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace TiledArray::math::linalg::native {
+
+namespace detail {
+
+/// Generate an elementary reflector (LAPACK's ?larfg)
+
+/// Computes \c tau and \c v such that
+/// \f$ (I - \tau v v^H)^H x = (\beta, 0, \dots, 0)^T \f$ with real
+/// \f$\beta\f$ and \f$ v_0 = 1 \f$.
+/// \param[in,out] x On entry the vector to be reflected; on exit \c x(0) is
+/// \f$\beta\f$ and \c x(1:) holds \c v(1:)
+/// \return \f$\tau\f$
+template <typename Derived>
+typename Derived::Scalar make_reflector(::Eigen::MatrixBase<Derived>& x) {
+  using T = typename Derived::Scalar;
+  using R = TiledArray::detail::scalar_t<T>;
+  const auto m = x.size();
+  const T alpha = x(0);
+  const R xnorm = (m > 1 ? x.tail(m - 1).norm() : R(0));
+  if (xnorm == R(0) && std::imag(alpha) == R(0)) return T(0);
+  const R beta = -std::copysign(std::hypot(std::abs(alpha), xnorm),
+                                std::real(alpha));
+  const T tau = (T(beta) - alpha) / T(beta);
+  if (m > 1) x.tail(m - 1) *= T(1) / (alpha - T(beta));
+  x(0) = T(beta);
+  return tau;
+}
+
+/// Blocked Householder reflectors of one tile column
+
+/// The product of the reflectors is \f$ I - V T V^H \f$.
+template <typename T>
+struct Reflectors {
+  Matrix<T> V;  ///< The reflectors, one per column
+  Matrix<T> T_;  ///< The upper triangular factor
+};
+
+/// Form the triangular factor of a block of reflectors (LAPACK's ?larft)
+
+/// \param V The reflectors, one per column
+/// \param tau The scale factors of the reflectors
+/// \return The upper triangular \c T such that
+/// \f$ H_0 H_1 \cdots = I - V T V^H \f$
+template <typename T>
+Matrix<T> make_block_reflector(const Matrix<T>& V, const std::vector<T>& tau) {
+  const auto nb = V.cols();
+  Matrix<T> result = Matrix<T>::Zero(nb, nb);
+  for (::Eigen::Index j = 0; j < nb; ++j) {
+    if (tau[j] == T(0)) continue;
+    if (j > 0) {
+      const Vector<T> x = V.leftCols(j).adjoint() * V.col(j);
+      const Vector<T> y =
+          result.topLeftCorner(j, j).template triangularView<::Eigen::Upper>() *
+          x;
+      result.col(j).head(j) = -tau[j] * y;
+    }
+    result(j, j) = tau[j];
+  }
+  return result;
+}
+
+/// Reduce a tile column of a Hermitian matrix to tridiagonal form (LAPACK's
+/// ?latrd)
+
+/// This is executed by the rank that owns the panel; the products of the
+/// trailing matrix with the reflectors are computed by \p matvec , which
+/// must be called by every rank.
+/// \param[in,out] panel The columns of the panel, with the rows of the whole
+/// matrix; the updates of the previous panels must have been applied
+/// \param first The index of the first column of the panel
+/// \param[out] V The reflectors (rows of the whole matrix)
+/// \param[out] W The matrix such that the trailing matrix is updated by
+/// \f$ A - V W^H - W V^H \f$
+/// \param[out] tau The scale factors of the reflectors
+/// \param[out] d The diagonal of the tridiagonal matrix
+/// \param[out] e The off-diagonal of the tridiagonal matrix
+/// \param matvec Computes \c y = A(i+1:,i+1:) v for the original trailing
+/// matrix \c A , called as \c matvec(v,y) ; \c v and \c y have the length of
+/// the whole matrix, and \c v is zero in rows \c 0..i
+template <typename T, typename MatVec>
+void tridiagonalize_panel(Matrix<T>& panel, const std::size_t first,
+                          Matrix<T>& V, Matrix<T>& W, std::vector<T>& tau,
+                          TiledArray::detail::scalar_t<T>* d,
+                          TiledArray::detail::scalar_t<T>* e,
+                          const MatVec& matvec) {
+  const ::Eigen::Index n = panel.rows();
+  const ::Eigen::Index nb = panel.cols();
+  V = Matrix<T>::Zero(n, nb);
+  W = Matrix<T>::Zero(n, nb);
+  tau.assign(nb, T(0));
+  Vector<T> v(n), y(n);
+
+  for (::Eigen::Index j = 0; j < nb; ++j) {
+    const ::Eigen::Index i = first + j;
+
+    // Apply the previous reflectors of the panel to column i
+    if (j > 0) {
+      panel.col(j).tail(n - i).noalias() -=
+          V.block(i, 0, n - i, j) * W.row(i).head(j).adjoint();
+      panel.col(j).tail(n - i).noalias() -=
+          W.block(i, 0, n - i, j) * V.row(i).head(j).adjoint();
+    }
+    d[i] = std::real(panel(i, j));
+    if (i + 1 >= n) break;
+
+    // Annihilate A(i+2:,i)
+    const ::Eigen::Index m = n - i - 1;
+    auto x = panel.col(j).tail(m);
+    tau[j] = make_reflector(x);
+    e[i] = std::real(x(0));
+    v.setZero();
+    v(i + 1) = T(1);
+    v.tail(m - 1) = x.tail(m - 1);
+
+    // Compute W(i+1:,j)
+    matvec(v, y);
+    const auto vs = v.tail(m);
+    Vector<T> w = y.tail(m);
+    if (j > 0) {
+      const Vector<T> wv = W.block(i + 1, 0, m, j).adjoint() * vs;
+      w.noalias() -= V.block(i + 1, 0, m, j) * wv;
+      const Vector<T> vv = V.block(i + 1, 0, m, j).adjoint() * vs;
+      w.noalias() -= W.block(i + 1, 0, m, j) * vv;
+    }
+    w *= tau[j];
+    const T alpha = T(-0.5) * tau[j] * w.dot(vs);
+    w += alpha * vs;
+    V.col(j).tail(m) = vs;
+    W.col(j).tail(m) = w;
+  }
+}
+
+/// Reduce a Hermitian matrix to real symmetric tridiagonal form
+
+/// Column \c k of tiles is reduced by rank \c k%P with ?latrd; the
+/// matrix-vector products with the trailing matrix and the rank-2k update
+/// of the trailing matrix are computed by every rank with tasks on its local
+/// tiles. The tiles are updated in place, so the ranks synchronize after
+/// each update.
+/// \note This is a collective operation.
+/// \param[in,out] A The matrix, which must have the same tiling for its rows
+/// and columns; it is overwritten
+/// \param[out] d The diagonal of the tridiagonal matrix
+/// \param[out] e The off-diagonal of the tridiagonal matrix
+/// \return The reflectors of the tile columns reduced by this rank, which
+/// satisfy \f$ A = Q T Q^H \f$ with \f$ Q = \prod_k (I - V_k T_k V_k^H) \f$
+template <typename Array>
+std::map<std::size_t, Reflectors<typename Array::numeric_type>>
+tridiagonalize(Array& A,
+               std::vector<TiledArray::detail::scalar_t<
+                   typename Array::numeric_type>>& d,
+               std::vector<TiledArray::detail::scalar_t<
+                   typename Array::numeric_type>>& e) {
+  using T = typename Array::numeric_type;
+  World& world = A.world();
+  const TiledRange1& tr = A.trange().dim(0);
+  const auto offset = tr.elements_range().first;
+  const std::size_t n = tr.extent();
+  const std::size_t nt = tr.tile_extent();
+  const auto tile0 = tr.tiles_range().first;
+
+  std::map<std::size_t, Reflectors<T>> result;
+  d.assign(n, 0);
+  e.assign(n > 0ul ? n - 1ul : 0ul, 0);
+  if (n == 0ul) return result;
+
+  std::mutex mutex;
+  Vector<T> v(n), y(n);
+  for (std::size_t k = 0ul; k < nt; ++k) {
+    const auto& tile = tr.tile(tile0 + k);
+    const std::size_t first = tile.first - offset;
+    const std::size_t nb = tile.second - tile.first;
+    const ProcessID owner = k % world.size();
+    const bool is_owner = (world.rank() == owner);
+
+    // y = A(k:,k:) v with the local tiles
+    auto local_matvec = [&](const Vector<T>& v, Vector<T>& y) {
+      y.setZero();
+      for_each_local_tile(
+          A,
+          [k, tile0](std::size_t i, std::size_t j) {
+            return i >= tile0 + k && j >= tile0 + k;
+          },
+          [&](auto& tile) {
+            const auto r0 = tile.range().lobound(0) - offset;
+            const auto c0 = tile.range().lobound(1) - offset;
+            const auto rows = tile.range().extent(0);
+            const auto cols = tile.range().extent(1);
+            const Vector<T> part =
+                RowMajorMap<T>(tile.data(), rows, cols) * v.segment(c0, cols);
+            std::lock_guard<std::mutex> lock(mutex);
+            y.segment(r0, rows) += part;
+          });
+      sum(world, y.data(), n);
+    };
+
+    Matrix<T> V, W;
+    if (is_owner) {
+      // Gather the panel
+      Matrix<T> panel = Matrix<T>::Zero(n, nb);
+      for (std::size_t i = k; i < nt; ++i) {
+        const auto tile = A.find({tile0 + i, tile0 + k}).get();
+        const auto r0 = tile.range().lobound(0) - offset;
+        panel.block(r0, 0, tile.range().extent(0), nb) =
+            RowMajorMap<T>(const_cast<T*>(tile.data()), tile.range().extent(0),
+                           nb);
+      }
+
+      std::vector<T> tau;
+      tridiagonalize_panel(panel, first, V, W, tau, d.data(), e.data(),
+                           [&](const Vector<T>& v, Vector<T>& y) {
+                             Vector<T> vc = v;
+                             broadcast(world, vc.data(), n, owner);
+                             local_matvec(vc, y);
+                           });
+      result[k] = Reflectors<T>{V, make_block_reflector(V, tau)};
+    } else {
+      // Take part in the matrix-vector products of the panel
+      for (std::size_t i = first; i < first + nb && i + 1 < n; ++i) {
+        broadcast(world, v.data(), n, owner);
+        local_matvec(v, y);
+      }
+      V.resize(n, nb);
+      W.resize(n, nb);
+    }
+
+    // Update the trailing matrix: A -= V W^H + W V^H
+    if (k + 1 < nt) {
+      broadcast(world, V.data(), n * nb, owner);
+      broadcast(world, W.data(), n * nb, owner);
+      for_each_local_tile(
+          A,
+          [k, tile0](std::size_t i, std::size_t j) {
+            return i > tile0 + k && j > tile0 + k;
+          },
+          [&](auto& tile) {
+            const auto r0 = tile.range().lobound(0) - offset;
+            const auto c0 = tile.range().lobound(1) - offset;
+            const auto rows = tile.range().extent(0);
+            const auto cols = tile.range().extent(1);
+            RowMajorMap<T> a(tile.data(), rows, cols);
+            a.noalias() -= V.middleRows(r0, rows) *
+                           W.middleRows(c0, cols).adjoint();
+            a.noalias() -= W.middleRows(r0, rows) *
+                           V.middleRows(c0, cols).adjoint();
+          });
+
+      // The owner of the next panel gathers tiles updated by other ranks
+      world.gop.fence();
+    }
+  }
+
+  sum(world, d.data(), d.size());
+  sum(world, e.data(), e.size());
+  return result;
+}
+
+/// Number of eigenvalues of a symmetric tridiagonal matrix less than \p x
+
+/// \param d The diagonal
+/// \param e2 The squares of the off-diagonal
+/// \param x The shift
+/// \param pivmin The smallest allowed magnitude of a pivot
+template <typename R>
+std::size_t sturm_count(const std::vector<R>& d, const std::vector<R>& e2,
+                        const R x, const R pivmin) {
+  std::size_t count = 0ul;
+  R q = 1;
+  for (std::size_t i = 0ul; i < d.size(); ++i) {
+    q = d[i] - x - (i > 0ul ? e2[i - 1] / q : R(0));
+    if (std::abs(q) < pivmin) q = -pivmin;
+    if (q < 0) ++count;
+  }
+  return count;
+}
+
+/// Eigenvalues of a symmetric tridiagonal matrix by bisection
+
+/// The eigenvalues are computed by rank \c k%P and then summed.
+/// \param world The world of the ranks
+/// \param d The diagonal
+/// \param e The off-diagonal
+/// \return The eigenvalues in ascending order
+template <typename R>
+std::vector<R> tridiagonal_eigenvalues(World& world, const std::vector<R>& d,
+                                       const std::vector<R>& e) {
+  const std::size_t n = d.size();
+  std::vector<R> result(n, R(0));
+  if (n == 0ul) return result;
+
+  std::vector<R> e2(e.size());
+  R lower = d[0], upper = d[0], max_e2 = 0;
+  for (std::size_t i = 0ul; i < n; ++i) {
+    const R radius = (i > 0ul ? std::abs(e[i - 1]) : R(0)) +
+                     (i + 1 < n ? std::abs(e[i]) : R(0));
+    lower = std::min(lower, d[i] - radius);
+    upper = std::max(upper, d[i] + radius);
+    if (i + 1 < n) {
+      e2[i] = e[i] * e[i];
+      max_e2 = std::max(max_e2, e2[i]);
+    }
+  }
+  const R eps = std::numeric_limits<R>::epsilon();
+  const R pivmin = std::numeric_limits<R>::min() * std::max(R(1), max_e2);
+  const R tnorm = std::max(std::abs(lower), std::abs(upper));
+  lower -= 2 * eps * tnorm + pivmin;
+  upper += 2 * eps * tnorm + pivmin;
+
+  for (std::size_t k = world.rank(); k < n; k += world.size()) {
+    R lo = lower, hi = upper;
+    for (int iter = 0; iter < 256; ++iter) {
+      const R mid = lo + (hi - lo) / 2;
+      if (hi - lo <= 2 * eps * std::max(std::abs(lo), std::abs(hi)) + pivmin ||
+          mid == lo || mid == hi)
+        break;
+      if (sturm_count(d, e2, mid, pivmin) > k)
+        hi = mid;
+      else
+        lo = mid;
+    }
+    result[k] = lo + (hi - lo) / 2;
+  }
+
+  sum(world, result.data(), n);
+  return result;
+}
+
+/// The number of eigenvectors after which \c tridiagonal_eigenvectors()
+/// splits a cluster of eigenvalues that are not degenerate
+constexpr std::size_t max_eigenvector_cluster = 64ul;
+
+/// Clusters of eigenvalues of a symmetric tridiagonal matrix
+
+/// Consecutive eigenvalues whose gap is at most \c 1e-3 times their
+/// magnitude (plus \c 10*eps*|T| ) form a cluster, whose eigenvectors are
+/// orthogonalized against each other. Clusters of more than
+/// \c max_eigenvector_cluster eigenvalues are split, so that a dense
+/// spectrum, in which all eigenvalues are chained by small gaps, does not
+/// form a single cluster. They are only split at gaps above
+/// \c sqrt(eps)*|T| , which bounds the loss of orthogonality between the
+/// eigenvectors of the parts by about \c sqrt(eps) ; (near-)degenerate
+/// eigenvalues are never split.
+/// \param evals The eigenvalues in ascending order
+/// \param tnorm The norm of the tridiagonal matrix, \c |T|
+/// \return The index of the first eigenvalue of each cluster, followed by
+/// the number of eigenvalues
+template <typename R>
+std::vector<std::size_t> eigenvalue_clusters(const std::vector<R>& evals,
+                                             const R tnorm) {
+  const R eps = std::numeric_limits<R>::epsilon();
+  const R pertol = 10 * eps * tnorm;
+  const R splittol = std::sqrt(eps) * tnorm;
+  std::vector<std::size_t> result;
+  for (std::size_t k = 0ul; k < evals.size(); ++k) {
+    const R gap = (k > 0ul ? evals[k] - evals[k - 1] : R(0));
+    const bool clustered =
+        k > 0ul && gap <= R(1e-3) * std::max(std::abs(evals[k - 1]),
+                                             std::abs(evals[k])) +
+                              pertol;
+    if (!clustered ||
+        (k - result.back() >= max_eigenvector_cluster && gap > splittol))
+      result.push_back(k);
+  }
+  result.push_back(evals.size());
+  return result;
+}
+
+/// Eigenvectors of a symmetric tridiagonal matrix by inverse iteration
+
+/// The eigenvectors of each cluster of eigenvalues, see
+/// \c eigenvalue_clusters() , are orthogonalized against each other; the
+/// eigenvectors of the cluster of eigenvalue \p first that precede it are
+/// recomputed, so the result is independent of \p first .
+/// \param d The diagonal
+/// \param e The off-diagonal
+/// \param evals The eigenvalues in ascending order
+/// \param first The index of the first eigenvector
+/// \param last The index past the last eigenvector
+/// \return The eigenvectors \c first..last-1 as columns
+template <typename R>
+Matrix<R> tridiagonal_eigenvectors(const std::vector<R>& d,
+                                   const std::vector<R>& e,
+                                   const std::vector<R>& evals,
+                                   const std::size_t first,
+                                   const std::size_t last) {
+  const std::size_t n = d.size();
+  R tnorm = 0;
+  for (std::size_t i = 0ul; i < n; ++i)
+    tnorm = std::max(tnorm, std::abs(d[i]) +
+                                (i > 0ul ? std::abs(e[i - 1]) : R(0)) +
+                                (i + 1 < n ? std::abs(e[i]) : R(0)));
+  const R eps = std::numeric_limits<R>::epsilon();
+  const R pertol = 10 * eps * tnorm;
+  const R tiny = std::max(eps * tnorm, std::numeric_limits<R>::min());
+
+  // Start at the beginning of the cluster of first
+  const auto clusters = eigenvalue_clusters(evals, tnorm);
+  auto next_cluster =
+      std::upper_bound(clusters.begin(), clusters.end(), first);
+  const std::size_t start = *std::prev(next_cluster);
+
+  Matrix<R> vectors(n, last - start);
+  std::vector<R> dl(n), dd(n), du(n), du2(n);
+  std::vector<char> swap(n);
+  std::size_t cluster = start;
+  R shift = 0;
+  for (std::size_t k = start; k < last; ++k) {
+    // Separate shifts within a cluster
+    if (k == *next_cluster) ++next_cluster;
+    if (k > start && k != *std::prev(next_cluster)) {
+      shift = std::max(evals[k], shift + pertol);
+    } else {
+      cluster = k;
+      shift = evals[k];
+    }
+
+    // LU factorization of T - shift with partial pivoting (LAPACK's ?gttrf)
+    for (std::size_t i = 0ul; i < n; ++i) {
+      dd[i] = d[i] - shift;
+      if (i + 1 < n) dl[i] = du[i] = e[i];
+      du2[i] = 0;
+      swap[i] = 0;
+    }
+    for (std::size_t i = 0ul; i + 1 < n; ++i) {
+      if (std::abs(dd[i]) >= std::abs(dl[i])) {
+        if (dd[i] != R(0)) {
+          const R fact = dl[i] / dd[i];
+          dl[i] = fact;
+          dd[i + 1] -= fact * du[i];
+        }
+      } else {
+        const R fact = dd[i] / dl[i];
+        dd[i] = dl[i];
+        dl[i] = fact;
+        const R temp = du[i];
+        du[i] = dd[i + 1];
+        dd[i + 1] = temp - fact * dd[i + 1];
+        if (i + 2 < n) {
+          du2[i] = du[i + 1];
+          du[i + 1] = -fact * du[i + 1];
+        }
+        swap[i] = 1;
+      }
+    }
+    for (std::size_t i = 0ul; i < n; ++i)
+      if (std::abs(dd[i]) < tiny) dd[i] = (dd[i] < R(0) ? -tiny : tiny);
+
+    // Inverse iteration from a reproducible random vector
+    auto x = vectors.col(k - start);
+    std::mt19937_64 generator(k + 1);
+    std::uniform_real_distribution<R> distribution(R(-1), R(1));
+    for (std::size_t i = 0ul; i < n; ++i) x(i) = distribution(generator);
+    for (int iter = 0; iter < 3; ++iter) {
+      x /= x.norm();
+      for (std::size_t i = 0ul; i + 1 < n; ++i) {
+        if (swap[i]) {
+          const R temp = x(i);
+          x(i) = x(i + 1);
+          x(i + 1) = temp - dl[i] * x(i);
+        } else {
+          x(i + 1) -= dl[i] * x(i);
+        }
+      }
+      x(n - 1) /= dd[n - 1];
+      if (n > 1ul) x(n - 2) = (x(n - 2) - du[n - 2] * x(n - 1)) / dd[n - 2];
+      for (std::size_t i = (n > 2ul ? n - 2ul : 0ul); i-- > 0ul;)
+        x(i) = (x(i) - du[i] * x(i + 1) - du2[i] * x(i + 2)) / dd[i];
+
+      // Orthogonalize against the preceding vectors of the cluster
+      for (std::size_t j = cluster; j < k; ++j) {
+        const auto z = vectors.col(j - start);
+        x -= z.dot(x) * z;
+      }
+    }
+    x /= x.norm();
+  }
+
+  return vectors.rightCols(last - first);
+}
+
+/// Apply the reflectors of the tridiagonalization to a matrix
+
+/// Computes \f$ Z = Q Z \f$; the reflectors of each tile column are
+/// broadcast by the rank that holds them.
+/// \param[in,out] Z The matrix, which must have the same row tiling as the
+/// tridiagonalized matrix
+/// \param reflectors The reflectors held by this rank, as returned by
+/// \c tridiagonalize()
+template <typename Array>
+void apply_reflectors(
+    Array& Z,
+    const std::map<std::size_t, Reflectors<typename Array::numeric_type>>&
+        reflectors) {
+  using T = typename Array::numeric_type;
+  World& world = Z.world();
+  const TiledRange1& tr = Z.trange().dim(0);
+  const auto offset = tr.elements_range().first;
+  const auto col_offset = Z.trange().dim(1).elements_range().first;
+  const std::size_t n = tr.extent();
+  const std::size_t ncols = Z.trange().dim(1).extent();
+  const std::size_t nt = tr.tile_extent();
+  const auto tile0 = tr.tiles_range().first;
+
+  std::mutex mutex;
+  for (std::size_t k = nt; k-- > 0ul;) {
+    const auto& tile = tr.tile(tile0 + k);
+    const std::size_t first = tile.first - offset;
+    const std::size_t nb = tile.second - tile.first;
+    const ProcessID owner = k % world.size();
+
+    Matrix<T> V(n, nb), T_(nb, nb);
+    if (world.rank() == owner) {
+      const auto& r = reflectors.at(k);
+      V = r.V;
+      T_ = r.T_;
+    }
+    broadcast(world, V.data(), n * nb, owner);
+    broadcast(world, T_.data(), nb * nb, owner);
+
+    // Z -= V T (V^H Z)
+    auto rows_pred = [first, offset, &tr](std::size_t i, std::size_t) {
+      return std::size_t(tr.tile(i).second - offset) > first + 1;
+    };
+    Matrix<T> X = Matrix<T>::Zero(nb, ncols);
+    for_each_local_tile(Z, rows_pred, [&](auto& tile) {
+      const auto r0 = tile.range().lobound(0) - offset;
+      const auto c0 = tile.range().lobound(1) - col_offset;
+      const auto rows = tile.range().extent(0);
+      const auto cols = tile.range().extent(1);
+      const Matrix<T> part = V.middleRows(r0, rows).adjoint() *
+                             RowMajorMap<T>(tile.data(), rows, cols);
+      std::lock_guard<std::mutex> lock(mutex);
+      X.middleCols(c0, cols) += part;
+    });
+    sum(world, X.data(), X.size());
+    X = T_.template triangularView<::Eigen::Upper>() * X;
+    for_each_local_tile(Z, rows_pred, [&](auto& tile) {
+      const auto r0 = tile.range().lobound(0) - offset;
+      const auto c0 = tile.range().lobound(1) - col_offset;
+      const auto rows = tile.range().extent(0);
+      const auto cols = tile.range().extent(1);
+      RowMajorMap<T>(tile.data(), rows, cols).noalias() -=
+          V.middleRows(r0, rows) * X.middleCols(c0, cols);
+    });
+  }
+}
+
+}  // namespace detail
+
+/**
+ *  @brief Solve the standard eigenvalue problem with a distributed solver
+ *
+ *  A(i,k) X(k,j) = X(i,j) E(j)
+ *
+ *  The matrix is reduced to real symmetric tridiagonal form by blocked
+ *  Householder reflections that act directly on the tiles of @p A : each tile
+ *  column is reduced by one rank, while every rank updates its own tiles with
+ *  tasks. The eigenvalues of the tridiagonal matrix are computed by bisection
+ *  and its eigenvectors by inverse iteration, with the work divided among the
+ *  ranks, and the eigenvectors are transformed back with the distributed
+ *  reflectors. No rank holds more than a few tile columns of the matrix.
+ *
+ *  Example Usage:
+ *
+ *  auto [E, X] = heig(A, ...)
+ *
+ *  @tparam Array Input array type, a DistArray of TiledArray::Tensor tiles
+ *
+ *  @param[in] A           Input array to be diagonalized. Must be rank-2
+ *  @param[in] evec_trange TiledRange for resulting eigenvectors. If left empty,
+ *                         will default to array.trange()
+ *
+ *  @returns A tuple containing the eigenvalues and eigenvectors of input array
+ *  as std::vector and in TA format, respectively.
+ *  @note this is a collective operation with respect to the world of @p A
+ */
+template <typename Array>
+auto heig(const Array& A, TiledRange evec_trange = TiledRange()) {
+  using numeric_type =
+      typename linalg::detail::array_traits<Array>::numeric_type;
+  using scalar_type = typename linalg::detail::array_traits<Array>::scalar_type;
+  using tile_type = typename Array::value_type;
+  using work_type = DistArray<tile_type, DensePolicy>;
+  static_assert(TiledArray::detail::is_ta_tensor_v<tile_type>,
+                "TA::math::linalg::native::heig is only usable with a "
+                "DistArray of TiledArray::Tensor tiles");
+
+  World& world = A.world();
+  TA_ASSERT(A.trange().rank() == 2);
+  TA_ASSERT(A.trange().dim(0).extent() == A.trange().dim(1).extent());
+  if (evec_trange.rank() == 0) evec_trange = A.trange();
+
+  // Copy A into a dense array whose rows and columns are tiled alike
+  const TiledRange trange{A.trange().dim(0), A.trange().dim(0)};
+  const Array source = (A.trange() == trange ? A : retile(A, trange));
+  work_type work(world, trange);
+  for (const auto ordinal : *work.pmap()) {
+    if (source.is_zero(ordinal))
+      work.set(ordinal,
+               tile_type(trange.make_tile_range(ordinal), numeric_type(0)));
+    else
+      work.set(ordinal, world.taskq.add(
+                            [](const tile_type& tile) { return tile.clone(); },
+                            source.find(ordinal)));
+  }
+
+  std::vector<scalar_type> d, e;
+  const auto reflectors = detail::tridiagonalize(work, d, e);
+  work = work_type();
+  const auto evals = detail::tridiagonal_eigenvalues(world, d, e);
+
+  // Compute the eigenvectors of the tridiagonal matrix of each tile column
+  // of the result
+  work_type evecs(world, trange);
+  const TiledRange1& tr = trange.dim(0);
+  const auto offset = tr.elements_range().first;
+  for (auto j = tr.tiles_range().first; j != tr.tiles_range().second; ++j) {
+    if ((j - tr.tiles_range().first) % world.size() !=
+        std::size_t(world.rank()))
+      continue;
+    const auto& cols = tr.tile(j);
+    const auto vectors = detail::tridiagonal_eigenvectors(
+        d, e, evals, cols.first - offset, cols.second - offset);
+    for (auto i = tr.tiles_range().first; i != tr.tiles_range().second; ++i) {
+      const auto& rows = tr.tile(i);
+      tile_type tile(
+          Range({rows.first, cols.first}, {rows.second, cols.second}));
+      detail::RowMajorMap<numeric_type>(tile.data(), rows.second - rows.first,
+                                        cols.second - cols.first) =
+          vectors.middleRows(rows.first - offset, rows.second - rows.first)
+              .template cast<numeric_type>();
+      evecs.set({i, j}, tile);
+    }
+  }
+  world.gop.fence();
+
+  detail::apply_reflectors(evecs, reflectors);
+
+  auto result_evecs =
+      (evec_trange == trange ? evecs : retile(evecs, evec_trange));
+  std::vector<numeric_type> result_evals(evals.begin(), evals.end());
+  if constexpr (is_dense_v<Array>)
+    return std::tuple(result_evals, Array(result_evecs));
+  else
+    return std::tuple(result_evals, Array(to_sparse(result_evecs)));
+}
+
+}  // namespace TiledArray::math::linalg::native
+
+#endif  // TILEDARRAY_MATH_LINALG_NATIVE_HEIG_H__INCLUDED
@@ -0,0 +1,123 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021 Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  util.h
+ *
+ */
+#ifndef TILEDARRAY_MATH_LINALG_NATIVE_UTIL_H__INCLUDED
+#define TILEDARRAY_MATH_LINALG_NATIVE_UTIL_H__INCLUDED
+
+#include <TiledArray/config.h>
+
+#include <TiledArray/external/eigen.h>
+#include <TiledArray/external/madness.h>
+#include <TiledArray/type_traits.h>
+
+namespace TiledArray::math::linalg::native::detail {
+
+template <typename T>
+using Matrix = ::Eigen::Matrix<T, ::Eigen::Dynamic, ::Eigen::Dynamic>;
+
+template <typename T>
+using Vector = ::Eigen::Matrix<T, ::Eigen::Dynamic, 1>;
+
+template <typename T>
+using RowMajorMap =
+    ::Eigen::Map<::Eigen::Matrix<T, ::Eigen::Dynamic, ::Eigen::Dynamic,
+                                 ::Eigen::RowMajor>>;
+
+template <typename T>
+using ConstRowMajorMap =
+    ::Eigen::Map<const ::Eigen::Matrix<T, ::Eigen::Dynamic, ::Eigen::Dynamic,
+                                       ::Eigen::RowMajor>>;
+
+/// A row-major matrix map of a tile
+
+/// \param tile A rank-2 tile
+/// \return An Eigen map that shares its data with \p tile
+template <typename Tile>
+auto matrix_map(Tile& tile) {
+  return RowMajorMap<typename Tile::numeric_type>(
+      tile.data(), tile.range().extent(0), tile.range().extent(1));
+}
+
+/// A read-only row-major matrix map of a tile
+
+/// \param tile A rank-2 tile
+/// \return An Eigen map that shares its data with \p tile
+template <typename Tile>
+auto matrix_map(const Tile& tile) {
+  return ConstRowMajorMap<typename Tile::numeric_type>(
+      tile.data(), tile.range().extent(0), tile.range().extent(1));
+}
+
+/// Sum a buffer over all ranks
+
+/// \param world The world of the ranks
+/// \param[in,out] data The buffer; on exit it holds the sum on every rank
+/// \param n The number of elements in \p data
+template <typename T>
+void sum(World& world, T* data, const std::size_t n) {
+  if constexpr (TiledArray::detail::is_complex_v<T>)
+    world.gop.sum(reinterpret_cast<TiledArray::detail::scalar_t<T>*>(data),
+                  2ul * n);
+  else
+    world.gop.sum(data, n);
+}
+
+/// Broadcast a buffer
+
+/// \param world The world of the ranks
+/// \param[in,out] data The buffer
+/// \param n The number of elements in \p data
+/// \param root The rank that holds the data
+template <typename T>
+void broadcast(World& world, T* data, const std::size_t n,
+               const ProcessID root) {
+  if (n > 0ul)
+    world.gop.broadcast(static_cast<void*>(data), n * sizeof(T), root);
+}
+
+/// Apply a function to the local tiles of a matrix in parallel
+
+/// \param array The matrix
+/// \param pred The tiles whose tile index satisfies \c pred(i,j) are visited
+/// \param op The function, called as \c op(tile) where \c tile shares its
+/// data with the tile of \p array
+template <typename Array, typename Pred, typename Op>
+void for_each_local_tile(const Array& array, const Pred& pred, const Op& op) {
+  World& world = array.world();
+  madness::AtomicInt counter;
+  counter = 0;
+  int n = 0;
+  for (const auto ordinal : *array.pmap()) {
+    const auto index = array.trange().tiles_range().idx(ordinal);
+    if (!pred(index[0], index[1])) continue;
+    world.taskq.add(
+        [&op, &counter](typename Array::value_type tile) {
+          op(tile);
+          counter++;
+        },
+        array.find(ordinal));
+    ++n;
+  }
+  world.await([&counter, n]() { return counter == n; });
+}
+
+}  // namespace TiledArray::math::linalg::native::detail
+
+#endif  // TILEDARRAY_MATH_LINALG_NATIVE_UTIL_H__INCLUDED
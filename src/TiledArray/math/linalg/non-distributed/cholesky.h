@@ -45,7 +45,6 @@ auto rank_local_cholesky(const DistArray<Tile, Policy>& A) {
   if (world.rank() == 0) {
     linalg::rank_local::cholesky(A_eig);
   }
-  world.gop.broadcast_serializable(A_eig, 0);
   return A_eig;
 }
 
@@ -73,7 +72,7 @@ auto cholesky(const Array& A, TiledRange l_trange = TiledRange()) {
   auto L_eig = rank_local_cholesky(A);
   detail::zero_out_upper_triangle(L_eig);
   if (l_trange.rank() == 0) l_trange = A.trange();
-  return eigen_to_array<Array>(A.world(), l_trange, L_eig);
+  return scatter_eigen_to_array<Array>(A.world(), l_trange, L_eig);
 }
 
 /**
@@ -140,14 +139,14 @@ auto cholesky_linv(const Array& A, TiledRange l_trange = TiledRange()) {
     linalg::rank_local::cholesky_linv(L_inv_eig_ref);
     detail::zero_out_upper_triangle(L_inv_eig_ref);
   }
-  world.gop.broadcast_serializable(Both ? L_inv_eig : L_eig, 0);
 
   if (l_trange.rank() == 0) l_trange = A.trange();
   if constexpr (Both)
-    return std::make_tuple(eigen_to_array<Array>(world, l_trange, L_eig),
-                           eigen_to_array<Array>(world, l_trange, L_inv_eig));
+    return std::make_tuple(
+        scatter_eigen_to_array<Array>(world, l_trange, L_eig),
+        scatter_eigen_to_array<Array>(world, l_trange, L_inv_eig));
   else
-    return eigen_to_array<Array>(world, l_trange, L_eig);
+    return scatter_eigen_to_array<Array>(world, l_trange, L_eig);
   abort();  // unreachable
 }
 
@@ -166,9 +165,8 @@ auto cholesky_solve(const Array& A, const Array& B,
   if (world.rank() == 0) {
     linalg::rank_local::cholesky_solve(A_eig, X_eig);
   }
-  world.gop.broadcast_serializable(X_eig, 0);
   if (x_trange.rank() == 0) x_trange = B.trange();
-  return eigen_to_array<Array>(world, x_trange, X_eig);
+  return scatter_eigen_to_array<Array>(world, x_trange, X_eig);
 }
 
 template <typename Array,
@@ -189,11 +187,11 @@ auto cholesky_lsolve(Op transpose, const Array& A, const Array& B,
   if (world.rank() == 0) {
     linalg::rank_local::cholesky_lsolve(transpose, L_eig, X_eig);
   }
-  world.gop.broadcast_serializable(X_eig, 0);
   if (l_trange.rank() == 0) l_trange = A.trange();
   if (x_trange.rank() == 0) x_trange = B.trange();
-  return std::make_tuple(eigen_to_array<Array>(world, l_trange, L_eig),
-                         eigen_to_array<Array>(world, x_trange, X_eig));
+  return std::make_tuple(
+      scatter_eigen_to_array<Array>(world, l_trange, L_eig),
+      scatter_eigen_to_array<Array>(world, x_trange, X_eig));
 }
 
 }  // namespace TiledArray::math::linalg::non_distributed
@@ -59,12 +59,11 @@ auto heig(const Array& A, TiledRange evec_trange = TiledRange()) {
   if (world.rank() == 0) {
     linalg::rank_local::heig(A_eig, evals);
   }
-  world.gop.broadcast_serializable(A_eig, 0);
   world.gop.broadcast_serializable(evals, 0);
   if (evec_trange.rank() == 0) evec_trange = A.trange();
   return std::tuple(
     evals,
-    eigen_to_array<Array>(world, evec_trange, A_eig)
+    scatter_eigen_to_array<Array>(world, evec_trange, A_eig)
   );
 }
 
@@ -102,12 +101,11 @@ auto heig(const ArrayA& A, const ArrayB& B, TiledRange evec_trange = TiledRange(
   if (world.rank() == 0) {
     linalg::rank_local::heig(A_eig, B_eig, evals);
   }
-  world.gop.broadcast_serializable(A_eig, 0);
   world.gop.broadcast_serializable(evals, 0);
   if (evec_trange.rank() == 0) evec_trange = A.trange();
   return std::tuple(
     evals,
-    eigen_to_array<ArrayA>(A.world(), evec_trange, A_eig)
+    scatter_eigen_to_array<ArrayA>(A.world(), evec_trange, A_eig)
   );
 }
 
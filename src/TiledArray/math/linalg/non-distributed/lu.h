@@ -46,9 +46,8 @@ auto lu_solve(const ArrayA& A, const ArrayB& B, TiledRange x_trange = TiledRange
   if (world.rank() == 0) {
     linalg::rank_local::lu_solve(A_eig, B_eig);
   }
-  world.gop.broadcast_serializable(B_eig, 0);
   if (x_trange.rank() == 0) x_trange = B.trange();
-  return eigen_to_array<ArrayB>(world, x_trange, B_eig);
+  return scatter_eigen_to_array<ArrayB>(world, x_trange, B_eig);
 }
 
 /**
@@ -62,9 +61,8 @@ auto lu_inv(const Array& A, TiledRange ainv_trange = TiledRange()) {
   if (world.rank() == 0) {
     linalg::rank_local::lu_inv(A_eig);
   }
-  world.gop.broadcast_serializable(A_eig, 0);
   if (ainv_trange.rank() == 0) ainv_trange = A.trange();
-  return eigen_to_array<Array>(A.world(), ainv_trange, A_eig);
+  return scatter_eigen_to_array<Array>(A.world(), ainv_trange, A_eig);
 }
 
 }  // namespace TiledArray::math::linalg::lapack
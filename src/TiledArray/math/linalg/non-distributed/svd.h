@@ -79,11 +79,9 @@ auto svd(const Array& A, TiledRange u_trange = TiledRange(), TiledRange vt_trang
   }
 
   world.gop.broadcast_serializable(S, 0);
-  if (U) world.gop.broadcast_serializable(*U, 0);
-  if (VT) world.gop.broadcast_serializable(*VT, 0);
 
   auto make_array = [&world](auto && ... args) {
-    return eigen_to_array<Array>(world, args...);
+    return scatter_eigen_to_array<Array>(world, args...);
   };
 
   if constexpr (need_u && need_vt) {
@@ -42,11 +42,12 @@ struct array_traits {
 };
 
 
+/// Gathers the data of \p A into a column-major matrix on rank 0
+
+/// \return the matrix on rank 0, an empty matrix on the other ranks
 template <typename Tile, typename Policy>
 auto make_matrix(const DistArray<Tile, Policy>& A) {
-  auto A_repl = A;
-  A_repl.make_replicated();
-  return array_to_eigen<Tile, Policy, Eigen::ColMajor>(A_repl);
+  return gather_array_to_eigen<Tile, Policy, Eigen::ColMajor>(A, 0);
 }
 
 template <typename ContiguousTensor,
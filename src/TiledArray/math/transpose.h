@@ -27,8 +27,11 @@
 #define TILEDARRAY_MATH_TRANSPOSE_H__INCLUDED
 
 #include <TiledArray/error.h>
+#include <TiledArray/math/transpose_kernel.h>
 #include <TiledArray/math/vector_op.h>
 
+#include <algorithm>
+
 namespace TiledArray {
 namespace math {
 
@@ -156,29 +159,55 @@ TILEDARRAY_FORCE_INLINE void transpose_block(
   }
 }
 
-/// Matrix transpose and initialization
+/// Width of the column panels of a matrix transpose
+
+/// The argument matrix of a transpose is traversed in strips of
+/// \c TILEDARRAY_LOOP_UNWIND rows; each strip writes a few elements to every
+/// result row it touches. The argument columns are partitioned into panels
+/// that are transposed one after the other, such that the cache lines of the
+/// result rows written by a strip of a panel stay close to the core until the
+/// next strip fills them. The lines of a panel take up 64 KiB, i.e. twice a
+/// typical L1 data cache; smaller panels were measured to be slower since
+/// they shorten the contiguous reads of the argument rows.
+/// \tparam T The matrix element type
+/// \return The number of argument columns per panel, a multiple of
+/// \c TILEDARRAY_LOOP_UNWIND
+template <typename T>
+constexpr std::size_t transpose_panel_size() {
+  constexpr std::size_t cache_size = 65536ul;
+  constexpr std::size_t lines_per_row =
+      (TILEDARRAY_LOOP_UNWIND * sizeof(T) + TILEDARRAY_CACHELINE_SIZE - 1ul) /
+      TILEDARRAY_CACHELINE_SIZE;
+  constexpr std::size_t size =
+      cache_size / (lines_per_row * TILEDARRAY_CACHELINE_SIZE);
+  return std::max<std::size_t>(size & ~std::size_t(TILEDARRAY_LOOP_UNWIND - 1ul),
+                               TILEDARRAY_LOOP_UNWIND);
+}
 
-/// This function will transpose and transform argument matrices into an
-/// uninitialized block of memory
-/// \tparam InputOp The input transform operation type
-/// \tparam OutputOp The output transform operation type
-/// \tparam Result The result element type
-/// \tparam Args The argument element type
-/// \param[in] input_op The transformation operation applied to input arguments
-/// \param[in] output_op The transformation operation used to set the result
-/// \param[in] m The number of rows in the argument matrix
-/// \param[in] n The number of columns in the argument matrix
-/// \param[in] result_stride THe stride between result rows
-/// \param[out] result A pointer to the first element of the result matrix
-/// \param[in] arg_stride The stride between argument rows
-/// \param[in] args A pointer to the first element of the argument matrix
-/// \note The data layout is expected to be row-major.
+/// Transpose a matrix panel by panel
+
+/// \tparam T The matrix element type
+/// \tparam Op The panel transpose operation type
+/// \param n The number of columns in the argument matrix
+/// \param op The operation that transposes a panel; it is called as
+/// <tt>op(j, panel_n)</tt> , where \c j is the first argument column of the
+/// panel and \c panel_n is the number of columns in the panel
+template <typename T, typename Op>
+inline void for_each_transpose_panel(const std::size_t n, Op&& op) {
+  constexpr std::size_t panel_size = transpose_panel_size<T>();
+  for (std::size_t j = 0ul; j < n; j += panel_size)
+    op(j, std::min(panel_size, n - j));
+}
+
+/// Matrix transpose and initialization of a column panel
+
+/// \sa transpose()
 template <typename InputOp, typename OutputOp, typename Result,
           typename... Args>
-void transpose(InputOp&& input_op, OutputOp&& output_op, const std::size_t m,
-               const std::size_t n, const std::size_t result_stride,
-               Result* result, const std::size_t arg_stride,
-               const Args* const... args) {
+void transpose_panel(InputOp&& input_op, OutputOp&& output_op,
+                     const std::size_t m, const std::size_t n,
+                     const std::size_t result_stride, Result* result,
+                     const std::size_t arg_stride, const Args* const... args) {
   // Compute block iteration control variables
   constexpr std::size_t index_mask = ~std::size_t(TILEDARRAY_LOOP_UNWIND - 1ul);
   const std::size_t mx = m & index_mask;  // = m - m % TILEDARRAY_LOOP_UNWIND
@@ -227,6 +256,96 @@ void transpose(InputOp&& input_op, OutputOp&& output_op, const std::size_t m,
   }
 }
 
+/// Matrix transpose and initialization
+
+/// This function will transpose and transform argument matrices into an
+/// uninitialized block of memory. The matrices are traversed in column
+/// panels (see \c transpose_panel_size() ), each of which is transposed in
+/// register-sized blocks.
+/// \tparam InputOp The input transform operation type
+/// \tparam OutputOp The output transform operation type
+/// \tparam Result The result element type
+/// \tparam Args The argument element type
+/// \param[in] input_op The transformation operation applied to input arguments
+/// \param[in] output_op The transformation operation used to set the result
+/// \param[in] m The number of rows in the argument matrix
+/// \param[in] n The number of columns in the argument matrix
+/// \param[in] result_stride THe stride between result rows
+/// \param[out] result A pointer to the first element of the result matrix
+/// \param[in] arg_stride The stride between argument rows
+/// \param[in] args A pointer to the first element of the argument matrix
+/// \note The data layout is expected to be row-major.
+template <typename InputOp, typename OutputOp, typename Result,
+          typename... Args>
+void transpose(InputOp&& input_op, OutputOp&& output_op, const std::size_t m,
+               const std::size_t n, const std::size_t result_stride,
+               Result* result, const std::size_t arg_stride,
+               const Args* const... args) {
+  for_each_transpose_panel<Result>(
+      n, [&](const std::size_t j, const std::size_t panel_n) {
+        transpose_panel(input_op, output_op, m, panel_n, result_stride,
+                        result + (j * result_stride), arg_stride,
+                        (args + j)...);
+      });
+}
+
+/// Matrix transpose copy
+
+/// This function copies the transpose of a matrix of trivially copyable
+/// elements. The matrix is traversed in column panels (see
+/// \c transpose_panel_size() ), which are transposed with the SIMD
+/// \c TransposeKernel<T> micro-kernel where one is available for \c T , and
+/// with the generic register-blocked transpose otherwise.
+/// \tparam T The matrix element type
+/// \param[in] m The number of rows in the argument matrix
+/// \param[in] n The number of columns in the argument matrix
+/// \param[in] result_stride The stride between result rows
+/// \param[out] result A pointer to the first element of the result matrix
+/// \param[in] arg_stride The stride between argument rows
+/// \param[in] arg A pointer to the first element of the argument matrix
+/// \note The data layout is expected to be row-major.
+template <typename T>
+void transpose_copy(const std::size_t m, const std::size_t n,
+                    const std::size_t result_stride, T* const result,
+                    const std::size_t arg_stride, const T* const arg) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "transpose_copy requires trivially copyable elements");
+  constexpr std::size_t block_size = TransposeKernel<T>::size;
+
+  if constexpr (block_size == 0ul) {
+    transpose([](const T& value) -> const T& { return value; },
+              [](T* const result_value, const T& value) {
+                *result_value = value;
+              },
+              m, n, result_stride, result, arg_stride, arg);
+  } else {
+    static_assert(transpose_panel_size<T>() % block_size == 0ul,
+                  "the transpose panel size must be a multiple of the "
+                  "micro-kernel block size");
+    const std::size_t mx = m - m % block_size;
+    for_each_transpose_panel<T>(
+        n, [=](const std::size_t j, const std::size_t panel_n) {
+          const T* MADNESS_RESTRICT const arg_j = arg + j;
+          T* MADNESS_RESTRICT const result_j = result + (j * result_stride);
+          const std::size_t nx = panel_n - panel_n % block_size;
+
+          // Transpose full blocks with the micro-kernel
+          for (std::size_t i = 0ul; i < mx; i += block_size)
+            for (std::size_t jj = 0ul; jj < nx; jj += block_size)
+              TransposeKernel<T>::apply(arg_j + (i * arg_stride + jj),
+                                        arg_stride,
+                                        result_j + (jj * result_stride + i),
+                                        result_stride);
+
+          // Copy the remaining columns and rows
+          for (std::size_t i = 0ul; i < m; ++i) {
+            for (std::size_t jj = (i < mx ? nx : 0ul); jj < panel_n; ++jj)
+              result_j[jj * result_stride + i] = arg_j[i * arg_stride + jj];
+          }
+        });
+  }
+}
+
 }  // namespace math
 }  // namespace TiledArray
 
@@ -0,0 +1,221 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  transpose_kernel.h
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_TRANSPOSE_KERNEL_H__INCLUDED
+#define TILEDARRAY_MATH_TRANSPOSE_KERNEL_H__INCLUDED
+
+#include <complex>
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace TiledArray {
+namespace math {
+
+/// Register-blocked matrix transpose micro-kernel
+
+/// \c TransposeKernel<T>::apply() copies a \c size x \c size block of a
+/// row-major matrix into the transposed block of another matrix with SIMD
+/// loads, shuffles, and stores. The primary template has \c size equal to 0,
+/// which indicates that there is no vectorized kernel for \c T and that
+/// callers must fall back to scalar code. Kernels are provided for
+/// \c float , \c double , and \c std::complex<float> when the compiler
+/// targets AVX (and AVX-512F for \c double ). Blocks of
+/// \c std::complex<double> fill at most half of a cache line per row with
+/// 256-bit registers and are left to the generic transpose.
+/// \tparam T The matrix element type
+template <typename T>
+struct TransposeKernel {
+  static constexpr std::size_t size = 0ul;  ///< Block size (0 = no kernel)
+};  // struct TransposeKernel
+
+#if defined(__AVX512F__)
+
+/// AVX-512 8x8 \c double transpose
+template <>
+struct TransposeKernel<double> {
+  static constexpr std::size_t size = 8ul;  ///< Block size
+
+  /// Transpose a block
+
+  /// \param arg A pointer to the first element of the argument block
+  /// \param arg_stride The stride between argument rows
+  /// \param result A pointer to the first element of the result block
+  /// \param result_stride The stride between result rows
+  static inline void apply(const double* const arg,
+                           const std::size_t arg_stride, double* const result,
+                           const std::size_t result_stride) {
+    __m512d r[8], t[8], u[8];
+    for (std::size_t i = 0ul; i < 8ul; ++i)
+      r[i] = _mm512_loadu_pd(arg + i * arg_stride);
+
+    // Interleave pairs of rows
+    for (std::size_t i = 0ul; i < 8ul; i += 2ul) {
+      t[i] = _mm512_unpacklo_pd(r[i], r[i + 1]);
+      t[i + 1] = _mm512_unpackhi_pd(r[i], r[i + 1]);
+    }
+
+    // Gather 2x2 sub-blocks of four rows
+    u[0] = _mm512_shuffle_f64x2(t[0], t[2], 0x88);
+    u[1] = _mm512_shuffle_f64x2(t[0], t[2], 0xDD);
+    u[2] = _mm512_shuffle_f64x2(t[1], t[3], 0x88);
+    u[3] = _mm512_shuffle_f64x2(t[1], t[3], 0xDD);
+    u[4] = _mm512_shuffle_f64x2(t[4], t[6], 0x88);
+    u[5] = _mm512_shuffle_f64x2(t[4], t[6], 0xDD);
+    u[6] = _mm512_shuffle_f64x2(t[5], t[7], 0x88);
+    u[7] = _mm512_shuffle_f64x2(t[5], t[7], 0xDD);
+
+    // Gather the columns
+    _mm512_storeu_pd(result, _mm512_shuffle_f64x2(u[0], u[4], 0x88));
+    _mm512_storeu_pd(result + result_stride,
+                     _mm512_shuffle_f64x2(u[2], u[6], 0x88));
+    _mm512_storeu_pd(result + 2ul * result_stride,
+                     _mm512_shuffle_f64x2(u[1], u[5], 0x88));
+    _mm512_storeu_pd(result + 3ul * result_stride,
+                     _mm512_shuffle_f64x2(u[3], u[7], 0x88));
+    _mm512_storeu_pd(result + 4ul * result_stride,
+                     _mm512_shuffle_f64x2(u[0], u[4], 0xDD));
+    _mm512_storeu_pd(result + 5ul * result_stride,
+                     _mm512_shuffle_f64x2(u[2], u[6], 0xDD));
+    _mm512_storeu_pd(result + 6ul * result_stride,
+                     _mm512_shuffle_f64x2(u[1], u[5], 0xDD));
+    _mm512_storeu_pd(result + 7ul * result_stride,
+                     _mm512_shuffle_f64x2(u[3], u[7], 0xDD));
+  }
+};  // struct TransposeKernel<double>
+
+#elif defined(__AVX__)
+
+/// AVX 4x4 \c double transpose
+template <>
+struct TransposeKernel<double> {
+  static constexpr std::size_t size = 4ul;  ///< Block size
+
+  /// Transpose a block
+
+  /// \param arg A pointer to the first element of the argument block
+  /// \param arg_stride The stride between argument rows
+  /// \param result A pointer to the first element of the result block
+  /// \param result_stride The stride between result rows
+  static inline void apply(const double* const arg,
+                           const std::size_t arg_stride, double* const result,
+                           const std::size_t result_stride) {
+    const __m256d r0 = _mm256_loadu_pd(arg);
+    const __m256d r1 = _mm256_loadu_pd(arg + arg_stride);
+    const __m256d r2 = _mm256_loadu_pd(arg + 2ul * arg_stride);
+    const __m256d r3 = _mm256_loadu_pd(arg + 3ul * arg_stride);
+
+    const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+    const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+    const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+    const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+    _mm256_storeu_pd(result, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(result + result_stride,
+                     _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(result + 2ul * result_stride,
+                     _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(result + 3ul * result_stride,
+                     _mm256_permute2f128_pd(t1, t3, 0x31));
+  }
+};  // struct TransposeKernel<double>
+
+#endif  // defined(__AVX__)
+
+#if defined(__AVX__)
+
+/// AVX 8x8 \c float transpose
+template <>
+struct TransposeKernel<float> {
+  static constexpr std::size_t size = 8ul;  ///< Block size
+
+  /// Transpose a block
+
+  /// \param arg A pointer to the first element of the argument block
+  /// \param arg_stride The stride between argument rows
+  /// \param result A pointer to the first element of the result block
+  /// \param result_stride The stride between result rows
+  static inline void apply(const float* const arg,
+                           const std::size_t arg_stride, float* const result,
+                           const std::size_t result_stride) {
+    __m256 r[8], t[8], s[8];
+    for (std::size_t i = 0ul; i < 8ul; ++i)
+      r[i] = _mm256_loadu_ps(arg + i * arg_stride);
+
+    // Interleave pairs of rows
+    for (std::size_t i = 0ul; i < 8ul; i += 2ul) {
+      t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+      t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+    }
+
+    // Gather 4x4 sub-blocks within each 128-bit lane
+    for (std::size_t i = 0ul; i < 8ul; i += 4ul) {
+      s[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+      s[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+      s[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+      s[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    // Exchange the 128-bit lanes
+    for (std::size_t i = 0ul; i < 4ul; ++i) {
+      _mm256_storeu_ps(result + i * result_stride,
+                       _mm256_permute2f128_ps(s[i], s[i + 4], 0x20));
+      _mm256_storeu_ps(result + (i + 4ul) * result_stride,
+                       _mm256_permute2f128_ps(s[i], s[i + 4], 0x31));
+    }
+  }
+};  // struct TransposeKernel<float>
+
+/// \c std::complex<float> transpose
+
+/// A \c std::complex<float> has the size of a \c double , so blocks are
+/// moved with the \c double kernel.
+template <>
+struct TransposeKernel<std::complex<float>> {
+  static_assert(sizeof(std::complex<float>) == sizeof(double),
+                "std::complex<float> must have the size of double");
+  static constexpr std::size_t size =
+      TransposeKernel<double>::size;  ///< Block size
+
+  /// Transpose a block
+
+  /// \param arg A pointer to the first element of the argument block
+  /// \param arg_stride The stride between argument rows
+  /// \param result A pointer to the first element of the result block
+  /// \param result_stride The stride between result rows
+  static inline void apply(const std::complex<float>* const arg,
+                           const std::size_t arg_stride,
+                           std::complex<float>* const result,
+                           const std::size_t result_stride) {
+    TransposeKernel<double>::apply(reinterpret_cast<const double*>(arg),
+                                   arg_stride, reinterpret_cast<double*>(result),
+                                   result_stride);
+  }
+};  // struct TransposeKernel<std::complex<float>>
+
+#endif  // defined(__AVX__)
+
+}  // namespace math
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_MATH_TRANSPOSE_KERNEL_H__INCLUDED
@@ -0,0 +1,173 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  layered_cyclic_pmap.h
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+
+namespace TiledArray {
+namespace detail {
+
+/// Maps cyclically a matrix of indices onto a stack of 2-d process matrices
+
+/// This map is the replicated (2.5D) analog of \c CyclicPmap . The processes
+/// are organized into \f$ c \f$ layers, each of which is a \f$ P_{\rm row}
+/// \times P_{\rm col} \f$ matrix of processes; layer \f$ l \f$ holds processes
+/// \f$ [l P_{\rm row} P_{\rm col}, (l+1) P_{\rm row} P_{\rm col}) \f$. One of
+/// the two tile dimensions (\c layer_dim ) is the inner dimension of a
+/// contraction with extent \f$ K \f$; index \f$ k \f$ of that dimension
+/// selects layer \f$ l = \lfloor k c / K \rfloor \f$. Within a layer, tile
+/// \f$ \{ k_{\rm row}, k_{\rm col} \} \f$ maps to process \f$ \{ k_{\rm row}
+/// \% P_{\rm row}, k_{\rm col} \% P_{\rm col} \} \f$, as in \c CyclicPmap .
+///
+/// \note This class is used to map <em>tile</em> indices of the arguments of
+/// a replicated SUMMA contraction to processes.
+class LayeredCyclicPmap : public Pmap {
+ protected:
+  // Import Pmap protected variables
+  using Pmap::local_;  ///< The local tiles
+  using Pmap::procs_;  ///< The number of processes
+  using Pmap::rank_;   ///< The rank of this process
+  using Pmap::size_;   ///< The number of tiles mapped among all processes
+
+ private:
+  const size_type rows_;       ///< Number of tile rows to be mapped
+  const size_type cols_;       ///< Number of tile columns to be mapped
+  const size_type proc_rows_;  ///< Number of process rows in each layer
+  const size_type proc_cols_;  ///< Number of process columns in each layer
+  const size_type layers_;     ///< Number of process layers
+  const unsigned int
+      layer_dim_;  ///< The tile dimension that selects the layer (0 = rows, 1
+                   ///< = columns)
+
+ public:
+  typedef Pmap::size_type size_type;  ///< Size type
+
+  /// Construct process map
+
+  /// \param world The world where the tiles will be mapped
+  /// \param rows The number of tile rows to be mapped
+  /// \param cols The number of tile columns to be mapped
+  /// \param proc_rows The number of process rows in each layer
+  /// \param proc_cols The number of process columns in each layer
+  /// \param layers The number of process layers
+  /// \param layer_dim The tile dimension that is partitioned among layers;
+  ///        0 for rows, 1 for columns
+  /// \throw TiledArray::Exception When <tt>proc_rows * proc_cols * layers >
+  /// world.size()</tt>
+  /// \throw TiledArray::Exception When the extent of dimension \c layer_dim
+  /// is smaller than \c layers
+  LayeredCyclicPmap(World& world, size_type rows, size_type cols,
+                    size_type proc_rows, size_type proc_cols, size_type layers,
+                    unsigned int layer_dim)
+      : Pmap(world, rows * cols),
+        rows_(rows),
+        cols_(cols),
+        proc_rows_(proc_rows),
+        proc_cols_(proc_cols),
+        layers_(layers),
+        layer_dim_(layer_dim) {
+    // Check that the size is non-zero
+    TA_ASSERT(rows_ >= 1ul);
+    TA_ASSERT(cols_ >= 1ul);
+
+    // Check limits of process rows, columns, and layers
+    TA_ASSERT(proc_rows_ >= 1ul);
+    TA_ASSERT(proc_cols_ >= 1ul);
+    TA_ASSERT(layers_ >= 1ul);
+    TA_ASSERT((proc_rows_ * proc_cols_ * layers_) <= procs_);
+    TA_ASSERT(layer_dim_ < 2u);
+    TA_ASSERT((layer_dim_ == 0u ? rows_ : cols_) >= layers_);
+
+    // Construct the list of local tiles, if have any
+    const size_type layer_size = proc_rows_ * proc_cols_;
+    const size_type layer = rank_ / layer_size;
+    if (layer < layers_) {
+      const size_type rank_row = (rank_ % layer_size) / proc_cols_;
+      const size_type rank_col = (rank_ % layer_size) % proc_cols_;
+      for (size_type row = rank_row; row < rows_; row += proc_rows_) {
+        for (size_type col = rank_col; col < cols_; col += proc_cols_) {
+          if (layer_of(layer_dim_ == 0u ? row : col) == layer)
+            local_.push_back(row * cols_ + col);
+        }
+      }
+    }
+    this->local_size_ = local_.size();
+  }
+
+  virtual ~LayeredCyclicPmap() {}
+
+  /// Access number of rows in the tile index matrix
+  size_type nrows() const { return rows_; }
+  /// Access number of columns in the tile index matrix
+  size_type ncols() const { return cols_; }
+  /// Access number of rows in each process layer
+  size_type nrows_proc() const { return proc_rows_; }
+  /// Access number of columns in each process layer
+  size_type ncols_proc() const { return proc_cols_; }
+  /// Access number of process layers
+  size_type nlayers() const { return layers_; }
+
+  /// Compute the layer of an inner index
+
+  /// \param k An index of dimension \c layer_dim
+  /// \return The layer that holds tiles with inner index \c k
+  size_type layer_of(const size_type k) const {
+    return (k * layers_) / (layer_dim_ == 0u ? rows_ : cols_);
+  }
+
+  /// Maps \c tile to the processor that owns it
+
+  /// \param tile The tile to be queried
+  /// \return Processor that logically owns \c tile
+  virtual size_type owner(const size_type tile) const {
+    TA_ASSERT(tile < size_);
+    // Compute tile coordinate in tile grid
+    const size_type tile_row = tile / cols_;
+    const size_type tile_col = tile % cols_;
+    // Compute process coordinate of tile in the process grid
+    const size_type proc_row = tile_row % proc_rows_;
+    const size_type proc_col = tile_col % proc_cols_;
+    const size_type layer = layer_of(layer_dim_ == 0u ? tile_row : tile_col);
+    // Compute the process that owns tile
+    const size_type proc =
+        (layer * proc_rows_ + proc_row) * proc_cols_ + proc_col;
+
+    TA_ASSERT(proc < procs_);
+
+    return proc;
+  }
+
+  /// Check that the tile is owned by this process
+
+  /// \param tile The tile to be checked
+  /// \return \c true if \c tile is owned by this process, otherwise \c false .
+  virtual bool is_local(const size_type tile) const {
+    return (LayeredCyclicPmap::owner(tile) == rank_);
+  }
+
+};  // class LayeredCyclicPmap
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
@@ -0,0 +1,276 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  weighted_pmap.h
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_WEIGHTED_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_WEIGHTED_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <TiledArray/tiled_range.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+namespace detail {
+
+/// Load imbalance ratio
+
+/// \param loads The load of each process
+/// \return The ratio of the largest load to the average load (1 is
+/// perfectly balanced)
+inline double imbalance(const std::vector<double>& loads) {
+  if (loads.empty()) return 1.0;
+  const double total = std::accumulate(loads.begin(), loads.end(), 0.0);
+  if (total <= 0.0) return 1.0;
+  return *std::max_element(loads.begin(), loads.end()) * loads.size() / total;
+}
+
+/// Process loads of a process map
+
+/// \param pmap The process map
+/// \param costs The cost of each tile
+/// \return The total cost of the tiles owned by each process
+inline std::vector<double> pmap_loads(const Pmap& pmap,
+                                      const std::vector<double>& costs) {
+  TA_ASSERT(costs.size() == pmap.size());
+  std::vector<double> loads(pmap.procs(), 0.0);
+  for (std::size_t tile = 0ul; tile < costs.size(); ++tile)
+    loads[pmap.owner(tile)] += costs[tile];
+  return loads;
+}
+
+/// A cost-weighted process map
+
+/// Tiles are assigned to processes so that the sum of the tile costs is
+/// approximately the same on every process. Unlike the other process maps,
+/// the owner of each tile is computed once at construction and stored, so
+/// the memory requirement is O(tiles) on every process. Two partitioning
+/// algorithms are available:
+/// - \c Partition::greedy assigns tiles in order of decreasing cost to the
+///   least loaded process (longest processing time first). This gives the
+///   best balance, but neighboring tiles are scattered among processes.
+/// - \c Partition::contiguous splits the tiles, in ordinal order, into
+///   \c procs() blocks of approximately equal cost, like \c BlockedPmap .
+///
+/// \note The costs must be identical on all processes.
+class WeightedPmap : public Pmap {
+ protected:
+  // Import Pmap protected variables
+  using Pmap::local_;  ///< The local tiles
+  using Pmap::procs_;  ///< The number of processes
+  using Pmap::rank_;   ///< The rank of this process
+  using Pmap::size_;   ///< The number of tiles mapped among all processes
+
+ public:
+  typedef Pmap::size_type size_type;  ///< Key type
+
+  /// Partitioning algorithms
+  enum class Partition { greedy, contiguous };
+
+ private:
+  std::vector<size_type> owners_;  ///< The owner of each tile
+  std::vector<double> loads_;      ///< The total cost of each process
+
+  /// Assign tiles with the longest processing time first rule
+
+  /// \param costs The cost of each tile
+  void partition_greedy(const std::vector<double>& costs) {
+    std::vector<size_type> order(size_);
+    std::iota(order.begin(), order.end(), size_type(0));
+    std::stable_sort(order.begin(), order.end(),
+                     [&costs](const size_type left, const size_type right) {
+                       return costs[left] > costs[right];
+                     });
+
+    // Min-heap of (load, process)
+    typedef std::pair<double, size_type> load_type;
+    std::priority_queue<load_type, std::vector<load_type>,
+                        std::greater<load_type>>
+        heap;
+    for (size_type p = 0ul; p < procs_; ++p) heap.emplace(0.0, p);
+
+    for (const size_type tile : order) {
+      load_type least = heap.top();
+      heap.pop();
+      owners_[tile] = least.second;
+      least.first += costs[tile];
+      heap.push(least);
+    }
+  }
+
+  /// Assign blocks of consecutive tiles with equal cost
+
+  /// \param costs The cost of each tile
+  void partition_contiguous(const std::vector<double>& costs) {
+    const double total = std::accumulate(costs.begin(), costs.end(), 0.0);
+
+    // Assign each tile to the block that holds the midpoint of its cost
+    double prefix = 0.0;
+    for (size_type tile = 0ul; tile < size_; ++tile) {
+      const size_type p =
+          (total > 0.0
+               ? size_type((prefix + 0.5 * costs[tile]) / total * procs_)
+               : tile * procs_ / size_);
+      owners_[tile] = std::min(p, procs_ - 1ul);
+      prefix += costs[tile];
+    }
+  }
+
+ public:
+  /// Construct a cost-weighted process map
+
+  /// \param world The world where the tiles will be mapped
+  /// \param costs The non-negative cost of each tile; the number of tiles
+  /// is \c costs.size()
+  /// \param partition The partitioning algorithm
+  WeightedPmap(World& world, const std::vector<double>& costs,
+               const Partition partition = Partition::greedy)
+      : Pmap(world, costs.size()), owners_(costs.size()), loads_(procs_, 0.0) {
+    TA_ASSERT(std::all_of(costs.begin(), costs.end(),
+                          [](const double cost) { return cost >= 0.0; }));
+
+    if (partition == Partition::greedy)
+      partition_greedy(costs);
+    else
+      partition_contiguous(costs);
+
+    for (size_type tile = 0ul; tile < size_; ++tile) {
+      loads_[owners_[tile]] += costs[tile];
+      if (owners_[tile] == rank_) local_.push_back(tile);
+    }
+    this->local_size_ = local_.size();
+  }
+
+  virtual ~WeightedPmap() {}
+
+  /// Maps \c tile to the processor that owns it
+
+  /// \param tile The tile to be queried
+  /// \return Processor that logically owns \c tile
+  virtual size_type owner(const size_type tile) const {
+    TA_ASSERT(tile < size_);
+    return owners_[tile];
+  }
+
+  /// Check that the tile is owned by this process
+
+  /// \param tile The tile to be checked
+  /// \return \c true if \c tile is owned by this process, otherwise \c false .
+  virtual bool is_local(const size_type tile) const {
+    return WeightedPmap::owner(tile) == rank_;
+  }
+
+  /// Process load accessor
+
+  /// \return The total cost of the tiles owned by each process
+  const std::vector<double>& loads() const { return loads_; }
+
+  /// Load imbalance
+
+  /// \return The ratio of the largest process load to the average process
+  /// load (1 is perfectly balanced)
+  double imbalance() const { return detail::imbalance(loads_); }
+
+};  // class WeightedPmap
+
+}  // namespace detail
+
+/// Estimate the cost of the tiles of an array
+
+/// \tparam Shape The array shape type
+/// \tparam Op The cost function type
+/// \param trange The tiled range of the array
+/// \param shape The shape of the array
+/// \param op The cost of a non-zero tile, called as
+/// \c op(trange.tile(ordinal)) ; it must return a non-negative value
+/// \return The cost of each tile; the cost of zero tiles is 0
+template <typename Shape, typename Op>
+std::vector<double> tile_costs(const TiledRange& trange, const Shape& shape,
+                               Op&& op) {
+  const std::size_t volume = trange.tiles_range().volume();
+  std::vector<double> costs(volume, 0.0);
+  for (std::size_t ord = 0ul; ord < volume; ++ord)
+    if (!shape.is_zero(ord)) costs[ord] = op(trange.tile(ord));
+  return costs;
+}
+
+/// Estimate the cost of the tiles of an array from their volume
+
+/// \tparam Shape The array shape type
+/// \param trange The tiled range of the array
+/// \param shape The shape of the array
+/// \return The volume of each non-zero tile, and 0 for zero tiles
+template <typename Shape>
+std::vector<double> tile_costs(const TiledRange& trange, const Shape& shape) {
+  return tile_costs(trange, shape, [](const TiledRange::range_type& range) {
+    return double(range.volume());
+  });
+}
+
+/// Construct a cost-weighted process map for an array
+
+/// The returned process map can be passed to the \c DistArray constructors.
+/// \tparam Shape The array shape type
+/// \param world The world where the tiles will be mapped
+/// \param trange The tiled range of the array
+/// \param shape The shape of the array
+/// \param partition The partitioning algorithm
+/// \return A process map that balances the volume of the non-zero tiles
+template <typename Shape>
+std::shared_ptr<Pmap> make_weighted_pmap(
+    World& world, const TiledRange& trange, const Shape& shape,
+    const detail::WeightedPmap::Partition partition =
+        detail::WeightedPmap::Partition::greedy) {
+  return std::make_shared<detail::WeightedPmap>(
+      world, tile_costs(trange, shape), partition);
+}
+
+/// Construct a cost-weighted process map for an array
+
+/// \tparam Shape The array shape type
+/// \tparam Op The cost function type
+/// \param world The world where the tiles will be mapped
+/// \param trange The tiled range of the array
+/// \param shape The shape of the array
+/// \param op The cost of a non-zero tile, called as
+/// \c op(trange.tile(ordinal)) ; it must return the same non-negative value
+/// on all processes
+/// \param partition The partitioning algorithm
+/// \return A process map that balances the cost of the non-zero tiles
+template <typename Shape, typename Op,
+          typename = std::enable_if_t<std::is_invocable_r_v<
+              double, Op, const TiledRange::range_type&>>>
+std::shared_ptr<Pmap> make_weighted_pmap(
+    World& world, const TiledRange& trange, const Shape& shape, Op&& op,
+    const detail::WeightedPmap::Partition partition =
+        detail::WeightedPmap::Partition::greedy) {
+  return std::make_shared<detail::WeightedPmap>(
+      world, tile_costs(trange, shape, std::forward<Op>(op)), partition);
+}
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_PMAP_WEIGHTED_PMAP_H__INCLUDED
@@ -0,0 +1,60 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  compressed_sparse_policy.h
+ *
+ */
+
+#ifndef TILEDARRAY_POLICIES_COMPRESSED_SPARSE_POLICY_H__INCLUDED
+#define TILEDARRAY_POLICIES_COMPRESSED_SPARSE_POLICY_H__INCLUDED
+
+#include <TiledArray/compressed_sparse_shape.h>
+#include <TiledArray/pmap/blocked_pmap.h>
+#include <TiledArray/tiled_range.h>
+
+namespace TiledArray {
+
+/// Policy of sparse arrays whose shape only stores the nonzero tile norms
+
+/// Use this policy instead of \c SparsePolicy for very sparse arrays whose
+/// dense shape (one norm per tile, replicated on every process) would be
+/// large compared to the array data.
+class CompressedSparsePolicy {
+ public:
+  typedef TiledArray::TiledRange trange_type;
+  typedef trange_type::range_type range_type;
+  typedef range_type::index1_type index1_type;
+  typedef range_type::ordinal_type ordinal_type;
+  typedef TiledArray::CompressedSparseShape<float> shape_type;
+  typedef TiledArray::Pmap pmap_interface;
+  typedef TiledArray::detail::BlockedPmap default_pmap_type;
+
+  /// Create a default process map
+
+  /// \param world The world of the process map
+  /// \param size The number of tiles in the array
+  /// \return A shared pointer to a process map
+  static std::shared_ptr<pmap_interface> default_pmap(World& world,
+                                                      const std::size_t size) {
+    return std::make_shared<default_pmap_type>(world, size);
+  }
+
+};  // class CompressedSparsePolicy
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_POLICIES_COMPRESSED_SPARSE_POLICY_H__INCLUDED
@@ -27,6 +27,7 @@
 #define TILEDARRAY_GRID_H__INCLUDED
 
 #include <TiledArray/pmap/cyclic_pmap.h>
+#include <TiledArray/pmap/layered_cyclic_pmap.h>
 
 namespace TiledArray {
 namespace detail {
@@ -55,6 +56,16 @@ namespace detail {
 /// \f]
 /// where the positive, real root of \f$P_{\rm{row}}\f$ give the optimal
 /// optimal communication time.
+///
+/// A process grid may also be replicated \f$c\f$ times (2.5D/3D SUMMA), in
+/// which case the processes are split into \f$c\f$ layers of
+/// \f$P/c\f$ processes each. Every layer has the same 2D shape, which is
+/// optimized as described above for \f$P/c\f$ processes, and layer \f$l\f$
+/// occupies processes
+/// \f$[l P_{\rm{row}} P_{\rm{col}}, (l+1) P_{\rm{row}} P_{\rm{col}})\f$.
+/// Each layer evaluates a contiguous slice of the inner (contraction)
+/// dimension, so that the broadcast volume of each layer is reduced by a
+/// factor of \f$c\f$ at the cost of a final reduction over layers.
 class ProcGrid {
  public:
   typedef uint_fast32_t size_type;
@@ -74,6 +85,9 @@ class ProcGrid {
   size_type local_rows_;  ///< The number of local element rows
   size_type local_cols_;  ///< The number of local element columns
   size_type local_size_;  ///< Number of local elements
+  size_type layers_;      ///< Number of replicated layers of the process grid
+  size_type layer_;  ///< The layer of this process (equal to \c layers_ if
+                     ///< this process is not part of any layer)
 
   /// Compute the number of process rows that minimizes communication
 
@@ -246,6 +260,38 @@ class ProcGrid {
     }
   }
 
+  /// Member variable initialization for a replicated process grid
+
+  /// This function initializes the member variables for a process grid with
+  /// \c layers replicas, each of which is a 2D grid with the optimal shape
+  /// for <tt>nprocs / layers</tt> processes.
+  void init(const size_type rank, const size_type nprocs,
+            const size_type layers, const std::size_t row_size,
+            const std::size_t col_size) {
+    TA_ASSERT(layers >= 1u);
+    TA_ASSERT(layers <= nprocs);
+    layers_ = layers;
+
+    const size_type layer_nprocs = nprocs / layers;
+
+    // Determine the shape of the 2D grid for each layer
+    init(0u, layer_nprocs, row_size, col_size);
+
+    layer_ = rank / proc_size_;
+    if (layer_ < layers_) {
+      // Initialize the rank data of this process within its layer
+      init(rank % proc_size_, layer_nprocs, row_size, col_size);
+    } else {
+      // This process does not participate in any layer
+      layer_ = layers_;
+      rank_row_ = -1;
+      rank_col_ = -1;
+      local_rows_ = 0u;
+      local_cols_ = 0u;
+      local_size_ = 0u;
+    }
+  }
+
  public:
   /// Default constructor
 
@@ -262,7 +308,9 @@ class ProcGrid {
         rank_col_(0),
         local_rows_(0u),
         local_cols_(0u),
-        local_size_(0u) {}
+        local_size_(0u),
+        layers_(1u),
+        layer_(0u) {}
 
   /// Construct a process grid
 
@@ -274,8 +322,13 @@ class ProcGrid {
   /// \param cols The number of tile columns
   /// \param row_size The number of element rows
   /// \param col_size The number of element columns
+  /// \param layers The number of replicated layers of the process grid
+  ///        [default = 1, i.e. a plain 2D grid]
+  /// \throw TiledArray::Exception When <tt>layers < 1</tt> or
+  ///        <tt>layers > world.size()</tt>
   ProcGrid(World& world, const size_type rows, const size_type cols,
-           const std::size_t row_size, const std::size_t col_size)
+           const std::size_t row_size, const std::size_t col_size,
+           const size_type layers = 1u)
       : world_(&world),
         rows_(rows),
         cols_(cols),
@@ -287,14 +340,19 @@ class ProcGrid {
         rank_col_(-1),
         local_rows_(0ul),
         local_cols_(0ul),
-        local_size_(0ul) {
+        local_size_(0ul),
+        layers_(1ul),
+        layer_(0ul) {
     // Check for non-zero sizes
     TA_ASSERT(rows_ >= 1u);
     TA_ASSERT(cols_ >= 1u);
     TA_ASSERT(row_size >= 1ul);
     TA_ASSERT(col_size >= 1ul);
 
-    init(world_->rank(), world_->size(), row_size, col_size);
+    if (layers == 1u)
+      init(world_->rank(), world_->size(), row_size, col_size);
+    else
+      init(world_->rank(), world_->size(), layers, row_size, col_size);
   }
 
 #ifdef TILEDARRAY_ENABLE_TEST_PROC_GRID
@@ -314,9 +372,11 @@ class ProcGrid {
   /// \param cols The number of tile columns
   /// \param row_size The number of element rows
   /// \param col_size The number of element columns
+  /// \param layers The number of replicated layers of the process grid
   ProcGrid(World& world, const size_type test_rank, size_type test_nprocs,
            const size_type rows, const size_type cols,
-           const std::size_t row_size, const std::size_t col_size)
+           const std::size_t row_size, const std::size_t col_size,
+           const size_type layers = 1u)
       : world_(&world),
         rows_(rows),
         cols_(cols),
@@ -328,7 +388,9 @@ class ProcGrid {
         rank_col_(-1),
         local_rows_(0u),
         local_cols_(0u),
-        local_size_(0u) {
+        local_size_(0u),
+        layers_(1u),
+        layer_(0u) {
     // Check for non-zero sizes
     TA_ASSERT(rows >= 1u);
     TA_ASSERT(cols >= 1u);
@@ -336,7 +398,10 @@ class ProcGrid {
     TA_ASSERT(col_size >= 1u);
     TA_ASSERT(test_rank < test_nprocs);
 
-    init(test_rank, test_nprocs, row_size, col_size);
+    if (layers == 1u)
+      init(test_rank, test_nprocs, row_size, col_size);
+    else
+      init(test_rank, test_nprocs, layers, row_size, col_size);
   }
 #endif  // TILEDARRAY_ENABLE_TEST_PROC_GRID
 
@@ -358,7 +423,9 @@ class ProcGrid {
         rank_col_(other.rank_col_),
         local_rows_(other.local_rows_),
         local_cols_(other.local_cols_),
-        local_size_(other.local_size_) {}
+        local_size_(other.local_size_),
+        layers_(other.layers_),
+        layer_(other.layer_) {}
 
   /// Copy assignment operator
 
@@ -376,6 +443,8 @@ class ProcGrid {
     local_rows_ = other.local_rows_;
     local_cols_ = other.local_cols_;
     local_size_ = other.local_size_;
+    layers_ = other.layers_;
+    layer_ = other.layer_;
 
     return *this;
   }
@@ -436,6 +505,53 @@ class ProcGrid {
   /// less than the number of process in world).
   size_type proc_size() const { return proc_size_; }
 
+  /// Layer count accessor
+
+  /// \return The number of replicated layers of the process grid
+  size_type layers() const { return layers_; }
+
+  /// Layer accessor
+
+  /// \return The layer of this process, or \c layers() if this process is
+  /// not part of the process grid
+  size_type layer() const { return layer_; }
+
+  /// Layer offset accessor
+
+  /// \return The rank of the first process in the layer of this process
+  ProcessID layer_offset() const { return layer_ * proc_size_; }
+
+  /// First inner index of a layer
+
+  /// The inner dimension of size \c k is partitioned into \c layers()
+  /// contiguous slices; slice \c l is <tt>[layer_k_begin(k,l),
+  /// layer_k_begin(k,l+1))</tt>. Inner index \c x belongs to layer
+  /// <tt>(x * layers()) / k</tt>.
+  /// \param k The number of tiles in the inner dimension
+  /// \param layer The layer index
+  /// \return The first inner index that is evaluated by \c layer
+  size_type layer_k_begin(const size_type k, const size_type layer) const {
+    TA_ASSERT(layer <= layers_);
+    return (std::size_t(layer) * k + layers_ - 1u) / layers_;
+  }
+
+  /// First inner index of this process's layer
+
+  /// \param k The number of tiles in the inner dimension
+  /// \return The first inner index that is evaluated by this process
+  size_type layer_k_begin(const size_type k) const {
+    return layer_k_begin(k, layer_);
+  }
+
+  /// End of the inner index range of this process's layer
+
+  /// \param k The number of tiles in the inner dimension
+  /// \return One past the last inner index that is evaluated by this process
+  size_type layer_k_end(const size_type k) const {
+    return (layer_ < layers_ ? layer_k_begin(k, layer_ + 1u)
+                             : layer_k_begin(k, layer_));
+  }
+
   /// Construct a row group
 
   /// \param did The distributed id for the result group
@@ -451,7 +567,7 @@ class ProcGrid {
       proc_list.reserve(proc_cols_);
 
       // Populate the row process list
-      size_type p = rank_row_ * proc_cols_;
+      size_type p = layer_offset() + rank_row_ * proc_cols_;
       const size_type row_end = p + proc_cols_;
       for (; p < row_end; ++p) proc_list.push_back(p);
 
@@ -477,7 +593,9 @@ class ProcGrid {
       proc_list.reserve(proc_rows_);
 
       // Populate the column process list
-      for (size_type p = rank_col_; p < proc_size_; p += proc_cols_)
+      const size_type layer_end = layer_offset() + proc_size_;
+      for (size_type p = layer_offset() + rank_col_; p < layer_end;
+           p += proc_cols_)
         proc_list.push_back(p);
 
       // Construct the group
@@ -495,7 +613,7 @@ class ProcGrid {
   /// (row,rank_col)
   ProcessID map_row(const size_type row) const {
     TA_ASSERT(row < proc_rows_);
-    return rank_col_ + row * proc_cols_;
+    return layer_offset() + rank_col_ + row * proc_cols_;
   }
 
   /// Map a column to the process in this process's row
@@ -505,12 +623,13 @@ class ProcGrid {
   /// (rank_row,col)
   ProcessID map_col(const size_type col) const {
     TA_ASSERT(col < proc_cols_);
-    return rank_row_ * proc_cols_ + col;
+    return layer_offset() + rank_row_ * proc_cols_ + col;
   }
 
   /// Construct a cyclic process
 
   /// Construct a cyclic process map with the same phase as the process grid.
+  /// For a replicated process grid the tiles are mapped onto the first layer.
   /// \return Cyclic process map
   std::shared_ptr<Pmap> make_pmap() const {
     TA_ASSERT(world_);
@@ -522,12 +641,18 @@ class ProcGrid {
   /// Construct column phased a cyclic process
 
   /// Construct a cyclic process map where the column phase of the process
-  /// matches that of this process grid.
+  /// matches that of this process grid. For a replicated process grid the
+  /// rows are the inner (contraction) dimension, and row \c k is mapped onto
+  /// the layer that evaluates \c k .
   /// \param rows The number of rows in the process map
   /// \return Cyclic process map with matching column phase
   std::shared_ptr<Pmap> make_col_phase_pmap(const size_type rows) const {
     TA_ASSERT(world_);
 
+    if (layers_ > 1u)
+      return std::make_shared<LayeredCyclicPmap>(
+          *world_, rows, cols_, proc_rows_, proc_cols_, layers_, 0u);
+
     return std::make_shared<CyclicPmap>(*world_, rows, cols_, proc_rows_,
                                         proc_cols_);
   }
@@ -535,12 +660,18 @@ class ProcGrid {
   /// Construct row phased a cyclic process
 
   /// Construct a cyclic process map where the column phase of the process
-  /// matches that of this process grid.
+  /// matches that of this process grid. For a replicated process grid the
+  /// columns are the inner (contraction) dimension, and column \c k is
+  /// mapped onto the layer that evaluates \c k .
   /// \param cols The number of columns in the process map
   /// \return Cyclic process map with matching column phase
   std::shared_ptr<Pmap> make_row_phase_pmap(const size_type cols) const {
     TA_ASSERT(world_);
 
+    if (layers_ > 1u)
+      return std::make_shared<LayeredCyclicPmap>(
+          *world_, rows_, cols, proc_rows_, proc_cols_, layers_, 1u);
+
     return std::make_shared<CyclicPmap>(*world_, rows_, cols, proc_rows_,
                                         proc_cols_);
   }
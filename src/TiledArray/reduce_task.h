@@ -23,6 +23,15 @@
 #include <TiledArray/config.h>
 #include <TiledArray/error.h>
 #include <TiledArray/external/madness.h>
+#include <TiledArray/type_traits.h>
+#include <TiledArray/util/env.h>
+#include <TiledArray/util/tracing.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 #ifdef TILEDARRAY_HAS_CUDA
 #include <TiledArray/cuda/cuda_task_fn.h>
@@ -34,6 +43,41 @@
 namespace TiledArray {
 namespace detail {
 
+/// Global reduce task accumulator count accessor
+inline std::size_t& reduce_task_accumulators_accessor() {
+  static std::size_t accumulators = std::clamp<std::size_t>(
+      getenv_number<std::size_t>("TA_REDUCE_ACCUMULATORS", 4ul), 1ul, 64ul);
+  return accumulators;
+}
+
+}  // namespace detail
+
+/// Reduce task accumulator count accessor
+
+/// \return The maximum number of partial results of a reduction task that
+/// are accumulated concurrently; the default value is read from the
+/// \c TA_REDUCE_ACCUMULATORS environment variable, or is 4 if it is not set.
+inline std::size_t reduce_task_accumulators() {
+  return detail::reduce_task_accumulators_accessor();
+}
+
+/// Set the reduce task accumulator count
+
+/// Arguments of a reduction task that become ready concurrently, e.g. the
+/// GEMM results that contribute to one result tile of a contraction, are
+/// reduced into up to \c accumulators partial results in parallel; the
+/// partial results are summed when the task runs. More accumulators reduce
+/// contention, at the cost of one temporary result object each. The new
+/// value is used by reduction tasks that are constructed after this call.
+/// \param accumulators The maximum number of partial results
+/// \throw TiledArray::Exception When \c accumulators is not in [1, 64]
+inline void set_reduce_task_accumulators(const std::size_t accumulators) {
+  TA_ASSERT(accumulators > 0ul && accumulators <= 64ul);
+  detail::reduce_task_accumulators_accessor() = accumulators;
+}
+
+namespace detail {
+
 template <typename T>
 struct ArgumentHelper {
   typedef Future<T> type;
@@ -49,6 +93,20 @@ struct ArgumentHelper<std::pair<Future<T>, Future<U> > > {
   typedef std::pair<Future<T>, Future<U> > type;
 };  // struct ArgumentHelper
 
+/// Batch size of a reduction operation
+
+/// \tparam opT The reduction operation type
+/// \param op The reduction operation
+/// \return <tt>op.batch_size()</tt> if \c opT has a \c batch_size() member
+/// function, otherwise 1
+template <typename opT>
+std::size_t reduce_batch_size(const opT& op) {
+  if constexpr (has_member_function_batch_size_anyreturn_v<const opT>)
+    return std::max<std::size_t>(op.batch_size(), 1ul);
+  else
+    return 1ul;
+}
+
 /// Wrapper that to convert a pair-wise reduction into a standard reduction
 
 /// \tparam opT The pair-wise reduction operation to be reduced
@@ -117,6 +175,49 @@ class ReducePairOpWrapper {
     op_(result, arg.first, arg.second);
   }
 
+  /// Reduce several argument pairs
+
+  /// If \c opT can reduce several pairs with one call, i.e. it has a member
+  /// <tt>op(result, first, second, n)</tt> where \c first and \c second are
+  /// arrays of \c n pointers to the arguments, the pairs are passed to it
+  /// together; otherwise they are reduced one at a time.
+  /// \param[out] result The object that will hold the result of this reduction
+  /// \param[in] args The argument pairs to be reduced
+  /// \param[in] n The number of argument pairs
+  void operator()(result_type& result, const argument_type* const* args,
+                  const std::size_t n) const {
+    if constexpr (op_is_batched) {
+      std::vector<const first_argument_type*> first(n);
+      std::vector<const second_argument_type*> second(n);
+      for (std::size_t i = 0ul; i < n; ++i) {
+        first[i] = &(args[i]->first.get());
+        second[i] = &(args[i]->second.get());
+      }
+      op_(result, first.data(), second.data(), n);
+    } else {
+      for (std::size_t i = 0ul; i < n; ++i)
+        op_(result, args[i]->first, args[i]->second);
+    }
+  }
+
+  /// Batch size accessor
+
+  /// \return The maximum number of argument pairs that should be reduced
+  /// together, or 1 if \c opT reduces one pair at a time
+  std::size_t batch_size() const {
+    if constexpr (op_is_batched)
+      return reduce_batch_size(op_);
+    else
+      return 1ul;
+  }
+
+ private:
+  static constexpr bool op_is_batched =
+      has_member_function_batch_size_anyreturn_v<const opT> &&
+      std::is_invocable_v<const opT&, result_type&,
+                          const first_argument_type* const*,
+                          const second_argument_type* const*, std::size_t>;
+
 };  // class ReducePairOpWrapper
 
 /// Reduce task
@@ -132,6 +233,13 @@ class ReducePairOpWrapper {
 /// data that is not stored in a future can be used, it may not be the best
 /// choice in that case.
 ///
+/// Arguments that are ready are pushed onto a lock-free stack, and are
+/// reduced by up to \c reduce_task_accumulators() concurrent accumulator
+/// tasks, each of which owns a partial result. The partial results are
+/// reduced together when the task runs. Thus, arguments that become ready at
+/// the same time, e.g. the contributions of a SUMMA iteration to a result
+/// tile, do not serialize on a lock.
+///
 /// The reduction operation must have the following form:
 /// \code
 /// struct ReductionOp {
@@ -217,11 +325,15 @@ class ReduceTask {
     /// this object are ready, it will invoke the parent callback.
     class ReduceObject : public madness::CallbackInterface {
      private:
+      friend class ReduceTaskImpl;
+
       ReduceTaskImpl* parent_;  ///< The parent task
       typename ArgumentHelper<argument_type>::type
           arg_;                               ///< The reduction argument
       madness::CallbackInterface* callback_;  ///< Reduction callback
       madness::AtomicInt count_;              ///< Dependency counter
+      ReduceObject* next_ = nullptr;  ///< The next argument in the stack of
+                                      ///< ready arguments
 
       /// Register a future as a dependency
 
@@ -326,9 +438,6 @@ class ReduceTask {
         }
         /// delete objects pointer
         delete objects;
-        //            std::cout << std::to_string(
-        //                             TiledArray::get_default_world().rank()) +
-        //                             " call 1\n";
       };
 
       /// use madness task to call the destroy function, since it might call
@@ -352,286 +461,174 @@ class ReduceTask {
         dep->dec();
       }
       delete objects;
-      //          std::cout <<
-      //          std::to_string(TiledArray::get_default_world().rank()) +
-      //                           " call 2\n";
 
       const auto t1 = TiledArray::now();
       TiledArray::detail::cuda_callback_duration_ns<1>() +=
           TiledArray::duration_in_ns(t0, t1);
     }
 
-    static void CUDART_CB
-    cuda_dependency_dec_reduceobject_delete_callback(void* userData) {
-      const auto t0 = TiledArray::now();
-
-      std::vector<void*>* objects = static_cast<std::vector<void*>*>(userData);
-
-      assert(objects->size() == 3);
-
-      /// convert void* to madness::World*
-      madness::World* world = static_cast<madness::World*>(objects->at(0));
-
-      // convert void* to DependencyInterface
-      ReduceTaskImpl* dep = static_cast<ReduceTaskImpl*>(objects->at(1));
-      // call dec
-      dep->dec();
-
-      // convert void* to ReduceObject*
-      ReduceObject* reduce_object = static_cast<ReduceObject*>(objects->at(2));
-
-      auto destroy = [](ReduceObject* object) {
-        ReduceObject::destroy(object);
-        //            std::cout << std::to_string(
-        //                             TiledArray::get_default_world().rank()) +
-        //                             " call 3\n";
-      };
-
-      // delete ReduceObject
-      world->taskq.add(destroy, reduce_object, TaskAttributes::hipri());
-
-      delete objects;
-
-      const auto t1 = TiledArray::now();
-      TiledArray::detail::cuda_callback_duration_ns<2>() +=
-          TiledArray::duration_in_ns(t0, t1);
+#endif
+    virtual void get_id(std::pair<void*, unsigned short>& id) const {
+      return PoolTaskInterface::make_id(id, *this);
     }
 
-    static void CUDART_CB cuda_readyresult_reset_callback(void* userData) {
-      const auto t0 = TiledArray::now();
+    /// Push a ready argument onto the lock-free stack of ready arguments
 
-      std::vector<void*>* objects = static_cast<std::vector<void*>*>(userData);
+    /// \param object The reduction argument that is ready to be reduced
+    void push(ReduceObject* object) {
+      ReduceObject* head = ready_objects_.load();
+      do {
+        object->next_ = head;
+      } while (!ready_objects_.compare_exchange_weak(head, object));
+    }
 
-      /// convert first void* to madness::World*
-      madness::World* world = static_cast<madness::World*>((*objects)[0]);
+    /// Claim an idle accumulator
+
+    /// \return The index of the claimed accumulator, or -1 if all
+    /// accumulators are busy
+    int acquire() {
+      std::uint64_t idle = idle_.load();
+      while (idle) {
+        const std::uint64_t bit = idle & (~idle + 1ul);  // lowest idle
+        if (idle_.compare_exchange_weak(idle, idle & ~bit)) {
+          int slot = 0;
+          for (std::uint64_t b = bit; b > 1ul; b >>= 1) ++slot;
+          return slot;
+        }
+      }
+      return -1;
+    }
 
-      auto reset = [](std::vector<void*>* objects) {
-        // skip the first one since it always be madness::World*
-        // convert void* to the correct type
-        std::shared_ptr<result_type>* result =
-            static_cast<std::shared_ptr<result_type>*>((*objects)[1]);
-        // call reset on shared_ptr
-        result->reset();
-        delete objects;
-        //            std::cout <<
-        //            std::to_string(TiledArray::get_default_world().rank()) +
-        //                         " call 4\n";
-      };
+    /// Return an accumulator to the idle state
 
-      world->taskq.add(reset, objects, TaskAttributes::hipri());
+    /// \param slot The index of the accumulator
+    void release(const int slot) { idle_.fetch_or(std::uint64_t(1) << slot); }
 
-      const auto t1 = TiledArray::now();
-      TiledArray::detail::cuda_callback_duration_ns<3>() +=
-          TiledArray::duration_in_ns(t0, t1);
-    }
+    /// Reduce a batch of reduction arguments
 
-#endif
-    virtual void get_id(std::pair<void*, unsigned short>& id) const {
-      return PoolTaskInterface::make_id(id, *this);
+    /// \param result The target of the reduction
+    /// \param batch The reduction arguments to be reduced
+    void reduce_batch(result_type& result,
+                      const std::vector<ReduceObject*>& batch) {
+      if constexpr (std::is_invocable_v<opT&, result_type&,
+                                        const argument_type* const*,
+                                        std::size_t>) {
+        std::vector<const argument_type*> args(batch.size());
+        for (std::size_t i = 0ul; i < batch.size(); ++i)
+          args[i] = &(batch[i]->arg());
+        op_(result, args.data(), args.size());
+      } else {
+        for (ReduceObject* object : batch) op_(result, object->arg());
+      }
     }
 
-    /// Check for ready reduce arguments and reduce them
-
-    /// This function will check for and reduce data that is ready until
-    /// there is no more data to be reduced. Once there is no more data
-    /// that is ready to be reduced, result will be placed in the ready
-    /// state.
-    /// \param result The result object that will be used to reduce
-    /// other data
-    void reduce(std::shared_ptr<result_type>& result) {
-      while (result) {
-        lock_.lock();  // <<< Begin critical section
-        if (ready_object_) {
-          // Get the ready argument
-          ReduceObject* ready_object = const_cast<ReduceObject*>(ready_object_);
-          ready_object_ = nullptr;
-          lock_.unlock();  // <<< End critical section
-
-          // Reduce the argument that was held by ready_object_
-          op_(*result, ready_object->arg());
-
-          // cleanup the argument
-#ifdef TILEDARRAY_HAS_CUDA
-          auto stream_ptr = tls_cudastream_accessor();
-
-          /// non-CUDA op
-          if (stream_ptr == nullptr) {
-            ReduceObject::destroy(ready_object);
-            this->dec();
-          } else {
-            auto callback_object = new std::vector<void*>(3);
-            (*callback_object)[0] = &world_;
-            (*callback_object)[1] = this;
-            (*callback_object)[2] = ready_object;
-            CudaSafeCall(
-                cudaSetDevice(cudaEnv::instance()->current_cuda_device_id()));
-            CudaSafeCall(cudaLaunchHostFunc(
-                *stream_ptr, cuda_dependency_dec_reduceobject_delete_callback,
-                callback_object));
-            synchronize_stream(nullptr);
-            //                std::cout << std::to_string(world().rank()) + "
-            //                add 3\n";
-          }
-#else
-          ReduceObject::destroy(ready_object);
-          this->dec();
-#endif
-        } else if (ready_result_) {
-          // Get the ready result
-          std::shared_ptr<result_type> ready_result = ready_result_;
-          ready_result_.reset();
-          lock_.unlock();  // <<< End critical section
+    /// Reduce a list of ready arguments and release them
 
-          // Reduce the result that was held by ready_result_
-          op_(*result, *ready_result);
-
-          // cleanup the result
+    /// The arguments are reduced in batches of up to \c batch_size_
+    /// arguments. The dependency counter is decremented once for each
+    /// argument.
+    /// \param result The target of the reduction
+    /// \param objects The head of the list of ready arguments
+    void reduce_objects(result_type& result, ReduceObject* objects) {
+      std::vector<ReduceObject*> batch;
+      batch.reserve(batch_size_);
+      while (objects) {
+        batch.clear();
+        for (; objects && (batch.size() < batch_size_);
+             objects = objects->next_)
+          batch.push_back(objects);
+        if (batch_size_ > 1ul)
+          reduce_batch(result, batch);
+        else
+          op_(result, batch.front()->arg());
+
+        // Cleanup the arguments
 #ifdef TILEDARRAY_HAS_CUDA
-          auto stream_ptr = tls_cudastream_accessor();
-          if (stream_ptr == nullptr) {
-            ready_result.reset();
-          } else {
-            auto ready_result_heap =
-                new std::shared_ptr<result_type>(ready_result);
-            auto callback_object = new std::vector<void*>(2);
-            (*callback_object)[0] = &world_;
-            (*callback_object)[1] = ready_result_heap;
-            CudaSafeCall(
-                cudaSetDevice(cudaEnv::instance()->current_cuda_device_id()));
-            CudaSafeCall(cudaLaunchHostFunc(
-                *stream_ptr, cuda_readyresult_reset_callback, callback_object));
-            synchronize_stream(nullptr);
-            //                std::cout << std::to_string(world().rank()) + "
-            //                add 4\n";
-          }
-#else
-          ready_result.reset();
+        auto stream_ptr = tls_cudastream_accessor();
+        if (stream_ptr != nullptr) {
+          // Release the arguments, and decrement the dependency counter,
+          // once the stream has reduced them
+          auto callback_object = new std::vector<void*>(1, &world_);
+          callback_object->insert(callback_object->end(), batch.begin(),
+                                  batch.end());
+          auto callback_object2 = new std::vector<void*>(batch.size(), this);
+          CudaSafeCall(
+              cudaSetDevice(cudaEnv::instance()->current_cuda_device_id()));
+          CudaSafeCall(cudaLaunchHostFunc(
+              *stream_ptr, cuda_reduceobject_delete_callback, callback_object));
+          CudaSafeCall(cudaLaunchHostFunc(
+              *stream_ptr, cuda_dependency_dec_callback, callback_object2));
+          synchronize_stream(nullptr);
+          continue;
+        }
 #endif
-        } else {
-          // Nothing is ready, so place result in the ready state.
-          ready_result_ = result;
-          result.reset();
-          lock_.unlock();  // <<< End critical section
+        for (ReduceObject* object : batch) {
+          ReduceObject::destroy(object);
+          this->dec();
         }
       }
     }
 
-    /// Reduce an argument
-
-    /// \param result The target of the reduction
-    /// \param object The reduction argument to be reduced
-    void reduce_result_object(std::shared_ptr<result_type> result,
-                              const ReduceObject* object) {
-      // Reduce the argument
-      op_(*result, object->arg());
-
-      // Cleanup the argument
-#ifdef TILEDARRAY_HAS_CUDA
-      auto stream_ptr = tls_cudastream_accessor();
-      if (stream_ptr == nullptr) {
-        ReduceObject::destroy(object);
-      } else {
-        auto callback_object = new std::vector<void*>(2);
-        (*callback_object)[0] = &world_;
-        (*callback_object)[1] = const_cast<ReduceObject*>(object);
-        CudaSafeCall(
-            cudaSetDevice(cudaEnv::instance()->current_cuda_device_id()));
-        CudaSafeCall(cudaLaunchHostFunc(
-            *stream_ptr, cuda_reduceobject_delete_callback, callback_object));
-        synchronize_stream(nullptr);
-        //            std::cout << std::to_string(world().rank()) + " add 1\n";
-      }
-#else
-      ReduceObject::destroy(object);
-#endif
-      // Check for more reductions
-      reduce(result);
+    /// Accumulator task function
+
+    /// Reduces ready arguments into the partial result of accumulator
+    /// \c slot until none are left, then returns the accumulator to the idle
+    /// state. The task holds a dependency of this task, so the partial
+    /// results are only merged after all accumulators have finished.
+    /// \param slot The index of the accumulator claimed for this task
+    void accumulate(int slot) {
+      tracing::TileContext context(trace_ordinal_);
+      while (slot >= 0) {
+        std::unique_ptr<result_type>& partial = partials_[slot];
+        while (ReduceObject* objects = ready_objects_.exchange(nullptr)) {
+          if (!partial) partial = std::make_unique<result_type>(op_());
+          reduce_objects(*partial, objects);
+        }
+        release(slot);
 
-      // Decrement the dependency counter for the argument. This must
-      // be done after the reduce call to avoid a race condition.
-#ifdef TILEDARRAY_HAS_CUDA
-      if (stream_ptr == nullptr) {
-        this->dec();
-      } else {
-        auto callback_object2 = new std::vector<void*>(1);
-        (*callback_object2)[0] = this;
-        CudaSafeCall(
-            cudaSetDevice(cudaEnv::instance()->current_cuda_device_id()));
-        CudaSafeCall(cudaLaunchHostFunc(
-            *stream_ptr, cuda_dependency_dec_callback, callback_object2));
-        //            std::cout << std::to_string(world().rank()) + " add 2\n";
+        // An argument that became ready before the release may not have
+        // found an idle accumulator, so check again.
+        slot = (ready_objects_.load() ? acquire() : -1);
       }
-#else
       this->dec();
-#endif
     }
 
-    /// Reduce two reduction arguments
-    void reduce_object_object(const ReduceObject* object1,
-                              const ReduceObject* object2) {
-      // Construct an empty result object
-      auto result = std::make_shared<result_type>(op_());
+    /// Start an accumulator task if an accumulator is idle
 
-      // Reduce the two arguments
-      op_(*result, object1->arg());
-      op_(*result, object2->arg());
+    /// When all accumulators are busy, one of them will reduce the ready
+    /// arguments before it becomes idle.
+    void launch() {
+      const int slot = acquire();
+      if (slot < 0) return;
+      this->inc();
+      world_.taskq.add(this, &ReduceTaskImpl::accumulate, slot,
+                       TaskAttributes::hipri());
+    }
 
-      // Cleanup arguments
-#ifdef TILEDARRAY_HAS_CUDA
-      auto stream_ptr = tls_cudastream_accessor();
-      if (stream_ptr == nullptr) {
-        ReduceObject::destroy(object1);
-        ReduceObject::destroy(object2);
-      } else {
-        auto callback_object1 = new std::vector<void*>(3);
-        (*callback_object1)[0] = &world_;
-        (*callback_object1)[1] = const_cast<ReduceObject*>(object1);
-        (*callback_object1)[2] = const_cast<ReduceObject*>(object2);
-        CudaSafeCall(
-            cudaSetDevice(cudaEnv::instance()->current_cuda_device_id()));
-        CudaSafeCall(cudaLaunchHostFunc(
-            *stream_ptr, cuda_reduceobject_delete_callback, callback_object1));
-        synchronize_stream(nullptr);
-        //            std::cout << std::to_string(world().rank()) + " add 1\n";
+    /// Merge the partial results of the accumulators
+
+    /// \return The total result
+    result_type& merge() {
+      result_type* result = nullptr;
+      for (auto& partial : partials_) {
+        if (!partial) continue;
+        if (result)
+          op_(*result, *partial);
+        else
+          result = partial.get();
       }
-#else
-      ReduceObject::destroy(object1);
-      ReduceObject::destroy(object2);
-#endif
-
-      // Check for more reductions
-      reduce(result);
-
-      // Decrement the dependency counter for the two arguments. This
-      // must be done after the reduce call to avoid a race condition.
-#ifdef TILEDARRAY_HAS_CUDA
-      if (stream_ptr == nullptr) {
-        this->dec();
-        this->dec();
-      } else {
-        auto callback_object2 = new std::vector<void*>(2);
-        (*callback_object2)[0] = this;
-        (*callback_object2)[1] = this;
-        CudaSafeCall(
-            cudaSetDevice(cudaEnv::instance()->current_cuda_device_id()));
-        CudaSafeCall(cudaLaunchHostFunc(
-            *stream_ptr, cuda_dependency_dec_callback, callback_object2));
-        //            std::cout << std::to_string(world().rank()) + " add 2\n";
+      if (!result) {
+        partials_.front() = std::make_unique<result_type>(op_());
+        result = partials_.front().get();
       }
-
-#else
-      this->dec();
-      this->dec();
-#endif
+      return *result;
     }
 
 #ifdef TILEDARRAY_HAS_CUDA
     template <typename Result = result_type>
     std::enable_if_t<detail::is_cuda_tile_v<Result>, void> internal_run(
         const madness::TaskThreadEnv&) {
-      TA_ASSERT(ready_result_);
-
-      auto post_result = madness::add_cuda_task(world_, op_, *ready_result_);
+      auto post_result = madness::add_cuda_task(world_, op_, merge());
       result_.set(post_result);
 
       if (callback_) {
@@ -645,21 +642,56 @@ class ReduceTask {
     void
 #endif
     internal_run(const madness::TaskThreadEnv&) {
-      TA_ASSERT(ready_result_);
-      result_.set(op_(*ready_result_));
+      {
+        tracing::TileContext context(trace_ordinal_);
+        tracing::Scope scope(tracing::Event::reduce, 0, 0);
+        result_.set(op_(merge()));
+      }
 
       if (callback_) callback_->notify();
     }
 
     World& world_;  ///< The world that owns this task
     opT op_;        ///< The reduction operation
-    std::shared_ptr<result_type>
-        ready_result_;  ///< Result object that is ready to be reduced
-    volatile ReduceObject*
-        ready_object_;  ///< Reduction argument that is ready to be reduced
+    std::atomic<ReduceObject*>
+        ready_objects_;  ///< Lock-free stack of reduction arguments that are
+                         ///< ready to be reduced
+    std::vector<std::unique_ptr<result_type>>
+        partials_;  ///< The partial result of each accumulator
+    std::atomic<std::uint64_t>
+        idle_;  ///< Bit \c i is set when accumulator \c i is idle
     Future<result_type> result_;  ///< The result of the reduction task
-    madness::Spinlock lock_;      ///< Task lock
     madness::CallbackInterface* callback_;  ///< The completion callback
+    const std::size_t batch_size_;  ///< The maximum number of arguments that
+                                    ///< are reduced together
+    std::uint64_t trace_ordinal_ =
+        tracing::no_ordinal;  ///< The tile ordinal of the trace events
+
+    /// Compute the batch size of a reduction operation
+
+    /// \param op The reduction operation
+    /// \return The maximum number of arguments that are reduced together
+    static std::size_t make_batch_size(const opT& op) {
+#ifdef TILEDARRAY_HAS_CUDA
+      // Arguments of CUDA tiles are released by stream callbacks, which are
+      // not batched
+      if constexpr (detail::is_cuda_tile_v<result_type>) return 1ul;
+#endif
+      return reduce_batch_size(op);
+    }
+
+    /// Compute the number of accumulators
+
+    /// \return The maximum number of partial results that are accumulated
+    /// concurrently
+    static std::size_t make_accumulators() {
+#ifdef TILEDARRAY_HAS_CUDA
+      // The results of CUDA tiles are post-processed on a stream, and are
+      // not merged
+      if constexpr (detail::is_cuda_tile_v<result_type>) return 1ul;
+#endif
+      return reduce_task_accumulators();
+    }
 
    public:
     /// Implementation constructor
@@ -672,11 +704,14 @@ class ReduceTask {
         : madness::TaskInterface(1, TaskAttributes::hipri()),
           world_(world),
           op_(op),
-          ready_result_(std::make_shared<result_type>(op())),
-          ready_object_(nullptr),
+          ready_objects_(nullptr),
+          partials_(make_accumulators()),
+          idle_(partials_.size() < 64ul
+                    ? (std::uint64_t(1) << partials_.size()) - 1ul
+                    : ~std::uint64_t(0)),
           result_(),
-          lock_(),
-          callback_(callback) {}
+          callback_(callback),
+          batch_size_(make_batch_size(op)) {}
 
     virtual ~ReduceTaskImpl() {}
 
@@ -687,31 +722,18 @@ class ReduceTask {
 
     /// Callback function invoked by \c ReductionObject
 
-    /// This function will place \c object in the ready state. If
-    /// another object is already in the ready state, then both objects
-    /// are used to spawn a task
+    /// This function pushes \c object onto the stack of ready arguments and
+    /// starts an accumulator task if one is idle. It does not take a lock,
+    /// so arguments that become ready concurrently do not serialize here.
     /// \param object The reduction object that is ready to be reduced
     void ready(ReduceObject* object) {
       TA_ASSERT(object);
-      lock_.lock();  // <<< Begin critical section
-      if (ready_result_) {
-        std::shared_ptr<result_type> ready_result = ready_result_;
-        ready_result_.reset();
-        lock_.unlock();  // <<< End critical section
-        TA_ASSERT(ready_result);
-        world_.taskq.add(this, &ReduceTaskImpl::reduce_result_object,
-                         ready_result, object, TaskAttributes::hipri());
-      } else if (ready_object_) {
-        ReduceObject* ready_object = const_cast<ReduceObject*>(ready_object_);
-        ready_object_ = nullptr;
-        lock_.unlock();  // <<< End critical section
-        TA_ASSERT(ready_object);
-        world_.taskq.add(this, &ReduceTaskImpl::reduce_object_object, object,
-                         ready_object, TaskAttributes::hipri());
-      } else {
-        ready_object_ = object;
-        lock_.unlock();  // <<< End critical section
-      }
+      // Once pushed, object may be reduced, and this task may run and be
+      // deleted, before launch() returns; hold a dependency until then.
+      this->inc();
+      push(object);
+      launch();
+      this->dec();
     }
 
     /// Task result accessor
@@ -724,6 +746,13 @@ class ReduceTask {
     /// \return The world that owns this task.
     World& world() const { return world_; }
 
+    /// Set the tile ordinal of the trace events
+
+    /// \param ordinal The ordinal of the result tile
+    void trace_ordinal(const std::uint64_t ordinal) {
+      trace_ordinal_ = ordinal;
+    }
+
   };  // class ReduceTaskImpl
 
   ReduceTaskImpl* pimpl_;  ///< The reduction task object.
@@ -795,6 +824,17 @@ class ReduceTask {
   /// \return The total number of arguments added to this task
   int count() const { return count_; }
 
+  /// Set the tile ordinal of the trace events of this task
+
+  /// The reduction, and operations of \c opT that are traced, e.g. the GEMMs
+  /// of a contraction, are recorded with this ordinal (see
+  /// \c tracing::TileContext ).
+  /// \param ordinal The ordinal of the result tile
+  void trace_ordinal(const std::uint64_t ordinal) {
+    TA_ASSERT(pimpl_);
+    pimpl_->trace_ordinal(ordinal);
+  }
+
   /// Submit the reduction task to the task queue
 
   /// \return The result of the reduction
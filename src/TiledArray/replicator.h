@@ -20,17 +20,45 @@
 #ifndef TILEDARRAY_REPLICATOR_H__INCLUDED
 #define TILEDARRAY_REPLICATOR_H__INCLUDED
 
+#include <TiledArray/error.h>
 #include <TiledArray/external/madness.h>
+#include <TiledArray/shared_memory.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <stack>
+#include <vector>
 
 namespace TiledArray {
+
+/// Algorithms for replicating a distributed array
+enum class ReplicationAlgorithm {
+  /// Bruck allgather among all processes
+  allgather,
+  /// Each process sends its tiles to the leader of its node, the node
+  /// leaders replicate the data with a Bruck allgather, and each leader
+  /// forwards the data to the other processes of its node
+  node
+};
+
 namespace detail {
 
 /// Replicate a \c Array object
 
 /// This object will create a replicated \c Array from a distributed
-/// \c Array.
+/// \c Array. The tiles are replicated with the Bruck allgather algorithm:
+/// in round \f$ r \f$ each process of the group sends the tiles it holds
+/// from \f$ \min(2^r, P - 2^r) \f$ processes to the process \f$ 2^r \f$
+/// ranks below it, so that \f$ \lceil \log_2 P \rceil \f$ rounds are
+/// needed instead of the \f$ P - 1 \f$ of a ring. With
+/// \c ReplicationAlgorithm::node only the node leaders take part in the
+/// allgather; when the intra-node transport is enabled (see
+/// \c SharedMemoryConfig ) and the tiles are \c TiledArray::Tensor objects,
+/// each leader then publishes the tiles once in its shared-memory segment,
+/// and the other processes of its node copy them from there.
 /// \tparam A The array type
-/// Homeworld = M7R-227
 template <typename A>
 class Replicator : public madness::WorldObject<Replicator<A> >,
                    private madness::Spinlock {
@@ -41,15 +69,43 @@ class Replicator : public madness::WorldObject<Replicator<A> >,
   typedef std::stack<madness::CallbackInterface*,
                      std::vector<madness::CallbackInterface*> >
       callback_type;  ///< Callback interface
+  typedef typename A::ordinal_type ordinal_type;  ///< Tile ordinal type
+  typedef typename A::value_type value_type;      ///< Tile type
+
+  /// The tiles received in one round of the allgather
+  struct Message {
+    std::vector<std::size_t> block_sizes;  ///< Number of tiles of each block
+    std::vector<ordinal_type> indices;     ///< Tile indices
+    std::vector<value_type> tiles;         ///< Tiles
+  };
 
-  A destination_;  ///< The replicated array
-  std::vector<typename A::ordinal_type>
-      indices_;  ///< List of local tile indices
-  std::vector<Future<typename A::value_type> > data_;  ///< List of local tiles
-  madness::AtomicInt sent_;  ///< The number of nodes the data has been sent to
   World& world_;
-  volatile callback_type callbacks_;  ///< A callback stack
-  volatile mutable bool probe_;       ///< Cache for local data probe
+  A destination_;  ///< The replicated array
+  std::vector<ordinal_type> indices_;  ///< List of local tile indices
+  std::vector<Future<value_type> > data_;  ///< List of local tiles
+  volatile callback_type callbacks_;       ///< A callback stack
+  volatile mutable bool probe_;            ///< Cache for local data probe
+
+  std::vector<ProcessID> group_;  ///< The processes of the allgather
+  std::size_t group_rank_;  ///< The position of this process in \c group_
+  ProcessID leader_;        ///< The node leader of this process
+  std::vector<ProcessID> peers_;  ///< The other processes of a leader's node
+  std::shared_ptr<SharedMemoryTransport> shm_;  ///< The intra-node transport
+                                                ///< of the node, or null
+
+  /// The tiles held by this process, grouped in blocks of the processes of
+  /// \c group_ starting with this process
+  std::vector<ordinal_type> held_indices_;
+  std::vector<value_type> held_tiles_;     ///< The held tiles
+  std::vector<std::size_t> block_sizes_;   ///< Number of tiles of each block
+  std::map<ProcessID, std::pair<std::size_t, std::size_t> >
+      peer_tiles_;  ///< The first held tile and number of tiles of each peer
+  std::size_t local_pending_;  ///< Contributions missing from the first block
+  std::map<std::size_t, Message> pending_;  ///< Rounds received early
+  std::size_t rounds_;  ///< The number of rounds of the allgather
+  std::size_t sent_;    ///< The number of rounds that have been sent
+  std::size_t round_;   ///< The number of rounds that have been received
+  bool done_;           ///< The replication is complete on this process
 
   /// \note Assume object is already locked
   void do_callbacks() {
@@ -70,9 +126,9 @@ class Replicator : public madness::WorldObject<Replicator<A> >,
     DelaySend(Replicator_& parent)
         : madness::TaskInterface(madness::TaskAttributes::hipri()),
           parent_(parent) {
-      typename std::vector<Future<typename A::value_type> >::iterator it =
+      typename std::vector<Future<value_type> >::iterator it =
           parent_.data_.begin();
-      typename std::vector<Future<typename A::value_type> >::iterator end =
+      typename std::vector<Future<value_type> >::iterator end =
           parent_.data_.end();
       for (; it != end; ++it) {
         if (!it->probe()) {
@@ -97,10 +153,10 @@ class Replicator : public madness::WorldObject<Replicator<A> >,
     madness::ScopedMutex<madness::Spinlock> locker(this);
 
     if (!probe_) {
-      typename std::vector<Future<typename A::value_type> >::const_iterator it =
+      typename std::vector<Future<value_type> >::const_iterator it =
           data_.begin();
-      typename std::vector<Future<typename A::value_type> >::const_iterator
-          end = data_.end();
+      typename std::vector<Future<value_type> >::const_iterator end =
+          data_.end();
       for (; it != end; ++it)
         if (!it->probe()) break;
 
@@ -114,7 +170,7 @@ class Replicator : public madness::WorldObject<Replicator<A> >,
   void delay_send() {
     if (probe()) {
       // The data is ready so send it now.
-      send();  // Replication is done
+      send();
     } else {
       // The local data is not ready to be sent, so create a task that will
       // send it when it is ready.
@@ -123,46 +179,253 @@ class Replicator : public madness::WorldObject<Replicator<A> >,
     }
   }
 
-  /// Send all local data to the next node
+  /// Contribute the local tiles, which are ready, to the replication
   void send() {
-    const long sent = ++sent_;
-    const ProcessID dest = (world_.rank() + sent) % world_.size();
-
-    if (dest != world_.rank()) {
-      wobj_type::task(dest, &Replicator_::send_handler, indices_, data_,
-                      madness::TaskAttributes::hipri());
-    } else
-      do_callbacks();  // Replication is done
+    std::vector<value_type> tiles;
+    tiles.reserve(data_.size());
+    for (const auto& tile : data_) tiles.push_back(tile.get());
+
+    if (leader_ != world_.rank()) {
+      // Send the local tiles to the leader of this node
+      wobj_type::task(leader_, &Replicator_::gather_handler, world_.rank(),
+                      indices_, tiles, madness::TaskAttributes::hipri());
+    } else {
+      madness::ScopedMutex<madness::Spinlock> locker(this);
+      held_indices_.insert(held_indices_.end(), indices_.begin(),
+                           indices_.end());
+      held_tiles_.insert(held_tiles_.end(), tiles.begin(), tiles.end());
+      --local_pending_;
+      progress();
+    }
   }
 
-  void send_handler(const std::vector<typename A::ordinal_type>& indices,
-                    const std::vector<Future<typename A::value_type> >& data) {
-    typename std::vector<typename A::ordinal_type>::const_iterator index_it =
-        indices.begin();
-    typename std::vector<Future<typename A::value_type> >::const_iterator
-        data_it = data.begin();
-    typename std::vector<Future<typename A::value_type> >::const_iterator
-        data_end = data.end();
+  /// Receive the tiles of a peer of this node leader
 
-    for (; data_it != data_end; ++data_it, ++index_it)
-      destination_.set(*index_it, data_it->get());
+  /// \param peer The peer
+  /// \param indices The indices of the tiles of \c peer
+  /// \param tiles The tiles of \c peer
+  void gather_handler(const ProcessID peer,
+                      const std::vector<ordinal_type>& indices,
+                      const std::vector<value_type>& tiles) {
+    for (std::size_t i = 0ul; i < indices.size(); ++i)
+      destination_.set(indices[i], tiles[i]);
 
-    delay_send();
+    madness::ScopedMutex<madness::Spinlock> locker(this);
+    peer_tiles_[peer] = std::make_pair(held_indices_.size(), indices.size());
+    held_indices_.insert(held_indices_.end(), indices.begin(), indices.end());
+    held_tiles_.insert(held_tiles_.end(), tiles.begin(), tiles.end());
+    --local_pending_;
+    progress();
+  }
+
+  /// Receive the tiles of one round of the allgather
+
+  /// \param round The round
+  /// \param block_sizes The number of tiles of each block
+  /// \param indices The indices of the tiles
+  /// \param tiles The tiles
+  void bruck_handler(const std::size_t round,
+                     const std::vector<std::size_t>& block_sizes,
+                     const std::vector<ordinal_type>& indices,
+                     const std::vector<value_type>& tiles) {
+    for (std::size_t i = 0ul; i < indices.size(); ++i)
+      destination_.set(indices[i], tiles[i]);
+
+    madness::ScopedMutex<madness::Spinlock> locker(this);
+    pending_[round] = Message{block_sizes, indices, tiles};
+    progress();
+  }
+
+  /// Receive all tiles of other processes from the leader of this node
+
+  /// \param indices The indices of the tiles
+  /// \param tiles The tiles
+  void forward_handler(const std::vector<ordinal_type>& indices,
+                       const std::vector<value_type>& tiles) {
+    for (std::size_t i = 0ul; i < indices.size(); ++i)
+      destination_.set(indices[i], tiles[i]);
+
+    madness::ScopedMutex<madness::Spinlock> locker(this);
+    done_ = true;
+    do_callbacks();
+  }
+
+  /// Copy all tiles of other processes out of the segment of the leader
+
+  /// \tparam Range The tile range type
+  /// \param leader The leader of this node
+  /// \param offset The offset of the block that holds the tiles
+  /// \param indices The indices of the tiles
+  /// \param ranges The ranges of the tiles
+  /// \param positions The positions of the tiles in the block in bytes
+  template <typename Range>
+  void forward_shm_handler(const ProcessID leader, const std::size_t offset,
+                           const std::vector<ordinal_type>& indices,
+                           const std::vector<Range>& ranges,
+                           const std::vector<std::size_t>& positions) {
+    TA_ASSERT(shm_);
+    const unsigned char* const data = shm_->data(leader, offset);
+    for (std::size_t i = 0ul; i < indices.size(); ++i) {
+      value_type tile(ranges[i]);
+      std::memcpy(tile.data(), data + positions[i],
+                  tile.size() * sizeof(typename value_type::value_type));
+      destination_.set(indices[i], std::move(tile));
+    }
+    shm_->release(leader, offset);
+
+    madness::ScopedMutex<madness::Spinlock> locker(this);
+    done_ = true;
+    do_callbacks();
+  }
+
+  /// Publish the held tiles for the peers of this node leader
+
+  /// \note Assume object is already locked
+  /// \return \c true if the tiles were forwarded, or \c false if the segment
+  /// of this process is full
+  bool forward_shm() {
+    typedef typename value_type::range_type range_type;
+    typedef typename value_type::value_type numeric_type;
+    std::vector<range_type> ranges;
+    std::vector<std::size_t> positions;
+    ranges.reserve(held_tiles_.size());
+    positions.reserve(held_tiles_.size());
+    std::size_t bytes = 0ul;
+    for (const auto& tile : held_tiles_) {
+      ranges.push_back(tile.range());
+      positions.push_back(bytes);
+      bytes += tile.size() * sizeof(numeric_type);
+    }
+    const std::size_t offset = shm_->publish(bytes, long(peers_.size()));
+    if (offset == SharedMemoryArena::npos) return false;
+    unsigned char* const data = shm_->data(offset);
+    for (std::size_t i = 0ul; i < held_tiles_.size(); ++i)
+      std::memcpy(data + positions[i], held_tiles_[i].data(),
+                  held_tiles_[i].size() * sizeof(numeric_type));
+
+    // Each peer reads all tiles but its own
+    for (const ProcessID peer : peers_) {
+      const auto& own = peer_tiles_[peer];
+      std::vector<ordinal_type> indices;
+      std::vector<range_type> peer_ranges;
+      std::vector<std::size_t> peer_positions;
+      indices.reserve(held_indices_.size() - own.second);
+      peer_ranges.reserve(held_indices_.size() - own.second);
+      peer_positions.reserve(held_indices_.size() - own.second);
+      for (std::size_t i = 0ul; i < held_indices_.size(); ++i) {
+        if (i >= own.first && i < own.first + own.second) continue;
+        indices.push_back(held_indices_[i]);
+        peer_ranges.push_back(ranges[i]);
+        peer_positions.push_back(positions[i]);
+      }
+      wobj_type::task(
+          peer, &Replicator_::template forward_shm_handler<range_type>,
+          world_.rank(), offset, indices, peer_ranges, peer_positions,
+          madness::TaskAttributes::hipri());
+    }
+    return true;
+  }
+
+  /// Advance the allgather as far as the received data allows
+
+  /// \note Assume object is already locked
+  void progress() {
+    if (local_pending_ != 0ul || done_) return;
+    if (block_sizes_.empty()) block_sizes_.push_back(held_tiles_.size());
+
+    const std::size_t size = group_.size();
+    while (round_ < rounds_) {
+      // Send the first blocks to the process 2^round ranks below
+      if (sent_ == round_) {
+        const std::size_t distance = 1ul << round_;
+        const std::size_t blocks = std::min(distance, size - distance);
+        const std::size_t tiles =
+            std::accumulate(block_sizes_.begin(),
+                            block_sizes_.begin() + blocks, std::size_t(0));
+        wobj_type::task(
+            group_[(group_rank_ + size - distance) % size],
+            &Replicator_::bruck_handler, round_,
+            std::vector<std::size_t>(block_sizes_.begin(),
+                                     block_sizes_.begin() + blocks),
+            std::vector<ordinal_type>(held_indices_.begin(),
+                                      held_indices_.begin() + tiles),
+            std::vector<value_type>(held_tiles_.begin(),
+                                    held_tiles_.begin() + tiles),
+            madness::TaskAttributes::hipri());
+        ++sent_;
+      }
+
+      // Append the blocks of the process 2^round ranks above
+      auto it = pending_.find(round_);
+      if (it == pending_.end()) return;
+      const Message& message = it->second;
+      block_sizes_.insert(block_sizes_.end(), message.block_sizes.begin(),
+                          message.block_sizes.end());
+      held_indices_.insert(held_indices_.end(), message.indices.begin(),
+                           message.indices.end());
+      held_tiles_.insert(held_tiles_.end(), message.tiles.begin(),
+                         message.tiles.end());
+      pending_.erase(it);
+      ++round_;
+    }
+
+    // Forward the tiles of the other processes to the peers of this node
+    bool forwarded = false;
+    if constexpr (is_shm_copyable_v<value_type>) {
+      if (shm_ && !peers_.empty() &&
+          std::none_of(held_tiles_.begin(), held_tiles_.end(),
+                       [](const value_type& tile) { return tile.empty(); }))
+        forwarded = forward_shm();
+    }
+    if (!forwarded) {
+      for (const ProcessID peer : peers_) {
+        const auto& own = peer_tiles_[peer];
+        std::vector<ordinal_type> indices;
+        std::vector<value_type> tiles;
+        indices.reserve(held_indices_.size() - own.second);
+        tiles.reserve(held_tiles_.size() - own.second);
+        for (std::size_t i = 0ul; i < held_indices_.size(); ++i) {
+          if (i >= own.first && i < own.first + own.second) continue;
+          indices.push_back(held_indices_[i]);
+          tiles.push_back(held_tiles_[i]);
+        }
+        wobj_type::task(peer, &Replicator_::forward_handler, indices, tiles,
+                        madness::TaskAttributes::hipri());
+      }
+    }
+
+    done_ = true;
+    do_callbacks();  // Replication is done
   }
 
  public:
-  Replicator(const A& source, const A destination)
+  /// Constructor
+
+  /// \note This is a collective operation.
+  /// \param source The distributed array
+  /// \param destination The replicated array
+  /// \param algorithm The replication algorithm
+  Replicator(const A& source, const A destination,
+             const ReplicationAlgorithm algorithm =
+                 ReplicationAlgorithm::allgather)
       : wobj_type(source.world()),
         madness::Spinlock(),
+        world_(source.world()),
         destination_(destination),
         indices_(),
         data_(),
-        sent_(),
-        world_(source.world()),
         callbacks_(),
-        probe_(false) {
-    sent_ = 0;
-
+        probe_(false),
+        group_(),
+        group_rank_(0ul),
+        leader_(world_.rank()),
+        peers_(),
+        shm_(),
+        local_pending_(1ul),
+        rounds_(0ul),
+        sent_(0ul),
+        round_(0ul),
+        done_(false) {
     // Generate a list of local tiles from other.
     typename A::pmap_interface::const_iterator end = source.pmap()->end();
     typename A::pmap_interface::const_iterator it = source.pmap()->begin();
@@ -185,7 +448,26 @@ class Replicator : public madness::WorldObject<Replicator<A> >,
         }
     }
 
-    /// Send the data to the first node
+    // Select the processes of the allgather
+    if (algorithm == ReplicationAlgorithm::node) {
+      const std::vector<ProcessID> leaders = node_leaders(world_);
+      leader_ = leaders[world_.rank()];
+      for (ProcessID p = 0; p < world_.size(); ++p) {
+        if (leaders[p] == p) group_.push_back(p);
+        if (leaders[p] == world_.rank() && p != world_.rank())
+          peers_.push_back(p);
+      }
+      local_pending_ += peers_.size();
+      if constexpr (is_shm_copyable_v<value_type>)
+        shm_ = SharedMemoryTransport::instance(world_);
+    } else {
+      for (ProcessID p = 0; p < world_.size(); ++p) group_.push_back(p);
+    }
+    group_rank_ = std::distance(
+        group_.begin(), std::find(group_.begin(), group_.end(), leader_));
+    while ((1ul << rounds_) < group_.size()) ++rounds_;
+
+    // Send the local data when it is ready
     delay_send();
 
     // Process any pending messages
@@ -194,21 +476,21 @@ class Replicator : public madness::WorldObject<Replicator<A> >,
 
   /// Check that the replication is complete
 
-  /// \return \c true when all data has been transfered.
+  /// \return \c true when all data has been received by this process
   bool done() {
     madness::ScopedMutex<madness::Spinlock> locker(this);
-    return sent_ == world_.size();
+    return done_;
   }
 
   /// Add a callback
 
-  /// The callback is called when the local data has been sent to all
-  /// nodes. If the data has already been sent to all nodes, the callback
-  /// is notified immediately.
+  /// The callback is called when this process has received the data of all
+  /// other processes. If it has already been received, the callback is
+  /// notified immediately.
   /// \param callback The callback object
   void register_callback(madness::CallbackInterface* callback) {
     madness::ScopedMutex<madness::Spinlock> locker(this);
-    if (sent_ == world_.size())
+    if (done_)
       callback->notify();
     else
       const_cast<callback_type&>(callbacks_).push(callback);
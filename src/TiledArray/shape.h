@@ -20,6 +20,7 @@
 #ifndef TILEDARRAY_SHAPE_H__INCLUDED
 #define TILEDARRAY_SHAPE_H__INCLUDED
 
+#include <TiledArray/compressed_sparse_shape.h>
 #include <TiledArray/dense_shape.h>
 #include <TiledArray/sparse_shape.h>
 
@@ -0,0 +1,509 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  shared_memory.h
+ *
+ */
+
+#ifndef TILEDARRAY_SHARED_MEMORY_H__INCLUDED
+#define TILEDARRAY_SHARED_MEMORY_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/external/madness.h>
+#include <TiledArray/tensor/type_traits.h>
+#include <TiledArray/type_traits.h>
+#include <TiledArray/util/memory_size.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+
+/// Intra-node tile transport parameters
+
+/// When \c segment_size is not zero, \c TiledArray::initialize creates a
+/// POSIX shared-memory segment of \c segment_size bytes for each process
+/// and maps the segments of the other processes on the same node. Remote
+/// tiles of \c TiledArray::Tensor type that are owned by a process on the
+/// same node are then copied through these segments instead of being
+/// serialized into active messages when they are fetched with
+/// \c detail::DistributedStorage::get() (e.g. by \c DistArray::find() ),
+/// broadcast by SUMMA contractions, or forwarded to the processes of a node
+/// by \c detail::Replicator . The active messages then only carry the
+/// location of the data in the segment of the sender.
+///
+/// The default value is read from the environment: \c TA_SHM_SIZE (a memory
+/// size, e.g. "1 GiB"). Pages of the segments are only allocated when they
+/// are used.
+struct SharedMemoryConfig {
+  std::size_t segment_size = 0ul;  ///< Bytes of the shared-memory segment of
+                                   ///< each process (0 = disabled)
+
+  /// Construct a configuration from the environment
+
+  /// \return The configuration defined by the \c TA_SHM_SIZE environment
+  /// variable, with defaults for unset variables
+  static SharedMemoryConfig from_env() {
+    SharedMemoryConfig config;
+    if (const char* str = std::getenv("TA_SHM_SIZE"))
+      config.segment_size = detail::memory_size_to_bytes(str);
+    return config;
+  }
+};  // struct SharedMemoryConfig
+
+namespace detail {
+
+/// Global intra-node transport configuration accessor
+inline SharedMemoryConfig& shared_memory_config_accessor() {
+  static SharedMemoryConfig config = SharedMemoryConfig::from_env();
+  return config;
+}
+
+}  // namespace detail
+
+/// Intra-node transport configuration accessor
+
+/// \return The configuration used by \c TiledArray::initialize
+inline const SharedMemoryConfig& shared_memory_config() {
+  return detail::shared_memory_config_accessor();
+}
+
+/// Set the intra-node transport configuration
+
+/// The configuration takes effect when \c TiledArray::initialize is called.
+/// \param config The new configuration
+inline void set_shared_memory_config(const SharedMemoryConfig& config) {
+  detail::shared_memory_config_accessor() = config;
+}
+
+namespace detail {
+
+/// The node leader of each process
+
+/// The processes that run on the same host belong to one node, and the
+/// process with the lowest rank of each node is its leader.
+/// \note This is a collective operation.
+/// \param world The world
+/// \return The rank of the node leader of each process of \c world
+inline std::vector<ProcessID> node_leaders(World& world) {
+  char name[256] = {};
+  gethostname(name, sizeof(name) - 1);
+  std::vector<unsigned long> hashes(world.size(), 0ul);
+  hashes[world.rank()] = std::hash<std::string>{}(name);
+  world.gop.sum(hashes.data(), hashes.size());
+
+  std::vector<ProcessID> leaders(world.size());
+  for (ProcessID p = 0; p < world.size(); ++p)
+    leaders[p] = std::distance(
+        hashes.begin(), std::find(hashes.begin(), hashes.end(), hashes[p]));
+  return leaders;
+}
+
+/// \c is_shm_copyable<T>::value is true if the data of \c T objects can be
+/// copied through shared memory, i.e. \c T is a \c TiledArray::Tensor of
+/// numeric elements
+template <typename T>
+struct is_shm_copyable : public std::false_type {};
+
+template <typename T, typename A>
+struct is_shm_copyable<Tensor<T, A>>
+    : public std::bool_constant<is_numeric_v<T>> {};
+
+/// \c is_shm_copyable_v<T> is an alias for \c is_shm_copyable<T>::value
+template <typename T>
+constexpr const bool is_shm_copyable_v = is_shm_copyable<T>::value;
+
+/// A mapped POSIX shared-memory segment
+class SharedMemorySegment {
+ private:
+  unsigned char* data_ = nullptr;  ///< The mapped memory
+  std::size_t size_ = 0ul;         ///< The size of the segment in bytes
+
+ public:
+  /// Create a segment
+
+  /// The segment is mapped for reading and writing.
+  /// \param name The name of the segment
+  /// \param size The size of the segment in bytes
+  /// \throw TiledArray::Exception When the segment cannot be created
+  SharedMemorySegment(const std::string& name, const std::size_t size)
+      : size_(size) {
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) TA_EXCEPTION("unable to create a shared-memory segment");
+    if (::ftruncate(fd, size_) != 0) {
+      ::close(fd);
+      ::shm_unlink(name.c_str());
+      TA_EXCEPTION("unable to resize a shared-memory segment");
+    }
+    if (!map(fd, PROT_READ | PROT_WRITE)) {
+      ::shm_unlink(name.c_str());
+      TA_EXCEPTION("unable to map a shared-memory segment");
+    }
+  }
+
+  /// Open a segment created by another process
+
+  /// The segment is mapped for reading and writing, so that the readers of a
+  /// block can update its reader count.
+  /// \param name The name of the segment
+  /// \throw TiledArray::Exception When the segment cannot be opened
+  explicit SharedMemorySegment(const std::string& name) {
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) TA_EXCEPTION("unable to open a shared-memory segment");
+    struct stat status;
+    if (::fstat(fd, &status) == 0) size_ = status.st_size;
+    if (!map(fd, PROT_READ | PROT_WRITE))
+      TA_EXCEPTION("unable to map a shared-memory segment");
+  }
+
+  ~SharedMemorySegment() {
+    if (data_) ::munmap(data_, size_);
+  }
+
+  SharedMemorySegment(const SharedMemorySegment&) = delete;
+  SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+  /// \return The mapped memory
+  unsigned char* data() const { return data_; }
+
+  /// \return The size of the segment in bytes
+  std::size_t size() const { return size_; }
+
+ private:
+  /// Map and close a segment
+
+  /// \param fd The file descriptor of the segment
+  /// \param protection The protection of the mapped memory
+  /// \return \c true if the segment was mapped
+  bool map(const int fd, const int protection) {
+    void* data = (size_ ? ::mmap(nullptr, size_, protection, MAP_SHARED, fd, 0)
+                        : MAP_FAILED);
+    ::close(fd);
+    if (data == MAP_FAILED) return false;
+    data_ = static_cast<unsigned char*>(data);
+    return true;
+  }
+};  // class SharedMemorySegment
+
+/// First-fit allocator of the blocks of a memory region
+class SharedMemoryArena {
+ public:
+  static constexpr std::size_t npos = ~std::size_t(0);  ///< No block
+  static constexpr std::size_t alignment = 64ul;  ///< Block alignment
+
+ private:
+  std::map<std::size_t, std::size_t> free_;  ///< Size of each free block
+  std::size_t blocks_ = 0ul;                 ///< Number of allocated blocks
+  mutable std::mutex mutex_;                 ///< Protects free_ and blocks_
+
+  /// \param size A size in bytes
+  /// \return \c size rounded up to a multiple of \c alignment
+  static std::size_t round_up(const std::size_t size) {
+    return (std::max(size, std::size_t(1)) + alignment - 1) / alignment *
+           alignment;
+  }
+
+ public:
+  /// \param size The size of the region in bytes
+  explicit SharedMemoryArena(const std::size_t size) {
+    const std::size_t usable = size / alignment * alignment;
+    if (usable) free_.emplace(0ul, usable);
+  }
+
+  /// Allocate a block
+
+  /// \param size The size of the block in bytes
+  /// \return The offset of the block, or \c npos if no free block is large
+  /// enough
+  std::size_t allocate(std::size_t size) {
+    size = round_up(size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = free_.begin(); it != free_.end(); ++it) {
+      if (it->second < size) continue;
+      const std::size_t offset = it->first;
+      const std::size_t remainder = it->second - size;
+      free_.erase(it);
+      if (remainder) free_.emplace(offset + size, remainder);
+      ++blocks_;
+      return offset;
+    }
+    return npos;
+  }
+
+  /// Free a block
+
+  /// \param offset The offset of the block
+  /// \param size The size of the block in bytes
+  void deallocate(std::size_t offset, std::size_t size) {
+    size = round_up(size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    TA_ASSERT(blocks_ > 0ul);
+    --blocks_;
+    auto next = free_.lower_bound(offset);
+    TA_ASSERT(next == free_.end() || offset + size <= next->first);
+
+    // Merge with the following free block
+    if (next != free_.end() && next->first == offset + size) {
+      size += next->second;
+      next = free_.erase(next);
+    }
+
+    // Merge with the preceding free block
+    if (next != free_.begin()) {
+      auto prev = std::prev(next);
+      TA_ASSERT(prev->first + prev->second <= offset);
+      if (prev->first + prev->second == offset) {
+        prev->second += size;
+        return;
+      }
+    }
+    free_.emplace(offset, size);
+  }
+
+  /// \return The number of allocated blocks
+  std::size_t blocks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocks_;
+  }
+};  // class SharedMemoryArena
+
+/// Copies tiles between the processes of a node through shared memory
+
+/// Each process owns a segment, which it writes tiles into, and maps the
+/// segments of the other processes of its node, which it reads tiles from.
+/// The segments are unlinked as soon as they are mapped, so they are
+/// released by the operating system when the processes exit, including when
+/// they terminate abnormally.
+///
+/// Data is exchanged in published blocks. A block starts with a header that
+/// holds the number of readers that have not copied the block yet; each
+/// reader decrements it with \c release() once it is done, and the writer
+/// frees the blocks whose count has dropped to zero the next time it
+/// publishes a block (or calls \c reclaim() ). Hence a block only lives
+/// as long as the transfer it was published for.
+class SharedMemoryTransport {
+ public:
+  typedef std::atomic<long> counter_type;  ///< Block reader count type
+  static_assert(counter_type::is_always_lock_free,
+                "the reader count of a block must be lock free to be shared "
+                "by processes");
+
+  /// The size of a block header in bytes, which keeps the data aligned
+  static constexpr std::size_t header_size = SharedMemoryArena::alignment;
+
+ private:
+  World& world_;                        ///< The world of the processes
+  std::vector<ProcessID> leaders_;      ///< The node leader of each process
+  std::unique_ptr<SharedMemorySegment> segment_;  ///< This process' segment
+  std::map<ProcessID, std::unique_ptr<SharedMemorySegment>>
+      peer_segments_;         ///< The segments of the other node processes
+  SharedMemoryArena arena_;  ///< The allocator of this process' segment
+  std::vector<std::pair<std::size_t, std::size_t>>
+      published_;  ///< The offset and size of each published block
+  std::mutex published_mutex_;  ///< Protects published_
+
+  /// \param block A pointer to a block
+  /// \return The reader count of \c block
+  static counter_type& counter(unsigned char* block) {
+    return *reinterpret_cast<counter_type*>(block);
+  }
+
+  /// \return The transport of the default world, if any
+  static std::shared_ptr<SharedMemoryTransport>& instance_accessor() {
+    static std::shared_ptr<SharedMemoryTransport> instance;
+    return instance;
+  }
+
+  /// \param pid A process id
+  /// \return The name of the segment of process \c pid
+  static std::string segment_name(const long pid) {
+    return "/ta_shm." + std::to_string(pid);
+  }
+
+ public:
+  /// Create the segments of a world
+
+  /// \note This is a collective operation.
+  /// \param world The world
+  /// \param size The size of the segment of each process in bytes
+  /// \throw TiledArray::Exception When a process cannot create its segment
+  /// or map the segments of its node
+  SharedMemoryTransport(World& world, const std::size_t size)
+      : world_(world), leaders_(node_leaders(world)), arena_(size) {
+    std::vector<long> pids(world.size(), 0l);
+    pids[world.rank()] = ::getpid();
+    world.gop.sum(pids.data(), pids.size());
+
+    // All processes must agree on failures, or they would deadlock
+    const std::string name = segment_name(pids[world.rank()]);
+    int failed = 0;
+    try {
+      segment_ = std::make_unique<SharedMemorySegment>(name, size);
+    } catch (TiledArray::Exception&) {
+      failed = 1;
+    }
+    world.gop.sum(failed);
+    if (!failed) {
+      try {
+        for (ProcessID p = 0; p < world.size(); ++p)
+          if (is_peer(p))
+            peer_segments_.emplace(p, std::make_unique<SharedMemorySegment>(
+                                          segment_name(pids[p])));
+      } catch (TiledArray::Exception&) {
+        failed = 1;
+      }
+      world.gop.sum(failed);
+    }
+    if (segment_) ::shm_unlink(name.c_str());
+    if (failed) TA_EXCEPTION("unable to create the shared-memory segments");
+  }
+
+  SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+  SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+  /// Create the transport of a world
+
+  /// \note This is a collective operation.
+  /// \param world The world
+  /// \param size The size of the segment of each process in bytes
+  static void initialize(World& world, const std::size_t size) {
+    instance_accessor() = std::make_shared<SharedMemoryTransport>(world, size);
+  }
+
+  /// Release the transport
+
+  /// The segments are unmapped once the objects that use them are destroyed.
+  static void finalize() { instance_accessor().reset(); }
+
+  /// \return The transport, or a null pointer if there is none
+  static std::shared_ptr<SharedMemoryTransport> instance() {
+    return instance_accessor();
+  }
+
+  /// \param world A world
+  /// \return The transport of \c world , or a null pointer if there is none
+  static std::shared_ptr<SharedMemoryTransport> instance(const World& world) {
+    auto result = instance_accessor();
+    if (result && (result->world().id() != world.id())) result.reset();
+    return result;
+  }
+
+  /// \return The world of the processes
+  World& world() const { return world_; }
+
+  /// \param p A process of \c world()
+  /// \return \c true if \c p is another process of the node of this process
+  bool is_peer(const ProcessID p) const {
+    return (p != world_.rank()) && (leaders_[p] == leaders_[world_.rank()]);
+  }
+
+  /// \param p A process of \c world()
+  /// \return The node leader of \c p
+  ProcessID leader(const ProcessID p) const { return leaders_[p]; }
+
+  /// Publish a block of the segment of this process
+
+  /// The caller writes the data into \c data(offset) and then sends
+  /// \c offset to the readers, each of which must call \c release() once it
+  /// has copied the data. Blocks whose readers are all done are freed first.
+  /// \param size The size of the data in bytes
+  /// \param readers The number of processes that will read the block
+  /// \return The offset of the block, or \c SharedMemoryArena::npos if the
+  /// segment is full
+  std::size_t publish(const std::size_t size, const long readers) {
+    TA_ASSERT(readers > 0l);
+    reclaim();
+    const std::size_t bytes = header_size + size;
+    const std::size_t offset = arena_.allocate(bytes);
+    if (offset == SharedMemoryArena::npos) return offset;
+    new (segment_->data() + offset) counter_type(readers);
+    std::lock_guard<std::mutex> lock(published_mutex_);
+    published_.emplace_back(offset, bytes);
+    return offset;
+  }
+
+  /// Free the published blocks that have been released by all readers
+  void reclaim() {
+    std::lock_guard<std::mutex> lock(published_mutex_);
+    auto it = published_.begin();
+    while (it != published_.end()) {
+      unsigned char* const block = segment_->data() + it->first;
+      if (counter(block).load(std::memory_order_acquire) == 0l) {
+        counter(block).~counter_type();
+        arena_.deallocate(it->first, it->second);
+        *it = published_.back();
+        published_.pop_back();
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  /// Signal that this process is done reading a block of a peer
+
+  /// \param p The process that published the block
+  /// \param offset The offset of the block
+  void release(const ProcessID p, const std::size_t offset) const {
+    counter(block(p, offset)).fetch_sub(1l, std::memory_order_acq_rel);
+  }
+
+  /// \return The number of allocated blocks of the segment of this process
+  std::size_t blocks() const { return arena_.blocks(); }
+
+  /// \param offset The offset of a published block of this process
+  /// \return A pointer to the data of the block
+  unsigned char* data(const std::size_t offset) const {
+    TA_ASSERT(offset + header_size <= segment_->size());
+    return segment_->data() + offset + header_size;
+  }
+
+  /// \param p Another process of the node of this process
+  /// \param offset The offset of a published block of \c p
+  /// \return A pointer to the data of the block
+  const unsigned char* data(const ProcessID p, const std::size_t offset) const {
+    return block(p, offset) + header_size;
+  }
+
+ private:
+  /// \param p Another process of the node of this process
+  /// \param offset The offset of a block of the segment of \c p
+  /// \return A pointer to the block
+  unsigned char* block(const ProcessID p, const std::size_t offset) const {
+    const auto it = peer_segments_.find(p);
+    TA_ASSERT(it != peer_segments_.end());
+    TA_ASSERT(offset + header_size <= it->second->size());
+    return it->second->data() + offset;
+  }
+};  // class SharedMemoryTransport
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_SHARED_MEMORY_H__INCLUDED
@@ -0,0 +1,294 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  shm_bcast.h
+ *
+ */
+
+#ifndef TILEDARRAY_SHM_BCAST_H__INCLUDED
+#define TILEDARRAY_SHM_BCAST_H__INCLUDED
+
+#include <TiledArray/chunked_bcast.h>
+#include <TiledArray/error.h>
+#include <TiledArray/external/madness.h>
+#include <TiledArray/shared_memory.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+namespace detail {
+
+/// Node-aware broadcast message key
+
+/// The first member is the key of the broadcast, the second member is the
+/// message index (see \c shm_bcast_tile_msg , \c shm_bcast_block_msg and
+/// \c shm_bcast_copy_msg ).
+typedef std::pair<madness::DistributedID, std::size_t> shm_bcast_key;
+
+/// Index of the tile messages between node roots
+constexpr std::size_t shm_bcast_tile_msg = 0ul;
+/// Index of the block messages from a node root to the processes of its node
+constexpr std::size_t shm_bcast_block_msg = ~std::size_t(0);
+/// Index of the tile messages from a node root to the processes of its node,
+/// which are only sent when the segment of the node root is full
+constexpr std::size_t shm_bcast_copy_msg = ~std::size_t(0) - 1ul;
+
+/// The offset of a published block and the range of the tile it holds
+template <typename T>
+using shm_bcast_block = std::pair<std::size_t, typename T::range_type>;
+
+/// Publish a tile for the other processes of a node
+
+/// This task waits for the tile, copies it into a block of the segment of
+/// this process, and sends the block offset to the readers.
+/// \tparam T The tile type
+template <typename T>
+class ShmBcastPublish : public madness::TaskInterface {
+ private:
+  World& world_;                                ///< The world of the broadcast
+  std::shared_ptr<SharedMemoryTransport> shm_;  ///< The intra-node transport
+  const madness::DistributedID key_;            ///< The broadcast key
+  Future<T> value_;                             ///< The tile
+  const std::vector<ProcessID> readers_;  ///< The processes that read the tile
+
+ public:
+  /// Constructor
+
+  /// \param world The world of the broadcast
+  /// \param shm The intra-node transport
+  /// \param key The broadcast key
+  /// \param value The tile
+  /// \param readers The other processes of this node that receive the tile
+  ShmBcastPublish(World& world,
+                  const std::shared_ptr<SharedMemoryTransport>& shm,
+                  const madness::DistributedID& key, const Future<T>& value,
+                  std::vector<ProcessID>&& readers)
+      : madness::TaskInterface(madness::TaskAttributes::hipri()),
+        world_(world),
+        shm_(shm),
+        key_(key),
+        value_(value),
+        readers_(std::move(readers)) {
+    if (!value_.probe()) {
+      madness::DependencyInterface::inc();
+      value_.register_callback(this);
+    }
+  }
+
+  virtual ~ShmBcastPublish() {}
+
+  /// Task run function
+  virtual void run(const madness::TaskThreadEnv&) {
+    const T& value = value_.get();
+    const std::size_t bytes = value.size() * sizeof(typename T::value_type);
+    const std::size_t offset =
+        (value.empty() ? SharedMemoryArena::npos
+                       : shm_->publish(bytes, long(readers_.size())));
+    if (offset != SharedMemoryArena::npos)
+      std::memcpy(shm_->data(offset), value.data(), bytes);
+
+    const shm_bcast_block<T> block(offset, value.range());
+    for (const ProcessID reader : readers_) {
+      world_.gop.send(reader, shm_bcast_key(key_, shm_bcast_block_msg), block);
+      if (offset == SharedMemoryArena::npos)
+        world_.gop.send(reader, shm_bcast_key(key_, shm_bcast_copy_msg), value);
+    }
+  }
+
+};  // class ShmBcastPublish
+
+/// Copy a tile out of the segment of the node root
+
+/// \tparam T The tile type
+template <typename T>
+class ShmBcastRead : public madness::TaskInterface {
+ private:
+  World& world_;                                ///< The world of the broadcast
+  std::shared_ptr<SharedMemoryTransport> shm_;  ///< The intra-node transport
+  const madness::DistributedID key_;            ///< The broadcast key
+  Future<T> value_;                             ///< The result tile
+  const ProcessID source_;            ///< The node root that published the tile
+  Future<shm_bcast_block<T>> block_;  ///< The block that holds the tile
+
+ public:
+  /// Constructor
+
+  /// \param world The world of the broadcast
+  /// \param shm The intra-node transport
+  /// \param key The broadcast key
+  /// \param value The future that will be set to the tile
+  /// \param source The node root that publishes the tile
+  ShmBcastRead(World& world, const std::shared_ptr<SharedMemoryTransport>& shm,
+               const madness::DistributedID& key, const Future<T>& value,
+               const ProcessID source)
+      : madness::TaskInterface(madness::TaskAttributes::hipri()),
+        world_(world),
+        shm_(shm),
+        key_(key),
+        value_(value),
+        source_(source),
+        block_(world.gop.template recv<shm_bcast_block<T>>(
+            source, shm_bcast_key(key, shm_bcast_block_msg))) {
+    if (!block_.probe()) {
+      madness::DependencyInterface::inc();
+      block_.register_callback(this);
+    }
+  }
+
+  virtual ~ShmBcastRead() {}
+
+  /// Task run function
+  virtual void run(const madness::TaskThreadEnv&) {
+    const shm_bcast_block<T>& block = block_.get();
+    if (block.first == SharedMemoryArena::npos) {
+      value_.set(world_.gop.template recv<T>(
+          source_, shm_bcast_key(key_, shm_bcast_copy_msg)));
+      return;
+    }
+
+    T result(block.second);
+    std::memcpy(result.data(), shm_->data(source_, block.first),
+                result.size() * sizeof(typename T::value_type));
+    shm_->release(source_, block.first);
+    value_.set(std::move(result));
+  }
+
+};  // class ShmBcastRead
+
+/// Check whether a node-aware broadcast would use shared memory
+
+/// \param shm The intra-node transport
+/// \param group The broadcast group
+/// \return \c true if two processes of \c group run on the same node
+inline bool shm_bcast_has_peers(const SharedMemoryTransport& shm,
+                                const madness::Group& group) {
+  std::vector<ProcessID> leaders;
+  leaders.reserve(group.size());
+  for (ProcessID g = 0; g < group.size(); ++g)
+    leaders.push_back(shm.leader(group.world_rank(g)));
+  std::sort(leaders.begin(), leaders.end());
+  return std::adjacent_find(leaders.begin(), leaders.end()) != leaders.end();
+}
+
+/// Node-aware broadcast
+
+/// This function has the same semantics as
+/// \c madness::WorldGopInterface::bcast() . The tile travels in active
+/// messages only between nodes: the process of each node that receives it
+/// (the node root, i.e. the broadcast root or the first process of the node
+/// in \c group ) takes part in a binary-tree broadcast among the node roots,
+/// which is chunked (see \c chunked_bcast() ) when \c chunk_size is not zero
+/// and the tree has more than one level. Each node root then publishes the
+/// tile once in its shared-memory segment, and the other processes of its
+/// node copy it from there; only the block offset and tile range are sent
+/// to them.
+/// \tparam T The tile type; it must satisfy \c is_shm_copyable
+/// \param world The world of the broadcast
+/// \param shm The intra-node transport of \c world
+/// \param key The broadcast key; it must be unique among all broadcasts in
+/// \c world that are in flight
+/// \param[in,out] value On the root process the tile to be broadcast,
+/// otherwise an unset future that will be set to the broadcast tile
+/// \param group_root The group rank of the broadcast root process
+/// \param group The broadcast group
+/// \param chunk_size The number of bytes per chunk of the broadcast among
+/// node roots, or 0 to send the tile in one message
+template <typename T>
+void shm_bcast(World& world, const std::shared_ptr<SharedMemoryTransport>& shm,
+               const madness::DistributedID& key, Future<T>& value,
+               const ProcessID group_root, const madness::Group& group,
+               const std::size_t chunk_size) {
+  static_assert(is_shm_copyable_v<T>,
+                "shm_bcast requires tiles that can be copied through shared "
+                "memory");
+  TA_ASSERT(shm);
+  TA_ASSERT(group.size() > 0);
+  TA_ASSERT(group_root < group.size());
+
+  // The node roots, starting with the broadcast root
+  const ProcessID root = group.world_rank(group_root);
+  std::vector<ProcessID> node_roots(1, root);
+  for (ProcessID g = 0; g < group.size(); ++g) {
+    const ProcessID p = group.world_rank(g);
+    if (std::none_of(node_roots.begin(), node_roots.end(),
+                     [&](const ProcessID r) {
+                       return shm->leader(r) == shm->leader(p);
+                     }))
+      node_roots.push_back(p);
+  }
+  const ProcessID rank = world.rank();
+  const std::size_t position = std::distance(
+      node_roots.begin(),
+      std::find_if(node_roots.begin(), node_roots.end(),
+                   [&](const ProcessID r) {
+                     return shm->leader(r) == shm->leader(rank);
+                   }));
+  TA_ASSERT(position < node_roots.size());
+  const ProcessID node_root = node_roots[position];
+
+  if (rank != node_root) {
+    TA_ASSERT(!value.probe());
+    world.taskq.add(new ShmBcastRead<T>(world, shm, key, value, node_root));
+    return;
+  }
+
+  // Broadcast the tile among the node roots
+  const std::size_t nroots = node_roots.size();
+  const ProcessID parent = (position ? node_roots[(position - 1) / 2] : -1);
+  const ProcessID child0 =
+      (2 * position + 1 < nroots ? node_roots[2 * position + 1] : -1);
+  const ProcessID child1 =
+      (2 * position + 2 < nroots ? node_roots[2 * position + 2] : -1);
+  if (chunk_size && (nroots > 3)) {
+    if (position == 0) {
+      if ((child0 != -1) || (child1 != -1))
+        world.taskq.add(new ChunkedBcastSend<T>(world, key, value, child0,
+                                                child1, chunk_size));
+    } else {
+      TA_ASSERT(!value.probe());
+      world.taskq.add(new ChunkedBcastRecv<T>(world, key, value, parent,
+                                              child0, child1, chunk_size));
+    }
+  } else {
+    const shm_bcast_key tile_key(key, shm_bcast_tile_msg);
+    if (position != 0) {
+      TA_ASSERT(!value.probe());
+      value.set(world.gop.template recv<T>(parent, tile_key));
+    }
+    if (child0 != -1) world.gop.send(child0, tile_key, value);
+    if (child1 != -1) world.gop.send(child1, tile_key, value);
+  }
+
+  // Publish the tile for the other processes of this node
+  std::vector<ProcessID> readers;
+  for (ProcessID g = 0; g < group.size(); ++g) {
+    const ProcessID p = group.world_rank(g);
+    if ((p != rank) && (shm->leader(p) == shm->leader(rank)))
+      readers.push_back(p);
+  }
+  if (!readers.empty())
+    world.taskq.add(
+        new ShmBcastPublish<T>(world, shm, key, value, std::move(readers)));
+}
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_SHM_BCAST_H__INCLUDED
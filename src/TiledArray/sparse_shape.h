@@ -32,9 +32,13 @@
 #include <TiledArray/tiled_range.h>
 #include <TiledArray/val_array.h>
 #include <typeinfo>
+#include <vector>
 
 namespace TiledArray {
 
+template <typename T>
+class CompressedSparseShape;
+
 /// Frobenius-norm-based sparse shape
 
 /// Sparse shape uses a \c Tensor of Frobenius norms to describe the magnitude
@@ -72,6 +76,9 @@ namespace TiledArray {
 ///       SparseShape<T>::to_abs_factor).
 template <typename T>
 class SparseShape {
+  template <typename>
+  friend class CompressedSparseShape;
+
  public:
   typedef SparseShape<T> SparseShape_;  ///< This object type
   typedef T value_type;                 ///< The norm value type
@@ -96,6 +103,7 @@ class SparseShape {
                       ///< reports the size of i-th tile in dimension d
   size_type zero_tile_count_;    ///< Number of zero tiles
   static value_type threshold_;  ///< The zero threshold
+  static float gemm_density_cutoff_;  ///< Maximum density of the screened gemm
 
   template <typename Op>
   static vector_type recursive_outer_product(
@@ -480,6 +488,24 @@ class SparseShape {
   /// \param thresh The new threshold
   static void threshold(const value_type thresh) { threshold_ = thresh; }
 
+  /// Screened gemm density cutoff accessor
+
+  /// \return The current screened gemm density cutoff
+  static float gemm_density_cutoff() { return gemm_density_cutoff_; }
+
+  /// Set the screened gemm density cutoff to \c cutoff
+
+  /// \c gemm() skips the zero norms of its arguments when the fraction of
+  /// the multiply-adds of the dense product that involve only nonzero norms
+  /// is no greater than \c cutoff ; otherwise the dense product is computed
+  /// with BLAS. A cutoff of 0 disables the screened product for all but
+  /// products with no nonzero contributions, a cutoff of 1 always uses it.
+  /// \param cutoff The new cutoff, in the range [0, 1]
+  static void gemm_density_cutoff(const float cutoff) {
+    TA_ASSERT(cutoff >= 0.0f && cutoff <= 1.0f);
+    gemm_density_cutoff_ = cutoff;
+  }
+
   /// Tile norm accessor
 
   /// \tparam Index The index type
@@ -1501,8 +1527,29 @@ class SparseShape {
             return size_vector;
           });
 
-      // TODO: Make this faster. It can be done without using temporaries
-      // for the arguments, but requires a custom matrix multiply.
+      // Estimate the number of multiply-adds that involve only nonzero
+      // norms; if the arguments are sparse enough, skip the zero norms
+      // instead of computing the dense product.
+      std::vector<size_type> left_col_nnz(K, 0ul), right_row_nnz(K, 0ul);
+      const value_type* const left_norms = tile_norms_.data();
+      const value_type* const right_norms = other.tile_norms_.data();
+      for (size_type mk = 0ul, m = 0ul; m < size_type(M); ++m)
+        for (integer k = 0; k < K; ++k, ++mk)
+          if (left_norms[mk] != value_type(0)) ++left_col_nnz[k];
+      for (size_type kn = 0ul, k = 0ul; k < size_type(K); ++k)
+        for (integer n = 0; n < N; ++n, ++kn)
+          if (right_norms[kn] != value_type(0)) ++right_row_nnz[k];
+      double screened_flops = 0.0;
+      for (integer k = 0; k < K; ++k)
+        screened_flops += double(left_col_nnz[k]) * double(right_row_nnz[k]);
+
+      if (screened_flops <=
+          double(gemm_density_cutoff_) * double(M) * double(N) * double(K)) {
+        const size_type zero_count = gemm_screened(
+            M, N, K, left_norms, right_norms, k_sizes, abs_factor,
+            left_col_nnz, right_row_nnz, result_norms.data());
+        return SparseShape_(result_norms, result_size_vectors, zero_count);
+      }
 
       Tensor<value_type> left(tile_norms_.range());
       const size_type mk = M * K;
@@ -1584,6 +1631,81 @@ class SparseShape {
   }
 
  private:
+  /// Screened matrix product of tile norms
+
+  /// Computes <tt>C(m,n) = factor * sum_k A(m,k) s(k) B(k,n) s(k)</tt> ,
+  /// where \c s is the inner size vector, skipping the zero norms of both
+  /// arguments. The nonzero norms of \c B are compressed by rows (CSR), and
+  /// each row of \c C is accumulated from the rows of \c B selected by the
+  /// nonzero norms in the matching row of \c A . The rows of \c C are
+  /// screened with the zero threshold as soon as they are complete, so no
+  /// dense temporaries of the arguments are needed.
+  /// \param M The number of rows of \c A and \c C
+  /// \param N The number of columns of \c B and \c C
+  /// \param K The number of columns of \c A and rows of \c B
+  /// \param A The left-hand norm matrix (row-major)
+  /// \param B The right-hand norm matrix (row-major)
+  /// \param k_sizes The inner size vector
+  /// \param factor The scaling factor
+  /// \param left_col_nnz The number of nonzero norms in each column of \c A
+  /// \param right_row_nnz The number of nonzero norms in each row of \c B
+  /// \param[out] C The result norm matrix (row-major), initialized to zero
+  /// \return The number of zero tiles in \c C
+  template <typename Integer>
+  static size_type gemm_screened(const Integer M, const Integer N,
+                                 const Integer K, const value_type* const A,
+                                 const value_type* const B,
+                                 const vector_type& k_sizes,
+                                 const value_type factor,
+                                 const std::vector<size_type>& left_col_nnz,
+                                 const std::vector<size_type>& right_row_nnz,
+                                 value_type* const C) {
+    const value_type threshold = threshold_;
+
+    // Compress the rows of B that are used by A
+    std::vector<size_type> row_ptr(K + 1, 0ul);
+    for (Integer k = 0; k < K; ++k)
+      row_ptr[k + 1] =
+          row_ptr[k] + (left_col_nnz[k] ? right_row_nnz[k] : 0ul);
+    std::vector<Integer> cols(row_ptr[K]);
+    std::vector<value_type> vals(row_ptr[K]);
+    for (Integer k = 0; k < K; ++k) {
+      if (left_col_nnz[k] == 0ul) continue;
+      const value_type* MADNESS_RESTRICT const B_k = B + k * N;
+      const value_type k_size = k_sizes[k];
+      size_type j = row_ptr[k];
+      for (Integer n = 0; n < N; ++n) {
+        if (B_k[n] != value_type(0)) {
+          cols[j] = n;
+          vals[j] = B_k[n] * k_size;
+          ++j;
+        }
+      }
+    }
+
+    // Accumulate and screen the rows of C
+    size_type zero_count = 0ul;
+    for (Integer m = 0; m < M; ++m) {
+      const value_type* MADNESS_RESTRICT const A_m = A + m * K;
+      value_type* MADNESS_RESTRICT const C_m = C + m * N;
+      for (Integer k = 0; k < K; ++k) {
+        if (A_m[k] == value_type(0)) continue;
+        const value_type a = A_m[k] * k_sizes[k] * factor;
+        const size_type last = row_ptr[k + 1];
+        for (size_type j = row_ptr[k]; j < last; ++j)
+          C_m[cols[j]] += a * vals[j];
+      }
+      for (Integer n = 0; n < N; ++n) {
+        if (C_m[n] < threshold) {
+          C_m[n] = value_type(0);
+          ++zero_count;
+        }
+      }
+    }
+
+    return zero_count;
+  }
+
   template <typename Factor>
   static value_type to_abs_factor(const Factor factor) {
     using std::abs;
@@ -1598,6 +1720,8 @@ class SparseShape {
 template <typename T>
 typename SparseShape<T>::value_type SparseShape<T>::threshold_ =
     std::numeric_limits<T>::epsilon();
+template <typename T>
+float SparseShape<T>::gemm_density_cutoff_ = 0.1f;
 
 /// Add the shape to an output stream
 
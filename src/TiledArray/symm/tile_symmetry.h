@@ -0,0 +1,241 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_symmetry.h
+ *
+ */
+
+#ifndef TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
+#define TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
+
+#include <TiledArray/dense_shape.h>
+#include <TiledArray/permutation.h>
+#include <TiledArray/sparse_shape.h>
+#include <TiledArray/symm/permutation_group.h>
+#include <TiledArray/symm/representation.h>
+#include <TiledArray/tiled_range.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+namespace symmetry {
+
+/**
+ * \addtogroup symmetry
+ * @{
+ */
+
+/// The phase of a tensor under a permutation of its modes
+enum class Phase : int { plus = 1, minus = -1 };
+
+/// Phase product
+
+/// \param p1 A phase
+/// \param p2 A phase
+/// \return The phase of the composition of the permutations of \c p1 and
+/// \c p2
+inline Phase operator*(const Phase p1, const Phase p2) {
+  return static_cast<Phase>(static_cast<int>(p1) * static_cast<int>(p2));
+}
+
+/// The phase of the identity permutation
+template <>
+inline Phase identity<Phase>() {
+  return Phase::plus;
+}
+
+/// Permutational symmetry of the tiles of an array
+
+/// A tensor \f$ T \f$ is symmetric under a permutation group \f$ G \f$ of its
+/// modes if \f$ T_{g x} = \phi(g) T_{x} \f$ for every element \f$ g \f$ of
+/// \f$ G \f$, where \f$ \phi(g) \f$ is the phase of \f$ g \f$; e.g. an
+/// antisymmetric matrix has \f$ G = S_2 \f$ and \f$ \phi((0,1)) = -1 \f$.
+/// When the modes related by \f$ G \f$ have identical tilings, the tiles
+/// obey the same relation: tile \f$ g t \f$ is the permutation of tile
+/// \f$ t \f$ by \f$ g \f$ times \f$ \phi(g) \f$. Only the tiles whose index
+/// is lexicographically smallest in its orbit are unique; an array with
+/// this symmetry stores only these tiles, see \c DistArray::make_symmetric .
+class TileSymmetry {
+ public:
+  typedef symmetry::Permutation Permutation;  ///< Group element type
+
+ private:
+  PermutationGroup group_;  ///< The group of mode permutations
+  std::map<Permutation, Phase> phases_;  ///< The phase of each element
+
+  /// \param generators The phase of each generator
+  /// \return The generators
+  static std::vector<Permutation> keys(
+      const std::map<Permutation, Phase>& generators) {
+    std::vector<Permutation> result;
+    result.reserve(generators.size());
+    for (const auto& generator : generators) result.push_back(generator.first);
+    return result;
+  }
+
+ public:
+  TileSymmetry() = delete;
+  TileSymmetry(const TileSymmetry&) = default;
+  TileSymmetry(TileSymmetry&&) = default;
+  TileSymmetry& operator=(const TileSymmetry&) = default;
+  TileSymmetry& operator=(TileSymmetry&&) = default;
+
+  /// Constructor
+
+  /// \param generators The phase of each generator of the group, e.g.
+  ///        <tt>{{Permutation{1,0}, Phase::minus}}</tt> for an
+  ///        antisymmetric matrix
+  explicit TileSymmetry(const std::map<Permutation, Phase>& generators)
+      : group_(keys(generators)),
+        phases_(Representation<PermutationGroup, Phase>(generators)
+                    .representatives()) {}
+
+  /// \return The group of mode permutations
+  const PermutationGroup& group() const { return group_; }
+
+  /// Phase accessor
+
+  /// \param g An element of the group
+  /// \return The phase of \c g
+  Phase phase(const Permutation& g) const {
+    const auto it = phases_.find(g);
+    TA_ASSERT(it != phases_.end());
+    return it->second;
+  }
+
+  /// Check that a tiled range is compatible with this symmetry
+
+  /// \param trange A tiled range
+  /// \return \c true if every mode permuted by the group is a mode of
+  /// \c trange and the modes related by the group have identical tilings
+  bool is_compatible(const TiledRange& trange) const {
+    for (const auto& g : group_) {
+      for (const auto& e : g) {
+        if ((e.first >= trange.rank()) || (e.second >= trange.rank()))
+          return false;
+        if (trange.data()[e.first] != trange.data()[e.second]) return false;
+      }
+    }
+    return true;
+  }
+
+  /// Check that a tile is unique
+
+  /// \tparam Index A coordinate index type
+  /// \param index The index of a tile
+  /// \return \c true if \c index is lexicographically smallest in its orbit
+  template <typename Index>
+  bool is_unique(const Index& index) const {
+    return is_lexicographically_smallest(index, group_);
+  }
+
+  /// The unique tile of the orbit of a tile
+
+  /// \tparam Index A coordinate index type
+  /// \param index The index of a tile
+  /// \return The index \c c of the unique tile and the element \c g of the
+  /// group such that <tt>index == g * c</tt>, i.e. tile \c index is the
+  /// permutation of tile \c c by \c g times <tt>phase(g)</tt>
+  template <typename Index>
+  std::pair<Index, Permutation> canonical(const Index& index) const {
+    std::pair<Index, Permutation> result(index, Permutation());
+    Index candidate = index;
+    for (const auto& g : group_) {
+      for (std::size_t i = 0ul; i < index.size(); ++i)
+        candidate[i] = index[g[i]];
+      if (std::lexicographical_compare(candidate.begin(), candidate.end(),
+                                       result.first.begin(),
+                                       result.first.end())) {
+        result.first = candidate;
+        result.second = g;
+      }
+    }
+    return result;
+  }
+
+  /// Tile permutation
+
+  /// \param g An element of the group
+  /// \param rank The rank of the tiles
+  /// \return \c g as a permutation of the modes of a tile
+  static TiledArray::Permutation tile_permutation(const Permutation& g,
+                                                  const unsigned int rank) {
+    std::vector<TiledArray::Permutation::index_type> p(rank);
+    for (unsigned int i = 0u; i < rank; ++i) p[i] = g[i];
+    return TiledArray::Permutation(p.begin(), p.end());
+  }
+
+  /// Zero the shape of the tiles that are not unique
+
+  /// \tparam T The shape value type
+  /// \param shape The shape of a symmetric array
+  /// \param trange The tiled range of the array
+  /// \return A copy of \c shape where only the unique tiles are nonzero
+  template <typename T>
+  SparseShape<T> mask(const SparseShape<T>& shape,
+                      const TiledRange& trange) const {
+    Tensor<T> norms = shape.data().clone();
+    const auto& tiles_range = trange.tiles_range();
+    for (std::size_t ord = 0ul; ord < norms.size(); ++ord)
+      if (!is_unique(tiles_range.idx(ord))) norms[ord] = T(0);
+    return SparseShape<T>(norms, trange, true);
+  }
+
+  /// Dense shapes have no zero tiles
+
+  /// \param shape The shape of a symmetric array
+  /// \return \c shape
+  DenseShape mask(const DenseShape& shape, const TiledRange&) const {
+    return shape;
+  }
+
+  /// Copy the shape of the unique tiles to the other tiles of their orbits
+
+  /// \tparam T The shape value type
+  /// \param shape The shape of the unique tiles of a symmetric array
+  /// \param trange The tiled range of the array
+  /// \return The shape of all tiles of the array
+  template <typename T>
+  SparseShape<T> symmetrize(const SparseShape<T>& shape,
+                            const TiledRange& trange) const {
+    Tensor<T> norms = shape.data().clone();
+    const auto& tiles_range = trange.tiles_range();
+    for (std::size_t ord = 0ul; ord < norms.size(); ++ord) {
+      const auto index = tiles_range.idx(ord);
+      if (!is_unique(index))
+        norms[ord] = norms[tiles_range.ordinal(canonical(index).first)];
+    }
+    return SparseShape<T>(norms, trange, true);
+  }
+
+  /// Dense shapes have no zero tiles
+
+  /// \param shape The shape of the unique tiles of a symmetric array
+  /// \return \c shape
+  DenseShape symmetrize(const DenseShape& shape, const TiledRange&) const {
+    return shape;
+  }
+};  // class TileSymmetry
+
+/** @}*/
+
+}  // namespace symmetry
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
@@ -492,12 +492,7 @@ inline void tensor_init(Op&& op, const Permutation& perm, TR& result,
   TA_ASSERT(perm);
   TA_ASSERT(perm.size() == result.range().rank());
 
-  auto output_op = [](typename TR::pointer MADNESS_RESTRICT result,
-                      typename TR::const_reference MADNESS_RESTRICT temp) {
-    new (result) typename TR::value_type(temp);
-  };
-
-  permute(std::forward<Op>(op), std::move(output_op), result, perm, tensor1,
+  permute(std::forward<Op>(op), PermuteInit{}, result, perm, tensor1,
           tensors...);
 }
 
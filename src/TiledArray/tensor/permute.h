@@ -30,9 +30,35 @@
 #include <TiledArray/perm_index.h>
 #include <TiledArray/tensor/type_traits.h>
 
+#include <algorithm>
+#include <type_traits>
+
 namespace TiledArray {
 namespace detail {
 
+/// Input operation of a plain permuted copy
+
+/// \c permute() recognizes this operation, together with \c PermuteInit , and
+/// copies trivially copyable elements with \c math::transpose_copy() .
+struct PermuteIdentity {
+  /// \param value An argument element
+  /// \return \c value
+  template <typename T>
+  const T& operator()(const T& value) const {
+    return value;
+  }
+};  // struct PermuteIdentity
+
+/// Output operation of a permuted copy into uninitialized memory
+struct PermuteInit {
+  /// \param result A pointer to an uninitialized result element
+  /// \param value The value that is used to initialize \c result
+  template <typename T, typename U>
+  void operator()(T* MADNESS_RESTRICT const result, const U& value) const {
+    new (result) T(value);
+  }
+};  // struct PermuteInit
+
 /// Compute the fused dimensions for permutation
 
 /// This function will compute the fused dimensions of a tensor for use in
@@ -111,6 +137,9 @@ inline void fuse_dimensions(SizeType* MADNESS_RESTRICT const fused_size,
 /// result tensor given the element pointer and the result value
 /// \param args The data pointers of the tensors to be permuted
 /// \param perm The permutation that will be applied to the copy
+/// \note A copy of a single tensor of trivially copyable elements with
+/// \c PermuteIdentity and \c PermuteInit bypasses the element-wise
+/// operations and uses the SIMD transpose kernels.
 template <typename InputOp, typename OutputOp, typename Result, typename Perm,
           typename Arg0, typename... Args,
           typename = std::enable_if_t<detail::is_permutation_v<Perm>>>
@@ -126,6 +155,15 @@ inline void permute(InputOp&& input_op, OutputOp&& output_op, Result& result,
   // Get pointer to arg extent
   const auto* MADNESS_RESTRICT const arg0_extent = arg0.range().extent_data();
 
+  // Plain copies of trivially copyable data skip the element-wise operations
+  constexpr bool plain_copy =
+      (sizeof...(Args) == 0ul) &&
+      std::is_same_v<std::decay_t<InputOp>, PermuteIdentity> &&
+      std::is_same_v<std::decay_t<OutputOp>, PermuteInit> &&
+      std::is_same_v<typename Result::value_type,
+                     typename Arg0::value_type> &&
+      std::is_trivially_copyable_v<typename Result::value_type>;
+
   if (perm[ndim1] == ndim1) {
     // This is the simple case where the last dimension is not permuted.
     // Therefore, it can be shuffled in chunks.
@@ -151,8 +189,12 @@ inline void permute(InputOp&& input_op, OutputOp&& output_op, Result& result,
       const typename Result::ordinal_type perm_index = perm_index_op(index);
 
       // Copy the block
-      math::vector_ptr_op(op, block_size, result.data() + perm_index,
-                          arg0.data() + index, (args.data() + index)...);
+      if constexpr (plain_copy)
+        std::copy_n(arg0.data() + index, block_size,
+                    result.data() + perm_index);
+      else
+        math::vector_ptr_op(op, block_size, result.data() + perm_index,
+                            arg0.data() + index, (args.data() + index)...);
     }
 
   } else {
@@ -192,10 +234,15 @@ inline void permute(InputOp&& input_op, OutputOp&& output_op, Result& result,
         // Compute the ordinal index of the input and output matrices.
         typename Result::ordinal_type perm_index = perm_index_op(index);
 
-        math::transpose(input_op, output_op, other_fused_size[1],
-                        other_fused_size[3], result_outer_stride,
-                        result.data() + perm_index, other_fused_weight[1],
-                        arg0.data() + index, (args.data() + index)...);
+        if constexpr (plain_copy)
+          math::transpose_copy(other_fused_size[1], other_fused_size[3],
+                               result_outer_stride, result.data() + perm_index,
+                               other_fused_weight[1], arg0.data() + index);
+        else
+          math::transpose(input_op, output_op, other_fused_size[1],
+                          other_fused_size[3], result_outer_stride,
+                          result.data() + perm_index, other_fused_weight[1],
+                          arg0.data() + index, (args.data() + index)...);
       }
     }
   }
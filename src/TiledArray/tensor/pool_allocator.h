@@ -0,0 +1,473 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  pool_allocator.h
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
+
+#include <TiledArray/config.h>
+#include <TiledArray/error.h>
+#include <TiledArray/util/memory_size.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace TiledArray {
+
+/// Tile pool parameters
+
+/// The default values are read from the environment:
+/// \c TA_TILE_POOL_THREAD_CACHE and \c TA_TILE_POOL_MAX_CACHED (memory sizes,
+/// e.g. "64 MiB").
+struct TilePoolConfig {
+  std::size_t thread_cache = 33554432ul;  ///< Maximum number of bytes cached
+                                          ///< by each thread
+  std::size_t max_cached = 0ul;  ///< Maximum number of bytes cached by the
+                                 ///< shared pool (0 = unbounded)
+
+  /// Construct a configuration from the environment
+
+  /// \return The configuration defined by the \c TA_TILE_POOL_* environment
+  /// variables, with defaults for unset variables
+  static TilePoolConfig from_env() {
+    TilePoolConfig config;
+    if (const char* str = std::getenv("TA_TILE_POOL_THREAD_CACHE"))
+      config.thread_cache = detail::memory_size_to_bytes(str);
+    if (const char* str = std::getenv("TA_TILE_POOL_MAX_CACHED"))
+      config.max_cached = detail::memory_size_to_bytes(str);
+    return config;
+  }
+};  // struct TilePoolConfig
+
+/// Tile pool statistics
+struct TilePoolStats {
+  std::size_t hits = 0ul;    ///< Allocations served from cached blocks
+  std::size_t misses = 0ul;  ///< Allocations served by the system allocator
+  std::size_t bytes = 0ul;   ///< Bytes currently obtained from the system,
+                             ///< including cached blocks
+  std::size_t peak_bytes = 0ul;  ///< High-water mark of \c bytes
+};  // struct TilePoolStats
+
+namespace detail {
+
+class TilePool;
+
+/// Per-thread cache of free tile pool blocks
+class TilePoolThreadCache {
+ public:
+  /// Number of size classes
+  static constexpr std::size_t nclasses = 81ul;
+
+ private:
+  friend class TilePool;
+
+  TilePool& pool_;                              ///< The shared pool
+  std::vector<void*> blocks_[nclasses];         ///< Free blocks per class
+  std::size_t bytes_ = 0ul;                     ///< Bytes held by blocks_
+  std::atomic<std::size_t> hits_{0ul};          ///< Cache hit counter
+  std::atomic<std::size_t> misses_{0ul};        ///< Cache miss counter
+
+  /// Increment a counter that is only modified by the owning thread
+  static void increment(std::atomic<std::size_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1ul,
+                  std::memory_order_relaxed);
+  }
+
+ public:
+  explicit TilePoolThreadCache(TilePool& pool);
+  ~TilePoolThreadCache();
+
+  TilePoolThreadCache(const TilePoolThreadCache&) = delete;
+  TilePoolThreadCache& operator=(const TilePoolThreadCache&) = delete;
+};  // class TilePoolThreadCache
+
+/// Thread-caching, size-class memory pool for tile data
+
+/// Requests are rounded up to one of \c TilePoolThreadCache::nclasses size
+/// classes: 256 bytes, and four classes per power of two above that, up to
+/// 256 MiB. Larger requests are passed to the system allocator. Freed blocks
+/// are kept in the cache of the freeing thread, which serves subsequent
+/// allocations of the same class without synchronization. When a thread
+/// cache holds more than \c TilePoolConfig::thread_cache bytes, blocks are
+/// moved to the shared pool, from which thread caches are refilled in
+/// batches. All blocks are aligned to \c TILEDARRAY_CACHELINE_SIZE bytes.
+class TilePool {
+ public:
+  static constexpr std::size_t nclasses = TilePoolThreadCache::nclasses;
+  static constexpr std::size_t alignment =
+      (TILEDARRAY_CACHELINE_SIZE > TILEDARRAY_ALIGNMENT
+           ? TILEDARRAY_CACHELINE_SIZE
+           : TILEDARRAY_ALIGNMENT);
+  static constexpr std::size_t min_block = 256ul;  ///< Smallest class size
+  static constexpr std::size_t max_block = 268435456ul;  ///< Largest class
+                                                         ///< size
+
+ private:
+  friend class TilePoolThreadCache;
+
+  /// Free blocks of one size class in the shared pool
+  struct SizeClass {
+    std::mutex mutex;           ///< Protects blocks
+    std::vector<void*> blocks;  ///< Free blocks
+  };
+
+  const TilePoolConfig config_;         ///< Pool parameters
+  SizeClass classes_[nclasses];         ///< Shared free blocks
+  std::atomic<std::size_t> cached_{0ul};  ///< Bytes held by classes_
+  std::atomic<std::size_t> bytes_{0ul};   ///< Bytes obtained from the system
+  std::atomic<std::size_t> peak_bytes_{0ul};  ///< High-water mark of bytes_
+  std::atomic<std::size_t> misses_{0ul};      ///< Pool bypass counter
+
+  mutable std::mutex caches_mutex_;           ///< Protects caches_, retired_
+  std::vector<TilePoolThreadCache*> caches_;  ///< Live thread caches
+  TilePoolStats retired_;  ///< Counters of destroyed thread caches
+
+  explicit TilePool(const TilePoolConfig& config) : config_(config) {}
+
+  /// Round a block size up to a multiple of \c alignment
+  static constexpr std::size_t align(const std::size_t size) {
+    return (size + alignment - 1ul) & ~(alignment - 1ul);
+  }
+
+  /// Allocate memory from the system
+
+  /// \param bytes The number of bytes
+  /// \return A pointer to the new block
+  /// \throw std::bad_alloc When the allocation fails
+  void* system_allocate(const std::size_t bytes) {
+    const std::size_t size = align(bytes);
+    void* ptr = std::aligned_alloc(alignment, size);
+    if (!ptr) throw std::bad_alloc();
+    const std::size_t total =
+        bytes_.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = peak_bytes_.load(std::memory_order_relaxed);
+    while ((total > peak) && !peak_bytes_.compare_exchange_weak(
+                                 peak, total, std::memory_order_relaxed))
+      ;
+    return ptr;
+  }
+
+  /// Return memory to the system
+
+  /// \param ptr A pointer to a block obtained from \c system_allocate()
+  /// \param bytes The number of bytes passed to \c system_allocate()
+  void system_deallocate(void* const ptr, const std::size_t bytes) {
+    std::free(ptr);
+    bytes_.fetch_sub(align(bytes), std::memory_order_relaxed);
+  }
+
+  /// Move free blocks of a thread cache class to the shared pool
+
+  /// \param cache The thread cache
+  /// \param c The size class
+  void flush(TilePoolThreadCache& cache, const std::size_t c) {
+    std::vector<void*>& blocks = cache.blocks_[c];
+    if (blocks.empty()) return;
+    const std::size_t size = class_size(c);
+    const std::size_t bytes = blocks.size() * size;
+    cache.bytes_ -= bytes;
+
+    std::size_t keep = blocks.size();
+    if (config_.max_cached) {
+      const std::size_t cached = cached_.load(std::memory_order_relaxed);
+      keep = (cached < config_.max_cached
+                  ? std::min(keep, (config_.max_cached - cached) / size)
+                  : 0ul);
+    }
+    for (std::size_t i = keep; i < blocks.size(); ++i)
+      system_deallocate(blocks[i], size);
+    blocks.resize(keep);
+
+    if (keep) {
+      cached_.fetch_add(keep * size, std::memory_order_relaxed);
+      std::lock_guard<std::mutex> lock(classes_[c].mutex);
+      classes_[c].blocks.insert(classes_[c].blocks.end(), blocks.begin(),
+                                blocks.end());
+    }
+    blocks.clear();
+  }
+
+  /// Move all free blocks of a thread cache to the shared pool
+  void flush(TilePoolThreadCache& cache) {
+    for (std::size_t c = 0ul; c < nclasses; ++c) flush(cache, c);
+  }
+
+  /// Refill a thread cache class from the shared pool
+
+  /// \param cache The thread cache
+  /// \param c The size class
+  /// \return \c true if at least one block was moved to \c cache
+  bool refill(TilePoolThreadCache& cache, const std::size_t c) {
+    const std::size_t size = class_size(c);
+    const std::size_t batch = std::max<std::size_t>(
+        std::min<std::size_t>(config_.thread_cache / (4ul * size), 16ul), 1ul);
+
+    std::vector<void*>& blocks = cache.blocks_[c];
+    {
+      std::lock_guard<std::mutex> lock(classes_[c].mutex);
+      std::vector<void*>& shared = classes_[c].blocks;
+      const std::size_t n = std::min(batch, shared.size());
+      blocks.insert(blocks.end(), shared.end() - n, shared.end());
+      shared.resize(shared.size() - n);
+    }
+    const std::size_t bytes = blocks.size() * size;
+    cached_.fetch_sub(bytes, std::memory_order_relaxed);
+    cache.bytes_ += bytes;
+    return !blocks.empty();
+  }
+
+  /// The cache of the calling thread
+  TilePoolThreadCache& thread_cache() {
+    static thread_local TilePoolThreadCache cache(*this);
+    return cache;
+  }
+
+ public:
+  TilePool(const TilePool&) = delete;
+  TilePool& operator=(const TilePool&) = delete;
+
+  /// The global tile pool
+
+  /// The pool is never destroyed, so that thread caches that are destroyed
+  /// during program termination can return their blocks.
+  static TilePool& instance() {
+    static TilePool* pool = new TilePool(TilePoolConfig::from_env());
+    return *pool;
+  }
+
+  /// Size class of an allocation
+
+  /// \param size The allocation size in bytes, <tt>0 < size <= max_block</tt>
+  /// \return The index of the smallest class that holds \c size bytes
+  static constexpr std::size_t size_class(const std::size_t size) {
+    if (size <= min_block) return 0ul;
+    const std::size_t x = size - 1ul;
+    std::size_t g = 0ul;  // floor(log2(x))
+    while ((x >> (g + 1ul)) != 0ul) ++g;
+    return 1ul + (g - 8ul) * 4ul + ((x >> (g - 2ul)) & 3ul);
+  }
+
+  /// Block size of a size class
+
+  /// \param c The size class
+  /// \return The number of bytes in each block of class \c c
+  static constexpr std::size_t class_size(const std::size_t c) {
+    if (c == 0ul) return min_block;
+    const std::size_t g = 8ul + (c - 1ul) / 4ul;
+    return (5ul + (c - 1ul) % 4ul) << (g - 2ul);
+  }
+
+  /// Allocate memory
+
+  /// \param size The number of bytes
+  /// \return A pointer to at least \c size bytes aligned to \c alignment , or
+  /// \c nullptr if \c size is 0
+  /// \throw std::bad_alloc When the allocation fails
+  void* allocate(const std::size_t size) {
+    if (size == 0ul) return nullptr;
+    if (size > max_block) {
+      misses_.fetch_add(1ul, std::memory_order_relaxed);
+      return system_allocate(size);
+    }
+
+    const std::size_t c = size_class(size);
+    TilePoolThreadCache& cache = thread_cache();
+    std::vector<void*>& blocks = cache.blocks_[c];
+    if (blocks.empty() && !refill(cache, c)) {
+      TilePoolThreadCache::increment(cache.misses_);
+      return system_allocate(class_size(c));
+    }
+
+    TilePoolThreadCache::increment(cache.hits_);
+    void* ptr = blocks.back();
+    blocks.pop_back();
+    cache.bytes_ -= class_size(c);
+    return ptr;
+  }
+
+  /// Deallocate memory
+
+  /// \param ptr A pointer obtained from \c allocate(size)
+  /// \param size The number of bytes passed to \c allocate()
+  void deallocate(void* const ptr, const std::size_t size) {
+    if (ptr == nullptr) return;
+    if (size > max_block) {
+      system_deallocate(ptr, size);
+      return;
+    }
+
+    const std::size_t c = size_class(size);
+    TilePoolThreadCache& cache = thread_cache();
+    cache.blocks_[c].push_back(ptr);
+    cache.bytes_ += class_size(c);
+    if (cache.bytes_ > config_.thread_cache) {
+      flush(cache, c);
+      if (cache.bytes_ > config_.thread_cache) flush(cache);
+    }
+  }
+
+  /// Pool statistics
+
+  /// \return The statistics accumulated since the pool was created
+  TilePoolStats stats() const {
+    std::lock_guard<std::mutex> lock(caches_mutex_);
+    TilePoolStats result = retired_;
+    for (const TilePoolThreadCache* cache : caches_) {
+      result.hits += cache->hits_.load(std::memory_order_relaxed);
+      result.misses += cache->misses_.load(std::memory_order_relaxed);
+    }
+    result.misses += misses_.load(std::memory_order_relaxed);
+    result.bytes = bytes_.load(std::memory_order_relaxed);
+    result.peak_bytes = peak_bytes_.load(std::memory_order_relaxed);
+    return result;
+  }
+
+  /// Return cached memory to the system
+
+  /// The free blocks of the calling thread and of the shared pool are
+  /// released; blocks cached by other threads are not affected.
+  void release() {
+    flush(thread_cache());
+    for (std::size_t c = 0ul; c < nclasses; ++c) {
+      std::vector<void*> blocks;
+      {
+        std::lock_guard<std::mutex> lock(classes_[c].mutex);
+        blocks.swap(classes_[c].blocks);
+      }
+      const std::size_t size = class_size(c);
+      cached_.fetch_sub(blocks.size() * size, std::memory_order_relaxed);
+      for (void* ptr : blocks) system_deallocate(ptr, size);
+    }
+  }
+
+};  // class TilePool
+
+static_assert(TilePool::class_size(TilePool::nclasses - 1ul) ==
+                  TilePool::max_block,
+              "inconsistent tile pool size classes");
+
+inline TilePoolThreadCache::TilePoolThreadCache(TilePool& pool) : pool_(pool) {
+  std::lock_guard<std::mutex> lock(pool_.caches_mutex_);
+  pool_.caches_.push_back(this);
+}
+
+inline TilePoolThreadCache::~TilePoolThreadCache() {
+  pool_.flush(*this);
+  std::lock_guard<std::mutex> lock(pool_.caches_mutex_);
+  pool_.retired_.hits += hits_.load(std::memory_order_relaxed);
+  pool_.retired_.misses += misses_.load(std::memory_order_relaxed);
+  pool_.caches_.erase(
+      std::find(pool_.caches_.begin(), pool_.caches_.end(), this));
+}
+
+}  // namespace detail
+
+/// Tile pool statistics
+
+/// \return The statistics of the pool used by \c tile_pool_allocator
+inline TilePoolStats tile_pool_stats() {
+  return detail::TilePool::instance().stats();
+}
+
+/// Return memory cached by the tile pool to the system
+
+/// Releases the free blocks held by the shared pool and by the calling
+/// thread, e.g. after a large computation has finished.
+inline void tile_pool_release() { detail::TilePool::instance().release(); }
+
+/// Thread-caching pool allocator for tile data
+
+/// This allocator can be used as the allocator of \c Tensor , in place of the
+/// default \c Eigen::aligned_allocator , to reduce the cost of allocating the
+/// many intermediate tiles of an expression and the contention on the system
+/// allocator when many threads allocate tiles concurrently. All instances
+/// share the global \c detail::TilePool . The \c TA_TENSOR_POOL_ALLOCATOR
+/// build option makes this the allocator of \c TArray and \c TSpArray tiles.
+/// \tparam T The element type
+template <typename T>
+class tile_pool_allocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef tile_pool_allocator<U> other;
+  };
+
+  static_assert(alignof(T) <= detail::TilePool::alignment,
+                "tile_pool_allocator does not support over-aligned types");
+
+  tile_pool_allocator() noexcept = default;
+  tile_pool_allocator(const tile_pool_allocator&) noexcept = default;
+  template <typename U>
+  tile_pool_allocator(const tile_pool_allocator<U>&) noexcept {}
+
+  /// Allocate memory for \c n objects
+
+  /// \param n The number of objects
+  /// \return A pointer to uninitialized memory for \c n objects
+  /// \throw std::bad_alloc When the allocation fails
+  pointer allocate(const size_type n) {
+    if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+      throw std::bad_alloc();
+    return static_cast<pointer>(
+        detail::TilePool::instance().allocate(n * sizeof(T)));
+  }
+
+  /// Deallocate memory
+
+  /// \param p A pointer obtained from \c allocate(n)
+  /// \param n The number of objects passed to \c allocate()
+  void deallocate(pointer p, const size_type n) noexcept {
+    detail::TilePool::instance().deallocate(p, n * sizeof(T));
+  }
+
+  size_type max_size() const noexcept {
+    return std::numeric_limits<size_type>::max() / sizeof(T);
+  }
+};  // class tile_pool_allocator
+
+template <typename T, typename U>
+inline bool operator==(const tile_pool_allocator<T>&,
+                       const tile_pool_allocator<U>&) noexcept {
+  return true;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const tile_pool_allocator<T>&,
+                       const tile_pool_allocator<U>&) noexcept {
+  return false;
+}
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
@@ -28,13 +28,13 @@
 
 namespace TiledArray {
 
-template class Tensor<double, Eigen::aligned_allocator<double> >;
-template class Tensor<float, Eigen::aligned_allocator<float> >;
-template class Tensor<int, Eigen::aligned_allocator<int> >;
-template class Tensor<long, Eigen::aligned_allocator<long> >;
+template class Tensor<double, tensor_allocator<double> >;
+template class Tensor<float, tensor_allocator<float> >;
+template class Tensor<int, tensor_allocator<int> >;
+template class Tensor<long, tensor_allocator<long> >;
 //  template class Tensor<std::complex<double>,
-//  Eigen::aligned_allocator<std::complex<double> > >; template class
-//  Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> >
+//  tensor_allocator<std::complex<double> > >; template class
+//  Tensor<std::complex<float>, tensor_allocator<std::complex<float> >
 //  >;
 
 }  // namespace TiledArray
@@ -24,10 +24,12 @@
 #include "TiledArray/math/gemm_helper.h"
 #include "TiledArray/tensor/complex.h"
 #include "TiledArray/tensor/kernels.h"
+#include "TiledArray/tensor/pool_allocator.h"
 #include "TiledArray/tile_interface/clone.h"
 #include "TiledArray/tile_interface/permute.h"
 #include "TiledArray/tile_interface/trace.h"
 #include "TiledArray/util/logger.h"
+#include "TiledArray/util/tracing.h"
 namespace TiledArray {
 
 // Forward declare Tensor for type traits
@@ -243,13 +245,20 @@ class Tensor {
                               detail::is_permutation_v<Perm>>::type* = nullptr>
   Tensor(const T1& other, const Perm& perm)
       : pimpl_(std::make_shared<Impl>(outer(perm) * other.range())) {
-    auto op = [](const numeric_t<T1> arg) -> numeric_t<T1> { return arg; };
-
-    detail::tensor_init(op, outer(perm), *this, other);
+    tracing::Scope scope(tracing::Event::permute,
+                         2ul * other.range().volume() * sizeof(value_type), 0);
+    constexpr bool is_tot = detail::is_tensor_of_tensor_v<Tensor_>;
+    if constexpr (is_tot) {
+      // Deep copy the inner tensors element by element
+      auto op = [](const numeric_t<T1> arg) -> numeric_t<T1> { return arg; };
+      detail::tensor_init(op, outer(perm), *this, other);
+    } else {
+      detail::tensor_init(detail::PermuteIdentity{}, outer(perm), *this,
+                          other);
+    }
 
     // If we actually have a ToT the inner permutation was not applied above so
     // we do that now
-    constexpr bool is_tot = detail::is_tensor_of_tensor_v<Tensor_>;
     constexpr bool is_bperm = detail::is_bipartite_permutation_v<Perm>;
     // tile ops pass bipartite permutations here even if this is a plain tensor
     // static_assert(is_tot || (!is_tot && !is_bperm), "Permutation type does
@@ -1644,9 +1653,14 @@ class Tensor {
     const integer ldb =
         (gemm_helper.right_op() == TiledArray::math::blas::NoTranspose ? n : k);
 
-    math::blas::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k,
-                     factor, pimpl_->data_, lda, other.data(), ldb,
-                     numeric_type(0), result.data(), n);
+    {
+      tracing::Scope scope(tracing::Event::gemm,
+                           (m * k + k * n + m * n) * sizeof(numeric_type),
+                           2ul * m * n * k);
+      math::blas::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k,
+                       factor, pimpl_->data_, lda, other.data(), ldb,
+                       numeric_type(0), result.data(), n);
+    }
 
 #ifdef TA_ENABLE_TILE_OPS_LOGGING
     if (TiledArray::TileOpsLogger<T>::get_instance_ptr() != nullptr &&
@@ -1802,6 +1816,10 @@ class Tensor {
           (gemm_helper.right_op() == TiledArray::math::blas::NoTranspose ? n
                                                                          : k);
 
+      tracing::Scope scope(tracing::Event::gemm,
+                           (m * k + k * n + 2 * m * n) * sizeof(numeric_type),
+                           2ul * m * n * k);
+
       // may need to split gemm into multiply + accumulate for tracing purposes
 #ifdef TA_ENABLE_TILE_OPS_LOGGING
       {
@@ -2247,14 +2265,14 @@ struct transform<Tensor<T, A>> {
 
 #ifndef TILEDARRAY_HEADER_ONLY
 
-extern template class Tensor<double, Eigen::aligned_allocator<double>>;
-extern template class Tensor<float, Eigen::aligned_allocator<float>>;
-extern template class Tensor<int, Eigen::aligned_allocator<int>>;
-extern template class Tensor<long, Eigen::aligned_allocator<long>>;
+extern template class Tensor<double, tensor_allocator<double>>;
+extern template class Tensor<float, tensor_allocator<float>>;
+extern template class Tensor<int, tensor_allocator<int>>;
+extern template class Tensor<long, tensor_allocator<long>>;
 //  extern template
 //  class Tensor<std::complex<double>,
-//  Eigen::aligned_allocator<std::complex<double> > >; extern template class
-//  Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> >
+//  tensor_allocator<std::complex<double> > >; extern template class
+//  Tensor<std::complex<float>, tensor_allocator<std::complex<float> >
 //  >;
 
 #endif  // TILEDARRAY_HEADER_ONLY
@@ -27,6 +27,7 @@
 #define TILEDARRAY_TENSOR_TYPE_TRAITS_H__INCLUDED
 
 #include <TiledArray/config.h>
+#include <tiledarray_fwd.h>
 
 #include <TiledArray/type_traits.h>
 #include <type_traits>
@@ -44,7 +45,7 @@ namespace TiledArray {
 // Forward declarations
 class Range;
 class BlockRange;
-template <typename T, typename A = Eigen::aligned_allocator<T>>
+template <typename T, typename A = tensor_allocator<T>>
 class Tensor;
 template <typename>
 class Tile;
@@ -29,14 +29,56 @@
 #include <TiledArray/math/gemm_helper.h>
 #include <TiledArray/permutation.h>
 #include <TiledArray/tensor/complex.h>
+#include <TiledArray/tensor/type_traits.h>
 #include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/util/env.h>
 #include <TiledArray/util/function.h>
+#include <TiledArray/util/tracing.h>
 #include "../tile_interface/add.h"
 #include "../tile_interface/permute.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace TiledArray {
 namespace detail {
 
+/// Global contraction batch size accessor
+inline std::size_t& contract_batch_size_accessor() {
+  static std::size_t batch_size = std::max<std::size_t>(
+      getenv_number<std::size_t>("TA_CONTRACT_BATCH_SIZE", 1ul), 1ul);
+  return batch_size;
+}
+
+}  // namespace detail
+
+/// Contraction batch size accessor
+
+/// \return The maximum number of tile pairs whose contributions to a result
+/// tile are contracted together; 1 (the default) disables batching. The
+/// default value is read from the \c TA_CONTRACT_BATCH_SIZE environment
+/// variable.
+inline std::size_t contract_batch_size() {
+  return detail::contract_batch_size_accessor();
+}
+
+/// Set the contraction batch size
+
+/// Contractions of small tiles are dominated by the overhead of the
+/// individual GEMM calls and of the reduction tasks. When the batch size is
+/// greater than 1, the reduction of a result tile collects up to
+/// \c batch_size tile pairs that are ready and contracts them with a single
+/// GEMM over packed panels. The new value is used by contractions that are
+/// constructed after this call.
+/// \param batch_size The maximum number of tile pairs per batch
+/// \throw TiledArray::Exception When \c batch_size is 0
+inline void set_contract_batch_size(const std::size_t batch_size) {
+  TA_ASSERT(batch_size > 0ul);
+  detail::contract_batch_size_accessor() = batch_size;
+}
+
+namespace detail {
+
 /// Contract and (sum) reduce base
 
 /// This implementation class is used to provide shallow copy semantics for
@@ -93,7 +135,8 @@ class ContractReduceBase {
         : gemm_helper_(left_op, right_op, result_rank, left_rank, right_rank),
           alpha_(alpha),
           perm_(perm),
-          elem_muladd_op_(std::forward<ElemMultAddOp>(elem_muladd_op)) {
+          elem_muladd_op_(std::forward<ElemMultAddOp>(elem_muladd_op)),
+          batch_size_(contract_batch_size()) {
       // non-unit alpha must be absorbed into elem_muladd_op
       if (elem_muladd_op_) TA_ASSERT(alpha == scalar_type(1));
     }
@@ -107,6 +150,9 @@ class ContractReduceBase {
     /// type-erased reference to custom element multiply-add op
     /// \note the lifetime is managed by the callee!
     TiledArray::function_ref<elem_muladd_op_type> elem_muladd_op_;
+
+    std::size_t batch_size_;  ///< The maximum number of tile pairs that are
+                              ///< contracted together
   };
 
   std::shared_ptr<Impl> pimpl_;
@@ -184,6 +230,14 @@ class ContractReduceBase {
     return pimpl_->elem_muladd_op_;
   }
 
+  /// Batch size accessor
+
+  /// \return The maximum number of tile pairs that are contracted together
+  std::size_t batch_size() const {
+    TA_ASSERT(pimpl_);
+    return pimpl_->batch_size_;
+  }
+
   //-------------- these are only used for unit tests -----------------
 
   /// Compute the number of contracted ranks
@@ -341,6 +395,120 @@ class ContractReduce : public ContractReduceBase<Result, Left, Right, Scalar> {
     }
   }
 
+  /// Contract several pairs of tiles and add them to a target tile
+
+  /// Contract \c left[i] and \c right[i] , for \c i in <tt>[0, n)</tt>, and
+  /// add the results to \c result. The pairs of \c TiledArray::Tensor tiles
+  /// are packed into a pair of panels, which are contracted with a single
+  /// GEMM whose inner dimension is the sum of the inner dimensions of the
+  /// pairs; other tile types are contracted one pair at a time.
+  /// \param[in,out] result The result object that will be the reduction
+  /// target
+  /// \param[in] left The left-hand tiles to be contracted
+  /// \param[in] right The right-hand tiles to be contracted
+  /// \param[in] n The number of tile pairs
+  void operator()(result_type& result, const Left* const* left,
+                  const Right* const* right, const std::size_t n) const {
+    TA_ASSERT(n > 0ul);
+    if constexpr (ContractReduceBase_::plain_tensors &&
+                  TiledArray::detail::is_ta_tensor_v<Result> &&
+                  TiledArray::detail::is_ta_tensor_v<Left> &&
+                  TiledArray::detail::is_ta_tensor_v<Right> &&
+                  std::is_same_v<result_value_type, left_value_type> &&
+                  std::is_same_v<result_value_type, right_value_type>) {
+#ifndef TA_ENABLE_TILE_OPS_LOGGING
+      if (n > 1ul) {
+        gemm_packed(result, left, right, n);
+        return;
+      }
+#endif  // TA_ENABLE_TILE_OPS_LOGGING
+    }
+
+    for (std::size_t i = 0ul; i < n; ++i) (*this)(result, *left[i], *right[i]);
+  }
+
+ private:
+  /// Contract packed panels of tile pairs and add them to a target tile
+
+  /// \param[in,out] result The result object that will be the reduction
+  /// target
+  /// \param[in] left The left-hand tiles to be contracted
+  /// \param[in] right The right-hand tiles to be contracted
+  /// \param[in] n The number of tile pairs
+  void gemm_packed(result_type& result, const Left* const* left,
+                   const Right* const* right, const std::size_t n) const {
+    using integer = TiledArray::math::blas::integer;
+    const math::GemmHelper& gemm_helper = ContractReduceBase_::gemm_helper();
+    const bool left_notrans =
+        (gemm_helper.left_op() == TiledArray::math::blas::NoTranspose);
+    const bool right_notrans =
+        (gemm_helper.right_op() == TiledArray::math::blas::NoTranspose);
+
+    // Compute the gemm dimensions of the pairs; the outer dimensions of all
+    // pairs are equal and the inner dimension of the panels is the sum of the
+    // inner dimensions of the pairs.
+    integer m = 1, n_cols = 1, k_total = 0;
+    std::vector<integer> k_sizes(n);
+    for (std::size_t i = 0ul; i < n; ++i) {
+      TA_ASSERT(!left[i]->empty());
+      TA_ASSERT(!right[i]->empty());
+      integer m_i = 1, n_i = 1, k_i = 1;
+      gemm_helper.compute_matrix_sizes(m_i, n_i, k_i, left[i]->range(),
+                                       right[i]->range());
+      TA_ASSERT((i == 0ul) || ((m_i == m) && (n_i == n_cols)));
+      m = m_i;
+      n_cols = n_i;
+      k_sizes[i] = k_i;
+      k_total += k_i;
+    }
+
+    // Pack the tiles into panels. A (transposed) panel that is stored with
+    // the inner dimension as its slowest-running index is formed by
+    // concatenation, otherwise the rows of the tiles are placed side by side.
+    std::vector<result_value_type> a(m * k_total), b(k_total * n_cols);
+    integer offset = 0;
+    for (std::size_t i = 0ul; i < n; ++i) {
+      const integer k = k_sizes[i];
+      const auto* MADNESS_RESTRICT const left_data = left[i]->data();
+      const auto* MADNESS_RESTRICT const right_data = right[i]->data();
+      if (left_notrans) {
+        for (integer row = 0; row < m; ++row)
+          std::copy_n(left_data + row * k, k,
+                      a.data() + row * k_total + offset);
+      } else {
+        std::copy_n(left_data, k * m, a.data() + offset * m);
+      }
+      if (right_notrans) {
+        std::copy_n(right_data, k * n_cols, b.data() + offset * n_cols);
+      } else {
+        for (integer row = 0; row < n_cols; ++row)
+          std::copy_n(right_data + row * k, k,
+                      b.data() + row * k_total + offset);
+      }
+      offset += k;
+    }
+
+    // Construct the result tile if needed and contract the panels
+    using TiledArray::empty;
+    result_value_type beta(1);
+    if (empty(result)) {
+      result = result_type(
+          gemm_helper.make_result_range<typename result_type::range_type>(
+              left[0]->range(), right[0]->range()));
+      beta = result_value_type(0);
+    }
+    const integer lda = (left_notrans ? k_total : m);
+    const integer ldb = (right_notrans ? n_cols : k_total);
+    tracing::Scope scope(
+        tracing::Event::gemm,
+        (m * k_total + k_total * n_cols + 2 * m * n_cols) *
+            sizeof(result_value_type),
+        2ul * m * n_cols * k_total);
+    math::blas::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n_cols,
+                     k_total, ContractReduceBase_::factor(), a.data(), lda,
+                     b.data(), ldb, beta, result.data(), n_cols);
+  }
+
 };  // class ContractReduce
 
 /// Contract and (sum) reduce operation
@@ -0,0 +1,325 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_spill.h
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_SPILL_H__INCLUDED
+#define TILEDARRAY_TILE_SPILL_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/util/memory_size.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+
+/// Tile spilling parameters
+
+/// When \c memory_budget is not zero, the local tiles of the arrays that are
+/// constructed afterwards are tracked by the process-wide
+/// \c detail::TileSpillManager . Once the tracked tiles take up more than
+/// \c memory_budget bytes, the least recently used tiles are written to a
+/// file in \c directory and released from memory; they are read back when
+/// they are accessed again.
+///
+/// The default values are read from the environment: \c TA_SPILL_MEMORY (a
+/// memory size, e.g. "16 GiB") and \c TA_SPILL_DIR (default: \c TMPDIR or
+/// \c /tmp ).
+struct SpillConfig {
+  std::size_t memory_budget = 0ul;  ///< Bytes of local tiles kept in memory
+                                    ///< by each process (0 = never spill)
+  std::string directory = "/tmp";   ///< Directory of the spill files; this
+                                    ///< should be on node-local storage
+
+  /// Construct a configuration from the environment
+
+  /// \return The configuration defined by the \c TA_SPILL_* environment
+  /// variables, with defaults for unset variables
+  static SpillConfig from_env() {
+    SpillConfig config;
+    if (const char* str = std::getenv("TA_SPILL_MEMORY"))
+      config.memory_budget = detail::memory_size_to_bytes(str);
+    if (const char* str = std::getenv("TA_SPILL_DIR"))
+      config.directory = str;
+    else if (const char* str = std::getenv("TMPDIR"))
+      config.directory = str;
+    return config;
+  }
+};  // struct SpillConfig
+
+namespace detail {
+
+/// Global tile spilling configuration accessor
+inline SpillConfig& spill_config_accessor() {
+  static SpillConfig config = SpillConfig::from_env();
+  return config;
+}
+
+}  // namespace detail
+
+/// Tile spilling configuration accessor
+
+/// \return The configuration used by arrays
+inline const SpillConfig& spill_config() {
+  return detail::spill_config_accessor();
+}
+
+/// Set the tile spilling configuration
+
+/// The new memory budget applies immediately to all tracked tiles; only
+/// arrays that are constructed after this call are tracked if spilling was
+/// disabled before. This function must not be called while tasks are
+/// running.
+/// \param config The new configuration
+inline void set_spill_config(const SpillConfig& config) {
+  detail::spill_config_accessor() = config;
+}
+
+namespace detail {
+
+/// Node-local file that holds spilled tiles
+
+/// The file is unlinked as soon as it is created, so that it is removed by
+/// the operating system when it is closed, including when the program
+/// terminates abnormally.
+class SpillFile {
+ private:
+  int fd_ = -1;             ///< The file descriptor
+  std::size_t end_ = 0ul;   ///< The end of the data in the file
+  std::mutex mutex_;        ///< Protects end_
+
+ public:
+  /// Create a spill file
+
+  /// \param directory The directory of the file
+  /// \throw TiledArray::Exception When the file cannot be created
+  explicit SpillFile(const std::string& directory) {
+    std::string path = directory + "/ta_spill.XXXXXX";
+    fd_ = ::mkstemp(&path[0]);
+    if (fd_ < 0) TA_EXCEPTION("unable to create a tile spill file");
+    ::unlink(path.c_str());
+  }
+
+  ~SpillFile() { ::close(fd_); }
+
+  SpillFile(const SpillFile&) = delete;
+  SpillFile& operator=(const SpillFile&) = delete;
+
+  /// Append data to the file
+
+  /// \param data The data to be written
+  /// \param size The number of bytes to be written
+  /// \return The offset of the data in the file
+  /// \throw TiledArray::Exception When the data cannot be written
+  std::size_t write(const unsigned char* data, const std::size_t size) {
+    std::size_t offset = 0ul;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      offset = end_;
+      end_ += size;
+    }
+    for (std::size_t n = 0ul; n < size;) {
+      const ssize_t result = ::pwrite(fd_, data + n, size - n, offset + n);
+      if (result <= 0) TA_EXCEPTION("unable to write to a tile spill file");
+      n += result;
+    }
+    return offset;
+  }
+
+  /// Read data from the file
+
+  /// \param offset The offset of the data in the file
+  /// \param[out] data The buffer that will hold the data
+  /// \param size The number of bytes to be read
+  /// \throw TiledArray::Exception When the data cannot be read
+  void read(const std::size_t offset, unsigned char* data,
+            const std::size_t size) const {
+    for (std::size_t n = 0ul; n < size;) {
+      const ssize_t result = ::pread(fd_, data + n, size - n, offset + n);
+      if (result <= 0) TA_EXCEPTION("unable to read from a tile spill file");
+      n += result;
+    }
+  }
+};  // class SpillFile
+
+/// Process-wide memory budget of local tiles
+
+/// Containers of tiles register the local tiles that are resident in memory
+/// with \c insert() , and report accesses to them with \c touch() . When the
+/// registered tiles exceed \c SpillConfig::memory_budget bytes, \c evict()
+/// asks the owning containers to spill the least recently used tiles.
+class TileSpillManager {
+ public:
+  /// Container of spillable tiles
+  class Client {
+   public:
+    virtual ~Client() {}
+
+    /// Move a tile out of memory
+
+    /// This function is called without any lock of the manager held.
+    /// \param key The key of the tile
+    virtual void spill(const std::size_t key) = 0;
+  };  // class Client
+
+ private:
+  /// A resident tile
+  struct Entry {
+    const Client* id;              ///< The address of the container
+    std::weak_ptr<Client> client;  ///< The container of the tile
+    std::size_t key;               ///< The key of the tile
+    std::size_t bytes;             ///< The size of the tile
+  };
+
+  typedef std::pair<const Client*, std::size_t> index_key;
+
+  struct index_hash {
+    std::size_t operator()(const index_key& key) const {
+      return std::hash<const void*>()(key.first) ^
+             (std::hash<std::size_t>()(key.second) * 0x9e3779b97f4a7c15ul);
+    }
+  };
+
+  std::mutex mutex_;       ///< Protects the members below
+  std::list<Entry> lru_;   ///< Resident tiles, least recently used first
+  std::unordered_map<index_key, std::list<Entry>::iterator, index_hash>
+      index_;               ///< Position of each tile in lru_
+  std::size_t bytes_ = 0ul;  ///< Total size of the resident tiles
+  std::size_t spills_ = 0ul;  ///< Number of spilled tiles
+
+  TileSpillManager() = default;
+
+ public:
+  TileSpillManager(const TileSpillManager&) = delete;
+  TileSpillManager& operator=(const TileSpillManager&) = delete;
+
+  /// The manager of this process
+
+  /// The manager is never destroyed, so that containers that are destroyed
+  /// during program termination can unregister their tiles.
+  static TileSpillManager& instance() {
+    static TileSpillManager* manager = new TileSpillManager;
+    return *manager;
+  }
+
+  /// Register a resident tile and spill tiles if over budget
+
+  /// \param client The container of the tile
+  /// \param key The key of the tile
+  /// \param bytes The size of the tile
+  void insert(const std::shared_ptr<Client>& client, const std::size_t key,
+              const std::size_t bytes) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(index_key(client.get(), key));
+      if (it != index_.end()) {
+        bytes_ -= it->second->bytes;
+        lru_.erase(it->second);
+        index_.erase(it);
+      }
+      lru_.push_back(Entry{client.get(), client, key, bytes});
+      index_.emplace(index_key(client.get(), key), std::prev(lru_.end()));
+      bytes_ += bytes;
+    }
+    evict();
+  }
+
+  /// Mark a resident tile as used
+
+  /// \param client The container of the tile
+  /// \param key The key of the tile
+  void touch(const Client* client, const std::size_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(index_key(client, key));
+    if (it != index_.end()) lru_.splice(lru_.end(), lru_, it->second);
+  }
+
+  /// Unregister all tiles of a container
+
+  /// This must be called before the container is destroyed.
+  /// \param client The container
+  void erase(const Client* client) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = lru_.begin(); it != lru_.end();) {
+      if (it->id == client) {
+        bytes_ -= it->bytes;
+        index_.erase(index_key(client, it->key));
+        it = lru_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  /// Spill the least recently used tiles until the budget is met
+
+  /// The most recently used tile is never spilled, so that a tile that has
+  /// just been inserted or touched remains resident.
+  void evict() {
+    const std::size_t budget = spill_config().memory_budget;
+    std::vector<Entry> victims;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (budget == 0ul) return;
+      while ((bytes_ > budget) && (lru_.size() > 1ul)) {
+        Entry& entry = lru_.front();
+        bytes_ -= entry.bytes;
+        index_.erase(index_key(entry.id, entry.key));
+        victims.push_back(std::move(entry));
+        lru_.pop_front();
+      }
+      spills_ += victims.size();
+    }
+    for (const Entry& entry : victims)
+      if (std::shared_ptr<Client> client = entry.client.lock())
+        client->spill(entry.key);
+  }
+
+  /// Size of the resident tiles
+
+  /// \return The total size of the registered tiles in bytes
+  std::size_t bytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+  }
+
+  /// Spill count
+
+  /// \return The number of tiles that have been spilled by this process
+  std::size_t spills() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spills_;
+  }
+
+};  // class TileSpillManager
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_TILE_SPILL_H__INCLUDED
@@ -1,5 +1,9 @@
 #include <TiledArray/config.h>
 #include <TiledArray/initialize.h>
+#include <TiledArray/shared_memory.h>
+#include <TiledArray/util/tracing.h>
+
+#include <cstdlib>
 
 #ifdef TILEDARRAY_HAS_CUDA
 #include <TiledArray/cuda/cublas.h>
@@ -107,6 +111,17 @@ TiledArray::World& TiledArray::initialize(int& argc, char**& argv,
     mkl_set_num_threads(1);
 #endif
     madness::print_meminfo_disable();
+    // create the shared-memory segments of the intra-node transport
+    if (shared_memory_config().segment_size)
+      detail::SharedMemoryTransport::initialize(
+          default_world, shared_memory_config().segment_size);
+    // enable tracing if a trace file name prefix is given
+    const char* trace = std::getenv("TA_TRACE");
+    if (trace && *trace) {
+      const char* size = std::getenv("TA_TRACE_BUFFER_SIZE");
+      tracing::set_output(trace);
+      tracing::enable(size ? std::strtoul(size, nullptr, 10) : 65536ul);
+    }
     initialized_accessor() = true;
     return default_world;
   } else
@@ -125,6 +140,11 @@ void TiledArray::finalize() {
 #endif
   TiledArray::get_default_world()
       .gop.fence();  // TODO remove when madness::finalize() fences
+  if (tracing::enabled()) {
+    tracing::disable();
+    tracing::dump(TiledArray::get_default_world().rank());
+  }
+  detail::SharedMemoryTransport::finalize();
   if (initialized_madworld()) {
     madness::finalize();
   }
@@ -338,6 +338,7 @@ GENERATE_HAS_MEMBER_FUNCTION(empty)
 GENERATE_HAS_MEMBER_FUNCTION_ANYRETURN(clear)
 GENERATE_HAS_MEMBER_FUNCTION(clear)
 GENERATE_HAS_MEMBER_FUNCTION_ANYRETURN(resize)
+GENERATE_HAS_MEMBER_FUNCTION_ANYRETURN(batch_size)
 
 GENERATE_HAS_MEMBER_FUNCTION_ANYRETURN(begin)
 GENERATE_HAS_MEMBER_FUNCTION(begin)
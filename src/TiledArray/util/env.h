@@ -0,0 +1,76 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  util/env.h
+ *
+ */
+
+#ifndef TILEDARRAY_UTIL_ENV_H__INCLUDED
+#define TILEDARRAY_UTIL_ENV_H__INCLUDED
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+
+namespace TiledArray {
+namespace detail {
+
+/// Read a number from an environment variable
+
+/// Unlike \c std::stoul and friends, this never throws, so it may be used
+/// to initialize static variables.
+/// \tparam T An arithmetic type
+/// \param name The name of the environment variable
+/// \param default_value The value used when the variable is unset or does
+/// not hold a number of type \c T
+/// \return The value of the variable, or \c default_value
+template <typename T>
+T getenv_number(const char* name, const T default_value) {
+  static_assert(std::is_arithmetic_v<T>);
+  const char* str = std::getenv(name);
+  if (!str) return default_value;
+  while (std::isspace(static_cast<unsigned char>(*str))) ++str;
+
+  char* end = nullptr;
+  errno = 0;
+  T value;
+  if constexpr (std::is_floating_point_v<T>) {
+    value = static_cast<T>(std::strtod(str, &end));
+  } else if constexpr (std::is_unsigned_v<T>) {
+    if (*str == '-') return default_value;
+    const unsigned long long v = std::strtoull(str, &end, 10);
+    if (v > static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+      return default_value;
+    value = static_cast<T>(v);
+  } else {
+    const long long v = std::strtoll(str, &end, 10);
+    if (v < static_cast<long long>(std::numeric_limits<T>::min()) ||
+        v > static_cast<long long>(std::numeric_limits<T>::max()))
+      return default_value;
+    value = static_cast<T>(v);
+  }
+  if (end == str || errno == ERANGE) return default_value;
+  while (std::isspace(static_cast<unsigned char>(*end))) ++end;
+  return (*end == '\0' ? value : default_value);
+}
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_UTIL_ENV_H__INCLUDED
@@ -0,0 +1,69 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  util/memory_size.h
+ *
+ */
+
+#ifndef TILEDARRAY_UTIL_MEMORY_SIZE_H__INCLUDED
+#define TILEDARRAY_UTIL_MEMORY_SIZE_H__INCLUDED
+
+#include <sstream>
+#include <string>
+
+namespace TiledArray {
+namespace detail {
+
+/// Convert a memory size string into bytes
+
+/// \param str A memory size, e.g. "100", "2.5 MB", or "1 GiB"; sizes
+/// without a unit are in bytes
+/// \return The memory size in bytes, or 0 if \c str is not a valid
+/// memory size
+inline double memory_size_to_bytes(const char* str) {
+  std::stringstream ss(str);
+  double memory = 0.0;
+  if (ss >> memory) {
+    if (memory > 0.0) {
+      std::string unit;
+      if (ss >> unit) {  // Failure == assume bytes
+        if (unit == "KB" || unit == "kB") {
+          memory *= 1000.0;
+        } else if (unit == "KiB" || unit == "kiB") {
+          memory *= 1024.0;
+        } else if (unit == "MB") {
+          memory *= 1000000.0;
+        } else if (unit == "MiB") {
+          memory *= 1048576.0;
+        } else if (unit == "GB") {
+          memory *= 1000000000.0;
+        } else if (unit == "GiB") {
+          memory *= 1073741824.0;
+        }
+      }
+    } else {
+      memory = 0.0;
+    }
+  }
+
+  return memory;
+}
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_UTIL_MEMORY_SIZE_H__INCLUDED
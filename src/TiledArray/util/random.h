@@ -20,7 +20,10 @@
 #ifndef TILEDARRAY_RANDOM_H__INCLUDED
 #define TILEDARRAY_RANDOM_H__INCLUDED
 
+#include <array> // for std::array
+#include <atomic> // for std::atomic
 #include <complex> // for std::complex
+#include <cstdint> // for std::uint32_t and std::uint64_t
 #include <cstdlib> // for std::rand
 #include <type_traits> // for true_type, false_type, and enable_if
 
@@ -92,7 +95,7 @@ template<typename ValueType>
 struct MakeRandom {
   /// Generates a random value of type ValueType
   static ValueType generate_value() {
-    return static_cast<ValueType>(std::rand() / RAND_MAX);
+    return static_cast<ValueType>(static_cast<double>(std::rand()) / RAND_MAX);
   }
 };
 
@@ -116,7 +119,175 @@ struct MakeRandom<std::complex<ScalarType>> {
   }
 };
 
+//------------------------------------------------------------------------------
+//                       Counter-based random values
+//------------------------------------------------------------------------------
+
+/// The Philox4x32-10 counter-based random number generator
+///
+/// Maps a 128-bit counter and a 64-bit key to 128 random bits, see J. K.
+/// Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11. Since
+/// the generator has no state, any element of a random sequence can be
+/// computed independently, in any order, by any thread or process.
+///
+/// \param ctr The counter
+/// \param key The key
+/// \return The random bits of \c ctr
+inline std::array<std::uint32_t, 4> philox4x32(
+    std::array<std::uint32_t, 4> ctr, std::array<std::uint32_t, 2> key) {
+  constexpr std::uint32_t m0 = 0xD2511F53, m1 = 0xCD9E8D57;
+  constexpr std::uint32_t w0 = 0x9E3779B9, w1 = 0xBB67AE85;
+  for (int round = 0; round < 10; ++round) {
+    const std::uint64_t p0 = std::uint64_t(m0) * ctr[0];
+    const std::uint64_t p1 = std::uint64_t(m1) * ctr[2];
+    ctr = {std::uint32_t(p1 >> 32) ^ ctr[1] ^ key[0], std::uint32_t(p1),
+           std::uint32_t(p0 >> 32) ^ ctr[3] ^ key[1], std::uint32_t(p0)};
+    key[0] += w0;
+    key[1] += w1;
+  }
+  return ctr;
+}
+
+/// Converts random bits into a random value of type `ValueType`
+///
+/// RandomBits contains the number of 32-bit random words, `words`, consumed by
+/// one value, and a static member function `make`, which converts these words
+/// into a value between 0 and 1 (0 or 1 for integers). `words` is 0 for types
+/// that cannot be made from random bits.
+///
+/// \tparam ValueType The type of random value to generate
+template<typename ValueType>
+struct RandomBits {
+  static constexpr unsigned int words = 0;
+};
+
+/// Makes random int values, 0 or 1
+template<>
+struct RandomBits<int> {
+  static constexpr unsigned int words = 1;
+  static int make(const std::uint32_t* w) { return int(w[0] >> 31); }
+};
+
+/// Makes random float values in [0,1) with 24 random bits
+template<>
+struct RandomBits<float> {
+  static constexpr unsigned int words = 1;
+  static float make(const std::uint32_t* w) {
+    return float(w[0] >> 8) * 0x1p-24f;
+  }
+};
+
+/// Makes random double values in [0,1) with 53 random bits
+template<>
+struct RandomBits<double> {
+  static constexpr unsigned int words = 2;
+  static double make(const std::uint32_t* w) {
+    return double((std::uint64_t(w[0]) << 21) ^ (w[1] >> 11)) * 0x1p-53;
+  }
+};
+
+/// Makes random complex values from random real and imaginary components
+template<typename ScalarType>
+struct RandomBits<std::complex<ScalarType>> {
+  static constexpr unsigned int words = 2 * RandomBits<ScalarType>::words;
+  static std::complex<ScalarType> make(const std::uint32_t* w) {
+    return std::complex<ScalarType>(
+        RandomBits<ScalarType>::make(w),
+        RandomBits<ScalarType>::make(w + RandomBits<ScalarType>::words));
+  }
+};
+
+/// Fills contiguous memory with counter-based random values
+///
+/// Element `i` is made from the Philox block with counter
+/// `{i / p, stream}`, where `p` values are made from each block, and key
+/// `key`. Hence the values depend only on `key`, `stream`, and `i`, e.g. on
+/// the seed, the tile ordinal, and the element offset in the tile, and not on
+/// the number of processes or threads. The loop over the blocks has no
+/// dependencies and is vectorized by the compiler.
+///
+/// \tparam ValueType The type of random value to generate
+/// \param data The memory to be filled
+/// \param n The number of values
+/// \param key The key of the random sequence
+/// \param stream The stream of the random sequence
+template<typename ValueType>
+void random_fill(ValueType* const data, const std::size_t n,
+                 const std::uint64_t key, const std::uint64_t stream) {
+  using bits_type = RandomBits<ValueType>;
+  static_assert(bits_type::words > 0 && 4 % bits_type::words == 0,
+                "RandomBits cannot make values of type ValueType");
+  constexpr std::size_t per_block = 4 / bits_type::words;
+  const std::array<std::uint32_t, 2> k = {std::uint32_t(key),
+                                          std::uint32_t(key >> 32)};
+  const std::uint32_t s0 = std::uint32_t(stream);
+  const std::uint32_t s1 = std::uint32_t(stream >> 32);
+
+  const std::size_t full = n / per_block;
+  for (std::size_t b = 0; b < full; ++b) {
+    const auto r =
+        philox4x32({std::uint32_t(b), std::uint32_t(b >> 32), s0, s1}, k);
+    for (std::size_t i = 0; i < per_block; ++i)
+      data[b * per_block + i] =
+          bits_type::make(r.data() + i * bits_type::words);
+  }
+
+  // The last, partial block
+  if (full * per_block < n) {
+    const auto r = philox4x32(
+        {std::uint32_t(full), std::uint32_t(full >> 32), s0, s1}, k);
+    for (std::size_t i = 0; full * per_block + i < n; ++i)
+      data[full * per_block + i] =
+          bits_type::make(r.data() + i * bits_type::words);
+  }
+}
+
+/// The seed of the random values and the number of sequences generated from it
+struct RandomSeed {
+  std::atomic<std::uint64_t> seed{0};
+  std::atomic<std::uint64_t> count{0};
+};
+
+/// \return The seed of the random values
+inline RandomSeed& random_seed_accessor() {
+  static RandomSeed seed;
+  return seed;
+}
+
+/// The key of the next random sequence
+///
+/// Each call returns the key of a new sequence, made from the seed and the
+/// number of previous calls, so that processes that generate their sequences
+/// in the same order use the same keys.
+///
+/// \return The key of a random sequence
+inline std::uint64_t next_random_key() {
+  auto& seed = random_seed_accessor();
+  // SplitMix64 finalizer
+  std::uint64_t z =
+      seed.seed + (seed.count++ + 1) * std::uint64_t(0x9E3779B97F4A7C15);
+  z = (z ^ (z >> 30)) * std::uint64_t(0xBF58476D1CE4E5B9);
+  z = (z ^ (z >> 27)) * std::uint64_t(0x94D049BB133111EB);
+  return z ^ (z >> 31);
+}
+
 } // namespace TiledArray::detail
 
+namespace TiledArray {
+
+/// Sets the seed of the random values generated by `DistArray::fill_random`
+///
+/// The sequences of the following `fill_random` calls are determined by
+/// `seed` and the order of the calls.
+///
+/// \param seed The seed
+inline void set_random_seed(const std::uint64_t seed) {
+  auto& random_seed = detail::random_seed_accessor();
+  random_seed.seed = seed;
+  random_seed.count = 0;
+}
+
+} // namespace TiledArray
+
 
 #endif
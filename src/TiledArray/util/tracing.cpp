@@ -0,0 +1,172 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  util/tracing.cpp
+ *
+ */
+
+#include <TiledArray/util/tracing.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace TiledArray::tracing {
+namespace {
+
+/// The buffers of all threads, which outlive the threads
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<Buffer>> buffers;
+  std::size_t capacity = 65536ul;
+  /// The wall clock time at which tracing was enabled, in us since the Unix
+  /// epoch, so that the events of different ranks are aligned
+  std::int64_t wall_epoch = 0;
+  std::string output;
+};
+
+Registry& registry() {
+  static Registry registry;
+  return registry;
+}
+
+}  // namespace
+
+const char* to_string(const Event event) {
+  switch (event) {
+    case Event::gemm:
+      return "gemm";
+    case Event::permute:
+      return "permute";
+    case Event::reduce:
+      return "reduce";
+    case Event::broadcast:
+      return "broadcast";
+    case Event::send:
+      return "send";
+    case Event::receive:
+      return "receive";
+  }
+  return "unknown";
+}
+
+std::vector<Record> Buffer::records() const {
+  std::vector<Record> result;
+  const std::size_t size = std::min(count_, records_.size());
+  result.reserve(size);
+  for (std::size_t i = count_ - size; i < count_; ++i)
+    result.push_back(records_[i % records_.size()]);
+  return result;
+}
+
+Buffer* detail::make_buffer() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.buffers.push_back(std::make_unique<Buffer>(
+      std::max(reg.capacity, std::size_t(1)), int(reg.buffers.size())));
+  return buffer_accessor() = reg.buffers.back().get();
+}
+
+void enable(const std::size_t capacity) {
+  auto& reg = registry();
+  {
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.capacity = capacity;
+    detail::epoch_accessor() = now();
+    reg.wall_epoch = std::chrono::duration_cast<std::chrono::microseconds>(
+                         system_now().time_since_epoch())
+                         .count();
+  }
+  detail::enabled_accessor() = true;
+}
+
+void disable() { detail::enabled_accessor() = false; }
+
+void clear() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  for (auto& buffer : reg.buffers) buffer->clear();
+}
+
+void set_output(const std::string& prefix) {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.output = prefix;
+}
+
+const std::string& output() { return registry().output; }
+
+void write_chrome_trace(std::ostream& os, const int rank) {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+
+  char line[512];
+  os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+  std::snprintf(line, sizeof(line),
+                "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                "\"args\":{\"name\":\"rank %d\"}}",
+                rank, rank);
+  os << line;
+
+  for (const auto& buffer : reg.buffers) {
+    std::snprintf(line, sizeof(line),
+                  ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                  "\"tid\":%d,\"args\":{\"name\":\"thread %d\","
+                  "\"dropped\":%zu}}",
+                  rank, buffer->thread(), buffer->thread(),
+                  buffer->dropped());
+    os << line;
+
+    // Timestamps are in us, with ns resolution
+    for (const auto& record : buffer->records()) {
+      const std::int64_t start = reg.wall_epoch * 1000 + record.start;
+      const std::int64_t duration = record.finish - record.start;
+      int n = std::snprintf(
+          line, sizeof(line),
+          ",\n{\"name\":\"%s\",\"cat\":\"tile\",\"pid\":%d,\"tid\":%d,"
+          "\"ts\":%" PRId64 ".%03d,",
+          to_string(record.event), rank, buffer->thread(), start / 1000,
+          int(start % 1000));
+      if (is_instant(record.event))
+        n += std::snprintf(line + n, sizeof(line) - n,
+                           "\"ph\":\"i\",\"s\":\"t\",\"args\":{");
+      else
+        n += std::snprintf(line + n, sizeof(line) - n,
+                           "\"ph\":\"X\",\"dur\":%" PRId64 ".%03d,\"args\":{",
+                           duration / 1000, int(duration % 1000));
+      if (record.ordinal != no_ordinal)
+        n += std::snprintf(line + n, sizeof(line) - n,
+                           "\"ordinal\":%" PRIu64 ",", record.ordinal);
+      std::snprintf(line + n, sizeof(line) - n,
+                    "\"bytes\":%" PRIu64 ",\"flops\":%" PRIu64 "}}",
+                    record.bytes, record.flops);
+      os << line;
+    }
+  }
+  os << "\n]}\n";
+}
+
+void dump(const int rank) {
+  if (output().empty()) return;
+  std::ofstream file(output() + "." + std::to_string(rank) + ".json");
+  write_chrome_trace(file, rank);
+}
+
+}  // namespace TiledArray::tracing
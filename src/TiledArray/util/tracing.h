@@ -0,0 +1,300 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  util/tracing.h
+ *
+ */
+
+#ifndef TILEDARRAY_UTIL_TRACING_H__INCLUDED
+#define TILEDARRAY_UTIL_TRACING_H__INCLUDED
+
+#include <TiledArray/util/time.h>
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// Tile-level performance tracing
+
+/// Tracing records the start and finish time, thread, tile ordinal, bytes,
+/// and flops of tile operations (GEMMs, permutations, reductions, and tile
+/// transfers) in per-thread ring buffers. Messages are asynchronous, so a
+/// tile send is recorded as an instant event when the tile is handed to the
+/// runtime; the transfer shows up on the receiving side, as a \c broadcast
+/// or \c receive span from the time the tile is requested until it arrives,
+/// which is the time the receiver may be idle waiting for it. It is always
+/// compiled, and is switched on at runtime: when the \c TA_TRACE
+/// environment variable holds a file name prefix, \c TiledArray::initialize
+/// enables tracing and \c TiledArray::finalize writes the events of each
+/// rank to <tt>\<prefix\>.\<rank\>.json</tt> in the Chrome trace event
+/// format, which can be viewed with Perfetto (ui.perfetto.dev) or
+/// chrome://tracing. \c TA_TRACE_BUFFER_SIZE sets the number of events kept
+/// by each thread (default 65536); older events are overwritten. When
+/// tracing is disabled, each traced operation costs one relaxed atomic load.
+namespace TiledArray::tracing {
+
+/// Traced tile operations
+enum class Event : std::uint8_t {
+  gemm,       ///< A GEMM
+  permute,    ///< A permutation
+  reduce,     ///< A reduction of two tiles
+  broadcast,  ///< Waiting for a broadcast tile (receivers only)
+  send,       ///< Handing a tile to the runtime for sending (instant)
+  receive     ///< Waiting for a tile sent by another process
+};
+
+/// \param event A traced tile operation
+/// \return \c true if \c event is recorded without a duration
+constexpr bool is_instant(const Event event) { return event == Event::send; }
+
+/// \param event A traced tile operation
+/// \return The name of \c event
+const char* to_string(Event event);
+
+/// The ordinal of events that do not belong to a known tile
+constexpr std::uint64_t no_ordinal = std::numeric_limits<std::uint64_t>::max();
+
+/// A traced tile operation
+struct Record {
+  std::int64_t start;     ///< Start time (ns since tracing was enabled)
+  std::int64_t finish;    ///< Finish time (ns since tracing was enabled)
+  std::uint64_t ordinal;  ///< The tile ordinal, or \c no_ordinal
+  std::uint64_t bytes;    ///< The number of bytes read, written, or sent
+  std::uint64_t flops;    ///< The number of floating-point operations
+  Event event;            ///< The operation
+};
+
+/// The ring buffer of the events of a thread
+
+/// Only the owning thread adds events; the events are read when no events
+/// are being recorded, e.g. by \c write_chrome_trace() .
+class Buffer {
+ public:
+  /// \param capacity The maximum number of events
+  /// \param thread The index of the owning thread
+  Buffer(std::size_t capacity, int thread)
+      : records_(capacity), thread_(thread) {}
+
+  /// Add an event, overwriting the oldest event when the buffer is full
+
+  /// \param record The event
+  void push(const Record& record) {
+    records_[count_ % records_.size()] = record;
+    ++count_;
+  }
+
+  /// \return The events in the buffer, oldest first
+  std::vector<Record> records() const;
+
+  /// \return The index of the owning thread
+  int thread() const { return thread_; }
+
+  /// \return The number of events that were overwritten
+  std::size_t dropped() const {
+    return (count_ > records_.size() ? count_ - records_.size() : 0ul);
+  }
+
+  /// Remove all events
+  void clear() { count_ = 0ul; }
+
+ private:
+  std::vector<Record> records_;  ///< The ring buffer
+  std::size_t count_ = 0ul;      ///< The number of events added
+  int thread_;                   ///< The index of the owning thread
+};  // class Buffer
+
+namespace detail {
+
+/// \return The tracing switch
+inline std::atomic<bool>& enabled_accessor() {
+  static std::atomic<bool> enabled{false};
+  return enabled;
+}
+
+/// \return The time at which tracing was enabled
+inline time_point& epoch_accessor() {
+  static time_point epoch = now();
+  return epoch;
+}
+
+/// \return The buffer of this thread, or \c nullptr if it has no buffer yet
+inline Buffer*& buffer_accessor() {
+  static thread_local Buffer* buffer = nullptr;
+  return buffer;
+}
+
+/// \return The ordinal of the tile processed by this thread
+inline std::uint64_t& ordinal_accessor() {
+  static thread_local std::uint64_t ordinal = no_ordinal;
+  return ordinal;
+}
+
+/// Create and register the buffer of this thread
+
+/// \return The buffer of this thread
+Buffer* make_buffer();
+
+}  // namespace detail
+
+/// \return \c true if tracing is enabled
+inline bool enabled() {
+  return detail::enabled_accessor().load(std::memory_order_relaxed);
+}
+
+/// Enable tracing
+
+/// \param capacity The maximum number of events kept by each thread; only
+/// applies to threads that have not recorded events yet
+void enable(std::size_t capacity = 65536ul);
+
+/// Disable tracing
+void disable();
+
+/// Remove the recorded events of all threads
+
+/// \warning Must not be called while events are being recorded
+void clear();
+
+/// Set the file name prefix of \c dump()
+
+/// \param prefix The file name prefix; if empty, \c dump() does nothing
+void set_output(const std::string& prefix);
+
+/// \return The file name prefix of \c dump()
+const std::string& output();
+
+/// \return The ordinal of the tile processed by this thread, or
+/// \c no_ordinal if it is unknown
+inline std::uint64_t current_ordinal() { return detail::ordinal_accessor(); }
+
+/// Record an event
+
+/// \param event The operation
+/// \param start The start time of the operation
+/// \param finish The finish time of the operation
+/// \param ordinal The tile ordinal, or \c no_ordinal
+/// \param bytes The number of bytes read, written, or sent
+/// \param flops The number of floating-point operations
+inline void record(const Event event, const time_point& start,
+                   const time_point& finish, const std::uint64_t ordinal,
+                   const std::uint64_t bytes, const std::uint64_t flops) {
+  Buffer* buffer = detail::buffer_accessor();
+  if (!buffer) buffer = detail::make_buffer();
+  const auto& epoch = detail::epoch_accessor();
+  buffer->push({duration_in_ns(epoch, start), duration_in_ns(epoch, finish),
+                ordinal, bytes, flops, event});
+}
+
+/// Record an instant event, if tracing is enabled
+
+/// \param event The operation
+/// \param bytes The number of bytes read, written, or sent
+/// \param ordinal The tile ordinal [default = the ordinal of the tile
+/// processed by this thread]
+inline void instant(const Event event, const std::uint64_t bytes,
+                    const std::uint64_t ordinal = current_ordinal()) {
+  if (!enabled()) return;
+  const time_point time = now();
+  record(event, time, time, ordinal, bytes, 0);
+}
+
+/// Records an event spanning the lifetime of this object
+
+/// The event is recorded if tracing is enabled when this object is
+/// constructed, e.g.
+/// \code
+/// {
+///   tracing::Scope scope(tracing::Event::gemm, bytes, flops);
+///   blas::gemm(...);
+/// }
+/// \endcode
+class Scope {
+ public:
+  Scope() = delete;
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+  /// \param event The operation
+  /// \param bytes The number of bytes read, written, or sent
+  /// \param flops The number of floating-point operations
+  /// \param ordinal The tile ordinal [default = the ordinal of the tile
+  /// processed by this thread]
+  Scope(const Event event, const std::uint64_t bytes, const std::uint64_t flops,
+        const std::uint64_t ordinal = current_ordinal())
+      : enabled_(enabled()),
+        event_(event),
+        ordinal_(ordinal),
+        bytes_(bytes),
+        flops_(flops) {
+    if (enabled_) start_ = now();
+  }
+
+  ~Scope() {
+    if (enabled_) record(event_, start_, now(), ordinal_, bytes_, flops_);
+  }
+
+ private:
+  bool enabled_;
+  Event event_;
+  std::uint64_t ordinal_;
+  std::uint64_t bytes_;
+  std::uint64_t flops_;
+  time_point start_;
+};  // class Scope
+
+/// Sets the tile processed by this thread for the lifetime of this object
+
+/// Events of operations that do not know their tile, e.g. a GEMM of a
+/// reduction task, are recorded with this ordinal.
+class TileContext {
+ public:
+  TileContext() = delete;
+  TileContext(const TileContext&) = delete;
+  TileContext& operator=(const TileContext&) = delete;
+
+  /// \param ordinal The tile ordinal
+  explicit TileContext(const std::uint64_t ordinal)
+      : previous_(detail::ordinal_accessor()) {
+    detail::ordinal_accessor() = ordinal;
+  }
+
+  ~TileContext() { detail::ordinal_accessor() = previous_; }
+
+ private:
+  std::uint64_t previous_;  ///< The ordinal of the enclosing context
+};  // class TileContext
+
+/// Write the recorded events in the Chrome trace event format
+
+/// \warning Must not be called while events are being recorded
+/// \param os The output stream
+/// \param rank The rank of this process, which is used as the process id
+void write_chrome_trace(std::ostream& os, int rank);
+
+/// Write the recorded events to <tt>\<output()\>.\<rank\>.json</tt>
+
+/// Does nothing if \c output() is empty.
+/// \warning Must not be called while events are being recorded
+/// \param rank The rank of this process
+void dump(int rank);
+
+}  // namespace TiledArray::tracing
+
+#endif  // TILEDARRAY_UTIL_TRACING_H__INCLUDED
@@ -30,6 +30,7 @@
 #include <TiledArray/tile.h>
 
 // Array policy classes
+#include <TiledArray/policies/compressed_sparse_policy.h>
 #include <TiledArray/policies/dense_policy.h>
 #include <TiledArray/policies/sparse_policy.h>
 
@@ -43,6 +44,7 @@
 #include <TiledArray/conversions/truncate.h>
 #include <TiledArray/expressions/scal_expr.h>
 #include <TiledArray/expressions/tsr_expr.h>
+#include <TiledArray/expressions/expr_plan.h>
 
 // Special Arrays
 #include <TiledArray/special/diagonal_array.h>
@@ -50,8 +52,10 @@
 // Process maps
 #include <TiledArray/pmap/hash_pmap.h>
 #include <TiledArray/pmap/replicated_pmap.h>
+#include <TiledArray/pmap/weighted_pmap.h>
 
 // Utility functionality
+#include <TiledArray/checkpoint.h>
 #include <TiledArray/conversions/eigen.h>
 
 // Linear algebra
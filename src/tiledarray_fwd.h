@@ -42,20 +42,30 @@ class TiledRange;
 // TiledArray Policy
 class DensePolicy;
 class SparsePolicy;
+class CompressedSparsePolicy;
 
 // TiledArray Tensors
 template <typename, typename>
 class Tensor;
 
-typedef Tensor<double, Eigen::aligned_allocator<double> > TensorD;
-typedef Tensor<int, Eigen::aligned_allocator<int> > TensorI;
-typedef Tensor<float, Eigen::aligned_allocator<float> > TensorF;
-typedef Tensor<long, Eigen::aligned_allocator<long> > TensorL;
-typedef Tensor<std::complex<double>,
-               Eigen::aligned_allocator<std::complex<double> > >
+// Allocator of the default Tensor types
+#ifdef TA_TENSOR_POOL_ALLOCATOR
+template <typename>
+class tile_pool_allocator;
+template <typename T>
+using tensor_allocator = tile_pool_allocator<T>;
+#else
+template <typename T>
+using tensor_allocator = Eigen::aligned_allocator<T>;
+#endif  // TA_TENSOR_POOL_ALLOCATOR
+
+typedef Tensor<double, tensor_allocator<double> > TensorD;
+typedef Tensor<int, tensor_allocator<int> > TensorI;
+typedef Tensor<float, tensor_allocator<float> > TensorF;
+typedef Tensor<long, tensor_allocator<long> > TensorL;
+typedef Tensor<std::complex<double>, tensor_allocator<std::complex<double> > >
     TensorZ;
-typedef Tensor<std::complex<float>,
-               Eigen::aligned_allocator<std::complex<float> > >
+typedef Tensor<std::complex<float>, tensor_allocator<std::complex<float> > >
     TensorC;
 
 // CUDA tensor
@@ -90,7 +100,7 @@ class DistArray;
 
 // Dense Array Typedefs
 template <typename T>
-using TArray = DistArray<Tensor<T, Eigen::aligned_allocator<T> >, DensePolicy>;
+using TArray = DistArray<Tensor<T, tensor_allocator<T> >, DensePolicy>;
 typedef TArray<double> TArrayD;
 typedef TArray<int> TArrayI;
 typedef TArray<float> TArrayF;
@@ -100,8 +110,7 @@ typedef TArray<std::complex<float> > TArrayC;
 
 // Sparse Array Typedefs
 template <typename T>
-using TSpArray =
-    DistArray<Tensor<T, Eigen::aligned_allocator<T> >, SparsePolicy>;
+using TSpArray = DistArray<Tensor<T, tensor_allocator<T> >, SparsePolicy>;
 typedef TSpArray<double> TSpArrayD;
 typedef TSpArray<int> TSpArrayI;
 typedef TSpArray<float> TSpArrayF;
@@ -112,7 +121,7 @@ typedef TSpArray<std::complex<float> > TSpArrayC;
 // type alias for backward compatibility: the old Array has static type,
 // DistArray is rank-polymorphic
 template <typename T, unsigned int = 0,
-          typename Tile = Tensor<T, Eigen::aligned_allocator<T> >,
+          typename Tile = Tensor<T, tensor_allocator<T> >,
           typename Policy = DensePolicy>
 using Array = DistArray<Tile, Policy>;
 
@@ -0,0 +1,82 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  chunked_bcast.cpp
+ *
+ */
+
+#include "TiledArray/chunked_bcast.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct ChunkedBcastFixture {
+  ChunkedBcastFixture() : group_list() {
+    for (ProcessID p = 0; p < GlobalFixture::world->size(); ++p)
+      group_list.push_back(p);
+  }
+
+  ~ChunkedBcastFixture() {}
+
+  /// Make a tensor with well-defined elements
+  static TensorD make_tensor(const std::size_t n) {
+    TensorD tensor(Range(n, 3ul));
+    for (std::size_t i = 0ul; i < tensor.size(); ++i) tensor[i] = i + 0.5;
+    return tensor;
+  }
+
+  /// Broadcast a tensor with \c n rows and check the result on all processes
+  void check_bcast(const std::size_t n, const ProcessID group_root,
+                   const std::size_t chunk_size) {
+    const madness::DistributedID did(madness::uniqueidT(), n);
+    madness::Group group(*GlobalFixture::world, group_list, did);
+
+    Future<TensorD> tile;
+    if (group.rank() == group_root) tile.set(make_tensor(n));
+
+    const madness::DistributedID key(madness::uniqueidT(), n + 1ul);
+    BOOST_REQUIRE_NO_THROW(detail::chunked_bcast(
+        *GlobalFixture::world, key, tile, group_root, group, chunk_size));
+
+    const TensorD reference = make_tensor(n);
+    const TensorD& result = tile.get();
+    BOOST_CHECK_EQUAL(result.range(), reference.range());
+    for (std::size_t i = 0ul; i < reference.size(); ++i)
+      BOOST_CHECK_EQUAL(result[i], reference[i]);
+
+    GlobalFixture::world->gop.fence();
+  }
+
+  std::vector<ProcessID> group_list;
+
+};  // ChunkedBcastFixture
+
+BOOST_FIXTURE_TEST_SUITE(chunked_bcast_suite, ChunkedBcastFixture)
+
+BOOST_AUTO_TEST_CASE(bcast_many_chunks) {
+  // The serialized tensor spans many chunks, and the last chunk is partial
+  check_bcast(1000ul, 0, 1000ul);
+  check_bcast(1001ul, GlobalFixture::world->size() - 1, 1000ul);
+}
+
+BOOST_AUTO_TEST_CASE(bcast_one_chunk) {
+  // The serialized tensor fits in a single chunk
+  check_bcast(10ul, 0, 1048576ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,379 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  compressed_sparse_shape.cpp
+ *
+ */
+
+#include "TiledArray/compressed_sparse_shape.h"
+#include "TiledArray/pmap/hash_pmap.h"
+#include "sparse_shape_fixture.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct CompressedSparseShapeFixture : public SparseShapeFixture {
+  CompressedSparseShapeFixture()
+      : compressed_shape(sparse_shape),
+        compressed_left(left),
+        compressed_right(right) {}
+
+  ~CompressedSparseShapeFixture() {}
+
+  /// Check that \c result holds the same norms as \c reference
+  void check(const CompressedSparseShape<float>& result,
+             const SparseShape<float>& reference) const {
+    BOOST_REQUIRE(result.validate(reference.data().range()));
+    std::size_t nnz = 0ul;
+    for (std::size_t i = 0ul; i < reference.data().size(); ++i) {
+      BOOST_CHECK_CLOSE(result[i], reference[i], tolerance);
+      BOOST_CHECK_EQUAL(result.is_zero(i), reference.is_zero(i));
+      if (!reference.is_zero(i)) ++nnz;
+    }
+    BOOST_CHECK_EQUAL(result.nnz(), nnz);
+    BOOST_CHECK_CLOSE(result.sparsity(), reference.sparsity(), tolerance);
+  }
+
+  CompressedSparseShape<float> compressed_shape;
+  CompressedSparseShape<float> compressed_left;
+  CompressedSparseShape<float> compressed_right;
+};  // CompressedSparseShapeFixture
+
+BOOST_FIXTURE_TEST_SUITE(compressed_sparse_shape_suite,
+                         CompressedSparseShapeFixture)
+
+BOOST_AUTO_TEST_CASE(default_constructor) {
+  BOOST_CHECK_NO_THROW(CompressedSparseShape<float> x);
+  CompressedSparseShape<float> x;
+  BOOST_CHECK(x.empty());
+  BOOST_CHECK(!x.is_dense());
+  BOOST_CHECK(!x.validate(tr.tiles_range()));
+  BOOST_CHECK_THROW(x[0], Exception);
+  BOOST_CHECK_THROW(x.perm(perm), Exception);
+  BOOST_CHECK_THROW(x.to_sparse_shape(), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(compressing_constructor) {
+  BOOST_CHECK(!compressed_shape.empty());
+  BOOST_CHECK(!compressed_shape.is_partitioned());
+  check(compressed_shape, sparse_shape);
+
+  // Check coordinate index access
+  for (auto index : tr.tiles_range()) {
+    BOOST_CHECK_EQUAL(compressed_shape[index], sparse_shape[index]);
+    BOOST_CHECK_EQUAL(compressed_shape.is_zero(index),
+                      sparse_shape.is_zero(index));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sparse_constructor) {
+  // Construct the list of nonzero tile norms
+  const Tensor<float> norms = make_norm_tensor(tr, 0.5, 42);
+  std::vector<std::pair<Range::index, float>> sparse_norms;
+  for (auto index : tr.tiles_range())
+    sparse_norms.emplace_back(Range::index(index.begin(), index.end()),
+                              norms(index));
+  std::reverse(sparse_norms.begin(), sparse_norms.end());
+
+  CompressedSparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(
+      result = CompressedSparseShape<float>(sparse_norms, tr));
+  check(result, SparseShape<float>(norms, tr));
+}
+
+BOOST_AUTO_TEST_CASE(to_sparse_shape) {
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = compressed_shape.to_sparse_shape());
+  BOOST_CHECK_EQUAL(result.data().range(), sparse_shape.data().range());
+  for (std::size_t i = 0ul; i < sparse_shape.data().size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], sparse_shape[i]);
+  BOOST_CHECK_CLOSE(result.sparsity(), sparse_shape.sparsity(), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(local) {
+  auto pmap = std::make_shared<detail::HashPmap>(*GlobalFixture::world,
+                                                 tr.tiles_range().volume());
+
+  CompressedSparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = compressed_shape.local(pmap));
+  BOOST_CHECK(result.is_partitioned());
+  BOOST_CHECK_CLOSE(result.sparsity(), sparse_shape.sparsity(), tolerance);
+
+  std::size_t nnz = 0ul;
+  for (std::size_t i = 0ul; i < sparse_shape.data().size(); ++i) {
+    if (pmap->is_local(i)) {
+      BOOST_CHECK_EQUAL(result[i], sparse_shape[i]);
+      BOOST_CHECK_EQUAL(result.is_zero(i), sparse_shape.is_zero(i));
+      if (!sparse_shape.is_zero(i)) ++nnz;
+    } else {
+      BOOST_CHECK_THROW(result.is_zero(i), Exception);
+    }
+  }
+  BOOST_CHECK_EQUAL(result.nnz(), nnz);
+
+  // Operations that require all tiles are not supported
+  BOOST_CHECK_THROW(result.perm(perm), Exception);
+  BOOST_CHECK_THROW(result.to_sparse_shape(), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(mask) {
+  CompressedSparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = compressed_left.mask(compressed_right));
+  check(result, left.mask(right));
+}
+
+BOOST_AUTO_TEST_CASE(block) {
+  auto less = std::less<std::size_t>();
+
+  for (auto lower_it = tr.tiles_range().begin();
+       lower_it != tr.tiles_range().end(); ++lower_it) {
+    const auto& lower = *lower_it;
+
+    for (auto upper_it = tr.tiles_range().begin();
+         upper_it != tr.tiles_range().end(); ++upper_it) {
+      auto upper = *upper_it;
+      for (auto it = upper.begin(); it != upper.end(); ++it) *it += 1;
+
+      if (std::equal(lower.begin(), lower.end(), upper.begin(), less)) {
+        CompressedSparseShape<float> result;
+        BOOST_REQUIRE_NO_THROW(result = compressed_shape.block(lower, upper));
+        check(result, sparse_shape.block(lower, upper));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(perm) {
+  CompressedSparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = compressed_shape.perm(perm));
+  check(result, sparse_shape.perm(perm));
+}
+
+BOOST_AUTO_TEST_CASE(gemm) {
+  math::GemmHelper gemm_helper(
+      TiledArray::math::blas::Op::NoTrans, TiledArray::math::blas::Op::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+
+  CompressedSparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(
+      result = compressed_left.gemm(compressed_right, -7.2, gemm_helper));
+  check(result, left.gemm(right, -7.2, gemm_helper));
+}
+
+BOOST_AUTO_TEST_CASE(gemm_perm) {
+  const Permutation perm({1, 0});
+  math::GemmHelper gemm_helper(
+      TiledArray::math::blas::Op::NoTrans, TiledArray::math::blas::Op::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+
+  CompressedSparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(
+      result = compressed_left.gemm(compressed_right, -7.2, gemm_helper, perm));
+  check(result, left.gemm(right, -7.2, gemm_helper, perm));
+}
+
+BOOST_AUTO_TEST_CASE(serialization) {
+  const std::size_t volume = tr.tiles_range().volume();
+  std::size_t buf_size =
+      (volume * (sizeof(float) + sizeof(std::size_t)) +
+       sizeof(std::size_t) * (tr.tiles_range().rank() * 4 + 4)) *
+      2;
+  unsigned char* buf = new unsigned char[buf_size];
+  madness::archive::BufferOutputArchive oar(buf, buf_size);
+  BOOST_REQUIRE_NO_THROW(oar & compressed_shape);
+  std::size_t nbyte = oar.size();
+  oar.close();
+
+  CompressedSparseShape<float> result;
+  madness::archive::BufferInputArchive iar(buf, nbyte);
+  BOOST_REQUIRE_NO_THROW(iar & result);
+  iar.close();
+
+  delete[] buf;
+
+  check(result, sparse_shape);
+}
+
+BOOST_AUTO_TEST_CASE(dense_constructor) {
+  CompressedSparseShape<float> x(1.0f, tr);
+  BOOST_CHECK_EQUAL(x.nnz(), tr.tiles_range().volume());
+  check(x, SparseShape<float>(1.0f, tr));
+
+  CompressedSparseShape<float> y(SparseShape<float>::threshold() / 2, tr);
+  BOOST_CHECK_EQUAL(y.nnz(), 0ul);
+  BOOST_CHECK_EQUAL(y.sparsity(), 1.0f);
+
+  const auto norms = make_norm_tensor(tr, 0.3, 11);
+  check(CompressedSparseShape<float>(norms, tr),
+        SparseShape<float>(norms, tr));
+  check(CompressedSparseShape<float>(*GlobalFixture::world, norms, tr),
+        SparseShape<float>(*GlobalFixture::world, norms, tr));
+}
+
+BOOST_AUTO_TEST_CASE(collective_sparse_constructor) {
+  // Each process contributes the norms of the tiles it owns
+  World& world = *GlobalFixture::world;
+  const auto norms = make_norm_tensor(tr, 0.3, 11);
+  std::vector<std::pair<std::vector<std::size_t>, float>> local_norms;
+  Tensor<float> local_dense(tr.tiles_range(), 0.0f);
+  for (std::size_t ord = 0ul; ord < norms.size(); ++ord) {
+    if (ord % world.size() != std::size_t(world.rank())) continue;
+    const auto index = tr.tiles_range().idx(ord);
+    local_norms.emplace_back(
+        std::vector<std::size_t>(index.begin(), index.end()), norms[ord]);
+    local_dense[ord] = norms[ord];
+  }
+
+  CompressedSparseShape<float> result(world, local_norms, tr);
+  check(result, SparseShape<float>(world, local_dense, tr));
+  BOOST_CHECK(is_replicated(world, result));
+}
+
+BOOST_AUTO_TEST_CASE(scale) {
+  check(compressed_shape.scale(-2.5), sparse_shape.scale(-2.5));
+  check(compressed_shape.scale(-2.5, perm), sparse_shape.scale(-2.5, perm));
+  // Scaling may screen tiles
+  check(compressed_shape.scale(1e-3), sparse_shape.scale(1e-3));
+}
+
+BOOST_AUTO_TEST_CASE(add) {
+  check(compressed_left.add(compressed_right), left.add(right));
+  check(compressed_left.add(compressed_right, perm), left.add(right, perm));
+  check(compressed_left.add(compressed_right, -0.5),
+        left.add(right, -0.5));
+  check(compressed_left.add(compressed_right, -0.5, perm),
+        left.add(right, -0.5, perm));
+  check(compressed_left.subt(compressed_right, -0.5, perm),
+        left.subt(right, -0.5, perm));
+}
+
+BOOST_AUTO_TEST_CASE(mult) {
+  check(compressed_left.mult(compressed_right), left.mult(right));
+  check(compressed_left.mult(compressed_right, perm), left.mult(right, perm));
+  check(compressed_left.mult(compressed_right, -2.0),
+        left.mult(right, -2.0));
+  check(compressed_left.mult(compressed_right, -2.0, perm),
+        left.mult(right, -2.0, perm));
+}
+
+BOOST_AUTO_TEST_CASE(update_block) {
+  std::vector<std::size_t> lower(GlobalFixture::dim, 1ul),
+      upper(GlobalFixture::dim, 3ul);
+  const auto result = compressed_left.update_block(
+      lower, upper, compressed_right.block(lower, upper));
+  check(result, left.update_block(lower, upper, right.block(lower, upper)));
+
+  const auto block_perm = compressed_left.block(lower, upper, -2.0, perm);
+  check(block_perm, left.block(lower, upper, -2.0, perm));
+}
+
+BOOST_AUTO_TEST_CASE(equality) {
+  BOOST_CHECK(compressed_shape == CompressedSparseShape<float>(sparse_shape));
+  BOOST_CHECK(!(compressed_shape == compressed_left));
+  BOOST_CHECK(is_replicated(*GlobalFixture::world, compressed_shape));
+}
+
+BOOST_AUTO_TEST_CASE(expressions) {
+  using sparse_array_t = TSpArrayD;
+  using compressed_array_t = DistArray<TensorD, CompressedSparsePolicy>;
+  World& world = *GlobalFixture::world;
+  TiledRange trange{{0, 2, 5, 7, 10, 12}, {0, 3, 4, 9, 11}};
+
+  // Make the same sparse data with both policies; about a third of the tiles
+  // of a and half of the tiles of b are nonzero
+  auto make_tile = [&trange](const std::size_t ord) {
+    TensorD tile(trange.make_tile_range(ord));
+    for (std::size_t x = 0ul; x < tile.size(); ++x)
+      tile[x] = double((7 * ord + 3 * x) % 17) - 8.0;
+    return tile;
+  };
+  auto make_arrays = [&](const std::size_t stride) {
+    Tensor<float> norms(trange.tiles_range(), 0.0f);
+    for (std::size_t ord = 0ul; ord < norms.size(); ord += stride)
+      norms[ord] = make_tile(ord).norm();
+    sparse_array_t array(world, trange,
+                         SparseShape<float>(world, norms, trange));
+    compressed_array_t compressed(
+        world, trange, CompressedSparseShape<float>(world, norms, trange));
+    BOOST_REQUIRE_EQUAL(compressed.shape().nnz(),
+                        (norms.size() + stride - 1) / stride);
+    for (const auto ord : *array.pmap()) {
+      if (array.is_zero(ord)) continue;
+      array.set(ord, make_tile(ord));
+      compressed.set(ord, make_tile(ord));
+    }
+    return std::make_pair(array, compressed);
+  };
+  const auto a_arrays = make_arrays(3ul), b_arrays = make_arrays(2ul);
+  const auto& a = a_arrays.first;
+  const auto& ca = a_arrays.second;
+  const auto& b = b_arrays.first;
+  const auto& cb = b_arrays.second;
+
+  auto compare = [&](const sparse_array_t& result,
+                     const compressed_array_t& compressed_result) {
+    BOOST_REQUIRE_EQUAL(compressed_result.trange(), result.trange());
+    const auto volume = result.trange().tiles_range().volume();
+    for (std::size_t ord = 0ul; ord < volume; ++ord) {
+      BOOST_CHECK_CLOSE(compressed_result.shape()[ord], result.shape()[ord],
+                        tolerance);
+      BOOST_REQUIRE_EQUAL(compressed_result.is_zero(ord), result.is_zero(ord));
+      if (result.is_zero(ord)) continue;
+      const auto tile = result.find(ord).get();
+      const auto compressed_tile = compressed_result.find(ord).get();
+      BOOST_CHECK_EQUAL_COLLECTIONS(compressed_tile.begin(),
+                                    compressed_tile.end(), tile.begin(),
+                                    tile.end());
+    }
+  };
+
+  sparse_array_t c;
+  compressed_array_t cc;
+  c("i,j") = 2.0 * (a("i,j") + b("i,j"));
+  cc("i,j") = 2.0 * (ca("i,j") + cb("i,j"));
+  compare(c, cc);
+
+  c("j,i") = a("i,j") - b("i,j");
+  cc("j,i") = ca("i,j") - cb("i,j");
+  compare(c, cc);
+
+  c("i,j") = a("i,j") * b("i,j");
+  cc("i,j") = ca("i,j") * cb("i,j");
+  compare(c, cc);
+
+  c("i,k") = a("i,j") * b("k,j");
+  cc("i,k") = ca("i,j") * cb("k,j");
+  compare(c, cc);
+
+  c("i,j") = 3.0 * a("i,j").block({1, 1}, {4, 3});
+  cc("i,j") = 3.0 * ca("i,j").block({1, 1}, {4, 3});
+  compare(c, cc);
+
+  c("i,j") = a("i,j");
+  cc("i,j") = ca("i,j");
+  c("i,j").block({0, 1}, {2, 3}) = b("i,j").block({3, 0}, {5, 2});
+  cc("i,j").block({0, 1}, {2, 3}) = cb("i,j").block({3, 0}, {5, 2});
+  compare(c, cc);
+
+  c.truncate();
+  cc.truncate();
+  compare(c, cc);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
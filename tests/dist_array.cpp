@@ -27,6 +27,7 @@
 
 #include <array_fixture.h>
 #include "../src/TiledArray/dist_array.h"
+#include "TiledArray/pmap/round_robin_pmap.h"
 #include "tiledarray.h"
 #include "unit_test_config.h"
 
@@ -426,6 +427,47 @@ BOOST_AUTO_TEST_CASE(fill_tiles) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(fill_random) {
+  TArrayD a(world, tr), b(world, tr);
+
+  // the values are reproducible from the seed
+  TiledArray::set_random_seed(1);
+  a.fill_random();
+  TiledArray::set_random_seed(1);
+  b.fill_random();
+  for (auto it = a.begin(); it != a.end(); ++it) {
+    const auto tile_a = it->get();
+    const auto tile_b = b.find(it.index()).get();
+    BOOST_CHECK_EQUAL(tile_a.range(), tile_b.range());
+    for (std::size_t i = 0; i < tile_a.size(); ++i) {
+      BOOST_CHECK_EQUAL(tile_a[i], tile_b[i]);
+      BOOST_CHECK(tile_a[i] >= 0.0 && tile_a[i] < 1.0);
+    }
+  }
+
+  // the next sequence differs
+  TArrayD c(world, tr);
+  c.fill_random();
+  auto tile_a = a.find(0).get();
+  auto tile_b = c.find(0).get();
+  BOOST_CHECK(tile_a[0] != tile_b[0]);
+
+  // and so do the tiles
+  tile_b = a.find(1).get();
+  BOOST_CHECK(tile_a[0] != tile_b[0]);
+}
+
+BOOST_AUTO_TEST_CASE(init_elements_by_ordinal) {
+  TArrayI a(world, tr);
+  a.init_elements([](const std::size_t ord) { return int(ord); });
+  const auto& elements = tr.elements_range();
+  for (auto it = a.begin(); it != a.end(); ++it) {
+    const auto tile = it->get();
+    for (const auto& idx : tile.range())
+      BOOST_CHECK_EQUAL(tile[idx], int(elements.ordinal(idx)));
+  }
+}
+
 BOOST_AUTO_TEST_CASE(assign_tiles) {
   std::vector<int> data;
   ArrayN a(world, tr);
@@ -529,6 +571,69 @@ BOOST_AUTO_TEST_CASE(make_replicated) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(make_replicated_by_node) {
+  // Get a copy of the original process map
+  std::shared_ptr<ArrayN::pmap_interface> distributed_pmap = a.pmap();
+
+  // Convert array to a replicated array via the node leaders.
+  BOOST_REQUIRE_NO_THROW(a.make_replicated(ReplicationAlgorithm::node));
+
+  // Check that all the data is local
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    BOOST_CHECK(a.is_local(i));
+    Future<ArrayN::value_type> tile = a.find(i);
+    BOOST_CHECK_EQUAL(tile.get().range(), a.trange().make_tile_range(i));
+    for (ArrayN::value_type::const_iterator it = tile.get().begin();
+         it != tile.get().end(); ++it)
+      BOOST_CHECK_EQUAL(*it, distributed_pmap->owner(i) + 1);
+  }
+
+  // Replicating a sparse array only moves the nonzero tiles
+  BOOST_REQUIRE_NO_THROW(b.make_replicated(ReplicationAlgorithm::node));
+  for (std::size_t i = 0; i < b.size(); ++i) {
+    BOOST_CHECK(b.is_local(i));
+    if (!b.is_zero(i))
+      BOOST_CHECK_EQUAL(b.find(i).get().range(),
+                        b.trange().make_tile_range(i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(make_symmetric) {
+  using TiledArray::symmetry::Phase;
+  using TiledArray::symmetry::Permutation;
+  using TiledArray::symmetry::TileSymmetry;
+
+  // an antisymmetric matrix, x(i,j) = i - j
+  TiledRange1 tr1{0, 2, 5, 6, 10};
+  TiledRange tr2{tr1, tr1};
+  TArrayI x(world, tr2);
+  x.init_elements([](const auto& i) { return int(i[0]) - int(i[1]); });
+  TArrayI ref = x;
+
+  const auto symm = std::make_shared<const TileSymmetry>(
+      std::map<Permutation, Phase>{{Permutation{1, 0}, Phase::minus}});
+  BOOST_REQUIRE_NO_THROW(x.make_symmetric(symm));
+  BOOST_CHECK(x.symmetry() == symm);
+
+  // only the unique tiles are stored and may be set
+  for (auto it = x.begin(); it != x.end(); ++it)
+    BOOST_CHECK(it.index()[0] <= it.index()[1]);
+
+  // the other tiles are permuted and negated
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    const auto tile = x.find(i).get();
+    const auto ref_tile = ref.find(i).get();
+    BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+    for (std::size_t j = 0; j < ref_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(tile[j], ref_tile[j]);
+  }
+
+  // the symmetry must be compatible with the tiling
+  TArrayI y(world, TiledRange{tr1, TiledRange1{0, 5, 10}});
+  y.fill(1);
+  BOOST_CHECK_THROW(y.make_symmetric(symm), TiledArray::Exception);
+}
+
 BOOST_AUTO_TEST_CASE(serialization_by_tile) {
   decltype(a) acopy(a.world(), a.trange(), a.shape());
 
@@ -666,6 +771,87 @@ BOOST_AUTO_TEST_CASE(parallel_sparse_serialization) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(checkpoint) {
+  char file_name[] = "tmp.XXXXXX";
+  mktemp(file_name);
+  world.gop.broadcast(file_name, sizeof(file_name), 0);
+
+  write_checkpoint(a, file_name);
+  auto aread = read_checkpoint<decltype(a)>(world, file_name);
+
+  BOOST_CHECK_EQUAL(aread.trange(), a.trange());
+  BOOST_REQUIRE(aread.shape() == a.shape());
+  BOOST_CHECK_EQUAL_COLLECTIONS(aread.begin(), aread.end(), a.begin(), a.end());
+  world.gop.fence();
+  if (world.rank() == 0) std::remove(file_name);
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint_redistribute) {
+  char file_name[] = "tmp.XXXXXX";
+  mktemp(file_name);
+  world.gop.broadcast(file_name, sizeof(file_name), 0);
+
+  // Write from a hashed distribution ...
+  const auto ntiles = a.trange().tiles_range().volume();
+  auto hash_pmap = std::make_shared<detail::HashPmap>(world, ntiles, 3ul);
+  decltype(a) a_hashed(world, a.trange(), a.shape(), hash_pmap);
+  for (const auto ord : *hash_pmap) a_hashed.set(ord, a.find(ord));
+  world.gop.fence();
+  write_checkpoint(a_hashed, file_name);
+
+  // ... and restart on the default (blocked) and on a round-robin one
+  auto blocked_read = read_checkpoint<decltype(a)>(world, file_name);
+  auto cyclic_pmap = std::make_shared<detail::RoundRobinPmap>(world, ntiles);
+  auto cyclic_read =
+      read_checkpoint<decltype(a)>(world, file_name, cyclic_pmap);
+  BOOST_CHECK(cyclic_read.pmap() == cyclic_pmap);
+
+  for (auto* aread : {&blocked_read, &cyclic_read}) {
+    BOOST_CHECK_EQUAL(aread->trange(), a.trange());
+    BOOST_REQUIRE(aread->shape() == a.shape());
+    for (std::size_t ord = 0ul; ord < ntiles; ++ord) {
+      auto tile = a.find(ord).get();
+      auto tile_read = aread->find(ord).get();
+      BOOST_CHECK_EQUAL(tile_read.range(), tile.range());
+      BOOST_CHECK_EQUAL_COLLECTIONS(tile_read.begin(), tile_read.end(),
+                                    tile.begin(), tile.end());
+    }
+  }
+  world.gop.fence();
+  if (world.rank() == 0) std::remove(file_name);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_checkpoint) {
+  char file_name[] = "tmp.XXXXXX";
+  mktemp(file_name);
+  world.gop.broadcast(file_name, sizeof(file_name), 0);
+
+  write_checkpoint(b, file_name);
+
+  // Read the tiles with a different distribution
+  auto pmap = std::make_shared<detail::HashPmap>(
+      world, b.trange().tiles_range().volume(), 7ul);
+  auto bread = read_checkpoint<decltype(b)>(world, file_name, pmap);
+
+  BOOST_CHECK_EQUAL(bread.trange(), b.trange());
+  BOOST_REQUIRE(bread.shape() == b.shape());
+  BOOST_CHECK(bread.pmap() == pmap);
+  for (std::size_t ord = 0ul; ord < b.trange().tiles_range().volume(); ++ord) {
+    if (!b.is_zero(ord)) {
+      auto tile = b.find(ord).get();
+      auto tile_read = bread.find(ord).get();
+      BOOST_CHECK_EQUAL_COLLECTIONS(tile_read.begin(), tile_read.end(),
+                                    tile.begin(), tile.end());
+    }
+  }
+  world.gop.fence();
+  if (world.rank() == 0) std::remove(file_name);
+
+  // Reading a file that is not a checkpoint fails
+  BOOST_CHECK_THROW(read_checkpoint<decltype(b)>(world, "no such file"),
+                    TiledArray::Exception);
+}
+
 BOOST_AUTO_TEST_CASE(issue_225) {
   TiledRange1 TR0{0, 3, 8, 10};
   TiledRange1 TR1{0, 4, 7, 10};
@@ -373,6 +373,55 @@ BOOST_AUTO_TEST_CASE(perm_eval) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(adaptive_eval) {
+  const SummaDepthConfig default_config = summa_depth_config();
+
+  // Compute the reference contraction
+  const matrix_type l = copy_to_matrix(left, 1),
+                    r = copy_to_matrix(right, GlobalFixture::dim - 1);
+  const matrix_type reference = l * r;
+
+  // Check that the result does not depend on how the depth changes during
+  // the evaluation: {grow ratio, shrink ratio} = {-1, -1} always grows the
+  // depth, {2, 2} always shrinks it.
+  for (double ratio : {-1.0, 2.0}) {
+    SummaDepthConfig config;
+    config.adaptive = true;
+    config.max_depth = 4ul;
+    config.window = 1ul;
+    config.grow_ratio = ratio;
+    config.shrink_ratio = ratio;
+    set_summa_depth_config(config);
+
+    auto contract = make_contract_eval(
+        left_arg, right_arg, left_arg.world(), DenseShape(), pmap,
+        Permutation(),
+        make_contract(2u, left_arg.trange().tiles_range().rank(),
+                      right_arg.trange().tiles_range().rank()));
+    using dist_eval_type = decltype(contract);
+
+    // Check evaluation
+    BOOST_REQUIRE_NO_THROW(contract.eval());
+    BOOST_REQUIRE_NO_THROW(contract.wait());
+
+    for (auto index : *contract.pmap()) {
+      dist_eval_type::eval_type eval_tile;
+      BOOST_REQUIRE_NO_THROW(eval_tile = contract.get(index).get());
+      BOOST_CHECK(!eval_tile.empty());
+
+      if (!eval_tile.empty()) {
+        BOOST_CHECK(eigen_map(eval_tile) ==
+                    reference.block(eval_tile.range().lobound(0),
+                                    eval_tile.range().lobound(1),
+                                    eval_tile.range().extent(0),
+                                    eval_tile.range().extent(1)));
+      }
+    }
+  }
+
+  set_summa_depth_config(default_config);
+}
+
 BOOST_AUTO_TEST_CASE(sparse_eval) {
   auto do_sparse_eval = [&](bool force_shape) -> void {
     TSpArrayI left(*GlobalFixture::world, tr, make_shape(tr, 0.1, 23));
@@ -101,4 +101,80 @@ BOOST_AUTO_TEST_CASE(array_operator) {
   BOOST_CHECK_THROW(t.get(t.max_size() + 2), TiledArray::Exception);
 }
 
+BOOST_AUTO_TEST_CASE(spill) {
+  // Keep a single local element in memory
+  const SpillConfig config = spill_config();
+  SpillConfig spill = config;
+  spill.memory_budget = sizeof(int);
+  set_spill_config(spill);
+
+  {
+    Storage s(world, 10, pmap);
+    const std::size_t spills0 = detail::TileSpillManager::instance().spills();
+    std::size_t nlocal = 0ul;
+    for (std::size_t i = 0; i < s.max_size(); ++i) {
+      if (s.is_local(i)) {
+        s.set(i, int(i) * 10);
+        ++nlocal;
+      }
+    }
+    if (nlocal > 1ul)
+      BOOST_CHECK_GE(detail::TileSpillManager::instance().spills(),
+                     spills0 + nlocal - 1ul);
+
+    // Spilled elements are read back when accessed
+    for (std::size_t i = 0; i < s.max_size(); ++i)
+      if (s.is_local(i)) BOOST_CHECK_EQUAL(s.get(i).get(), int(i) * 10);
+    for (std::size_t i = s.max_size(); i > 0ul; --i)
+      if (s.is_local(i - 1ul))
+        BOOST_CHECK_EQUAL(s.get_local(i - 1ul).get(), int(i - 1ul) * 10);
+
+    world.gop.fence();
+  }
+  BOOST_CHECK_EQUAL(detail::TileSpillManager::instance().bytes(), 0ul);
+
+  set_spill_config(config);
+}
+
+BOOST_AUTO_TEST_CASE(spill_pinned) {
+  // Keep a single local element in memory
+  const SpillConfig config = spill_config();
+  SpillConfig spill = config;
+  spill.memory_budget = sizeof(int);
+  set_spill_config(spill);
+
+  {
+    Storage s(world, 10, pmap);
+    std::vector<Storage::future> copies;
+    for (std::size_t i = 0; i < s.max_size(); ++i) {
+      if (s.is_local(i)) {
+        s.set(i, int(i) * 10);
+        copies.push_back(s.get(i));
+      }
+    }
+
+    // An element referenced with get_local() is no longer spilled
+    std::size_t first = s.max_size();
+    for (std::size_t i = 0; i < s.max_size() && first == s.max_size(); ++i)
+      if (s.is_local(i)) first = i;
+    if (first < s.max_size()) {
+      const Storage::future& pinned = s.get_local(first);
+      for (std::size_t i = 0; i < s.max_size(); ++i)
+        if (s.is_local(i)) BOOST_CHECK_EQUAL(s.get(i).get(), int(i) * 10);
+      BOOST_REQUIRE(pinned.probe());
+      BOOST_CHECK_EQUAL(pinned.get(), int(first) * 10);
+    }
+
+    // Copies of futures are unaffected by spilling
+    std::size_t c = 0ul;
+    for (std::size_t i = 0; i < s.max_size(); ++i)
+      if (s.is_local(i)) BOOST_CHECK_EQUAL(copies[c++].get(), int(i) * 10);
+
+    world.gop.fence();
+  }
+  BOOST_CHECK_EQUAL(detail::TileSpillManager::instance().bytes(), 0ul);
+
+  set_spill_config(config);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -362,4 +362,60 @@ BOOST_AUTO_TEST_CASE(array_to_vector) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(gather_array_to_matrix) {
+  // Fill local tiles with data
+  GlobalFixture::world->srand(27);
+  for (const auto i : *array.pmap()) {
+    TArrayI::value_type tile(array.trange().make_tile_range(i));
+    for (auto& value : tile) value = GlobalFixture::world->rand();
+    array.set(i, tile);
+  }
+
+  const ProcessID root = GlobalFixture::world->size() - 1;
+  for (const std::size_t max_pending_tiles : {0ul, 2ul}) {
+    BOOST_CHECK_NO_THROW(
+        matrix = gather_array_to_eigen(array, root, max_pending_tiles));
+
+    if (GlobalFixture::world->rank() == root) {
+      BOOST_CHECK_EQUAL(matrix.rows(),
+                        array.trange().elements_range().extent(0));
+      BOOST_CHECK_EQUAL(matrix.cols(),
+                        array.trange().elements_range().extent(1));
+      for (const auto& index : array.range()) {
+        auto tile = array.find(index).get();
+        for (const auto& i : tile.range())
+          BOOST_CHECK_EQUAL(matrix(i[0], i[1]), tile[i]);
+      }
+    } else {
+      BOOST_CHECK_EQUAL(matrix.size(), 0);
+    }
+  }
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE(scatter_matrix_to_array) {
+  const ProcessID root = GlobalFixture::world->size() - 1;
+  if (GlobalFixture::world->rank() == root)
+    matrix = decltype(matrix)::Random(matrix.rows(), matrix.cols());
+  else
+    matrix.resize(0, 0);
+
+  for (const std::size_t max_pending_tiles : {0ul, 2ul}) {
+    BOOST_CHECK_NO_THROW(
+        (array = scatter_eigen_to_array<TArrayI>(*GlobalFixture::world, trange,
+                                                 matrix, root, {},
+                                                 max_pending_tiles)));
+
+    // Check that the data in array is equal to that in matrix
+    if (GlobalFixture::world->rank() == root) {
+      for (const auto& index : array.range()) {
+        auto tile = array.find(index).get();
+        for (const auto& i : tile.range())
+          BOOST_CHECK_EQUAL(tile[i], matrix(i[0], i[1]));
+      }
+    }
+    GlobalFixture::world->gop.fence();
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,57 @@
 using namespace TiledArray;
 using namespace TiledArray::expressions;
 
+namespace {
+
+/// Modes of an inner annotation of single-letter indices
+std::string letters(const std::string& vars) {
+  std::string rv;
+  for (const auto c : vars)
+    if (c != ',') rv.push_back(c);
+  return rv;
+}
+
+/// Extent of the inner mode labeled \c c
+std::size_t inner_extent(const char c) { return 2ul + (c - 'a') % 3; }
+
+/// An inner tensor with modes \c vars whose elements depend on \c seed
+Tensor<double> make_inner(const std::string& vars, const std::size_t seed) {
+  std::vector<std::size_t> extents;
+  for (const auto c : letters(vars)) extents.push_back(inner_extent(c));
+  Tensor<double> rv{Range(extents)};
+  for (std::size_t x = 0ul; x < rv.size(); ++x)
+    rv[x] = double((seed + 7 * x) % 13) - 6.0;
+  return rv;
+}
+
+/// Add the contraction of two inner tensors to \c result with a loop over
+/// every combination of the indices
+void reference_contract(Tensor<double>& result, const std::string& ovars,
+                        const std::string& lvars, const std::string& rvars,
+                        const Tensor<double>& lhs, const Tensor<double>& rhs) {
+  const auto o = letters(ovars), l = letters(lvars), r = letters(rvars);
+  std::string all = o;
+  for (const auto c : l + r)
+    if (all.find(c) == std::string::npos) all.push_back(c);
+  std::vector<std::size_t> idx(all.size(), 0ul);
+  auto select = [&](const std::string& vars) {
+    std::vector<std::size_t> rv;
+    for (const auto c : vars) rv.push_back(idx[all.find(c)]);
+    return rv;
+  };
+  while (true) {
+    result(select(o)) += lhs(select(l)) * rhs(select(r));
+    std::size_t d = 0ul;
+    for (; d < all.size(); ++d) {
+      if (++idx[d] < inner_extent(all[d])) break;
+      idx[d] = 0ul;
+    }
+    if (d == all.size()) break;
+  }
+}
+
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE(einsumfxn)
 
 BOOST_AUTO_TEST_CASE(ik_mn_eq_ij_mn_times_jk_mn){
@@ -239,4 +290,164 @@ BOOST_AUTO_TEST_CASE(ij_mn_eq_ij_mn_times_ji_mn){
 }
 
 
+BOOST_AUTO_TEST_CASE(ik_mp_eq_ij_mn_times_jk_pn){
+  using dist_array_t = DistArray<Tensor<Tensor<double>>, DensePolicy>;
+  auto& world = TiledArray::get_default_world();
+  TiledRange trange{{0, 2, 5},{0, 2, 5}};
+
+  // The inner contraction maps to GEMM with a transposed right-hand side;
+  // the extents of the free inner modes differ between outer tiles
+  auto make_tile = [](const Range& range, const std::size_t mode) {
+    Tensor<Tensor<double>> tile(range);
+    const auto lo = range.lobound_data();
+    for (std::size_t i = 0ul; i < tile.size(); ++i) {
+      Tensor<double> inner(Range{2 + lo[mode] % 2, 3});
+      for (std::size_t j = 0ul; j < inner.size(); ++j)
+        inner[j] = double((lo[0] + 3 * lo[1] + i + j) % 11) - 5.0;
+      tile[i] = inner;
+    }
+    return tile;
+  };
+  dist_array_t lhs(world, trange), rhs(world, trange);
+  lhs.init_tiles([&](const Range& range) { return make_tile(range, 0); });
+  rhs.init_tiles([&](const Range& range) { return make_tile(range, 1); });
+
+  dist_array_t out;
+  einsum(out("i,k;m,p"), lhs("i,j;m,n"), rhs("j,k;p,n"));
+
+  // Compare with explicit loops over all elements
+  auto element = [](const dist_array_t& array, std::size_t i, std::size_t j) {
+    const std::vector<std::size_t> idx{i, j};
+    return array.find(array.trange().element_to_tile(idx)).get()(i, j);
+  };
+  const std::size_t extent = trange.dim(0).extent();
+  for (std::size_t i = 0ul; i < extent; ++i) {
+    for (std::size_t k = 0ul; k < extent; ++k) {
+      const auto result = element(out, i, k);
+      for (std::size_t m = 0ul; m < result.range().extent(0); ++m) {
+        for (std::size_t p = 0ul; p < result.range().extent(1); ++p) {
+          double expected = 0.0;
+          for (std::size_t j = 0ul; j < extent; ++j) {
+            const auto l = element(lhs, i, j);
+            const auto r = element(rhs, j, k);
+            for (std::size_t n = 0ul; n < l.range().extent(1); ++n)
+              expected += l(m, n) * r(p, n);
+          }
+          BOOST_CHECK_CLOSE(result(m, p), expected, 1e-10);
+        }
+      }
+    }
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE(ik_inner_gemm_permutations){
+  using dist_array_t = DistArray<Tensor<Tensor<double>>, DensePolicy>;
+  auto& world = TiledArray::get_default_world();
+  TiledRange trange{{0, 2, 5},{0, 2, 5}};
+  const std::size_t extent = trange.dim(0).extent();
+
+  // Inner annotations {result, lhs, rhs} that exercise each layout handled
+  // by kernels::GemmPlan
+  const std::vector<std::array<std::string, 3>> cases{
+      {"m,p", "n,m,q", "n,q,p"},    // lhs permuted
+      {"m,p", "m,n,q", "q,p,n"},    // rhs permuted
+      {"p,m", "m,n", "n,p"},        // result permuted
+      {"b,m,p", "b,m,n", "b,n,p"},  // one GEMM per b, m and p > 1
+      {"m,b,p", "n,b,m", "p,n,b"}}; // every tensor permuted, one GEMM per b
+
+  auto element = [](const dist_array_t& array, std::size_t i, std::size_t j) {
+    const std::vector<std::size_t> idx{i, j};
+    return array.find(array.trange().element_to_tile(idx)).get()(i, j);
+  };
+  for (const auto& vars : cases) {
+    BOOST_TEST_CONTEXT(vars[0] + " = " + vars[1] + " * " + vars[2]) {
+      auto make_tile = [&](const Range& range, const std::string& ivars) {
+        Tensor<Tensor<double>> tile(range);
+        const auto lo = range.lobound_data();
+        for (std::size_t i = 0ul; i < tile.size(); ++i)
+          tile[i] = make_inner(ivars, lo[0] + 3 * lo[1] + i);
+        return tile;
+      };
+      dist_array_t lhs(world, trange), rhs(world, trange);
+      lhs.init_tiles(
+          [&](const Range& range) { return make_tile(range, vars[1]); });
+      rhs.init_tiles(
+          [&](const Range& range) { return make_tile(range, vars[2]); });
+
+      dist_array_t out;
+      einsum(out("i,k;" + vars[0]), lhs("i,j;" + vars[1]),
+             rhs("j,k;" + vars[2]));
+
+      for (std::size_t i = 0ul; i < extent; ++i) {
+        for (std::size_t k = 0ul; k < extent; ++k) {
+          const auto result = element(out, i, k);
+          Tensor<double> expected(make_inner(vars[0], 0ul).range(), 0.0);
+          for (std::size_t j = 0ul; j < extent; ++j)
+            reference_contract(expected, vars[0], vars[1], vars[2],
+                               element(lhs, i, j), element(rhs, j, k));
+          BOOST_REQUIRE_EQUAL(result.range(), expected.range());
+          for (std::size_t x = 0ul; x < expected.size(); ++x)
+            BOOST_CHECK_CLOSE(result[x], expected[x], 1e-10);
+        }
+      }
+      world.gop.fence();
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ik_mn_eq_ij_mn_times_jk_mn_sparse){
+  using dense_array_t = DistArray<Tensor<Tensor<double>>, DensePolicy>;
+  using sparse_array_t = DistArray<Tensor<Tensor<double>>, SparsePolicy>;
+  auto& world = TiledArray::get_default_world();
+  TiledRange trange{{0, 2, 5},{0, 3, 4}};
+
+  // Tile (0,1) of lhs is zero
+  Tensor<float> lhs_norms(trange.tiles_range(), 1.0f);
+  lhs_norms(0, 1) = 0.0f;
+  Tensor<float> rhs_norms(trange.tiles_range(), 1.0f);
+  auto make_tile = [](const Range& range) {
+    Tensor<Tensor<double>> tile(range);
+    for (std::size_t i = 0ul; i < tile.size(); ++i) {
+      const auto lo = range.lobound_data();
+      tile[i] = Tensor<double>(Range{2, 3}, double(lo[0] + 2 * lo[1] + i + 1));
+    }
+    return tile;
+  };
+  auto make_zero_tile = [](const Range& range) {
+    return Tensor<Tensor<double>>(range, Tensor<double>(Range{2, 3}, 0.0));
+  };
+
+  dense_array_t dense_lhs(world, trange), dense_rhs(world, trange);
+  for (auto it = dense_lhs.begin(); it != dense_lhs.end(); ++it) {
+    const auto range = dense_lhs.trange().make_tile_range(it.index());
+    *it = lhs_norms[it.ordinal()] == 0.0f ? make_zero_tile(range)
+                                          : make_tile(range);
+  }
+  dense_rhs.init_tiles(make_tile);
+  sparse_array_t sparse_lhs(world, trange,
+                            SparseShape<float>(lhs_norms, trange));
+  sparse_array_t sparse_rhs(world, trange,
+                            SparseShape<float>(rhs_norms, trange));
+  sparse_lhs.init_tiles(make_tile);
+  sparse_rhs.init_tiles(make_tile);
+
+  dense_array_t dense_out;
+  sparse_array_t sparse_out;
+  einsum(dense_out("i,k;m,n"), dense_lhs("i,j;m,n"), dense_rhs("j,k;m,n"));
+  einsum(sparse_out("i,k;m,n"), sparse_lhs("i,j;m,n"), sparse_rhs("j,k;m,n"));
+
+  BOOST_REQUIRE(dense_out.trange() == sparse_out.trange());
+  for (auto idx : dense_out.range()) {
+    const auto dense_tile = dense_out.find(idx).get();
+    if (sparse_out.is_zero(idx)) {
+      for (const auto& elem : dense_tile)
+        BOOST_CHECK(elem.empty() || elem.norm() == 0.0);
+    } else {
+      BOOST_CHECK(dense_tile == sparse_out.find(idx).get());
+    }
+  }
+  world.gop.fence();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
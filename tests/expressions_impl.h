@@ -2541,6 +2541,97 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_non_uniform2, F, Fixtures, F) {
   }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_summa_replication, F, Fixtures, F) {
+  // Construct the tiled range
+  std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
+  std::array<std::size_t, 2> tiling2 = {{0, 40}};
+  TiledRange1 tr1_1(tiling1.begin(), tiling1.end());
+  TiledRange1 tr1_2(tiling2.begin(), tiling2.end());
+  std::array<TiledRange1, 4> tiling4 = {{tr1_1, tr1_2, tr1_1, tr1_1}};
+  TiledRange trange(tiling4.begin(), tiling4.end());
+
+  const std::size_t m = 5;
+  const std::size_t k = 40 * 5 * 5;
+  const std::size_t n = 5;
+
+  // Construct the test arguments
+  auto left = F::make_array(trange);
+  auto right = F::make_array(trange);
+
+  // Construct the reference matrices
+  typename F::Matrix left_ref(m, k);
+  typename F::Matrix right_ref(n, k);
+
+  // Initialize input
+  F::rand_fill_matrix_and_array(left_ref, left, 23);
+  F::rand_fill_matrix_and_array(right_ref, right, 42);
+
+  // Compute the reference result
+  typename F::Matrix result_ref = left_ref * right_ref.transpose();
+
+  // The number of layers is clamped to the number of processes, so this
+  // also covers the 2D algorithm when running on a single process.
+  for (unsigned int layers : {1u, 2u, 3u, 4u}) {
+    // Compute the result to be tested
+    typename F::TArray result;
+    BOOST_REQUIRE_NO_THROW(
+        result("x,y") = (left("x,i,j,k") * right("y,i,j,k"))
+                            .set_summa_replication(layers));
+
+    // Check the result
+    for (auto it = result.begin(); it != result.end(); ++it) {
+      typename F::TArray::value_type tile = *it;
+      for (Range::const_iterator rit = tile.range().begin();
+           rit != tile.range().end(); ++rit) {
+        const std::size_t elem_index = result.elements_range().ordinal(*rit);
+        BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+      }
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_summa_replication_long_inner, F,
+                                 Fixtures, F) {
+  // More inner tiles than outer tiles, so that the broadcast keys of the
+  // argument tiles outnumber the result tiles
+  TiledRange1 tr_m{0, 2, 4};
+  TiledRange1 tr_k{0, 2, 4, 7};
+  TiledRange left_trange{tr_m, tr_k};
+  TiledRange right_trange{tr_k, tr_m};
+
+  // Construct the test arguments
+  auto left = F::make_array(left_trange);
+  auto right = F::make_array(right_trange);
+
+  // Construct the reference matrices
+  typename F::Matrix left_ref(4, 7);
+  typename F::Matrix right_ref(7, 4);
+
+  // Initialize input
+  F::rand_fill_matrix_and_array(left_ref, left, 23);
+  F::rand_fill_matrix_and_array(right_ref, right, 42);
+
+  // Compute the reference result
+  typename F::Matrix result_ref = left_ref * right_ref;
+
+  for (unsigned int layers : {1u, 2u, 3u}) {
+    // Compute the result to be tested
+    typename F::TArray result;
+    BOOST_REQUIRE_NO_THROW(result("i,j") = (left("i,k") * right("k,j"))
+                                               .set_summa_replication(layers));
+
+    // Check the result
+    for (auto it = result.begin(); it != result.end(); ++it) {
+      typename F::TArray::value_type tile = *it;
+      for (Range::const_iterator rit = tile.range().begin();
+           rit != tile.range().end(); ++rit) {
+        const std::size_t elem_index = result.elements_range().ordinal(*rit);
+        BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+      }
+    }
+  }
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_plus_reduce, F, Fixtures, F) {
   // Construct the tiled range
   std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
@@ -2890,6 +2981,167 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(inner_product, F, Fixtures, F) {
   BOOST_CHECK_EQUAL(result, expected);
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(plan, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  typename F::TArray r, ref;
+
+  auto plan = make_plan(r("i,j"), 2 * a("i,k,l") * b("j,k,l"));
+  BOOST_CHECK(!plan.compiled());
+
+  auto check = [&]() {
+    ref("i,j") = 2 * a("i,k,l") * b("j,k,l");
+    BOOST_CHECK_EQUAL(r.trange(), ref.trange());
+    for (std::size_t i = 0ul; i < ref.size(); ++i) {
+      BOOST_CHECK_EQUAL(r.is_zero(i), ref.is_zero(i));
+      if (ref.is_zero(i)) continue;
+      auto r_tile = r.find(i).get();
+      auto ref_tile = ref.find(i).get();
+      for (std::size_t j = 0ul; j < ref_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(r_tile[j], ref_tile[j]);
+    }
+  };
+
+  // the first evaluation compiles the plan, the second reuses it
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  check();
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  check();
+  BOOST_CHECK_EQUAL(plan.compilations(), 1ul);
+
+  // new data with the same structure reuses the plan
+  typename F::TArray a_new(a.world(), a.trange(), a.shape());
+  F::random_fill(a_new);
+  a = a_new;
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  check();
+  BOOST_CHECK_EQUAL(plan.compilations(), 1ul);
+
+  // a new tiled range recompiles the plan
+  std::array<std::size_t, 3> tiling = {{0, 3, 7}};
+  TiledRange1 tr1(tiling.begin(), tiling.end());
+  TiledRange trange{tr1, tr1, tr1};
+  a = F::make_array(trange);
+  b = F::make_array(trange);
+  F::random_fill(a);
+  F::random_fill(b);
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  check();
+  BOOST_CHECK_EQUAL(plan.compilations(), 2ul);
+
+  BOOST_REQUIRE_NO_THROW(plan.invalidate());
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  check();
+  BOOST_CHECK_EQUAL(plan.compilations(), 3ul);
+
+  // new norms with the same zero tiles recompile the plan unless only the
+  // zero tiles are compared
+  auto zplan = make_plan(r("i,j"), a("i,k,l") * b("j,k,l"),
+                         PlanReuse::same_zero_tiles);
+  BOOST_REQUIRE_NO_THROW(zplan.eval());
+  a("i,j,k") = 2 * a("i,j,k");
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  BOOST_REQUIRE_NO_THROW(zplan.eval());
+  BOOST_CHECK_EQUAL(zplan.compilations(), 1ul);
+  BOOST_CHECK_EQUAL(plan.compilations(),
+                    F::TArray::shape_type::is_dense() ? 3ul : 4ul);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(predict_cost, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& c = F::c;
+  World& world = *GlobalFixture::world;
+  const std::size_t volume = a.trange().elements_range().volume();
+  const std::size_t extent = a.trange().elements_range().extent(0);
+
+  // the prediction does not assign the result
+  typename F::TArray r;
+  ExprCost cost(0);
+  BOOST_REQUIRE_NO_THROW(cost =
+                             (a("i,k,l") * b("j,k,l")).predict_cost(r("i,j")));
+  BOOST_CHECK(!r.is_initialized());
+  BOOST_REQUIRE_EQUAL(cost.size(), std::size_t(world.size()));
+
+  // every tile product of the contraction is counted once
+  const auto total = cost.total();
+  if (F::TArray::shape_type::is_dense())
+    BOOST_CHECK_EQUAL(total.flops, 2.0 * volume * extent);
+  else
+    BOOST_CHECK_LE(total.flops, 2.0 * volume * extent);
+  BOOST_CHECK_EQUAL(total.bytes_sent, total.bytes_received);
+  if (world.size() == 1) BOOST_CHECK_EQUAL(total.bytes_sent, 0ul);
+
+  // the tasks and the memory of the result tiles are counted
+  r("i,j") = a("i,k,l") * b("j,k,l");
+  std::size_t tiles = 0ul, result_memory = 0ul;
+  for (std::size_t i = 0ul; i < r.size(); ++i) {
+    if (r.is_zero(i)) continue;
+    ++tiles;
+    result_memory += r.trange().make_tile_range(i).volume() *
+                     sizeof(typename F::element_type);
+  }
+  BOOST_CHECK_GE(total.tasks, tiles);
+  BOOST_CHECK_GE(total.memory, result_memory);
+
+  // an element-wise operation costs one operation per element
+  BOOST_REQUIRE_NO_THROW(
+      cost = (a("i,j,k") + b("i,j,k")).predict_cost(c("i,j,k")));
+  if (F::TArray::shape_type::is_dense())
+    BOOST_CHECK_EQUAL(cost.total().flops, double(volume));
+  else
+    BOOST_CHECK_LE(cost.total().flops, double(volume));
+
+  // a plan predicts the cost of its compiled engine
+  auto plan = make_plan(r("i,j"), a("i,k,l") * b("j,k,l"));
+  BOOST_CHECK_EQUAL(plan.predict_cost().total().flops, total.flops);
+  BOOST_CHECK_EQUAL(plan.compilations(), 1ul);
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  BOOST_CHECK_EQUAL(plan.compilations(), 1ul);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(symmetric_result, F, Fixtures, F) {
+  using TiledArray::symmetry::Phase;
+  using TiledArray::symmetry::Permutation;
+  using TiledArray::symmetry::TileSymmetry;
+  auto& a = F::a;
+  typename F::TArray r, ref;
+
+  // a("i,k,l") * a("j,k,l") is symmetric in i and j
+  const auto symm = std::make_shared<const TileSymmetry>(
+      std::map<Permutation, Phase>{{Permutation{1, 0}, Phase::plus}});
+  BOOST_REQUIRE_NO_THROW(r("i,j") =
+                             (a("i,k,l") * a("j,k,l")).set_symmetry(symm));
+  ref("i,j") = a("i,k,l") * a("j,k,l");
+  BOOST_CHECK(r.symmetry() == symm);
+
+  // only the unique tiles are stored
+  for (auto it = r.begin(); it != r.end(); ++it)
+    BOOST_CHECK(symm->is_unique(it.index()));
+
+  // the other tiles are reconstructed
+  std::size_t redundant = 0ul;
+  for (std::size_t i = 0ul; i < ref.size(); ++i) {
+    BOOST_CHECK_EQUAL(r.is_zero(i), ref.is_zero(i));
+    if (ref.is_zero(i)) continue;
+    if (!symm->is_unique(ref.trange().tiles_range().idx(i))) ++redundant;
+    auto r_tile = r.find(i).get();
+    auto ref_tile = ref.find(i).get();
+    BOOST_CHECK_EQUAL(r_tile.range(), ref_tile.range());
+    for (std::size_t j = 0ul; j < ref_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(r_tile[j], ref_tile[j]);
+  }
+
+  // with sparse shapes the products of the other tiles are skipped
+  const auto flops =
+      (a("i,k,l") * a("j,k,l")).set_symmetry(symm).predict_cost(r("i,j"));
+  const auto ref_flops = (a("i,k,l") * a("j,k,l")).predict_cost(r("i,j"));
+  if (!F::TArray::shape_type::is_dense() && redundant > 0ul)
+    BOOST_CHECK_LT(flops.total().flops, ref_flops.total().flops);
+  else
+    BOOST_CHECK_LE(flops.total().flops, ref_flops.total().flops);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif  // TILEDARRAY_TEST_EXPRESSIONS_IMPL_H
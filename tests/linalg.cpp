@@ -4,6 +4,8 @@
 //#include "range_fixture.h"
 #include "unit_test_config.h"
 
+#include "TiledArray/math/linalg/native/cholesky.h"
+#include "TiledArray/math/linalg/native/heig.h"
 #include "TiledArray/math/linalg/non-distributed/cholesky.h"
 #include "TiledArray/math/linalg/non-distributed/heig.h"
 #include "TiledArray/math/linalg/non-distributed/lu.h"
@@ -16,6 +18,7 @@
 
 namespace TA = TiledArray;
 namespace non_dist = TA::math::linalg::non_distributed;
+namespace native = TA::math::linalg::native;
 
 #if TILEDARRAY_HAS_SCALAPACK
 namespace scalapack = TA::math::linalg::scalapack;
@@ -491,6 +494,145 @@ BOOST_AUTO_TEST_CASE(heig_diff_tiling) {
   GlobalFixture::world->gop.fence();
 }
 
+BOOST_AUTO_TEST_CASE(heig_native) {
+  GlobalFixture::world->gop.fence();
+  auto trange = gen_trange(N, {107ul, 113ul, 211ul, 151ul});
+
+  auto ref_ta = TA::make_array<TA::TArray<double>>(
+      *GlobalFixture::world, trange,
+      [this](TA::Tensor<double>& t, TA::Range const& range) -> double {
+        return this->make_ta_reference(t, range);
+      });
+
+  auto [evals, evecs] = native::heig(ref_ta);
+
+  BOOST_CHECK(evecs.trange() == ref_ta.trange());
+
+  // Check eigenvalue correctness
+  double tol = N * N * std::numeric_limits<double>::epsilon();
+  for (int64_t i = 0; i < N; ++i) {
+    BOOST_CHECK_SMALL(std::abs(evals[i] - exact_evals[i]), tol);
+  }
+
+  // Check that the eigenvectors are orthonormal and diagonalize the matrix
+  auto diagonal = [&](const std::vector<double>& values) {
+    return TA::make_array<TA::TArray<double>>(
+        *GlobalFixture::world, trange,
+        [&values](TA::Tensor<double>& t, TA::Range const& range) -> double {
+          t = TA::Tensor<double>(range, 0.0);
+          const auto lo = range.lobound_data();
+          const auto up = range.upbound_data();
+          for (auto i = std::max(lo[0], lo[1]); i < std::min(up[0], up[1]); ++i)
+            t(i, i) = values[i];
+          return t.norm();
+        });
+  };
+  auto evals_ta = diagonal(evals);
+  auto iden = diagonal(std::vector<double>(N, 1.0));
+
+  decltype(evecs) residual, ortho;
+  residual("i,j") =
+      ref_ta("i,k") * evecs("k,j") - evecs("i,k") * evals_ta("k,j");
+  ortho("i,j") = evecs("k,i") * evecs("k,j") - iden("i,j");
+  BOOST_CHECK_SMALL(residual("i,j").norm().get(), tol);
+  BOOST_CHECK_SMALL(ortho("i,j").norm().get(), tol);
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE(heig_native_distributed, TA_UT_LABEL_DISTRIBUTED) {
+  GlobalFixture::world->gop.fence();
+  // Many tile columns, so that every rank reduces some of the panels
+  auto trange = gen_trange(N, {64ul});
+
+  auto ref_ta = TA::make_array<TA::TArray<double>>(
+      *GlobalFixture::world, trange,
+      [this](TA::Tensor<double>& t, TA::Range const& range) -> double {
+        return this->make_ta_reference(t, range);
+      });
+
+  auto [evals, evecs] = native::heig(ref_ta);
+
+  double tol = N * N * std::numeric_limits<double>::epsilon();
+  for (int64_t i = 0; i < N; ++i)
+    BOOST_CHECK_SMALL(std::abs(evals[i] - exact_evals[i]), tol);
+
+  // The eigenvectors are orthonormal
+  auto iden = TA::make_array<TA::TArray<double>>(
+      *GlobalFixture::world, trange,
+      [](TA::Tensor<double>& t, TA::Range const& range) -> double {
+        t = TA::Tensor<double>(range, 0.0);
+        const auto lo = range.lobound_data();
+        const auto up = range.upbound_data();
+        for (auto i = std::max(lo[0], lo[1]); i < std::min(up[0], up[1]); ++i)
+          t(i, i) = 1.0;
+        return t.norm();
+      });
+  decltype(evecs) ortho;
+  ortho("i,j") = evecs("k,i") * evecs("k,j") - iden("i,j");
+  BOOST_CHECK_SMALL(ortho("i,j").norm().get(), tol);
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE(heig_native_clustered) {
+  // A spectrum whose eigenvalues are all chained by small gaps
+  const std::size_t n = 1000;
+  std::vector<double> d(n), e(n - 1, 1e-9);
+  for (std::size_t i = 0; i < n; ++i) d[i] = 1.0 + 1e-7 * ((i * 7919) % n);
+  const auto evals =
+      native::detail::tridiagonal_eigenvalues(*GlobalFixture::world, d, e);
+
+  // The clusters are bounded
+  const auto clusters = native::detail::eigenvalue_clusters(evals, 1.0);
+  BOOST_CHECK_EQUAL(clusters.back(), n);
+  for (std::size_t i = 0; i + 1 < clusters.size(); ++i)
+    BOOST_CHECK_LE(clusters[i + 1] - clusters[i],
+                   native::detail::max_eigenvector_cluster);
+
+  // The eigenvectors of a block are accurate and orthonormal
+  const std::size_t first = n - 100, last = n;
+  const auto vectors =
+      native::detail::tridiagonal_eigenvectors(d, e, evals, first, last);
+  BOOST_REQUIRE_EQUAL(vectors.cols(), last - first);
+  native::detail::Matrix<double> T = native::detail::Matrix<double>::Zero(n, n);
+  for (std::size_t i = 0; i < n; ++i) {
+    T(i, i) = d[i];
+    if (i + 1 < n) T(i, i + 1) = T(i + 1, i) = e[i];
+  }
+  const double tol = n * std::numeric_limits<double>::epsilon();
+  for (std::size_t k = first; k < last; ++k)
+    BOOST_CHECK_SMALL((T * vectors.col(k - first) -
+                       evals[k] * vectors.col(k - first))
+                          .norm(),
+                      tol);
+  BOOST_CHECK_SMALL(
+      (vectors.transpose() * vectors -
+       native::detail::Matrix<double>::Identity(last - first, last - first))
+          .norm(),
+      tol);
+
+  // Degenerate eigenvalues of a multiplicity above the cluster size limit
+  // are not split, so that all of their eigenvectors are orthonormal
+  const std::size_t m = 2 * native::detail::max_eigenvector_cluster + 10;
+  std::vector<double> dd(m), ed(m - 1, 0.0);
+  for (std::size_t i = 0; i < m; ++i) dd[i] = (i % 2 ? 1.0 : -1.0);
+  const auto evals_d =
+      native::detail::tridiagonal_eigenvalues(*GlobalFixture::world, dd, ed);
+  const auto clusters_d = native::detail::eigenvalue_clusters(evals_d, 1.0);
+  BOOST_CHECK_EQUAL(clusters_d.size(), 3ul);
+  native::detail::Matrix<double> Z(m, m);
+  for (std::size_t f = 0; f < m; f += 30) {
+    const std::size_t l = std::min(m, f + 30);
+    Z.middleCols(f, l - f) =
+        native::detail::tridiagonal_eigenvectors(dd, ed, evals_d, f, l);
+  }
+  BOOST_CHECK_SMALL(
+      (Z.transpose() * Z - native::detail::Matrix<double>::Identity(m, m))
+          .norm(),
+      tol);
+}
+
 BOOST_AUTO_TEST_CASE(heig_generalized) {
   GlobalFixture::world->gop.fence();
 
@@ -717,6 +859,75 @@ BOOST_AUTO_TEST_CASE(cholesky_lsolve) {
   GlobalFixture::world->gop.fence();
 }
 
+BOOST_AUTO_TEST_CASE(cholesky_native) {
+  GlobalFixture::world->gop.fence();
+
+  auto trange = gen_trange(N, {107ul, 113ul, 211ul, 151ul});
+
+  auto A = TA::make_array<TA::TArray<double>>(
+      *GlobalFixture::world, trange,
+      [this](TA::Tensor<double>& t, TA::Range const& range) -> double {
+        return this->make_ta_reference(t, range);
+      });
+  const double epsilon = N * N * std::numeric_limits<double>::epsilon();
+
+  auto L = native::cholesky(A);
+  BOOST_CHECK(L.trange() == A.trange());
+
+  auto L_ref = non_dist::cholesky(A);
+  decltype(L) L_diff;
+  L_diff("i,j") = L("i,j") - L_ref("i,j");
+  BOOST_CHECK_SMALL(L_diff("i,j").norm().get(), epsilon);
+
+  // the zero tiles of a sparse array are skipped
+  auto A_sparse = TA::to_sparse(A);
+  auto L_sparse = native::cholesky(A_sparse);
+  decltype(L_sparse) A_minus_LLt;
+  A_minus_LLt("i,j") = A_sparse("i,j") - L_sparse("i,k") * L_sparse("j,k");
+  BOOST_CHECK_SMALL(A_minus_LLt("i,j").norm().get(), epsilon);
+
+  auto [L_both, Linv] = native::cholesky_linv<true>(A);
+  BOOST_CHECK(Linv.trange() == A.trange());
+  L_diff("i,j") = L_both("i,j") - L_ref("i,j");
+  BOOST_CHECK_SMALL(L_diff("i,j").norm().get(), epsilon);
+  auto Linv_ref = non_dist::cholesky_linv<false>(A);
+  decltype(Linv) Linv_diff;
+  Linv_diff("i,j") = Linv("i,j") - Linv_ref("i,j");
+  BOOST_CHECK_SMALL(Linv_diff("i,j").norm().get(), epsilon);
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE(cholesky_native_solve) {
+  GlobalFixture::world->gop.fence();
+
+  auto trange = gen_trange(N, {107ul, 113ul, 211ul, 151ul});
+
+  auto A = TA::make_array<TA::TArray<double>>(
+      *GlobalFixture::world, trange,
+      [this](TA::Tensor<double>& t, TA::Range const& range) -> double {
+        return this->make_ta_reference(t, range);
+      });
+  const double epsilon = N * N * std::numeric_limits<double>::epsilon();
+
+  auto X = native::cholesky_solve(A, A);
+  BOOST_CHECK(X.trange() == A.trange());
+  auto X_ref = non_dist::cholesky_solve(A, A);
+  decltype(X) X_diff;
+  X_diff("i,j") = X("i,j") - X_ref("i,j");
+  BOOST_CHECK_SMALL(X_diff("i,j").norm().get(), epsilon);
+
+  for (auto op : {TA::NoTranspose, TA::Transpose}) {
+    auto [L, Y] = native::cholesky_lsolve(op, A, A);
+    auto [L_ref, Y_ref] = non_dist::cholesky_lsolve(op, A, A);
+    decltype(Y) Y_diff;
+    Y_diff("i,j") = Y("i,j") - Y_ref("i,j");
+    BOOST_CHECK_SMALL(Y_diff("i,j").norm().get(), epsilon);
+  }
+
+  GlobalFixture::world->gop.fence();
+}
+
 BOOST_AUTO_TEST_CASE(lu_solve) {
   GlobalFixture::world->gop.fence();
 
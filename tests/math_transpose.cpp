@@ -27,11 +27,50 @@
 #include "tiledarray.h"
 #include "unit_test_config.h"
 
+#include <complex>
+#include <vector>
+
 struct TransposeFixture {
   TransposeFixture() {}
 
   ~TransposeFixture() {}
 
+  /// Check \c transpose_copy() for submatrices of an \c m x \c n matrix
+
+  /// The submatrix sizes cover the edge cases of the SIMD micro-kernels and
+  /// the column panels of the transpose.
+  template <typename T>
+  static void check_transpose_copy(const std::size_t m, const std::size_t n) {
+    std::vector<T> a(m * n), b(m * n);
+    for (std::size_t i = 0ul; i < a.size(); ++i)
+      a[i] = T(GlobalFixture::world->rand() % 101);
+
+    const std::size_t sizes[] = {1ul, 2ul, 3ul, 4ul, 5ul, 7ul, 8ul, 9ul,
+                                 15ul, 16ul, 17ul, 31ul, 33ul};
+    std::vector<std::size_t> xs(std::begin(sizes), std::end(sizes)), ys = xs;
+    xs.push_back(m);
+    ys.push_back(n - 1ul);
+    ys.push_back(n);
+
+    for (const std::size_t x : xs) {
+      for (const std::size_t y : ys) {
+        if ((x > m) || (y > n)) continue;
+        std::fill(b.begin(), b.end(), T(0));
+
+        TiledArray::math::transpose_copy(x, y, m, b.data(), n, a.data());
+
+        std::size_t errors = 0ul;
+        for (std::size_t i = 0ul; i < m; ++i) {
+          for (std::size_t j = 0ul; j < n; ++j) {
+            const T expected = ((i < x) && (j < y)) ? a[i * n + j] : T(0);
+            if (b[j * m + i] != expected) ++errors;
+          }
+        }
+        BOOST_CHECK_EQUAL(errors, 0ul);
+      }
+    }
+  }
+
 };  // TransposeFixture
 
 BOOST_FIXTURE_TEST_SUITE(transpose_suite, TransposeFixture,
@@ -151,4 +190,45 @@ BOOST_AUTO_TEST_CASE(binary) {
   delete[] b;
   delete[] c;
 }
+
+BOOST_AUTO_TEST_CASE(copy_panels) {
+  // The matrix is wider than a column panel
+  const std::size_t m = 11;
+  const std::size_t n = 2 * TiledArray::math::transpose_panel_size<int>() + 3;
+  const std::size_t mn = m * n;
+
+  std::vector<int> a(mn), b(mn);
+
+  GlobalFixture::world->srand(1764);
+  for (std::size_t i = 0ul; i < mn; ++i)
+    a[i] = GlobalFixture::world->rand() % 42;
+
+  const auto no_op = [](const int& a) -> const int& { return a; };
+  const auto copy_op = [](int* b, const int a) { *b = a; };
+
+  TiledArray::math::transpose(no_op, copy_op, m, n, m, b.data(), n, a.data());
+
+  std::size_t errors = 0ul;
+  for (std::size_t i = 0ul; i < m; ++i)
+    for (std::size_t j = 0ul; j < n; ++j)
+      if (b[j * m + i] != a[i * n + j]) ++errors;
+  BOOST_CHECK_EQUAL(errors, 0ul);
+}
+
+BOOST_AUTO_TEST_CASE(transpose_copy) {
+  GlobalFixture::world->srand(1764);
+
+  check_transpose_copy<double>(35, 40);
+  check_transpose_copy<float>(35, 40);
+  check_transpose_copy<std::complex<double>>(35, 40);
+  check_transpose_copy<std::complex<float>>(35, 40);
+  check_transpose_copy<int>(35, 40);
+
+  // Matrices wider than a column panel
+  check_transpose_copy<double>(
+      17, TiledArray::math::transpose_panel_size<double>() + 9);
+  check_transpose_copy<float>(
+      17, TiledArray::math::transpose_panel_size<float>() + 9);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
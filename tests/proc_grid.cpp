@@ -154,6 +154,65 @@ BOOST_AUTO_TEST_CASE(random_constructor_test) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(layered_constructor_test) {
+  const std::size_t rows = 42, cols = 84, row_size = 2048, col_size = 1024;
+
+  for (ProcessID nprocs = 2; nprocs <= 16; ++nprocs) {
+    for (std::size_t layers = 2; layers <= std::size_t(nprocs); ++layers) {
+      const TiledArray::detail::ProcGrid proc_grid0(
+          *GlobalFixture::world, 0, nprocs, rows, cols, row_size, col_size,
+          layers);
+
+      // Check that each layer is a 2D grid for nprocs / layers processes
+      const TiledArray::detail::ProcGrid layer_grid(
+          *GlobalFixture::world, 0, nprocs / layers, rows, cols, row_size,
+          col_size);
+      BOOST_CHECK_EQUAL(proc_grid0.layers(), layers);
+      BOOST_CHECK_EQUAL(proc_grid0.proc_rows(), layer_grid.proc_rows());
+      BOOST_CHECK_EQUAL(proc_grid0.proc_cols(), layer_grid.proc_cols());
+      BOOST_CHECK_EQUAL(proc_grid0.proc_size(), layer_grid.proc_size());
+
+      // Check that the inner dimension slices partition [0, k)
+      const std::size_t k = 37;
+      BOOST_CHECK_EQUAL(proc_grid0.layer_k_begin(k, 0), 0ul);
+      BOOST_CHECK_EQUAL(proc_grid0.layer_k_begin(k, layers), k);
+      for (std::size_t x = 0; x < k; ++x) {
+        const std::size_t l = (x * layers) / k;
+        BOOST_CHECK_LE(proc_grid0.layer_k_begin(k, l), x);
+        BOOST_CHECK_GT(proc_grid0.layer_k_begin(k, l + 1), x);
+      }
+
+      for (ProcessID rank = 0; rank < nprocs; ++rank) {
+        const TiledArray::detail::ProcGrid proc_grid(
+            *GlobalFixture::world, rank, nprocs, rows, cols, row_size,
+            col_size, layers);
+
+        if (std::size_t(rank) < proc_grid.proc_size() * layers) {
+          // Check that the process is placed in the correct layer
+          const std::size_t layer = rank / proc_grid.proc_size();
+          BOOST_CHECK_EQUAL(proc_grid.layer(), layer);
+          BOOST_CHECK_EQUAL(proc_grid.layer_offset(),
+                            ProcessID(layer * proc_grid.proc_size()));
+          BOOST_CHECK_EQUAL(
+              proc_grid.rank_row(),
+              ProcessID((rank % proc_grid.proc_size()) / proc_grid.proc_cols()));
+          BOOST_CHECK_EQUAL(
+              proc_grid.rank_col(),
+              ProcessID((rank % proc_grid.proc_size()) % proc_grid.proc_cols()));
+          BOOST_CHECK_EQUAL(proc_grid.map_col(proc_grid.rank_col()), rank);
+          BOOST_CHECK_EQUAL(proc_grid.map_row(proc_grid.rank_row()), rank);
+        } else {
+          // Check that unused processes are not part of any layer
+          BOOST_CHECK_EQUAL(proc_grid.layer(), layers);
+          BOOST_CHECK_EQUAL(proc_grid.rank_row(), -1);
+          BOOST_CHECK_EQUAL(proc_grid.rank_col(), -1);
+          BOOST_CHECK_EQUAL(proc_grid.local_size(), 0ul);
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(make_groups) {
   madness::DistributedID did_row(madness::uniqueidT(), 0);
   madness::DistributedID did_col(madness::uniqueidT(), 1);
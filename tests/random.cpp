@@ -45,3 +45,44 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(enable_if_true, ValueType, true_types) {
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(counter_based_random, TA_UT_LABEL_SERIAL)
+
+BOOST_AUTO_TEST_CASE(philox_known_answers) {
+  // Random123 known-answer tests for Philox4x32-10
+  using result_type = std::array<std::uint32_t, 4>;
+  BOOST_CHECK(philox4x32({0, 0, 0, 0}, {0, 0}) ==
+              (result_type{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  BOOST_CHECK(philox4x32({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                         {0xffffffff, 0xffffffff}) ==
+              (result_type{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(random_fill_values, ValueType, true_types) {
+  // values depend only on the key, the stream, and the element offset
+  std::vector<ValueType> x(37), y(11), z(37);
+  random_fill(x.data(), x.size(), 42, 3);
+  random_fill(y.data(), y.size(), 42, 3);
+  random_fill(z.data(), z.size(), 42, 4);
+  for (std::size_t i = 0; i < y.size(); ++i) BOOST_CHECK_EQUAL(x[i], y[i]);
+  BOOST_CHECK(x != z);
+
+  // values are in [0,1)
+  for (const auto& value : x) {
+    const auto re = std::real(value), im = std::imag(value);
+    BOOST_CHECK(re >= 0 && re <= 1 && im >= 0 && im <= 1);
+    if constexpr (!std::is_integral_v<ValueType>)
+      BOOST_CHECK(re < 1 && im < 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(random_keys) {
+  TiledArray::set_random_seed(7);
+  const auto k0 = next_random_key(), k1 = next_random_key();
+  BOOST_CHECK_NE(k0, k1);
+  TiledArray::set_random_seed(7);
+  BOOST_CHECK_EQUAL(next_random_key(), k0);
+  BOOST_CHECK_EQUAL(next_random_key(), k1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
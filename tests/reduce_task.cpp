@@ -77,6 +77,18 @@ struct ReduceOp {
   }
 };  // struct ReduceOp
 
+struct BatchedReduceOp : public ReduceOp {
+  using ReduceOp::operator();
+
+  std::size_t batch_size() const { return 4ul; }
+
+  void operator()(result_type& result, const first_argument_type* const* first,
+                  const second_argument_type* const* second,
+                  const std::size_t n) const {
+    for (std::size_t i = 0ul; i < n; ++i) result += *first[i] * *second[i];
+  }
+};  // struct BatchedReduceOp
+
 struct ReducePairTaskFixture {
   ReducePairTaskFixture() : world(*GlobalFixture::world), rt(world) {}
 
@@ -210,3 +222,70 @@ BOOST_AUTO_TEST_CASE(reduce_zero) {
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(reduce_pair_task_batched_suite)
+
+BOOST_AUTO_TEST_CASE(reduce_future) {
+  ReducePairTask<BatchedReduceOp> rt(*GlobalFixture::world);
+  BOOST_CHECK_EQUAL(reduce_batch_size(ReducePairOpWrapper<BatchedReduceOp>()),
+                    4ul);
+
+  std::vector<Future<int> > fut1_vec;
+  std::vector<Future<int> > fut2_vec;
+
+  int sum = 0;
+  for (int i = 0; i < 100; ++i) {
+    Future<int> f1;
+    Future<int> f2;
+    fut1_vec.push_back(f1);
+    fut2_vec.push_back(f2);
+    rt.add(f1, f2);
+    sum += i * i;
+  }
+
+  Future<int> result = rt.submit();
+
+  BOOST_CHECK(!(result.probe()));
+
+  for (int i = 0; i < 100; ++i) {
+    fut1_vec[i].set(i);
+    fut2_vec[i].set(i);
+  }
+
+  BOOST_CHECK_EQUAL(result.get(), sum);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(reduce_task_contention_suite)
+
+BOOST_AUTO_TEST_CASE(concurrent_arguments) {
+  TiledArray::World& world = *GlobalFixture::world;
+  const std::size_t default_accumulators = reduce_task_accumulators();
+
+  for (std::size_t accumulators : {1ul, 2ul, 8ul, 64ul}) {
+    set_reduce_task_accumulators(accumulators);
+    BOOST_CHECK_EQUAL(reduce_task_accumulators(), accumulators);
+
+    // Arguments are set concurrently by tasks, so that many of them become
+    // ready at the same time
+    ReduceTask<plus<int> > rt(world);
+    std::vector<Future<int> > fut_vec(1000);
+    int sum = 0;
+    for (int i = 0; i < 1000; ++i) {
+      sum += i;
+      rt.add(fut_vec[i]);
+    }
+    Future<int> result = rt.submit();
+    for (int i = 0; i < 1000; ++i)
+      world.taskq.add([](Future<int>* f, int value) { f->set(value); },
+                      &fut_vec[i], i);
+
+    BOOST_CHECK_EQUAL(result.get(), sum);
+    world.gop.fence();
+  }
+
+  set_reduce_task_accumulators(default_accumulators);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
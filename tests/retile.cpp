@@ -28,4 +28,74 @@ BOOST_AUTO_TEST_CASE(retile_tensor) {
     BOOST_CHECK_EQUAL(result_sparse.trange(), trange);
 }
 
+// Checks that every element of result equals the corresponding element of
+// reference
+template <typename Array>
+void check_retiled_values(const Array& result, const Array& reference) {
+  for (const auto ordinal : *result.pmap()) {
+    const auto range = result.trange().make_tile_range(ordinal);
+    if (result.is_zero(ordinal)) {
+      for (const auto& index : range) {
+        const auto tile_index = reference.trange().element_to_tile(index);
+        if (!reference.is_zero(tile_index))
+          BOOST_CHECK_EQUAL(reference.find(tile_index).get()(index), 0.0);
+      }
+      continue;
+    }
+    const auto tile = result.find(ordinal).get();
+    BOOST_CHECK_EQUAL(tile.range(), range);
+    for (const auto& index : range) {
+      const auto tile_index = reference.trange().element_to_tile(index);
+      const double expected =
+          (reference.is_zero(tile_index)
+               ? 0.0
+               : reference.find(tile_index).get()(index));
+      BOOST_CHECK_EQUAL(tile(index), expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(retile_values) {
+  auto& world = *GlobalFixture::world;
+  const auto source_trange = TA::TiledRange(
+      {TA::TiledRange1(0, 2, 5, 9, 11), TA::TiledRange1(0, 4, 7),
+       TA::TiledRange1(0, 3, 6)});
+  const auto target_trange = TA::TiledRange(
+      {TA::TiledRange1(0, 2, 4, 11), TA::TiledRange1(0, 1, 2, 7),
+       TA::TiledRange1(0, 3, 6)});
+
+  auto fill = [](const TA::Range& range) {
+    TA::TensorD tile(range);
+    for (const auto& index : range)
+      tile(index) = 100.0 * index[0] + 10.0 * index[1] + index[2] + 1.0;
+    return tile;
+  };
+
+  TA::TArrayD dense(world, source_trange);
+  dense.init_tiles(fill);
+  auto result_dense = retile(dense, target_trange);
+  BOOST_CHECK_EQUAL(result_dense.trange(), target_trange);
+  check_retiled_values(result_dense, dense);
+
+  // source tiles {0,*,*} and {3,1,1} are zero
+  TA::Tensor<float> norms(source_trange.tiles_range(), 1.0f);
+  for (std::size_t j = 0; j < 2; ++j)
+    for (std::size_t k = 0; k < 2; ++k) norms(0, j, k) = 0.0f;
+  norms(3, 1, 1) = 0.0f;
+  TA::TSpArrayD sparse(world, source_trange,
+                       TA::SparseShape<float>(norms, source_trange));
+  sparse.init_tiles(fill);
+  auto result_sparse = retile(sparse, target_trange);
+  BOOST_CHECK_EQUAL(result_sparse.trange(), target_trange);
+  check_retiled_values(result_sparse, sparse);
+
+  // target tiles {0,*,*} only overlap zero source tiles
+  for (std::size_t j = 0; j < 3; ++j)
+    for (std::size_t k = 0; k < 2; ++k) {
+      BOOST_CHECK(result_sparse.is_zero({0, j, k}));
+      BOOST_CHECK(!result_sparse.is_zero({1, j, k}));
+    }
+  world.gop.fence();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
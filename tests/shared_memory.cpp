@@ -0,0 +1,215 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  shared_memory.cpp
+ *
+ */
+
+#include "TiledArray/shared_memory.h"
+#include "TiledArray/shm_bcast.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+#include <cstring>
+
+using namespace TiledArray;
+using TiledArray::detail::SharedMemoryArena;
+using TiledArray::detail::SharedMemorySegment;
+using TiledArray::detail::SharedMemoryTransport;
+
+BOOST_AUTO_TEST_SUITE(shared_memory_suite)
+
+BOOST_AUTO_TEST_CASE(arena) {
+  // the tail of the region that is not a multiple of the alignment is unused
+  SharedMemoryArena arena(1000ul);
+  const auto a = arena.allocate(100ul);
+  const auto b = arena.allocate(100ul);
+  BOOST_CHECK_EQUAL(a, 0ul);
+  BOOST_CHECK_EQUAL(b, 128ul);
+  BOOST_CHECK_EQUAL(arena.allocate(800ul), SharedMemoryArena::npos);
+  const auto c = arena.allocate(600ul);
+  BOOST_CHECK_EQUAL(c, 256ul);
+
+  // freed blocks are merged with their free neighbors
+  arena.deallocate(b, 100ul);
+  arena.deallocate(a, 100ul);
+  BOOST_CHECK_EQUAL(arena.allocate(256ul), 0ul);
+  arena.deallocate(0ul, 256ul);
+  arena.deallocate(c, 600ul);
+  BOOST_CHECK_EQUAL(arena.blocks(), 0ul);
+  BOOST_CHECK_EQUAL(arena.allocate(960ul), 0ul);
+  BOOST_CHECK_EQUAL(arena.blocks(), 1ul);
+}
+
+BOOST_AUTO_TEST_CASE(segment) {
+  const std::string name =
+      "/ta_shm_test." + std::to_string(GlobalFixture::world->rank()) + "." +
+      std::to_string(::getpid());
+  {
+    SharedMemorySegment segment(name, 4096ul);
+    std::strcpy(reinterpret_cast<char*>(segment.data()) + 64, "tile");
+
+    // another mapping sees the data
+    SharedMemorySegment view(name);
+    BOOST_CHECK_EQUAL(view.size(), 4096ul);
+    BOOST_CHECK_EQUAL(reinterpret_cast<const char*>(view.data()) + 64,
+                      std::string("tile"));
+    ::shm_unlink(name.c_str());
+  }
+  BOOST_CHECK_THROW(SharedMemorySegment{name}, TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE(remote_tiles) {
+  auto& world = *GlobalFixture::world;
+  SharedMemoryTransport::initialize(world, 1ul << 20);
+  {
+    TiledRange1 tr1{0, 3, 6, 10};
+    TArrayD a(world, TiledRange{tr1, tr1});
+    a.init_elements([](const auto& index) {
+      return double(index[0] * 10 + index[1]);
+    });
+    a.world().gop.fence();
+
+    // every tile, local or not, is fetched by every process
+    for (std::size_t i = 0ul; i < a.size(); ++i) {
+      const TArrayD::value_type tile = a.find(i).get();
+      for (const auto& index : tile.range())
+        BOOST_CHECK_EQUAL(tile(index), double(index[0] * 10 + index[1]));
+    }
+    a.world().gop.fence();
+
+    // the tiles owned by processes of the same node were copied through
+    // shared memory; the last block published by a process is only freed
+    // when it publishes again or reclaims its blocks
+    const auto transport = SharedMemoryTransport::instance();
+    std::size_t peer_tiles = 0ul;
+    for (std::size_t i = 0ul; i < a.size(); ++i)
+      if (transport->is_peer(a.owner(i))) ++peer_tiles;
+    std::size_t blocks = transport->blocks();
+    world.gop.sum(peer_tiles);
+    world.gop.sum(blocks);
+    if (peer_tiles > 0ul) BOOST_CHECK_GT(blocks, 0ul);
+
+    // no copy outlives the fetch that it was made for
+    transport->reclaim();
+    BOOST_CHECK_EQUAL(transport->blocks(), 0ul);
+  }
+  SharedMemoryTransport::finalize();
+}
+
+BOOST_AUTO_TEST_CASE(bcast) {
+  auto& world = *GlobalFixture::world;
+  SharedMemoryTransport::initialize(world, 1ul << 20);
+  {
+    const auto transport = SharedMemoryTransport::instance();
+    std::vector<ProcessID> group_list;
+    for (ProcessID p = 0; p < world.size(); ++p) group_list.push_back(p);
+
+    // broadcast from the first and last process, with and without chunks
+    std::size_t n = 0ul;
+    for (const ProcessID group_root : {ProcessID(0), world.size() - 1})
+      for (const std::size_t chunk_size : {std::size_t(0), std::size_t(100)}) {
+        ++n;
+        const madness::DistributedID did(madness::uniqueidT(), 2ul * n);
+        madness::Group group(world, group_list, did);
+
+        TensorD reference(Range(20ul, 3ul));
+        for (std::size_t i = 0ul; i < reference.size(); ++i)
+          reference[i] = i + 0.5 * n;
+        Future<TensorD> tile;
+        if (group.rank() == group_root) tile.set(reference.clone());
+
+        const madness::DistributedID key(madness::uniqueidT(), 2ul * n + 1ul);
+        BOOST_REQUIRE_NO_THROW(detail::shm_bcast(world, transport, key, tile,
+                                                 group_root, group,
+                                                 chunk_size));
+        const TensorD& result = tile.get();
+        BOOST_CHECK_EQUAL(result.range(), reference.range());
+        for (std::size_t i = 0ul; i < reference.size(); ++i)
+          BOOST_CHECK_EQUAL(result[i], reference[i]);
+        world.gop.fence();
+      }
+
+    // each node root published one block per broadcast, which the other
+    // processes of its node have released
+    transport->reclaim();
+    BOOST_CHECK_EQUAL(transport->blocks(), 0ul);
+  }
+  SharedMemoryTransport::finalize();
+}
+
+BOOST_AUTO_TEST_CASE(replicate) {
+  auto& world = *GlobalFixture::world;
+  SharedMemoryTransport::initialize(world, 1ul << 20);
+  {
+    TiledRange1 tr1{0, 3, 6, 10};
+    TArrayD a(world, TiledRange{tr1, tr1});
+    a.init_elements([](const auto& index) {
+      return double(index[0] * 10 + index[1]);
+    });
+    a.make_replicated(ReplicationAlgorithm::node);
+    for (std::size_t i = 0ul; i < a.size(); ++i) {
+      BOOST_CHECK(a.is_local(i));
+      const TArrayD::value_type tile = a.find(i).get();
+      BOOST_CHECK_EQUAL(tile.range(), a.trange().make_tile_range(i));
+      for (const auto& index : tile.range())
+        BOOST_CHECK_EQUAL(tile(index), double(index[0] * 10 + index[1]));
+    }
+    world.gop.fence();
+
+    const auto transport = SharedMemoryTransport::instance();
+    transport->reclaim();
+    BOOST_CHECK_EQUAL(transport->blocks(), 0ul);
+  }
+  SharedMemoryTransport::finalize();
+}
+
+BOOST_AUTO_TEST_CASE(contraction) {
+  auto& world = *GlobalFixture::world;
+  TiledRange1 tr1{0, 3, 6, 10, 13, 17};
+  TArrayD a(world, TiledRange{tr1, tr1});
+  TArrayD b(world, TiledRange{tr1, tr1});
+  a.init_elements([](const auto& index) {
+    return double(index[0]) - 0.5 * double(index[1]);
+  });
+  b.init_elements([](const auto& index) {
+    return 0.25 * double(index[0] + 1) * double(index[1] % 3);
+  });
+
+  // the SUMMA broadcasts within each node go through shared memory
+  SharedMemoryTransport::initialize(world, 1ul << 20);
+  TArrayD c;
+  c("i,j") = a("i,k") * b("k,j");
+  world.gop.fence();
+  SharedMemoryTransport::instance()->reclaim();
+  BOOST_CHECK_EQUAL(SharedMemoryTransport::instance()->blocks(), 0ul);
+  SharedMemoryTransport::finalize();
+
+  TArrayD reference;
+  reference("i,j") = a("i,k") * b("k,j");
+  for (std::size_t i = 0ul; i < c.size(); ++i) {
+    if (!c.is_local(i)) continue;
+    const TArrayD::value_type tile = c.find(i).get();
+    const TArrayD::value_type expected = reference.find(i).get();
+    BOOST_CHECK_EQUAL(tile.range(), expected.range());
+    for (std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_CLOSE(tile[j], expected[j], 1e-10);
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1376,4 +1376,32 @@ BOOST_AUTO_TEST_CASE(gemm_perm) {
                     tolerance);
 }
 
+BOOST_AUTO_TEST_CASE(gemm_screened) {
+  const float default_cutoff = SparseShape<float>::gemm_density_cutoff();
+
+  math::GemmHelper gemm_helper(
+      TiledArray::math::blas::Op::NoTrans, TiledArray::math::blas::Op::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+
+  // Evaluate the contraction of sparse shapes with the dense product
+  SparseShape<float>::gemm_density_cutoff(0.0f);
+  SparseShape<float> reference;
+  BOOST_REQUIRE_NO_THROW(reference = left.gemm(right, -7.2, gemm_helper));
+
+  // Evaluate the contraction of sparse shapes with the screened product
+  SparseShape<float>::gemm_density_cutoff(1.0f);
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = left.gemm(right, -7.2, gemm_helper));
+
+  SparseShape<float>::gemm_density_cutoff(default_cutoff);
+
+  // Check that the result is correct
+  BOOST_REQUIRE_EQUAL(result.data().range(), reference.data().range());
+  for (std::size_t i = 0ul; i < reference.data().size(); ++i) {
+    BOOST_CHECK_CLOSE(result[i], reference[i], tolerance);
+    BOOST_CHECK_EQUAL(result.is_zero(i), reference.is_zero(i));
+  }
+  BOOST_CHECK_CLOSE(result.sparsity(), reference.sparsity(), tolerance);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
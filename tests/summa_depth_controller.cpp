@@ -0,0 +1,128 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  summa_depth_controller.cpp
+ *
+ */
+
+#include "TiledArray/dist_eval/summa_depth_controller.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+using TiledArray::detail::SummaDepthController;
+
+struct SummaDepthControllerFixture {
+  SummaDepthControllerFixture() {
+    config.adaptive = true;
+    config.min_depth = 2ul;
+    config.max_depth = 8ul;
+    config.window = 2ul;
+    config.grow_ratio = 0.25;
+    config.shrink_ratio = 0.05;
+  }
+
+  ~SummaDepthControllerFixture() {}
+
+  SummaDepthConfig config;
+};  // SummaDepthControllerFixture
+
+BOOST_FIXTURE_TEST_SUITE(summa_depth_controller_suite,
+                         SummaDepthControllerFixture)
+
+BOOST_AUTO_TEST_CASE(memory_size) {
+  BOOST_CHECK_EQUAL(detail::memory_size_to_bytes("100"), 100.0);
+  BOOST_CHECK_EQUAL(detail::memory_size_to_bytes("2 kB"), 2000.0);
+  BOOST_CHECK_EQUAL(detail::memory_size_to_bytes("2 KiB"), 2048.0);
+  BOOST_CHECK_EQUAL(detail::memory_size_to_bytes("1.5 MiB"), 1572864.0);
+  BOOST_CHECK_EQUAL(detail::memory_size_to_bytes("1 GB"), 1.0e9);
+  BOOST_CHECK_EQUAL(detail::memory_size_to_bytes("-1 GB"), 0.0);
+  BOOST_CHECK_EQUAL(detail::memory_size_to_bytes("none"), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(config) {
+  const SummaDepthConfig default_config = summa_depth_config();
+
+  BOOST_CHECK_NO_THROW(set_summa_depth_config(config));
+  BOOST_CHECK_EQUAL(summa_depth_config().adaptive, config.adaptive);
+  BOOST_CHECK_EQUAL(summa_depth_config().min_depth, config.min_depth);
+  BOOST_CHECK_EQUAL(summa_depth_config().max_depth, config.max_depth);
+  BOOST_CHECK_EQUAL(summa_depth_config().window, config.window);
+
+  SummaDepthConfig bad_config = config;
+  bad_config.window = 0ul;
+  BOOST_CHECK_THROW(set_summa_depth_config(bad_config), TiledArray::Exception);
+
+  set_summa_depth_config(default_config);
+}
+
+BOOST_AUTO_TEST_CASE(grow) {
+  SummaDepthController controller(config, 0ul);
+
+  // The depth is not changed until a window of measurements is complete
+  BOOST_CHECK_EQUAL(controller.next(4ul), 1u);
+  controller.record(1.0, 1.0);
+  BOOST_CHECK_EQUAL(controller.next(4ul), 1u);
+  controller.record(1.0, 1.0);
+
+  // Communication dominates, so the depth is increased
+  BOOST_CHECK_EQUAL(controller.next(4ul), 2u);
+
+  // The measurements are reset after each decision
+  BOOST_CHECK_EQUAL(controller.next(5ul), 1u);
+
+  // The depth is not increased beyond max_depth
+  controller.record(1.0, 1.0);
+  controller.record(1.0, 1.0);
+  BOOST_CHECK_EQUAL(controller.next(8ul), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(shrink) {
+  SummaDepthController controller(config, 0ul);
+
+  // Computation dominates, so the depth is decreased
+  controller.record(0.0, 1.0);
+  controller.record(0.0, 1.0);
+  BOOST_CHECK_EQUAL(controller.next(4ul), 0u);
+
+  // The depth is not decreased below min_depth
+  controller.record(0.0, 1.0);
+  controller.record(0.0, 1.0);
+  BOOST_CHECK_EQUAL(controller.next(2ul), 1u);
+
+  // Neither communication nor computation dominates
+  controller.record(0.2, 1.0);
+  controller.record(0.2, 1.0);
+  BOOST_CHECK_EQUAL(controller.next(4ul), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(memory_bound) {
+  config.max_memory = 1000ul;
+  SummaDepthController controller(config, 200ul);
+
+  // The depth is decreased immediately when the memory bound is exceeded
+  BOOST_CHECK_EQUAL(controller.next(6ul), 0u);
+
+  // The depth is not increased beyond the memory bound
+  controller.record(1.0, 1.0);
+  controller.record(1.0, 1.0);
+  BOOST_CHECK_EQUAL(controller.next(5ul), 1u);
+  controller.record(1.0, 1.0);
+  controller.record(1.0, 1.0);
+  BOOST_CHECK_EQUAL(controller.next(4ul), 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7307,4 +7307,36 @@ BOOST_AUTO_TEST_CASE(ijk_ijk_kji) {
   BOOST_CHECK_EQUAL(rv, corr);
 }
 
+// The arguments and the result are all permuted around one GEMM
+BOOST_AUTO_TEST_CASE(li_kij_jlk) {
+  Tensor<double> lhs(Range{3, 4, 2}), rhs(Range{2, 5, 3});
+  for (std::size_t x = 0ul; x < lhs.size(); ++x) lhs[x] = double(x % 7) - 3;
+  for (std::size_t x = 0ul; x < rhs.size(); ++x) rhs[x] = double(x % 5) - 2;
+  Tensor<double> corr(Range{5, 4}, 0.0);
+  for (std::size_t l = 0ul; l < 5ul; ++l)
+    for (std::size_t i = 0ul; i < 4ul; ++i)
+      for (std::size_t j = 0ul; j < 2ul; ++j)
+        for (std::size_t k = 0ul; k < 3ul; ++k)
+          corr(l, i) += lhs(k, i, j) * rhs(j, l, k);
+  BipartiteIndexList oidx("l,i"), lidx("k,i,j"), ridx("j,l,k");
+  auto rv = kernels::t_t_t_contract_(oidx, lidx, ridx, lhs, rhs);
+  BOOST_CHECK_EQUAL(rv, corr);
+}
+
+// One GEMM per slice of j, with a permuted left-hand argument
+BOOST_AUTO_TEST_CASE(jil_ijk_jkl) {
+  Tensor<double> lhs(Range{4, 3, 2}), rhs(Range{3, 2, 5});
+  for (std::size_t x = 0ul; x < lhs.size(); ++x) lhs[x] = double(x % 7) - 3;
+  for (std::size_t x = 0ul; x < rhs.size(); ++x) rhs[x] = double(x % 5) - 2;
+  Tensor<double> corr(Range{3, 4, 5}, 0.0);
+  for (std::size_t j = 0ul; j < 3ul; ++j)
+    for (std::size_t i = 0ul; i < 4ul; ++i)
+      for (std::size_t l = 0ul; l < 5ul; ++l)
+        for (std::size_t k = 0ul; k < 2ul; ++k)
+          corr(j, i, l) += lhs(i, j, k) * rhs(j, k, l);
+  BipartiteIndexList oidx("j,i,l"), lidx("i,j,k"), ridx("j,k,l");
+  auto rv = kernels::t_t_t_contract_(oidx, lidx, ridx, lhs, rhs);
+  BOOST_CHECK_EQUAL(rv, corr);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -219,6 +219,60 @@ BOOST_AUTO_TEST_CASE(matrix_multiply) {
   BOOST_CHECK_EQUAL(result_map, C);
 }
 
+BOOST_AUTO_TEST_CASE(batched_matrix_multiply) {
+  // Set dimension constants; each pair has a different inner dimension
+  const std::size_t left_outer_start = 2, left_outer_finish = 9,
+                    right_outer_start = 4, right_outer_finish = 15;
+  const std::size_t inner_start[3] = {0, 3, 8},
+                    inner_finish[3] = {3, 8, 20};
+
+  const TiledArray::math::blas::Op ops[2] = {
+      TiledArray::math::blas::Op::NoTrans, TiledArray::math::blas::Op::Trans};
+  for (auto left_op : ops) {
+    for (auto right_op : ops) {
+      const bool left_notrans =
+          (left_op == TiledArray::math::blas::Op::NoTrans);
+      const bool right_notrans =
+          (right_op == TiledArray::math::blas::Op::NoTrans);
+
+      // Construct tensors
+      std::vector<TensorI> left, right;
+      for (std::size_t i = 0ul; i < 3ul; ++i) {
+        left.push_back(left_notrans
+                           ? make_tensor(left_outer_start, inner_start[i],
+                                         left_outer_finish, inner_finish[i])
+                           : make_tensor(inner_start[i], left_outer_start,
+                                         inner_finish[i], left_outer_finish));
+        right.push_back(right_notrans
+                            ? make_tensor(inner_start[i], right_outer_start,
+                                          inner_finish[i], right_outer_finish)
+                            : make_tensor(right_outer_start, inner_start[i],
+                                          right_outer_finish, inner_finish[i]));
+      }
+      const TensorI* left_ptrs[3] = {&left[0], &left[1], &left[2]};
+      const TensorI* right_ptrs[3] = {&right[0], &right[1], &right[2]};
+
+      ContractReduce<TensorI, TensorI, TensorI, int> op(left_op, right_op, 3,
+                                                        2u, 2u, 2u);
+
+      // Compute reference values one pair at a time
+      TensorI reference;
+      for (std::size_t i = 0ul; i < 3ul; ++i) op(reference, left[i], right[i]);
+
+      // Contract the pairs as a batch into an empty result
+      TensorI result;
+      BOOST_REQUIRE_NO_THROW(op(result, left_ptrs, right_ptrs, 3ul));
+      BOOST_CHECK_EQUAL(result.range(), reference.range());
+      BOOST_CHECK(std::equal(result.begin(), result.end(), reference.begin()));
+
+      // Contract the pairs as a batch into an existing result
+      for (std::size_t i = 0ul; i < 3ul; ++i) op(reference, left[i], right[i]);
+      BOOST_REQUIRE_NO_THROW(op(result, left_ptrs, right_ptrs, 3ul));
+      BOOST_CHECK(std::equal(result.begin(), result.end(), reference.begin()));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(tensor_contract1) {
   // Set dimension constants
   const std::size_t left_outer_start = 2, left_outer_finish = 20,
@@ -0,0 +1,184 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_pool_allocator.cpp
+ *
+ */
+
+#include "TiledArray/tensor/pool_allocator.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace TiledArray;
+using TiledArray::detail::TilePool;
+
+struct TilePoolAllocatorFixture {
+  TilePoolAllocatorFixture() {}
+
+  ~TilePoolAllocatorFixture() {}
+
+};  // TilePoolAllocatorFixture
+
+BOOST_FIXTURE_TEST_SUITE(tile_pool_allocator_suite, TilePoolAllocatorFixture,
+                         TA_UT_LABEL_SERIAL)
+
+BOOST_AUTO_TEST_CASE(size_classes) {
+  BOOST_CHECK_EQUAL(TilePool::size_class(1ul), 0ul);
+  BOOST_CHECK_EQUAL(TilePool::size_class(TilePool::min_block), 0ul);
+  BOOST_CHECK_EQUAL(TilePool::size_class(TilePool::max_block),
+                    TilePool::nclasses - 1ul);
+
+  // Each size maps to the smallest class that holds it
+  std::size_t last_class = 0ul;
+  for (std::size_t size = 1ul; size <= 65536ul; ++size) {
+    const std::size_t c = TilePool::size_class(size);
+    BOOST_REQUIRE_GE(TilePool::class_size(c), size);
+    if (c > 0ul) BOOST_REQUIRE_LT(TilePool::class_size(c - 1ul), size);
+    BOOST_REQUIRE_GE(c, last_class);
+    last_class = c;
+  }
+
+  // Classes are at most 25% larger than the requests above the minimum
+  for (std::size_t c = 1ul; c < TilePool::nclasses; ++c) {
+    BOOST_CHECK_LE(4ul * TilePool::class_size(c),
+                   5ul * (TilePool::class_size(c - 1ul) + 1ul));
+    BOOST_CHECK_EQUAL(TilePool::size_class(TilePool::class_size(c)), c);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(reuse) {
+  tile_pool_allocator<double> alloc;
+
+  const TilePoolStats stats0 = tile_pool_stats();
+  double* p = alloc.allocate(1000ul);
+  BOOST_REQUIRE(p != nullptr);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % TilePool::alignment,
+                    0ul);
+  for (std::size_t i = 0ul; i < 1000ul; ++i) p[i] = double(i);
+  alloc.deallocate(p, 1000ul);
+
+  // A request of the same size class is served by the freed block
+  double* q = alloc.allocate(990ul);
+  BOOST_CHECK_EQUAL(q, p);
+  alloc.deallocate(q, 990ul);
+
+  const TilePoolStats stats1 = tile_pool_stats();
+  BOOST_CHECK_EQUAL(stats1.hits + stats1.misses,
+                    stats0.hits + stats0.misses + 2ul);
+  BOOST_CHECK_GE(stats1.hits, stats0.hits + 1ul);
+  BOOST_CHECK_GE(stats1.peak_bytes, stats1.bytes);
+  BOOST_CHECK_GE(stats1.bytes, TilePool::class_size(TilePool::size_class(
+                                   1000ul * sizeof(double))));
+
+  // Empty allocations
+  BOOST_CHECK(alloc.allocate(0ul) == nullptr);
+  BOOST_CHECK_NO_THROW(alloc.deallocate(nullptr, 0ul));
+}
+
+BOOST_AUTO_TEST_CASE(large) {
+  tile_pool_allocator<char> alloc;
+
+  const std::size_t n = TilePool::max_block + 1ul;
+  const TilePoolStats stats0 = tile_pool_stats();
+  char* p = alloc.allocate(n);
+  p[0] = p[n - 1ul] = 'a';
+  const TilePoolStats stats1 = tile_pool_stats();
+  BOOST_CHECK_EQUAL(stats1.misses, stats0.misses + 1ul);
+  BOOST_CHECK_GE(stats1.bytes, stats0.bytes + n);
+  BOOST_CHECK_GE(stats1.peak_bytes, stats0.bytes + n);
+
+  // Large blocks are returned to the system immediately
+  alloc.deallocate(p, n);
+  BOOST_CHECK_EQUAL(tile_pool_stats().bytes, stats0.bytes);
+}
+
+BOOST_AUTO_TEST_CASE(release) {
+  tile_pool_allocator<double> alloc;
+
+  std::vector<double*> blocks;
+  for (std::size_t i = 0ul; i < 16ul; ++i)
+    blocks.push_back(alloc.allocate(4096ul));
+  const std::size_t bytes = tile_pool_stats().bytes;
+  for (double* p : blocks) alloc.deallocate(p, 4096ul);
+  BOOST_CHECK_EQUAL(tile_pool_stats().bytes, bytes);
+
+  tile_pool_release();
+  BOOST_CHECK_LE(tile_pool_stats().bytes,
+                 bytes - 16ul * 4096ul * sizeof(double));
+}
+
+BOOST_AUTO_TEST_CASE(threads) {
+  const std::size_t nthreads = 4ul;
+  const TilePoolStats stats0 = tile_pool_stats();
+
+  // Blocks are allocated by one thread and freed by another
+  std::vector<std::vector<int*>> blocks(nthreads);
+  std::atomic<std::size_t> errors{0ul};
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0ul; t < nthreads; ++t) {
+    threads.emplace_back([&blocks, t]() {
+      tile_pool_allocator<int> alloc;
+      for (std::size_t i = 0ul; i < 1000ul; ++i) {
+        int* p = alloc.allocate(100ul + i);
+        p[0] = int(i);
+        blocks[t].push_back(p);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  threads.clear();
+  for (std::size_t t = 0ul; t < nthreads; ++t) {
+    threads.emplace_back([&blocks, &errors, t, nthreads]() {
+      tile_pool_allocator<int> alloc;
+      std::vector<int*>& b = blocks[(t + 1ul) % nthreads];
+      for (std::size_t i = 0ul; i < b.size(); ++i) {
+        if (b[i][0] != int(i)) ++errors;
+        alloc.deallocate(b[i], 100ul + i);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  BOOST_CHECK_EQUAL(errors.load(), 0ul);
+
+  // The counters of exited threads are retained
+  const TilePoolStats stats1 = tile_pool_stats();
+  BOOST_CHECK_EQUAL(stats1.hits + stats1.misses,
+                    stats0.hits + stats0.misses + nthreads * 1000ul);
+}
+
+BOOST_AUTO_TEST_CASE(tensor) {
+  typedef Tensor<double, tile_pool_allocator<double>> tensor_type;
+
+  const TilePoolStats stats0 = tile_pool_stats();
+  {
+    tensor_type t(Range(10, 20, 30), 1.0);
+    tensor_type p = t.permute(Permutation{2, 0, 1});
+    tensor_type s = t.add(t);
+    BOOST_CHECK_EQUAL(p.range().volume(), t.range().volume());
+    BOOST_CHECK_EQUAL(s[17], 2.0);
+  }
+  const TilePoolStats stats1 = tile_pool_stats();
+  BOOST_CHECK_GE(stats1.hits + stats1.misses,
+                 stats0.hits + stats0.misses + 3ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tracing.cpp
+ *
+ */
+
+#include "TiledArray/util/tracing.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+#include <sstream>
+
+using namespace TiledArray;
+
+struct TracingFixture {
+  TracingFixture() { tracing::clear(); }
+
+  ~TracingFixture() {
+    tracing::disable();
+    tracing::clear();
+  }
+
+  /// \return The recorded events in the Chrome trace event format
+  static std::string trace() {
+    GlobalFixture::world->gop.fence();
+    std::stringstream ss;
+    tracing::write_chrome_trace(ss, GlobalFixture::world->rank());
+    return ss.str();
+  }
+
+  /// \return The number of occurrences of \c str in \c trace
+  static std::size_t count(const std::string& trace, const std::string& str) {
+    std::size_t result = 0ul;
+    for (auto pos = trace.find(str); pos != std::string::npos;
+         pos = trace.find(str, pos + str.size()))
+      ++result;
+    return result;
+  }
+};  // TracingFixture
+
+BOOST_FIXTURE_TEST_SUITE(tracing_suite, TracingFixture, TA_UT_LABEL_SERIAL)
+
+BOOST_AUTO_TEST_CASE(buffer) {
+  tracing::Buffer buffer(3ul, 0);
+  for (std::uint64_t i = 0ul; i < 5ul; ++i)
+    buffer.push({0, 1, i, 0, 0, tracing::Event::gemm});
+
+  // the oldest events are overwritten
+  const auto records = buffer.records();
+  BOOST_REQUIRE_EQUAL(records.size(), 3ul);
+  BOOST_CHECK_EQUAL(records.front().ordinal, 2ul);
+  BOOST_CHECK_EQUAL(records.back().ordinal, 4ul);
+  BOOST_CHECK_EQUAL(buffer.dropped(), 2ul);
+
+  buffer.clear();
+  BOOST_CHECK(buffer.records().empty());
+}
+
+BOOST_AUTO_TEST_CASE(scope) {
+  // nothing is recorded while tracing is disabled
+  { tracing::Scope scope(tracing::Event::send, 8, 0, 1); }
+  BOOST_CHECK_EQUAL(count(trace(), "\"name\":\"send\""), 0ul);
+
+  tracing::enable();
+  {
+    tracing::TileContext context(42);
+    BOOST_CHECK_EQUAL(tracing::current_ordinal(), 42ul);
+    tracing::Scope scope(tracing::Event::permute, 8, 0);
+  }
+  BOOST_CHECK_EQUAL(tracing::current_ordinal(), tracing::no_ordinal);
+  { tracing::Scope scope(tracing::Event::send, 8, 0, 1); }
+
+  const auto events = trace();
+  BOOST_CHECK_EQUAL(count(events, "\"name\":\"permute\""), 1ul);
+  BOOST_CHECK_EQUAL(count(events, "\"ordinal\":42,"), 1ul);
+  BOOST_CHECK_EQUAL(count(events, "\"name\":\"send\""), 1ul);
+
+  // sends are instant events
+  BOOST_CHECK_EQUAL(count(events, "\"ph\":\"i\""), 1ul);
+  BOOST_CHECK_EQUAL(count(events, "\"ph\":\"X\""), 1ul);
+}
+
+BOOST_AUTO_TEST_CASE(arrival) {
+  tracing::enable();
+  Future<int> f;
+  detail::trace_arrival(tracing::Event::receive, f, 4, 7);
+  BOOST_CHECK_EQUAL(count(trace(), "\"name\":\"receive\""), 0ul);
+
+  // the wait is recorded when the future is set
+  f.set(1);
+  const auto events = trace();
+  BOOST_CHECK_EQUAL(count(events, "\"name\":\"receive\""), 1ul);
+  BOOST_CHECK_EQUAL(count(events, "\"ordinal\":7,"), 1ul);
+}
+
+BOOST_AUTO_TEST_CASE(contraction) {
+  TiledRange1 tr1{0, 3, 6, 10};
+  TArrayD a(*GlobalFixture::world, TiledRange{tr1, tr1});
+  TArrayD b(*GlobalFixture::world, TiledRange{tr1, tr1});
+  a.fill(1.0);
+  b.fill(1.0);
+
+  tracing::enable();
+  TArrayD c;
+  c("i,j") = a("i,k") * b("k,j");
+  c.world().gop.fence();
+
+  // every result tile is the sum of 3 GEMMs, some of which may be batched
+  // into one GEMM
+  const auto events = trace();
+  std::size_t gemms = count(events, "\"name\":\"gemm\"");
+  std::size_t reductions = count(events, "\"name\":\"reduce\"");
+  c.world().gop.sum(gemms);
+  c.world().gop.sum(reductions);
+  BOOST_CHECK_GE(gemms, c.size());
+  BOOST_CHECK_LE(gemms, 3ul * c.size());
+  BOOST_CHECK_EQUAL(reductions, c.size());
+
+  // the GEMMs know their result tile
+  std::stringstream ss(events);
+  for (std::string line; std::getline(ss, line);)
+    if (line.find("\"name\":\"gemm\"") != std::string::npos)
+      BOOST_CHECK(line.find("\"ordinal\":") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,171 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2021  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/weighted_pmap.h"
+#include "global_fixture.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct WeightedPmapFixture {
+  WeightedPmapFixture() {}
+
+  // Costs that grow rapidly with the tile index
+  static std::vector<double> make_costs(const std::size_t tiles) {
+    std::vector<double> costs;
+    for (std::size_t tile = 0ul; tile < tiles; ++tile)
+      costs.push_back(double((tile % 7ul) * (tile % 7ul) * (tile + 1ul)));
+    return costs;
+  }
+};
+
+// =============================================================================
+// WeightedPmap Test Suite
+
+BOOST_FIXTURE_TEST_SUITE(weighted_pmap_suite, WeightedPmapFixture)
+
+BOOST_AUTO_TEST_CASE(constructor) {
+  for (std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    BOOST_REQUIRE_NO_THROW(detail::WeightedPmap pmap(*GlobalFixture::world,
+                                                     make_costs(tiles)));
+    detail::WeightedPmap pmap(*GlobalFixture::world, make_costs(tiles));
+    BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+    BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+    BOOST_CHECK_EQUAL(pmap.size(), tiles);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(owner) {
+  const std::size_t rank = GlobalFixture::world->rank();
+  const std::size_t size = GlobalFixture::world->size();
+
+  ProcessID* p_owner = new ProcessID[size];
+
+  // Check various pmap sizes and partitions
+  for (auto partition : {detail::WeightedPmap::Partition::greedy,
+                         detail::WeightedPmap::Partition::contiguous}) {
+    for (std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+      detail::WeightedPmap pmap(*GlobalFixture::world, make_costs(tiles),
+                                partition);
+
+      for (std::size_t tile = 0; tile < tiles; ++tile) {
+        std::fill_n(p_owner, size, 0);
+        p_owner[rank] = pmap.owner(tile);
+        // check that the value is in range
+        BOOST_CHECK_LT(p_owner[rank], size);
+        GlobalFixture::world->gop.sum(p_owner, size);
+
+        // Make sure everyone agrees on who owns what.
+        for (std::size_t p = 0ul; p < size; ++p)
+          BOOST_CHECK_EQUAL(p_owner[p], p_owner[rank]);
+      }
+    }
+  }
+
+  delete[] p_owner;
+}
+
+BOOST_AUTO_TEST_CASE(local_size) {
+  for (std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    detail::WeightedPmap pmap(*GlobalFixture::world, make_costs(tiles));
+    std::size_t total_size = pmap.local_size();
+    GlobalFixture::world->gop.sum(total_size);
+
+    // Check that the total number of elements in all local groups is equal to
+    // the number of tiles in the map.
+    BOOST_CHECK_EQUAL(total_size, tiles);
+    BOOST_CHECK(pmap.empty() == (pmap.local_size() == 0ul));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(local_group) {
+  ProcessID tile_owners[100];
+
+  for (std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    detail::WeightedPmap pmap(*GlobalFixture::world, make_costs(tiles));
+
+    // Check that all local elements map to this rank
+    for (detail::WeightedPmap::const_iterator it = pmap.begin();
+         it != pmap.end(); ++it) {
+      BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+    }
+
+    std::fill_n(tile_owners, tiles, 0);
+    for (detail::WeightedPmap::const_iterator it = pmap.begin();
+         it != pmap.end(); ++it) {
+      tile_owners[*it] += GlobalFixture::world->rank();
+    }
+
+    GlobalFixture::world->gop.sum(tile_owners, tiles);
+    for (std::size_t tile = 0; tile < tiles; ++tile) {
+      BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(balance) {
+  const std::vector<double> costs = make_costs(1000ul);
+  const double max_cost = *std::max_element(costs.begin(), costs.end());
+  const double mean_load =
+      std::accumulate(costs.begin(), costs.end(), 0.0) /
+      GlobalFixture::world->size();
+
+  // No process exceeds the mean load by more than the largest tile cost
+  for (auto partition : {detail::WeightedPmap::Partition::greedy,
+                         detail::WeightedPmap::Partition::contiguous}) {
+    detail::WeightedPmap pmap(*GlobalFixture::world, costs, partition);
+    const std::vector<double> loads = detail::pmap_loads(pmap, costs);
+    BOOST_CHECK(loads == pmap.loads());
+    for (const double load : loads) BOOST_CHECK_LE(load, mean_load + max_cost);
+    BOOST_CHECK_LE(pmap.imbalance(), 1.0 + max_cost / mean_load);
+  }
+
+  // The contiguous partition preserves the tile order
+  detail::WeightedPmap pmap(*GlobalFixture::world, costs,
+                            detail::WeightedPmap::Partition::contiguous);
+  for (std::size_t tile = 1ul; tile < costs.size(); ++tile)
+    BOOST_CHECK_LE(pmap.owner(tile - 1ul), pmap.owner(tile));
+}
+
+BOOST_AUTO_TEST_CASE(shape_costs) {
+  TiledRange trange{{0, 2, 5, 10, 20}, {0, 3, 4, 8}};
+  Tensor<float> norms(trange.tiles_range(), 1.0f);
+  norms[0] = 0.0f;
+  norms[5] = 0.0f;
+  SparseShape<float> shape(norms, trange);
+
+  const std::vector<double> costs = tile_costs(trange, shape);
+  BOOST_REQUIRE_EQUAL(costs.size(), trange.tiles_range().volume());
+  for (std::size_t ord = 0ul; ord < costs.size(); ++ord)
+    BOOST_CHECK_EQUAL(costs[ord], shape.is_zero(ord)
+                                      ? 0.0
+                                      : double(trange.tile(ord).volume()));
+
+  auto pmap = make_weighted_pmap(
+      *GlobalFixture::world, trange, shape,
+      [](const Range& range) { return 2.0 * range.volume(); });
+  BOOST_CHECK_EQUAL(pmap->size(), costs.size());
+
+  // The map plugs into the array constructors
+  TSpArrayD array(*GlobalFixture::world, trange, shape, pmap);
+  BOOST_CHECK(array.pmap() == pmap);
+}
+
+BOOST_AUTO_TEST_SUITE_END()